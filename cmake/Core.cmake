@@ -0,0 +1,56 @@
+# Game and ReShade independent part of the toggler: rule engine, scheduler, config I/O and apply layer
+set(CORE_TARGET "${PROJECT_NAME}Core")
+
+add_library("${CORE_TARGET}" STATIC)
+target_compile_features("${CORE_TARGET}" PUBLIC cxx_std_23)
+
+file(GLOB_RECURSE CORE_HEADER_FILES
+	LIST_DIRECTORIES false
+	CONFIGURE_DEPENDS
+	"${CMAKE_CURRENT_SOURCE_DIR}/include/Core/*.h"
+)
+
+file(GLOB_RECURSE CORE_SOURCE_FILES
+	LIST_DIRECTORIES false
+	CONFIGURE_DEPENDS
+	"${CMAKE_CURRENT_SOURCE_DIR}/src/Core/*.cpp"
+)
+
+find_package(spdlog CONFIG REQUIRED)
+find_path(SIMPLEINI_INCLUDE_DIRS "SimpleIni.h")
+
+# Config I/O is the only part that needs SimpleIni, skip it where it isn't available
+if(SIMPLEINI_INCLUDE_DIRS)
+	target_include_directories("${CORE_TARGET}" SYSTEM PUBLIC ${SIMPLEINI_INCLUDE_DIRS})
+else()
+	message(STATUS "SimpleIni not found, building ${CORE_TARGET} without config I/O")
+	list(FILTER CORE_SOURCE_FILES EXCLUDE REGEX "/src/Core/ConfigIO.cpp$")
+endif()
+
+# Same for the CSV exports and rapidcsv
+find_path(RAPIDCSV_INCLUDE_DIRS "rapidcsv.h")
+
+if(RAPIDCSV_INCLUDE_DIRS)
+	target_include_directories("${CORE_TARGET}" SYSTEM PUBLIC ${RAPIDCSV_INCLUDE_DIRS})
+else()
+	message(STATUS "rapidcsv not found, building ${CORE_TARGET} without CSV export")
+	list(FILTER CORE_SOURCE_FILES EXCLUDE REGEX "/src/Core/(FrameStats|CostProfiler)IO.cpp$")
+endif()
+
+source_group(TREE ${CMAKE_CURRENT_SOURCE_DIR}/include PREFIX "Header Files" FILES ${CORE_HEADER_FILES})
+source_group(TREE ${CMAKE_CURRENT_SOURCE_DIR}/src PREFIX "Source Files" FILES ${CORE_SOURCE_FILES})
+
+target_sources("${CORE_TARGET}" PRIVATE ${CORE_HEADER_FILES} ${CORE_SOURCE_FILES})
+target_include_directories("${CORE_TARGET}" PUBLIC ${CMAKE_CURRENT_SOURCE_DIR}/include)
+target_link_libraries("${CORE_TARGET}" PUBLIC spdlog::spdlog)
+
+# Same switch as DEBUG_LOG in the plugin
+target_compile_definitions("${CORE_TARGET}" PRIVATE "$<$<CONFIG:DEBUG>:SPDLOG_ACTIVE_LEVEL=SPDLOG_LEVEL_DEBUG>")
+
+# Same warning level as the plugin, the tests build the core with GCC or Clang
+if(MSVC)
+	target_compile_options("${CORE_TARGET}" PRIVATE /W4 /WX /permissive-)
+else()
+	# GCC doesn't know #pragma region
+	target_compile_options("${CORE_TARGET}" PRIVATE -Wall -Wextra -Werror -Wno-unknown-pragmas)
+endif()
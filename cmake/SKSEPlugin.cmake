@@ -69,4 +69,4 @@ target_include_directories("${PROJECT_NAME}" PUBLIC ${CMAKE_CURRENT_SOURCE_DIR}/
 target_include_directories("${PROJECT_NAME}" PRIVATE ${CMAKE_CURRENT_BINARY_DIR}/cmake ${CMAKE_CURRENT_SOURCE_DIR}/src)
 
 # Link libraries
-target_link_libraries("${PROJECT_NAME}" PUBLIC CommonLibSSE::CommonLibSSE)
\ No newline at end of file
+target_link_libraries("${PROJECT_NAME}" PUBLIC CommonLibSSE::CommonLibSSE "${PROJECT_NAME}Core")
\ No newline at end of file
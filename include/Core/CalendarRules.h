@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Config.h"
+#include "GameState.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Evaluates the calendar rules, each kept as a month mask, a weekday mask and a range of days passed.
+// After every evaluation it works out the next date any rule can change at, the next midnight if a
+// rule looks at the weekday, the next month if one looks at the month, and the next range start or
+// end. Until the game gets there Update does nothing, so a month long rule is looked at once a month.
+class CalendarRules
+{
+public:
+	static constexpr std::uint16_t kAllMonths = 0xFFF;
+	static constexpr std::uint8_t kAllWeekdays = 0x7F;
+
+	static constexpr std::array<const char*, 12> kMonthNames = {
+		"Morning Star", "Sun's Dawn", "First Seed", "Rain's Hand", "Second Seed", "Mid Year",
+		"Sun's Height", "Last Seed", "Hearthfire", "Frostfall", "Sun's Dusk", "Evening Star"
+	};
+	static constexpr std::array<const char*, 7> kWeekdayNames = {
+		"Sundas", "Morndas", "Tirdas", "Middas", "Turdas", "Fredas", "Loredas"
+	};
+
+	void Compile(const std::vector<CalendarInfo>& rules);
+	// Rules whose date condition flipped, every rule after Compile or Invalidate
+	const std::vector<std::size_t>& Update(const GameDate& date, float hour);
+	// Reports every rule again on the next Update
+	void Invalidate() { m_Valid = false; }
+
+	bool IsActive(std::size_t rule) const { return m_Active[rule] != 0; }
+	std::size_t GetRuleCount() const { return m_Rules.size(); }
+	// Days passed the rules are evaluated again at
+	double GetNextBoundary() const { return m_NextBoundary; }
+	// Updates that evaluated the rules, the rest returned right away
+	std::size_t GetEvaluationCount() const { return m_EvaluationCount; }
+
+	static bool Matches(const CalendarInfo& info, const GameDate& date);
+
+	// Names separated by commas, seasons ("Winter", "Spring", "Summer", "Autumn") add their three months
+	static std::uint16_t ParseMonths(std::string_view text);
+	static std::string FormatMonths(std::uint16_t months);
+	static std::uint8_t ParseWeekdays(std::string_view text);
+	static std::string FormatWeekdays(std::uint8_t weekdays);
+
+private:
+	struct Rule
+	{
+		std::uint16_t months = kAllMonths;
+		std::uint8_t weekdays = kAllWeekdays;
+		std::int32_t firstDay = 0;
+		std::int32_t lastDay = -1;
+	};
+
+	static bool Matches(const Rule& rule, const GameDate& date);
+
+	std::vector<Rule> m_Rules;
+	std::vector<std::uint8_t> m_Active;
+	std::vector<std::size_t> m_Changed;
+	bool m_Valid = false;
+	bool m_AnyWeekday = false; // Some rule looks at the weekday
+	bool m_AnyMonth = false;   // Some rule looks at the month
+	double m_NextBoundary = 0.0;
+	double m_LastDaysPassed = 0.0;
+	std::size_t m_EvaluationCount = 0;
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Condition inputs as the rule passes last saw them
+struct ConditionSnapshot
+{
+	float hour = 0.0f;
+	bool interior = false;
+	const std::unordered_set<std::string>* menus = nullptr; // Open menus, none if nullptr
+	std::string_view weather;                              // Eg. "kRainy"
+	std::uint32_t player = 0;                              // PlayerState bits
+	std::uint32_t camera = 0;                              // CameraState
+	std::uint32_t light = 0;                               // LightBand
+};
+
+// Boolean expressions over the condition inputs, eg.
+//   interior && hour(22, 5) && !menu(MapMenu)
+// Terms are interior, exterior, menu(Name), weather(kName), player(State), camera(State), light(Band),
+// hour(start, stop) (wraps past midnight when start > stop), true and false, combined with ! && ||
+// (or not, and, or) and parentheses.
+// Every term is interned as one boolean input. Add compiles to postfix bytecode appended to one
+// shared code array, Update refreshes the inputs and re-runs only the expressions reading one that
+// changed.
+class ConditionExpressions
+{
+public:
+	using Index = std::size_t;
+
+	static constexpr std::size_t kMaxDepth = 64; // Deepest operand stack an expression may need
+
+	// Compiles an expression, empty with error set if it doesn't parse. New expressions are evaluated on the next Update.
+	std::optional<Index> Add(std::string_view text, std::string* error = nullptr);
+	void Clear();
+	// Evaluates and reports every expression on the next Update, eg. when their results weren't applied
+	void Invalidate();
+
+	// Expressions whose result changed, or that were evaluated for the first time, in index order
+	const std::vector<Index>& Update(const ConditionSnapshot& snapshot);
+
+	bool GetResult(Index index) const { return m_Results[index] != 0; }
+	std::size_t GetCount() const { return m_Expressions.size(); }
+	std::size_t GetInputCount() const { return m_Inputs.size(); }
+	// Expressions the last Update ran
+	std::size_t GetEvaluatedCount() const { return m_EvaluatedCount; }
+
+	static bool IsHourInRange(float hour, double start, double stop);
+
+private:
+	enum class InputType : std::uint8_t
+	{
+		kInterior,
+		kMenu,
+		kWeather,
+		kHour,
+		kPlayer,
+		kCamera,
+		kLight
+	};
+
+	struct Input
+	{
+		InputType type = InputType::kInterior;
+		std::string name;  // Menu, weather or player state
+		double start = 0.0; // Hour only
+		double stop = 0.0;
+		std::uint32_t flag = 0; // PlayerState bit, CameraState or LightBand
+	};
+
+	enum class OpCode : std::uint8_t
+	{
+		kFalse,
+		kTrue,
+		kInput,
+		kNot,
+		kAnd,
+		kOr
+	};
+
+	struct Instruction
+	{
+		OpCode op = OpCode::kFalse;
+		std::uint32_t input = 0; // kInput only
+	};
+
+	struct Expression
+	{
+		std::uint32_t first = 0; // Into m_Code
+		std::uint32_t count = 0;
+	};
+
+	class Parser;
+
+	std::uint32_t Intern(const Input& input);
+	bool ReadInput(const Input& input, const ConditionSnapshot& snapshot) const;
+	bool Evaluate(const Expression& expression) const;
+	void MarkDirty(Index index);
+
+	std::vector<Input> m_Inputs;
+	std::unordered_map<std::string, std::uint32_t> m_InputIndex; // By type and arguments, so every term is read once
+	std::vector<std::uint8_t> m_Values; // By input
+	std::vector<std::vector<Index>> m_Dependents; // By input, expressions reading it
+	std::size_t m_KnownInputs = 0; // Inputs read at least once, later ones are new
+
+	std::vector<Instruction> m_Code;
+	std::vector<Expression> m_Expressions;
+	std::vector<std::uint8_t> m_Results;
+	std::vector<std::uint8_t> m_Evaluated; // Whether a result exists yet
+
+	std::vector<std::uint8_t> m_Dirty; // By expression
+	std::vector<Index> m_DirtyList;
+	std::vector<Index> m_Changed;
+	std::size_t m_EvaluatedCount = 0;
+};
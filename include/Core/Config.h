@@ -0,0 +1,372 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+struct TechniqueInfo
+{
+	std::string filename = ""; // Effect file, or a group as "@Name"
+	std::string state = "";
+	std::string Name = "";
+	double startTime = 0.0;
+	double stopTime = 0.0;
+	bool enable = true;
+	int priority = 0; // Performance: lowest priority is shed first
+};
+
+// Sets a preprocessor definition of an effect while a condition holds, eg. a cheaper quality tier indoors
+struct DefinitionInfo
+{
+	std::string filename = "";
+	std::string name = "";         // Definition, eg. "SSAO_SAMPLES"
+	std::string value = "";        // While the condition holds
+	std::string defaultValue = ""; // Otherwise
+	std::string category = "";     // "Menu", "Time", "Interior" or "Weather"
+	std::string condition = "";    // Menu or weather name
+	double startTime = 0.0;        // Time only
+	double stopTime = 0.0;
+};
+
+// Sets a uniform of an effect while a condition holds, eg. weaker bloom at night. Same conditions as DefinitionInfo.
+struct UniformInfo
+{
+	std::string filename = "";
+	std::string name = "";     // Uniform variable, eg. "fBloomStrength"
+	std::string type = "float"; // "float", "int" or "bool"
+	double value = 0.0;        // While the condition holds
+	double defaultValue = 0.0; // Otherwise
+	std::string category = "";
+	std::string condition = "";
+	double startTime = 0.0;
+	double stopTime = 0.0;
+};
+
+struct CurveKey
+{
+	double hour = 0.0;
+	double value = 0.0;
+
+	bool operator==(const CurveKey&) const = default;
+};
+
+// Float uniform following keyframes over the day, linear in between and wrapping at midnight
+struct CurveInfo
+{
+	std::string filename = "";
+	std::string name = "";
+	std::vector<CurveKey> keys; // Sorted by hour
+};
+
+// Fades an effect in and out through one of its uniforms instead of switching it hard
+struct FadeInfo
+{
+	std::string filename = "";
+	std::string uniform = "";  // Intensity uniform, ramped between 0 and maxValue
+	double duration = 500.0;   // Milliseconds
+	double maxValue = 1.0;
+};
+
+// Switches the whole ReShade preset while a condition holds, eg. a night preset. Same conditions as DefinitionInfo.
+struct ReshadePresetInfo
+{
+	std::string path = ""; // ReShade preset .ini, as ReShade's own PresetPath
+	std::string category = "";
+	std::string condition = "";
+	double startTime = 0.0;
+	double stopTime = 0.0;
+};
+
+// Named set of effects and techniques rules can target as "@Name", eg. every DOF effect.
+// Techniques can also join with a toggler_group = "Name" annotation.
+struct GroupInfo
+{
+	std::string name = "";
+	std::vector<std::string> members; // "Effect.fx" for all its techniques or "Effect.fx:Technique"
+};
+
+// Toggles an effect while a boolean expression over the conditions holds, eg.
+// interior && hour(22, 5) && !menu(MapMenu). See ConditionExpressions for the syntax.
+struct ExpressionInfo
+{
+	std::string filename = ""; // Effect file, or a group as "@Name"
+	std::string state = "off"; // While the expression holds, the opposite otherwise
+	std::string expression = "";
+};
+
+// Toggles an effect by the in-game calendar, eg. snow effects only in the winter months.
+// Every set condition has to hold.
+struct CalendarInfo
+{
+	std::string filename = ""; // Effect file, or a group as "@Name"
+	std::string state = "off"; // While the date matches, the opposite otherwise
+	std::uint16_t months = 0xFFF; // Bit 0 Morning Star to bit 11 Evening Star
+	std::uint8_t weekdays = 0x7F; // Bit 0 Sundas to bit 6 Loredas
+	int firstDay = 0;             // Days passed, inclusive
+	int lastDay = -1;             // Days passed, inclusive, -1 for no end
+};
+
+// Toggles an effect by where the player is, eg. cheaper effects in Blackreach or in cities
+struct LocationInfo
+{
+	std::string filename = ""; // Effect file, or a group as "@Name"
+	std::string state = "off"; // While the player is there, the opposite otherwise
+	std::string type = "Worldspace"; // "Worldspace", "Location" or "Keyword" of the current location
+	std::string name = "";     // Editor ID, "Plugin.esm|0x1234" or a plain "0x..." FormID
+};
+
+// Toggles an effect while the scene is busy, eg. no RTGI in big battles
+struct SceneInfo
+{
+	std::string filename = ""; // Effect file, or a group as "@Name"
+	std::string state = "off"; // While the scene is busy, the opposite otherwise
+	std::string metric = "Actors"; // "Actors" or "References"
+	double threshold = 30.0;   // Busy from here up
+	double hysteresis = 5.0;   // Until this far below the threshold again
+};
+
+// Sets an effect while one state read from the game holds, eg. the player in combat. StateRuleKind says which.
+struct StateRuleInfo
+{
+	std::string filename = ""; // Effect file, or a group as "@Name"
+	std::string state = "off"; // While the condition holds, the opposite otherwise
+	std::string condition = ""; // One of the kind's state names, eg. "Combat"
+};
+
+// Runs an action when a key is pressed, without opening the overlay
+struct HotkeyInfo
+{
+	std::string key = "";            // eg. "Ctrl+Shift+F10"
+	std::string action = "Toggle";   // "Toggle", "CyclePreset" or "Suspend"
+	std::string target = "";         // Effect file or "@Group" to toggle, presets to cycle separated by commas
+};
+
+struct Info
+{
+	std::string Index = "";
+	std::string Name = "";
+};
+
+enum class Categories
+{
+	Menu,
+	Time,
+	Weather,
+	Interior,
+	Performance
+};
+
+// Everything below is loaded from / saved to a preset by Config.
+
+inline bool isLoaded = false;
+
+// General
+inline bool EnableMenus = true;
+inline bool EnableTime = true;
+inline bool EnableInterior = true;
+inline bool EnableWeather = true;
+inline bool EnablePerformance = false;
+inline bool EnableDeferral = false;
+inline bool EnableDefinitions = false;
+inline bool EnableUniforms = false;
+inline bool EnableCurves = false;
+inline bool EnableFades = false;
+inline bool EnableGameUniforms = false;
+inline bool EnableReshadePresets = false;
+inline bool EnableExpressions = false;
+inline bool EnableCalendar = false;
+inline bool EnableLocation = false;
+inline bool EnableScene = false;
+inline bool EnablePlayer = false;
+inline bool EnableCamera = false;
+inline bool EnableLight = false;
+inline bool EnableHotkeys = false;
+
+
+inline std::atomic<std::uint32_t> ruleRevision = 0; // Bump after changing the Menu, Time, Interior, Weather, Calendar, Location, Scene, Player, Camera or Light rules so they get compiled again
+
+// Menus
+inline std::unordered_set<std::string> g_MenuToggleFile;
+inline std::unordered_set<std::string> g_MenuToggleState;
+inline std::unordered_set<std::string> g_MenuSpecificMenu;
+
+
+inline std::vector<std::string> g_SpecificMenu;
+inline std::vector<std::string> g_INImenus;
+inline std::vector<TechniqueInfo> techniqueMenuInfoList;
+inline std::vector<Info> menuList;
+
+inline std::string ToggleStateMenus;
+inline std::string ToggleAllStateMenus;
+
+inline const char* itemMenuShaderToToggle;
+inline const char* itemMenuStateValue;
+inline const char* itemSpecificMenu;
+
+// Time
+inline std::unordered_set<std::string> g_TimeToggleFile;
+inline std::unordered_set<std::string> g_TimeToggleState;
+
+inline std::vector<TechniqueInfo> techniqueTimeInfoList;
+inline std::vector<TechniqueInfo> techniqueTimeInfoListAll;
+inline std::vector<std::string> g_SpecificTime;
+
+inline std::string ToggleStateTime;
+inline std::string ToggleAllStateTime;
+
+inline const char* itemTimeShaderToToggle;
+inline const char* itemTimeStateValue;
+
+inline double itemTimeStartHour;
+inline double itemTimeStopHour;
+inline double itemTimeStartHourAll;
+inline double itemTimeStopHourAll;
+
+inline int TimeUpdateIntervalTime;
+
+inline bool EnableTimePrewarm = false;
+inline double TimePrewarmLookahead = 120.0; // Real seconds
+
+//Interior
+inline std::unordered_set<std::string> g_InteriorToggleFile;
+inline std::unordered_set<std::string> g_InteriorToggleState;
+
+inline std::vector<TechniqueInfo> techniqueInteriorInfoList;
+inline std::vector<std::string> g_SpecificInterior;
+
+inline std::string ToggleStateInterior;
+inline std::string ToggleAllStateInterior;
+
+inline const char* itemInteriorShaderToToggle;
+inline const char* itemInteriorStateValue;
+
+inline int TimeUpdateIntervalInterior;
+
+inline bool IsInInteriorCell = false;
+
+//Weather
+inline std::unordered_set<std::string> g_WeatherValue;
+inline std::unordered_set<std::string> g_WeatherToggleFile;
+inline std::unordered_set<std::string> g_WeatherToggleState;
+inline std::unordered_set<std::string> g_WeatherSpecificWeather;
+
+inline std::vector<std::string> g_SpecificWeather;
+inline std::vector<std::string> g_INIweather;
+inline std::vector<Info> weatherList;
+inline std::vector<TechniqueInfo> techniqueWeatherInfoList;
+
+inline std::string ToggleStateWeather;
+inline std::string ToggleAllStateWeather;
+inline std::string weatherflags;
+
+inline const char* itemWeatherShaderToToggle;
+inline const char* itemWeatherStateValue;
+inline const char* itemSpecificWeather;
+
+inline int TimeUpdateIntervalWeather;
+
+//Performance
+inline std::vector<TechniqueInfo> techniquePerformanceInfoList;
+
+inline double PerformanceTargetFrameTime = 16.6;
+inline double PerformanceHeadroom = 0.1;
+inline int PerformanceWindowFrames = 30;
+
+//Deferral
+inline std::vector<std::string> deferredEffectList;
+
+inline int DeferralTimeout = 120; // Seconds, 0 waits for a loading screen no matter how long
+
+//Definitions
+inline std::vector<DefinitionInfo> definitionInfoList;
+
+inline int DefinitionBatchDelay = 10; // Seconds, 0 waits for a loading screen no matter how long
+
+//Uniforms
+inline std::vector<UniformInfo> uniformInfoList;
+
+//Curves
+inline std::vector<CurveInfo> curveInfoList;
+inline std::atomic<std::uint32_t> curveRevision = 0; // Bump after changing curveInfoList so it gets compiled again
+
+//Fades
+inline std::vector<FadeInfo> fadeInfoList;
+
+//Groups
+inline std::vector<GroupInfo> groupInfoList;
+inline std::atomic<std::uint32_t> groupRevision = 0; // Bump after changing groupInfoList so the groups get resolved again
+
+//Calendar
+inline std::vector<CalendarInfo> calendarInfoList;
+
+//Location
+inline std::vector<LocationInfo> locationInfoList;
+
+//Player
+inline std::vector<StateRuleInfo> playerInfoList;
+
+//Camera
+inline std::vector<StateRuleInfo> cameraInfoList;
+
+//Light
+inline std::vector<StateRuleInfo> lightInfoList;
+
+inline float LightDarkThreshold = 0.12f;  // Interiors below this level are dark
+inline float LightBrightThreshold = 0.35f; // and from this one on bright, dim in between
+
+//Hotkeys
+inline std::vector<HotkeyInfo> hotkeyInfoList;
+inline std::atomic<std::uint32_t> hotkeyRevision = 0; // Bump after changing hotkeyInfoList so the bindings get compiled again
+
+//Scene
+inline std::vector<SceneInfo> sceneInfoList;
+
+inline int TimeUpdateIntervalScene = 5; // Seconds between samples
+
+//Expressions
+inline std::vector<ExpressionInfo> expressionInfoList;
+inline std::atomic<std::uint32_t> expressionRevision = 0; // Bump after changing expressionInfoList so it gets compiled again
+
+//ReShade presets
+inline std::vector<ReshadePresetInfo> reshadePresetInfoList;
+
+inline std::string DefaultReshadePreset = ""; // While no rule holds, empty keeps whatever is active
+inline int PresetSwitchInterval = 60;         // Seconds between switches outside of loading screens
+inline int PresetSwitchTimeout = 120;         // Seconds, 0 waits for a loading screen no matter how long
+
+// Thread
+inline std::mutex timeMutexTime;
+inline std::mutex vectorMutexTime;
+inline std::mutex timeMutexInterior;
+inline std::mutex timeMutexWeather;
+inline std::mutex timeMutexPerformance;
+inline std::mutex timeMutexDefinitions;
+inline std::mutex timeMutexUniforms;
+inline std::mutex timeMutexCurves;
+inline std::mutex timeMutexFades;
+inline std::mutex timeMutexReshadePresets;
+inline std::mutex timeMutexGroups;
+inline std::mutex timeMutexExpressions;
+inline std::mutex timeMutexCalendar;
+inline std::mutex timeMutexLocation;
+inline std::mutex timeMutexScene;
+inline std::mutex timeMutexPlayer;
+inline std::mutex timeMutexCamera;
+inline std::mutex timeMutexLight;
+inline std::mutex timeMutexHotkeys;
+
+class Config
+{
+public:
+	// Parses a preset into the globals above. Does not clear first, call Clear() for that.
+	static void LoadINI(const std::string& presetPath);
+	// Writes the globals above back out as a preset.
+	static void Save(const std::string& presetPath);
+	// Same as Save, but returns the preset text instead of writing it
+	static std::string Serialize();
+	// Resets every preset global to its empty state.
+	static void Clear();
+};
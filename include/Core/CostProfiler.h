@@ -0,0 +1,102 @@
+#pragma once
+
+#include "EffectRuntime.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Running mean and variance of cost samples (Welford)
+class CostStats
+{
+public:
+	void Add(double sample);
+
+	std::size_t GetCount() const { return m_Count; }
+	double GetMean() const { return m_Mean; }
+	double GetStandardDeviation() const;
+	// Half width of the 95% confidence interval of the mean (Student's t), 0 below two samples
+	double GetConfidenceHalfWidth() const;
+
+private:
+	std::size_t m_Count = 0;
+	double m_Mean = 0.0;
+	double m_M2 = 0.0;
+};
+
+// Measures what each enabled effect costs by turning it off for a window of frames.
+//
+// Windows alternate baseline / effect off / baseline / next effect off ...
+// Each off window is compared to the mean of the baseline windows on both sides, so slow drift in the scene cancels out.
+// One sample per effect per round, the table gets tighter the more rounds run.
+class CostProfiler
+{
+public:
+	struct Settings
+	{
+		std::size_t windowFrames = 60;
+		std::size_t settleFrames = 5; // Dropped after every toggle
+		std::size_t rounds = 10;
+	};
+
+	struct Result
+	{
+		std::string effect;
+		double cost = 0.0;         // ms, baseline minus effect off
+		double confidence = 0.0;   // ms, 95% interval is cost +- confidence
+		std::size_t samples = 0;
+	};
+
+	void SetSettings(const Settings& settings) { m_Settings = settings; }
+	const Settings& GetSettings() const { return m_Settings; }
+
+	// Profiles every effect from the list that has at least one enabled technique right now
+	void Start(IEffectRuntime& runtime, const std::vector<std::string>& effects);
+	// Puts the effect under test back, keeps the results gathered so far
+	void Stop(IEffectRuntime& runtime);
+	// Stops without touching the runtime, for when the effects were reloaded and the technique handles are gone.
+	// The reload put the effect under test back to the preset already. Keeps the results gathered so far.
+	void Abort();
+	bool IsRunning() const { return m_Phase != Phase::kIdle; }
+
+	void AddFrame(IEffectRuntime& runtime, float frameTime);
+
+	// Most expensive first
+	std::vector<Result> GetResults() const;
+	// Completed rounds plus progress in the current one, 0 to 1
+	float GetProgress() const;
+
+	bool SaveCSV(const std::string& path) const;
+
+private:
+	enum class Phase
+	{
+		kIdle,
+		kBaseline,
+		kDisabled
+	};
+
+	struct Subject
+	{
+		std::string effect;
+		std::vector<EffectTechnique> techniques; // Only the ones that were enabled at Start
+		CostStats stats;
+	};
+
+	void SetSubjectState(IEffectRuntime& runtime, Subject& subject, bool enabled);
+
+	Settings m_Settings;
+	std::vector<Subject> m_Subjects;
+
+	Phase m_Phase = Phase::kIdle;
+	std::size_t m_Current = 0;
+	std::size_t m_Round = 0;
+
+	std::size_t m_PhaseFrames = 0;
+	double m_WindowSum = 0.0;
+	std::size_t m_WindowCount = 0;
+
+	double m_LastBaseline = 0.0;
+	double m_PendingOff = -1.0; // Off window mean waiting for the following baseline, < 0 if none
+	std::size_t m_PendingSubject = 0;
+};
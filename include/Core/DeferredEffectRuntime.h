@@ -0,0 +1,44 @@
+#pragma once
+
+#include "EffectRuntime.h"
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Holds back enables of expensive effects (deferredEffectList) until a loading screen hides the
+// shader compile hitch, or until DeferralTimeout runs out. Disables always go through immediately.
+class DeferredEffectRuntime : public EffectRuntimeDecorator
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	explicit DeferredEffectRuntime(IEffectRuntime& runtime) : EffectRuntimeDecorator(runtime) {}
+
+	void SetTechniqueState(EffectTechnique technique, bool enabled) override;
+
+	// Applies every queued enable
+	void Flush();
+	// Applies enables that waited longer than the timeout, or everything once deferral got turned off
+	void Update(Clock::time_point now);
+
+	std::size_t GetPendingCount();
+
+	// Menus that cover the screen long enough to compile behind
+	static bool IsLoadingMenu(std::string_view menuName) { return menuName == "Loading Menu" || menuName == "Fader Menu"; }
+
+private:
+	struct Pending
+	{
+		Clock::time_point queued;
+		std::vector<std::uint64_t> techniques;
+	};
+
+	void Apply(std::unordered_map<std::string, Pending>& pending);
+
+	std::mutex m_PendingMutex;
+	std::unordered_map<std::string, Pending> m_Pending; // By effect file
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "EffectRuntime.h"
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+
+// Collects preprocessor definition changes from every category and applies them as one batch,
+// on the next loading screen or DefinitionBatchDelay seconds after the first change came in.
+// Each definition only keeps its last queued value and values the effect already has are dropped,
+// so a batch touches every effect at most once and ReShade recompiles it once.
+class DefinitionBatchRuntime : public EffectRuntimeDecorator
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	explicit DefinitionBatchRuntime(IEffectRuntime& runtime) : EffectRuntimeDecorator(runtime) {}
+
+	void SetPreprocessorDefinition(const char* effectName, const char* name, const char* value) override;
+	// Includes queued values, so callers see their own changes before the batch lands
+	std::optional<std::string> GetPreprocessorDefinition(const char* effectName, const char* name) const override;
+
+	// Applies the batch, returns the number of effects it changed
+	std::size_t Flush();
+	// Applies the batch once it waited long enough, or right away once definitions got turned off
+	void Update(Clock::time_point now);
+
+	// Queued definitions over all effects
+	std::size_t GetPendingCount();
+	std::size_t GetBatchCount() const { return m_BatchCount; }
+
+private:
+	mutable std::mutex m_PendingMutex;
+	std::map<std::string, std::map<std::string, std::string>> m_Pending; // Effect, then definition name
+	Clock::time_point m_Queued;
+	std::size_t m_BatchCount = 0;
+};
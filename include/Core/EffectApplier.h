@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Config.h"
+#include "EffectGroups.h"
+#include "EffectRuntime.h"
+
+class EffectApplier
+{
+public:
+	// Rules targeting a group ("@Name") need the groups, without them they do nothing
+	static void ApplyTechniqueState(IEffectRuntime& runtime, bool enableReshade, const TechniqueInfo& info, EffectGroups* groups = nullptr);
+	static void ApplyReshadeState(IEffectRuntime& runtime, bool enableReshade, const std::string& toggleState);
+	// Calls callback for every technique of an effect file or "@Group", groups need the groups
+	static void EnumerateTechniques(IEffectRuntime& runtime, const std::string& target, EffectGroups* groups, const IEffectRuntime::TechniqueCallback& callback);
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Config.h"
+#include "EffectRuntime.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Resolves groups (groupInfoList plus toggler_group technique annotations) into bitsets.
+// Build numbers the techniques of every effect consecutively, so a group is one bitset over
+// technique IDs plus one over effects. Applying a group scans the effect words for set bits and
+// enumerates only those effects, setting techniques by their bit. Going through EnumerateTechniques
+// keeps decorators further down aware of the effect. IDs follow enumeration order, so Build has to
+// run again after every reload.
+class EffectGroups
+{
+public:
+	using Bits = std::vector<std::uint64_t>;
+
+	// Numbers the techniques of the given effect files and resolves every group
+	void Build(IEffectRuntime& runtime, const std::vector<std::string>& effects, const std::vector<GroupInfo>& groups);
+	// Sets every technique of the group, returns how many were set. With or without the @, unknown groups set nothing.
+	std::size_t Apply(IEffectRuntime& runtime, std::string_view group, bool enabled);
+	// Whether any technique of the group is enabled, false for unknown groups
+	bool IsEnabled(IEffectRuntime& runtime, std::string_view group);
+	// Calls callback for every technique of the group, from inside EnumerateTechniques of its effect. Unknown groups call nothing.
+	void Enumerate(IEffectRuntime& runtime, std::string_view group, const IEffectRuntime::TechniqueCallback& callback);
+
+	std::size_t GetTechniqueCount();
+	// Members of a group by technique ID, empty if unknown. With or without the @.
+	Bits GetTechniques(std::string_view group);
+	// Preset and annotation groups, sorted
+	std::vector<std::string> GetGroupNames();
+	// Bumped by every Build
+	std::uint32_t GetRevision() const { return m_Revision; }
+
+	// Rule targets starting with @ name a group
+	static bool IsGroup(std::string_view filename) { return filename.starts_with('@'); }
+	// "DOF.fx, Bloom.fx:BloomPass" into its members
+	static std::vector<std::string> ParseMembers(std::string_view text);
+	static std::string FormatMembers(const std::vector<std::string>& members);
+
+private:
+	struct Group
+	{
+		Bits techniques;
+		Bits effects;
+	};
+
+	// Calls callback for every member technique, enumerating only the effects that have any. Needs m_Mutex held.
+	void EnumerateMembers(IEffectRuntime& runtime, const Group& group, const IEffectRuntime::TechniqueCallback& callback);
+	const Group* FindGroup(std::string_view name) const;
+
+	static void SetBit(Bits& bits, std::size_t index);
+	static bool TestBit(const Bits& bits, std::size_t index);
+
+	std::mutex m_Mutex;
+	std::vector<std::string> m_Effects;            // By effect index
+	std::vector<std::size_t> m_FirstTechnique;     // By effect index, one past the end for the last
+	std::unordered_map<std::string, Group> m_Groups; // By name without the @
+	std::uint32_t m_Revision = 0;
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+
+// Opaque technique handle, same meaning as reshade::api::effect_technique::handle
+struct EffectTechnique
+{
+	std::uint64_t handle = 0;
+};
+
+// Opaque uniform variable handle, same meaning as reshade::api::effect_uniform_variable::handle. Zero if not found.
+struct EffectUniform
+{
+	std::uint64_t handle = 0;
+};
+
+// The subset of reshade::api::effect_runtime the toggler uses.
+// The plugin forwards this to the real runtime, tests and benchmarks use a stub.
+class IEffectRuntime
+{
+public:
+	using TechniqueCallback = std::function<void(EffectTechnique)>;
+	using UniformCallback = std::function<void(EffectUniform)>;
+
+	virtual ~IEffectRuntime() = default;
+
+	virtual void SetEffectsState(bool enabled) = 0;
+	// Calls callback for every technique in the given effect file (eg. "Bloom.fx")
+	virtual void EnumerateTechniques(const char* effectName, const TechniqueCallback& callback) = 0;
+	virtual void SetTechniqueState(EffectTechnique technique, bool enabled) = 0;
+	virtual bool GetTechniqueState(EffectTechnique technique) const = 0;
+	virtual std::string GetTechniqueName(EffectTechnique technique) const = 0;
+	// Value of a string annotation on the technique. Empty if it has none by that name.
+	virtual std::optional<std::string> GetTechniqueAnnotation(EffectTechnique technique, const char* name) const = 0;
+	// Per effect preprocessor definitions. Setting one makes ReShade recompile the effect.
+	virtual void SetPreprocessorDefinition(const char* effectName, const char* name, const char* value) = 0;
+	// Empty if the effect doesn't define it
+	virtual std::optional<std::string> GetPreprocessorDefinition(const char* effectName, const char* name) const = 0;
+	// Handles stay valid until the effects are reloaded
+	virtual EffectUniform FindUniformVariable(const char* effectName, const char* variableName) const = 0;
+	virtual void SetUniformValueFloat(EffectUniform variable, const float* values, std::size_t count) = 0;
+	virtual void SetUniformValueInt(EffectUniform variable, const std::int32_t* values, std::size_t count) = 0;
+	virtual void SetUniformValueBool(EffectUniform variable, const bool* values, std::size_t count) = 0;
+	// Calls callback for every uniform in the given effect file, or in every effect if it's nullptr
+	virtual void EnumerateUniformVariables(const char* effectName, const UniformCallback& callback) = 0;
+	// Value of a string annotation on the uniform, eg. source = "toggler_hour". Empty if it has none by that name.
+	virtual std::optional<std::string> GetUniformAnnotation(EffectUniform variable, const char* name) const = 0;
+	// Path of the active ReShade preset
+	virtual std::string GetCurrentPresetPath() const = 0;
+	// Saves the active preset and loads another one, reloading whatever effects it needs
+	virtual void SetCurrentPresetPath(const char* path) = 0;
+	// Windows virtual key codes. Down while held, pressed only in the frame it went down.
+	virtual bool IsKeyDown(std::uint32_t keycode) const = 0;
+	virtual bool IsKeyPressed(std::uint32_t keycode) const = 0;
+};
+
+// Base for runtimes that sit in front of another one. Forwards everything and
+// remembers which effect is being enumerated, since SetTechniqueState only gets a handle.
+class EffectRuntimeDecorator : public IEffectRuntime
+{
+public:
+	explicit EffectRuntimeDecorator(IEffectRuntime& runtime) : m_Runtime(runtime) {}
+
+	void SetEffectsState(bool enabled) override { m_Runtime.SetEffectsState(enabled); }
+	void EnumerateTechniques(const char* effectName, const TechniqueCallback& callback) override;
+	void SetTechniqueState(EffectTechnique technique, bool enabled) override { m_Runtime.SetTechniqueState(technique, enabled); }
+	bool GetTechniqueState(EffectTechnique technique) const override { return m_Runtime.GetTechniqueState(technique); }
+	std::string GetTechniqueName(EffectTechnique technique) const override { return m_Runtime.GetTechniqueName(technique); }
+	std::optional<std::string> GetTechniqueAnnotation(EffectTechnique technique, const char* name) const override { return m_Runtime.GetTechniqueAnnotation(technique, name); }
+	void SetPreprocessorDefinition(const char* effectName, const char* name, const char* value) override { m_Runtime.SetPreprocessorDefinition(effectName, name, value); }
+	std::optional<std::string> GetPreprocessorDefinition(const char* effectName, const char* name) const override { return m_Runtime.GetPreprocessorDefinition(effectName, name); }
+	EffectUniform FindUniformVariable(const char* effectName, const char* variableName) const override { return m_Runtime.FindUniformVariable(effectName, variableName); }
+	void SetUniformValueFloat(EffectUniform variable, const float* values, std::size_t count) override { m_Runtime.SetUniformValueFloat(variable, values, count); }
+	void SetUniformValueInt(EffectUniform variable, const std::int32_t* values, std::size_t count) override { m_Runtime.SetUniformValueInt(variable, values, count); }
+	void SetUniformValueBool(EffectUniform variable, const bool* values, std::size_t count) override { m_Runtime.SetUniformValueBool(variable, values, count); }
+	void EnumerateUniformVariables(const char* effectName, const UniformCallback& callback) override { m_Runtime.EnumerateUniformVariables(effectName, callback); }
+	std::optional<std::string> GetUniformAnnotation(EffectUniform variable, const char* name) const override { return m_Runtime.GetUniformAnnotation(variable, name); }
+	std::string GetCurrentPresetPath() const override { return m_Runtime.GetCurrentPresetPath(); }
+	void SetCurrentPresetPath(const char* path) override { m_Runtime.SetCurrentPresetPath(path); }
+	bool IsKeyDown(std::uint32_t keycode) const override { return m_Runtime.IsKeyDown(keycode); }
+	bool IsKeyPressed(std::uint32_t keycode) const override { return m_Runtime.IsKeyPressed(keycode); }
+
+protected:
+	// Effect whose techniques are being enumerated on this thread, empty outside of EnumerateTechniques
+	static const char* GetCurrentEffect();
+	// For changes made outside of EnumerateTechniques, eg. at the end of a fade, so the runtimes further down still see the effect
+	void SetEffectTechniqueState(const char* effectName, EffectTechnique technique, bool enabled);
+
+	IEffectRuntime& m_Runtime;
+};
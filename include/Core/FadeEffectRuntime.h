@@ -0,0 +1,72 @@
+#pragma once
+
+#include "EffectRuntime.h"
+
+#include <array>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Turns toggles of effects in fadeInfoList into ramps of their intensity uniform. A disable ramps
+// down and switches the technique off at the end, an enable switches it on at zero and ramps up.
+// Toggling again mid-fade reverses from the current level. Fades live in a fixed pool driven from
+// Update, when it's full toggles go through hard.
+class FadeEffectRuntime : public EffectRuntimeDecorator
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	static constexpr std::size_t kMaxFades = 32;
+
+	explicit FadeEffectRuntime(IEffectRuntime& runtime) : EffectRuntimeDecorator(runtime) {}
+
+	void SetTechniqueState(EffectTechnique technique, bool enabled) override;
+
+	// Call every present, writes the ramps and finishes fades that are done
+	void Update(Clock::time_point now);
+	// The effects reloaded, drops every fade and cached handle
+	void Reset();
+
+	std::size_t GetActiveCount();
+
+private:
+	struct Fade
+	{
+		bool active = false;
+		EffectTechnique technique;
+		const char* effect = ""; // Key in m_Uniforms, both are dropped together by Reset
+		EffectUniform uniform;
+		float from = 0.0f;
+		float to = 0.0f;
+		Clock::time_point start;
+		Clock::duration duration{};
+		bool disable = false; // Switch the technique off once the ramp is done
+	};
+
+	struct CachedUniform
+	{
+		std::string name;
+		EffectUniform uniform;
+	};
+
+	// Lets the cache be searched with the effect name as is
+	struct NameHash
+	{
+		using is_transparent = void;
+		std::size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+	};
+
+	// Level of a fade at the given time, 0 to 1 progress in between
+	static float GetLevel(const Fade& fade, Clock::time_point now);
+
+	// Caller holds m_Mutex
+	Fade* FindFade(EffectTechnique technique);
+	Fade* FindFreeFade();
+
+	std::mutex m_Mutex;
+	std::array<Fade, kMaxFades> m_Fades;
+	std::unordered_map<std::string, CachedUniform, NameHash, std::equal_to<>> m_Uniforms; // By effect file, looked up once per reload
+};
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "EffectRuntime.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Fixed size ring of frame times in milliseconds.
+// Single producer (the present callback), any number of readers, no locks on either side.
+class FrameTimeRing
+{
+public:
+	static constexpr std::size_t kCapacity = 4096;
+
+	void Push(float frameTime)
+	{
+		const std::uint64_t frame = m_Count.load(std::memory_order_relaxed);
+		m_Samples[frame % kCapacity].store(frameTime, std::memory_order_relaxed);
+		m_Count.store(frame + 1, std::memory_order_release);
+	}
+
+	// Total number of frames pushed, the newest frame has index GetCount() - 1
+	std::uint64_t GetCount() const { return m_Count.load(std::memory_order_acquire); }
+
+	// Copies up to count of the newest samples, oldest first. Returns the frame index of the first copied sample.
+	std::uint64_t CopyLatest(std::size_t count, std::vector<float>& out) const;
+
+private:
+	std::array<std::atomic<float>, kCapacity> m_Samples{};
+	std::atomic<std::uint64_t> m_Count = 0;
+};
+
+struct TechniqueChange
+{
+	std::uint64_t frame = 0; // Frame index the change landed in
+	std::string effect;      // Empty for SetEffectsState
+	bool enabled = false;
+};
+
+// Rolling frame time statistics plus the technique changes that happened in the same frames
+class FrameStats
+{
+public:
+	struct Window
+	{
+		std::uint64_t firstFrame = 0;
+		std::size_t frames = 0;
+		float p50 = 0.0f;
+		float p95 = 0.0f;
+		float p99 = 0.0f;
+		std::vector<TechniqueChange> changes;
+	};
+
+	// Called once per present, returns the frame time. The first call only starts the clock.
+	std::optional<float> OnPresent(std::chrono::steady_clock::time_point now);
+	void RecordFrameTime(float frameTime) { m_Frames.Push(frameTime); }
+
+	// Safe from any thread, attributed to the frame currently being rendered
+	void RecordChange(std::string effect, bool enabled);
+
+	// Stats over the newest frameCount frames
+	Window GetWindow(std::size_t frameCount) const;
+	// Consecutive windows of frameCount frames over everything still in the ring, oldest first
+	std::vector<Window> GetWindows(std::size_t frameCount) const;
+
+	std::uint64_t GetFrameCount() const { return m_Frames.GetCount(); }
+
+	// One row per window: first frame, frame count, p50/p95/p99 in ms and the changes as "Effect.fx=on;..."
+	bool SaveCSV(const std::string& path, std::size_t frameCount) const;
+
+	// Nearest rank percentile, reorders samples
+	static float Percentile(std::vector<float>& samples, float percentile);
+
+private:
+	Window MakeWindow(std::uint64_t firstFrame, std::vector<float> samples) const;
+
+	FrameTimeRing m_Frames;
+	std::chrono::steady_clock::time_point m_LastPresent;
+
+	// Changes are rare compared to frames, a plain locked list is enough
+	static constexpr std::size_t kMaxChanges = 1024;
+	mutable std::mutex m_ChangesMutex;
+	std::vector<TechniqueChange> m_Changes;
+};
+
+// Forwards to another runtime and reports every state that actually changed to FrameStats
+class FrameStatsEffectRuntime : public EffectRuntimeDecorator
+{
+public:
+	FrameStatsEffectRuntime(IEffectRuntime& runtime, FrameStats& stats) :
+		EffectRuntimeDecorator(runtime), m_Stats(stats)
+	{}
+
+	void SetEffectsState(bool enabled) override;
+	void SetTechniqueState(EffectTechnique technique, bool enabled) override;
+
+	// Forgets the technique states, call after every reload or new runtime. Handles can be reused by other techniques,
+	// so each is read from the runtime again the next time it's set.
+	void Reset();
+
+private:
+	FrameStats& m_Stats;
+
+	std::mutex m_StateMutex;
+	std::unordered_map<std::uint64_t, bool> m_TechniqueStates;
+	int m_EffectsState = -1; // Unknown until the first call
+};
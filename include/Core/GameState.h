@@ -0,0 +1,160 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+// Mirrors RE::TESWeather::WeatherDataFlag so the core doesn't need CommonLib.
+enum class WeatherFlag : std::uint32_t
+{
+	kNone = 0,
+	kPleasant = 1 << 0,
+	kCloudy = 1 << 1,
+	kRainy = 1 << 2,
+	kSnow = 1 << 3,
+	kPermAurora = 1 << 4,
+	kAuroraFollowsSun = 1 << 5
+};
+
+// Bits of IGameStateProvider::GetPlayerState
+enum class PlayerState : std::uint32_t
+{
+	kNone = 0,
+	kCombat = 1 << 0,
+	kSneaking = 1 << 1,
+	kSwimming = 1 << 2,
+	kMounted = 1 << 3,
+	kTransformed = 1 << 4 // Werewolf or vampire lord
+};
+
+// Preset names of the PlayerState bits, in bit order
+inline constexpr std::array<const char*, 5> kPlayerStateNames = { "Combat", "Sneaking", "Swimming", "Mounted", "Transformed" };
+
+// What the camera is doing, the few states rules care about
+enum class CameraState : std::uint32_t
+{
+	kThirdPerson, // Also on a horse or dragon
+	kFirstPerson,
+	kFree,        // tfc
+	kKillcam,     // VATS, kill moves
+	kOther        // Furniture, bleedout, transitions
+};
+
+// Preset names of the CameraState values, in order
+inline constexpr std::array<const char*, 5> kCameraStateNames = { "ThirdPerson", "FirstPerson", "Free", "Killcam", "Other" };
+
+// How bright the current interior is, in bands of IGameStateProvider::GetCellLightLevel
+enum class LightBand : std::uint32_t
+{
+	kNone, // Exteriors, their light follows the weather
+	kDark,
+	kDim,
+	kBright
+};
+
+// Preset names of the LightBand values, in order
+inline constexpr std::array<const char*, 4> kLightBandNames = { "None", "Dark", "Dim", "Bright" };
+
+// Dark below darkBelow, bright from brightFrom on, dim in between
+inline LightBand GetLightBand(std::optional<float> level, float darkBelow, float brightFrom)
+{
+	if (!level)
+	{
+		return LightBand::kNone;
+	}
+	if (*level < darkBelow)
+	{
+		return LightBand::kDark;
+	}
+	return *level < brightFrom ? LightBand::kDim : LightBand::kBright;
+}
+
+enum class CellType : std::uint8_t
+{
+	kNone,
+	kInterior,
+	kExterior
+};
+
+// The in-game calendar date
+struct GameDate
+{
+	std::uint32_t month = 0;       // 0 Morning Star to 11 Evening Star
+	std::uint32_t day = 1;         // Day of the month, from 1
+	std::uint32_t dayOfWeek = 0;   // 0 Sundas to 6 Loredas
+	float daysPassed = 0.0f;       // Since the game started, the hour as the fraction
+};
+
+// Where the player is, as FormIDs
+struct LocationSnapshot
+{
+	std::uint32_t worldspace = 0;         // 0 in interiors
+	std::vector<std::uint32_t> locations; // Current location, then its parents
+	std::vector<std::uint32_t> keywords;  // Of every location above, eg. LocTypeCity
+
+	bool operator==(const LocationSnapshot&) const = default;
+};
+
+// How busy the scene around the player is
+struct SceneSample
+{
+	std::uint32_t actors = 0;     // Actors in high process, the fully simulated ones
+	std::uint32_t references = 0; // References in the loaded cells
+};
+
+// Everything the RuleEngine needs to know about the game.
+// The plugin implements this on top of the RE:: singletons, tests use a stub.
+class IGameStateProvider
+{
+public:
+	virtual ~IGameStateProvider() = default;
+
+	virtual float GetHour() const = 0;
+	// Game seconds per real second, 20 in an unmodded game
+	virtual float GetTimeScale() const = 0;
+	virtual GameDate GetDate() const = 0;
+	virtual CellType GetCellType() const = 0;
+	// PlayerState bits, a few flag reads so it can be called every frame
+	virtual std::uint32_t GetPlayerState() const = 0;
+	// Same, a pointer read
+	virtual CameraState GetCameraState() const = 0;
+	// Ambient and directional light of the current interior from its lighting template or its own
+	// lighting, as luminance from 0 to 1. Empty in exteriors. Read it on cell change, not every frame.
+	virtual std::optional<float> GetCellLightLevel() const = 0;
+	virtual LocationSnapshot GetLocation() const = 0;
+	// FormID of a worldspace, location or keyword by editor ID, or "Plugin.esm|0x1234". 0 if there is none.
+	virtual std::uint32_t LookupFormID(std::string_view name) const = 0;
+	// Main thread only. Reads one count per loaded cell, never walks the references themselves.
+	virtual SceneSample GetSceneSample() const = 0;
+	// Empty if there is no current weather
+	virtual std::optional<std::uint32_t> GetWeatherFlags() const = 0;
+	// How far the current weather has replaced the previous one, 0 to 1
+	virtual float GetWeatherTransition() const = 0;
+	// A menu that pauses the game is open
+	virtual bool IsMenuOpen() const = 0;
+};
+
+// Returns the preset name (eg. "kRainy") for a flag value, nullptr if it isn't exactly one known flag.
+inline const char* GetWeatherFlagName(std::uint32_t flags)
+{
+	switch (static_cast<WeatherFlag>(flags))
+	{
+	case WeatherFlag::kNone:
+		return "kNone";
+	case WeatherFlag::kRainy:
+		return "kRainy";
+	case WeatherFlag::kPleasant:
+		return "kPleasant";
+	case WeatherFlag::kCloudy:
+		return "kCloudy";
+	case WeatherFlag::kSnow:
+		return "kSnow";
+	case WeatherFlag::kPermAurora:
+		return "kPermAurora";
+	case WeatherFlag::kAuroraFollowsSun:
+		return "kAuroraFollowsSun";
+	}
+	return nullptr;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "EffectRuntime.h"
+#include "GameState.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+enum class GameUniformSource : std::uint8_t
+{
+	kHour,
+	kInterior,
+	kWeatherFlags,
+	kWeatherTransition,
+	kMenuOpen,
+	kCount
+};
+
+// Publishes game state to uniforms that ask for it with a source annotation, eg.
+//   uniform float Hour < source = "toggler_hour"; >;
+// so shaders don't have to guess day and night from the screen. The uniforms are found once after
+// each reload, the state is read once per frame and only written when it changed.
+// Everything runs on the render thread, from present and the reload event.
+class GameUniformFeed
+{
+public:
+	// Call every present, returns the number of uniforms written
+	std::size_t Update(IEffectRuntime& runtime, const IGameStateProvider& gameState);
+	// The effects reloaded, handles are gone and ReShade reset the values
+	void Reset();
+
+	std::size_t GetUniformCount() const;
+	std::size_t GetWriteCount() const { return m_WriteCount; }
+
+	// Annotation value for a source, eg. "toggler_hour"
+	static const char* GetSourceName(GameUniformSource source);
+	static std::optional<GameUniformSource> ParseSource(std::string_view name);
+
+private:
+	static constexpr std::size_t kSourceCount = static_cast<std::size_t>(GameUniformSource::kCount);
+
+	void Discover(IEffectRuntime& runtime);
+
+	bool m_Discovered = false;
+	std::array<std::vector<EffectUniform>, kSourceCount> m_Uniforms; // By source
+	std::array<std::optional<float>, kSourceCount> m_Written;        // Empty until written since the last reload
+	std::size_t m_WriteCount = 0;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Config.h"
+#include "EffectGroups.h"
+#include "EffectRuntime.h"
+#include "PresetSwitcher.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Hotkey bindings compiled into one flat array. Poll runs once per frame and only asks the runtime
+// whether each binding's key went down, the modifiers are read once one did and the target strings
+// are only touched by a binding that fires. Modifiers have to match exactly, so Ctrl+F10 and F10
+// can be bound to different actions.
+class Hotkeys
+{
+public:
+	enum class Action : std::uint8_t
+	{
+		kToggle,      // Effect or group, off if any of its techniques is on, otherwise on
+		kCyclePreset, // Next preset of the list, switched on the next present
+		kSuspend      // Stop or resume applying rules
+	};
+
+	enum Modifier : std::uint8_t
+	{
+		kCtrl = 1 << 0,
+		kShift = 1 << 1,
+		kAlt = 1 << 2
+	};
+
+	struct Key
+	{
+		std::uint32_t keycode = 0; // Windows virtual key code
+		std::uint8_t modifiers = 0;
+
+		bool operator==(const Key&) const = default;
+	};
+
+	// Bindings with an unknown key or action, or nothing to act on, are left out
+	void Compile(const std::vector<HotkeyInfo>& hotkeys);
+	// Call once per frame. Toggles and preset cycles are done right away, returns whether a Suspend binding fired.
+	bool Poll(IEffectRuntime& runtime, EffectGroups* groups, PresetSwitcher& presets);
+
+	std::size_t GetBindingCount() const { return m_Bindings.size(); }
+	// Indices into the list passed to Compile that were left out
+	const std::vector<std::size_t>& GetInvalid() const { return m_Invalid; }
+
+	// "Ctrl+Shift+F10", "Alt+Home", "Numpad5", case doesn't matter
+	static std::optional<Key> ParseKey(std::string_view text);
+	static std::string FormatKey(Key key);
+	static std::optional<Action> ParseAction(std::string_view action);
+
+private:
+	struct Binding
+	{
+		Key key;
+		Action action = Action::kToggle;
+		std::uint32_t first = 0;   // Targets in m_Targets
+		std::uint32_t count = 0;
+		std::uint32_t next = 0;    // CyclePreset only, offset of the next preset
+	};
+
+	void Fire(Binding& binding, IEffectRuntime& runtime, EffectGroups* groups, PresetSwitcher& presets);
+
+	std::vector<Binding> m_Bindings;
+	std::vector<std::string> m_Targets;
+	std::vector<std::size_t> m_Invalid;
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Config.h"
+#include "GameState.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Matches the location rules against where the player is. Compile resolves every rule's name to a
+// FormID once and files the rule under it in a hash index per type. Update then looks up the few
+// FormIDs of the current worldspace, locations and keywords instead of walking the rules, and does
+// nothing at all when the player moved without any of them changing.
+class LocationRules
+{
+public:
+	enum class Type : std::uint8_t
+	{
+		kWorldspace,
+		kLocation,
+		kKeyword
+	};
+
+	// FormID by name, 0 if it doesn't resolve
+	using Resolver = std::function<std::uint32_t(std::string_view)>;
+
+	// Plain "0x..." names are taken as FormIDs, everything else goes through the resolver
+	void Compile(const std::vector<LocationInfo>& rules, const Resolver& resolve);
+	// Rules that started or stopped holding, every rule after Compile or Invalidate
+	const std::vector<std::size_t>& Update(const LocationSnapshot& location);
+	// Reports every rule again on the next Update
+	void Invalidate() { m_Valid = false; }
+
+	bool IsActive(std::size_t rule) const { return m_Active[rule] != 0; }
+	std::size_t GetRuleCount() const { return m_RuleCount; }
+	// Rules whose name didn't resolve, they never hold
+	const std::vector<std::size_t>& GetUnresolved() const { return m_Unresolved; }
+
+	static std::optional<Type> ParseType(std::string_view type);
+
+private:
+	using Index = std::unordered_map<std::uint32_t, std::vector<std::uint32_t>>;
+
+	void Mark(Type type, std::uint32_t formID);
+
+	std::array<Index, 3> m_Index; // By Type
+	std::size_t m_RuleCount = 0;
+	std::vector<std::uint8_t> m_Active;
+	std::vector<std::uint8_t> m_Next;
+	std::vector<std::size_t> m_Changed;
+	std::vector<std::size_t> m_Unresolved;
+	LocationSnapshot m_Last;
+	bool m_Valid = false;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Frame budget control loop. Knows nothing about effects, only how many levels have been shed.
+//
+// Frame times are collected in windows. At the end of each window the p95 is compared to the target:
+//  - over target: shed one more level and remember the p95 before shedding
+//  - the next window measures what shedding saved, that becomes the level's cost
+//  - restore the last shed level only once p95 + its cost stays below target * (1 - headroom)
+// Measuring the cost keeps an effect that doesn't fit the headroom from flapping on and off.
+class PerformanceGovernor
+{
+public:
+	struct Settings
+	{
+		float targetFrameTime = 16.6f; // ms
+		float headroom = 0.1f;         // Fraction of the target that has to stay free after a restore
+		std::size_t windowFrames = 30;
+	};
+
+	enum class Action
+	{
+		kNone,
+		kShed,    // Disable level GetShedCount() - 1
+		kRestore  // Re-enable level GetShedCount()
+	};
+
+	void SetSettings(const Settings& settings) { m_Settings = settings; }
+	const Settings& GetSettings() const { return m_Settings; }
+
+	// Number of levels the governor is allowed to shed, shrinking it below GetShedCount() restores on the next window
+	void SetLevelCount(std::size_t levelCount) { m_LevelCount = levelCount; }
+
+	Action AddFrame(float frameTime);
+
+	std::size_t GetShedCount() const { return m_Costs.size(); }
+	float GetLastFrameTime() const { return m_LastFrameTime; }
+
+	// Forgets every shed level, the caller is responsible for re-enabling them
+	void Reset();
+
+private:
+	Action Decide(float frameTime);
+
+	Settings m_Settings;
+	std::size_t m_LevelCount = 0;
+
+	std::vector<float> m_Window;
+	std::vector<float> m_Costs; // Measured saving per shed level
+	float m_BeforeShed = -1.0f; // p95 before the last shed, < 0 when not measuring
+	float m_LastFrameTime = 0.0f;
+};
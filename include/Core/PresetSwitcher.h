@@ -0,0 +1,67 @@
+#pragma once
+
+#include "EffectRuntime.h"
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Switches the whole ReShade preset to the one the rules ask for. Loading a preset recompiles
+// whatever effects it turns on, so a switch waits for a loading screen to hide behind, or for
+// PresetSwitchTimeout. Outside of loading screens switches are at least PresetSwitchInterval apart.
+// Requests and loading screens can come from any thread, the switch itself happens in Update on
+// the render thread. Latency is the time from the switch until the next present.
+class PresetSwitcher
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	// Preset the rules want, empty for none. Asking for the same one again is free.
+	void Request(const std::string& path);
+	// Preset asked for outside of the rules, eg. by a hotkey. The next Update switches to it without
+	// waiting, even with the preset rules off. Rules asking for another one later take over again.
+	void RequestNow(const std::string& path);
+	// A loading screen opened, the next Update switches without waiting
+	void Flush();
+	// Call every present
+	void Update(IEffectRuntime& runtime, Clock::time_point now);
+
+	// Requested preset that isn't active yet, empty if there is none
+	std::string GetPending();
+	std::size_t GetSwitchCount() const { return m_SwitchCount; }
+	// In ms
+	double GetLastLatency() const { return m_LastLatency; }
+	double GetMaxLatency() const { return m_MaxLatency; }
+	double GetAverageLatency() const { return m_SwitchCount > 0 ? m_TotalLatency / m_SwitchCount : 0.0; }
+	// Seconds the last switch waited for a loading screen or the timeout
+	double GetLastWait() const { return m_LastWait; }
+
+	// Same file, whether relative or absolute and in whatever case
+	static bool IsSamePreset(std::string_view a, std::string_view b);
+	// Absolute, lexically normal and lower case, what IsSamePreset compares. Empty stays empty.
+	static std::string Normalize(std::string_view path);
+
+private:
+	// Caller holds m_Mutex
+	bool IsPending() const;
+	void Switch(IEffectRuntime& runtime, Clock::time_point now);
+
+	std::mutex m_Mutex;
+	std::string m_Target;
+	std::string m_NormalTarget; // Normalized once per request, Update compares every present
+	Clock::time_point m_Requested;
+	std::string m_NormalActive; // Last preset switched to or found active
+	bool m_Flush = false;
+	bool m_Manual = false; // m_Target came from RequestNow
+	std::optional<Clock::time_point> m_LastSwitch;
+	std::optional<Clock::time_point> m_Measuring; // Set until the present after a switch
+
+	std::size_t m_SwitchCount = 0;
+	double m_LastLatency = 0.0;
+	double m_MaxLatency = 0.0;
+	double m_TotalLatency = 0.0;
+	double m_LastWait = 0.0;
+};
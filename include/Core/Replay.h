@@ -0,0 +1,109 @@
+#pragma once
+
+#include "EffectRuntime.h"
+#include "GameState.h"
+#include "Timeline.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Effect runtime that only logs what it was asked to do.
+// Every effect is treated as loaded with a single technique, so any preset replays without the shaders.
+class ReplayEffectRuntime : public IEffectRuntime
+{
+public:
+	struct Call
+	{
+		std::uint32_t time = 0; // Timeline time of the event that caused the call
+		std::string effect;     // Empty for SetEffectsState
+		bool enabled = false;
+
+		bool operator==(const Call&) const = default;
+	};
+
+	void SetEffectsState(bool enabled) override;
+	void EnumerateTechniques(const char* effectName, const TechniqueCallback& callback) override;
+	void SetTechniqueState(EffectTechnique technique, bool enabled) override;
+	bool GetTechniqueState(EffectTechnique technique) const override { return m_States[technique.handle]; }
+	// The single technique is named after its effect and has no annotations
+	std::string GetTechniqueName(EffectTechnique technique) const override { return m_Effects[technique.handle]; }
+	std::optional<std::string> GetTechniqueAnnotation(EffectTechnique, const char*) const override { return std::nullopt; }
+	// Definitions aren't part of the timeline, only remembered so the batch sees them as applied
+	void SetPreprocessorDefinition(const char* effectName, const char* name, const char* value) override;
+	std::optional<std::string> GetPreprocessorDefinition(const char* effectName, const char* name) const override;
+	// Every uniform exists, writes are only counted
+	EffectUniform FindUniformVariable(const char* effectName, const char* variableName) const override;
+	void SetUniformValueFloat(EffectUniform, const float*, std::size_t) override { m_UniformWrites++; }
+	void SetUniformValueInt(EffectUniform, const std::int32_t*, std::size_t) override { m_UniformWrites++; }
+	void SetUniformValueBool(EffectUniform, const bool*, std::size_t) override { m_UniformWrites++; }
+	// Only uniforms that were looked up by name exist, none of them annotated
+	void EnumerateUniformVariables(const char* effectName, const UniformCallback& callback) override;
+	std::optional<std::string> GetUniformAnnotation(EffectUniform, const char*) const override { return std::nullopt; }
+	// Preset switches are remembered and counted, the effects stay as they are
+	std::string GetCurrentPresetPath() const override { return m_PresetPath; }
+	void SetCurrentPresetPath(const char* path) override { m_PresetPath = path; m_PresetSwitches++; }
+	bool IsKeyDown(std::uint32_t) const override { return false; }
+	bool IsKeyPressed(std::uint32_t) const override { return false; }
+
+	void SetTime(std::uint32_t time) { m_Time = time; }
+	// Turn off to replay for throughput without building the log
+	void SetLogging(bool enabled) { m_Logging = enabled; }
+
+	const std::vector<Call>& GetCalls() const { return m_Calls; }
+	std::size_t GetCallCount() const { return m_CallCount; }
+	std::size_t GetUniformWriteCount() const { return m_UniformWrites; }
+	std::size_t GetPresetSwitchCount() const { return m_PresetSwitches; }
+
+private:
+	std::unordered_map<std::string, std::uint64_t> m_Handles;
+	std::vector<std::string> m_Effects;
+	std::vector<bool> m_States; // Per handle, effects start enabled
+	std::unordered_map<std::string, std::string> m_Definitions; // By "effect:name"
+	mutable std::unordered_map<std::string, std::uint64_t> m_Uniforms; // By "effect:name", handles start at 1
+	std::size_t m_UniformWrites = 0;
+	std::string m_PresetPath;
+	std::size_t m_PresetSwitches = 0;
+	std::vector<Call> m_Calls;
+	std::size_t m_CallCount = 0;
+	std::uint32_t m_Time = 0;
+	bool m_Logging = true;
+};
+
+// Feeds a recorded timeline through a RuleEngine, acting as its game state.
+// The engine drives the runtime directly, without the definition batch, deferral, fade and frame stats
+// decorators Processor puts in between. Those stamp their work with the wall clock and finish it on
+// presents, and a timeline has neither. So the log is what the rules asked for and when: deferred
+// enables and fades show up as immediate switches, and definitions are set right away.
+class TimelineReplayer : public IGameStateProvider
+{
+public:
+	float GetHour() const override { return m_Hour; }
+	// Not recorded, predictions made during replay assume the default
+	float GetTimeScale() const override { return 20.0f; }
+	// Not recorded, calendar rules replay on the first day
+	GameDate GetDate() const override { return GameDate{}; }
+	CellType GetCellType() const override { return m_CellType; }
+	// Not recorded, player rules replay as idle
+	std::uint32_t GetPlayerState() const override { return 0; }
+	CameraState GetCameraState() const override { return CameraState::kThirdPerson; }
+	std::optional<float> GetCellLightLevel() const override { return std::nullopt; }
+	// Not recorded, location rules never hold during replay
+	LocationSnapshot GetLocation() const override { return LocationSnapshot{}; }
+	std::uint32_t LookupFormID(std::string_view) const override { return 0; }
+	// Not recorded, scene rules replay an empty scene
+	SceneSample GetSceneSample() const override { return SceneSample{}; }
+	std::optional<std::uint32_t> GetWeatherFlags() const override { return m_WeatherFlags; }
+	// Not recorded either, weather changes replay as instant and menus as not pausing
+	float GetWeatherTransition() const override { return 1.0f; }
+	bool IsMenuOpen() const override { return false; }
+
+	// Replays every event in order against the current preset, returns the number of events replayed.
+	// Loading screens in the timeline don't flush anything, nothing is held back to flush.
+	std::size_t Replay(const Timeline& timeline, ReplayEffectRuntime& runtime);
+
+private:
+	float m_Hour = 0.0f;
+	CellType m_CellType = CellType::kNone;
+	std::optional<std::uint32_t> m_WeatherFlags;
+};
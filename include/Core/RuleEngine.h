@@ -0,0 +1,201 @@
+#pragma once
+
+#include "CalendarRules.h"
+#include "ConditionExpressions.h"
+#include "Config.h"
+#include "EffectGroups.h"
+#include "EffectRuntime.h"
+#include "GameState.h"
+#include "LocationRules.h"
+#include "PerformanceGovernor.h"
+#include "PresetSwitcher.h"
+#include "SceneRules.h"
+#include "StateRules.h"
+#include "TimeIntervals.h"
+#include "Timeline.h"
+#include "UniformWriter.h"
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Evaluates the loaded preset against the game state and pushes the result to ReShade.
+// Owns no game or ReShade objects, both are passed in so the whole pipeline runs off-game.
+class RuleEngine
+{
+public:
+	// A performance rule target the governor turned off
+	struct ShedEffect
+	{
+		std::string filename;
+		std::vector<std::uint32_t> techniques; // Positions in the target's enumeration that were on when it was shed
+	};
+
+	explicit RuleEngine(const IGameStateProvider& gameState, IEffectRuntime* runtime = nullptr) :
+		m_GameState(gameState), m_Runtime(runtime)
+	{}
+
+	// Runtime only exists once ReShade initialized its effect runtime
+	void SetRuntime(IEffectRuntime* runtime)
+	{
+		m_Runtime = runtime;
+		InvalidateRules();
+	}
+	IEffectRuntime* GetRuntime() const { return m_Runtime; }
+	// A suspended engine keeps evaluating but applies nothing, resuming applies every rule again. Any thread.
+	void SetSuspended(bool suspended)
+	{
+		m_Suspended = suspended;
+		InvalidateRules();
+	}
+	bool IsSuspended() const { return m_Suspended; }
+
+	// Every condition input the engine reads is also handed to the recorder
+	void SetRecorder(TimelineRecorder* recorder) { m_Recorder = recorder; }
+	// Uniform rules go through the writer, which the owner flushes every frame
+	void SetUniformWriter(UniformWriter* uniforms) { m_Uniforms = uniforms; }
+	// ReShade preset rules only request a preset, the switcher decides when to switch
+	void SetPresetSwitcher(PresetSwitcher* presets) { m_Presets = presets; }
+	// Resolves rules that target a group, which the owner builds after every reload
+	void SetGroups(EffectGroups* groups) { m_Groups = groups; }
+
+	// Specific rules are only applied when their condition flips. After the techniques were reset,
+	// eg. by an effect reload, this applies every rule again on its next pass. Any thread.
+	void InvalidateRules() { m_RuleGeneration++; }
+
+	void ProcessMenuEvent(std::string_view menuName, bool opening);
+	void ProcessTimeBasedToggling();
+	void ProcessInteriorBasedToggling();
+	void ProcessWeatherBasedToggling();
+	// Run on cell and location change events, names are resolved to FormIDs only when the rules changed
+	void ProcessLocationBasedToggling();
+	// Call every frame, reads the player state and only evaluates the rules when it changed
+	void ProcessPlayerBasedToggling();
+	// Same for the camera state, so a burst of camera switches costs at most one evaluation per frame
+	void ProcessCameraBasedToggling();
+	// Reads the light level of the current interior, run on cell change events
+	void SampleCellLight();
+	// Call every frame, buckets the last sampled level into a band and only evaluates the rules when it changed
+	void ProcessLightBasedToggling();
+	// Last sampled level, empty in exteriors
+	std::optional<float> GetCellLightLevel() const;
+	// Fed with a scene sample taken on the main thread and how long taking it took in ms
+	void ProcessSceneBasedToggling(const SceneSample& sample, double sampleCost);
+	// Fed every present with the last frame time in ms
+	void ProcessPerformanceBasedToggling(float frameTime);
+	// Turns back on what the governor shed and starts it over, for when the performance rules are switched off or
+	// another preset loads. Without restore the shed effects are only forgotten, after a reload their positions are stale.
+	void ResetGovernor(bool restore = true);
+	// Evaluate the definition, uniform, ReShade preset and expression rules against what the other passes saw last. Run after each of them.
+	void ProcessDefinitions();
+	void ProcessUniforms();
+	void ProcessReshadePresets();
+	// Expression rules, only the ones reading an input that changed are evaluated again
+	void ProcessExpressions();
+	// Calendar rules, run from the time pass and only evaluated again once the date can have changed
+	void ProcessCalendar();
+
+	bool IsMenuOpen() const { return m_IsMenuOpen; }
+	const PerformanceGovernor& GetGovernor() const { return m_Governor; }
+	// Effects and groups the governor currently has turned off, in the order they were shed
+	const std::vector<ShedEffect>& GetShedEffects() const { return m_ShedEffects; }
+	// Copy of the sampling numbers, any thread
+	SceneStats GetSceneStats() const;
+
+	static bool IsTimeWithinRange(double currentTime, double startTime, double endTime);
+
+private:
+	// Specific rules of one category compiled to expressions, one per rule in list order
+	struct CompiledRules
+	{
+		ConditionExpressions expressions;
+		std::uint32_t revision = ~0u;   // ruleRevision compiled from
+		std::uint32_t generation = ~0u; // m_RuleGeneration compiled from
+	};
+
+	// Rules whose condition flipped since the last call, everything after a compile. Caller holds the category's lock.
+	// Kind is the Categories of TechniqueInfo rules or the StateRuleKind of StateRuleInfo ones.
+	template <class Info, class Kind>
+	const std::vector<ConditionExpressions::Index>& UpdateRules(IEffectRuntime* runtime, CompiledRules& rules, const std::vector<Info>& list, const Kind& kind, const ConditionSnapshot& snapshot);
+	// Condition of a rule as an expression
+	static std::string GetRuleExpression(const TechniqueInfo& info, Categories category);
+	static std::string GetRuleExpression(const StateRuleInfo& info, const StateRuleKind& kind);
+
+	// Player, camera and light rules, evaluated only when the state, the rules or the effects changed since the last
+	// call. Returns whether they were. Caller holds the category's lock.
+	bool ProcessStateRules(CompiledRules& rules, std::uint32_t& last, std::uint32_t state, const StateRuleKind& kind);
+
+	// Runtime for one pass, nullptr while suspended. Passes load it once, so a suspend coming in
+	// from another thread can't pull it out from under them.
+	IEffectRuntime* GetActiveRuntime() const { return m_Suspended ? nullptr : m_Runtime; }
+
+	// Turns on the techniques the governor turned off, returns how many. Caller holds timeMutexPerformance.
+	std::size_t RestoreShedEffect(IEffectRuntime& runtime, const ShedEffect& shed) const;
+
+	void ProcessValueRules();
+	// For DefinitionInfo, UniformInfo and ReshadePresetInfo, caller holds m_ConditionMutex
+	template <class T>
+	bool IsConditionActive(const T& info, float hour) const;
+
+	const IGameStateProvider& m_GameState;
+	IEffectRuntime* m_Runtime = nullptr;
+	std::atomic<bool> m_Suspended = false;
+	TimelineRecorder* m_Recorder = nullptr;
+	UniformWriter* m_Uniforms = nullptr;
+	PresetSwitcher* m_Presets = nullptr;
+	EffectGroups* m_Groups = nullptr;
+
+	std::unordered_set<std::string> m_OpenMenus;
+	bool m_IsMenuOpen = false;
+
+	PerformanceGovernor m_Governor;
+	std::vector<ShedEffect> m_ShedEffects;
+
+	// Copies for the definition and uniform rules, the passes run on different threads
+	std::mutex m_ConditionMutex;
+	std::unordered_set<std::string> m_ConditionMenus;
+	std::string m_ConditionWeather;
+	std::uint32_t m_ConditionPlayer = 0;
+	std::uint32_t m_ConditionCamera = static_cast<std::uint32_t>(CameraState::kThirdPerson);
+	std::uint32_t m_ConditionLight = static_cast<std::uint32_t>(LightBand::kNone);
+
+	// Each guarded by its category's lock, menus only run on the UI thread
+	CompiledRules m_MenuRules;
+	TimeIntervals m_TimeIntervals;
+	std::uint32_t m_TimeRevision = ~0u;   // Same as CompiledRules
+	std::uint32_t m_TimeGeneration = ~0u;
+	CompiledRules m_InteriorRules;
+	CompiledRules m_WeatherRules;
+	CompiledRules m_PlayerRules;
+	std::uint32_t m_PlayerState = 0; // Last one evaluated
+	CompiledRules m_CameraRules;
+	std::uint32_t m_CameraState = static_cast<std::uint32_t>(CameraState::kThirdPerson);
+	CompiledRules m_LightRules;
+	std::uint32_t m_LightBand = static_cast<std::uint32_t>(LightBand::kNone);
+	std::optional<float> m_CellLightLevel; // From the last cell change
+	std::atomic<std::uint32_t> m_RuleGeneration = 0;
+
+	// Compiled expressionInfoList, guarded by timeMutexExpressions
+	ConditionExpressions m_Expressions;
+	std::vector<std::size_t> m_ExpressionSources; // Index into expressionInfoList per compiled expression
+	std::uint32_t m_ExpressionRevision = ~0u;
+
+	// Compiled calendarInfoList, guarded by timeMutexCalendar
+	CalendarRules m_CalendarRules;
+	std::uint32_t m_CalendarRevision = ~0u;   // Same as CompiledRules
+	std::uint32_t m_CalendarGeneration = ~0u;
+
+	// Compiled locationInfoList, guarded by timeMutexLocation
+	LocationRules m_LocationRules;
+	std::uint32_t m_LocationRevision = ~0u;   // Same as CompiledRules
+	std::uint32_t m_LocationGeneration = ~0u;
+
+	// Compiled sceneInfoList and the sampling numbers, guarded by timeMutexScene
+	SceneRules m_SceneRules;
+	SceneStats m_SceneStats;
+	std::uint32_t m_SceneRevision = ~0u;   // Same as CompiledRules
+	std::uint32_t m_SceneGeneration = ~0u;
+};
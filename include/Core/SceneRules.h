@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Config.h"
+#include "GameState.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+// Sampling numbers for the menu, costs in milliseconds spent reading the scene
+struct SceneStats
+{
+	SceneSample sample; // Last one taken
+	std::size_t samples = 0;
+	double lastCost = 0.0;
+	double maxCost = 0.0;
+	double averageCost = 0.0;
+};
+
+// Scene complexity rules with hysteresis. A rule starts holding once its metric reaches the
+// threshold and only stops once it dropped the hysteresis below it again, so a crowd hovering
+// around the threshold doesn't flip the effect on every sample.
+class SceneRules
+{
+public:
+	enum class Metric : std::uint8_t
+	{
+		kActors,
+		kReferences
+	};
+
+	void Compile(const std::vector<SceneInfo>& rules);
+	// Rules that started or stopped holding, every rule after Compile or Invalidate
+	const std::vector<std::size_t>& Update(const SceneSample& sample);
+	// Reports every rule again on the next Update
+	void Invalidate() { m_Valid = false; }
+
+	bool IsActive(std::size_t rule) const { return m_Active[rule] != 0; }
+	std::size_t GetRuleCount() const { return m_Rules.size(); }
+
+	static std::optional<Metric> ParseMetric(std::string_view metric);
+
+private:
+	struct Rule
+	{
+		Metric metric = Metric::kActors; // Rules with an unknown metric never hold
+		bool valid = false;
+		double on = 0.0;  // Holds from here up
+		double off = 0.0; // Until down to here
+	};
+
+	std::vector<Rule> m_Rules;
+	std::vector<std::uint8_t> m_Active;
+	std::vector<std::size_t> m_Changed;
+	bool m_Valid = false;
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Named task queue drained on the game thread.
+// Submitting a name that is already queued replaces it, so a slow frame never runs the same update twice.
+class Scheduler
+{
+public:
+	using Task = void (*)();
+
+	void Submit(const std::string& name, Task task);
+	bool IsQueued(const std::string& name);
+	void Execute();
+
+private:
+	std::unordered_map<std::string, Task> m_Queue;
+	std::mutex m_QueueMutex;
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Config.h"
+#include "GameState.h"
+
+#include <span>
+#include <vector>
+
+// Player, camera and light rules only differ in their names and the state they read, so one kind per
+// category drives loading, saving, compiling and the menu. A rule compiles to term(condition), the
+// same function expressions use, eg. player(Combat).
+struct StateRuleKind
+{
+	const char* name;                    // Preset section and key prefix, eg. "Player" for PlayerFile1
+	const char* conditionKey;            // Condition key without the index, eg. "PlayerCondition"
+	const char* term;                    // Expression function, eg. "player"
+	std::span<const char* const> states; // Conditions a rule can pick
+	StateRuleInfo newRule;               // What "Add New" starts from
+	std::vector<StateRuleInfo>& rules;
+	bool& enabled;
+};
+
+inline const StateRuleKind kPlayerRules{ "Player", "PlayerCondition", "player", kPlayerStateNames, { "Default.fx", "off", "Combat" }, playerInfoList, EnablePlayer };
+inline const StateRuleKind kCameraRules{ "Camera", "CameraCondition", "camera", kCameraStateNames, { "Default.fx", "off", "FirstPerson" }, cameraInfoList, EnableCamera };
+inline const StateRuleKind kLightRules{ "Light", "LightBand", "light", kLightBandNames, { "Default.fx", "on", "Dark" }, lightInfoList, EnableLight };
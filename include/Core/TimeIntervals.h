@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Config.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Index over the Specific time rules. Build normalizes every range into [0, 24), a range whose start
+// is after its stop runs over midnight. Rules with the same effect and state form one target, and
+// their overlapping ranges are merged. All range ends go into one sorted boundary array, each with
+// the targets that switch there. Finding the hour is a binary search, the next change is the
+// neighbouring boundary, and Update only walks the boundaries passed since the last call.
+class TimeIntervals
+{
+public:
+	using Target = std::size_t;
+
+	void Build(const std::vector<TechniqueInfo>& rules);
+	// Targets whose ranges were entered or left since the last call, in rule order. Everything after a Build or Invalidate.
+	const std::vector<Target>& Update(float hour);
+	// Reports every target again on the next Update
+	void Invalidate() { m_Valid = false; }
+
+	// Whether one of the target's ranges held at the last Update
+	bool IsActive(Target target) const { return m_Active[target] != 0; }
+	// Rules sharing the target, in list order
+	const std::vector<std::size_t>& GetRules(Target target) const { return m_TargetRules[target]; }
+
+	// Index of the boundary the hour's segment starts at. Before the first boundary is the segment from the last one over midnight.
+	std::size_t FindSegment(float hour) const;
+	// Next hour any target switches at, empty if none ever does
+	std::optional<double> GetNextBoundary(float hour) const;
+
+	std::size_t GetRuleCount() const { return m_RuleCount; }
+	std::size_t GetTargetCount() const { return m_TargetRules.size(); }
+	std::size_t GetIntervalCount() const { return m_Intervals.size(); }
+	std::size_t GetBoundaryCount() const { return m_Boundaries.size(); }
+
+private:
+	// [start, stop), wraps over midnight when start > stop
+	struct Interval
+	{
+		double start = 0.0;
+		double stop = 0.0;
+	};
+
+	struct Event
+	{
+		std::uint32_t target = 0;
+		bool active = false;
+	};
+
+	bool Contains(Target target, double hour) const;
+
+	std::size_t m_RuleCount = 0;
+	std::vector<std::vector<std::size_t>> m_TargetRules;
+	std::vector<Interval> m_Intervals;        // Merged, grouped by target
+	std::vector<std::uint32_t> m_TargetFirst; // Per target its first interval, one past the end for the last
+
+	std::vector<double> m_Boundaries;        // Sorted, unique, within [0, 24)
+	std::vector<std::uint32_t> m_EventFirst; // Per boundary its first event, one past the end for the last
+	std::vector<Event> m_Events;
+
+	std::vector<std::uint8_t> m_Active; // By target
+	std::size_t m_Segment = 0;
+	bool m_Valid = false;
+
+	std::vector<std::uint8_t> m_Touched; // By target, switched during this Update
+	std::vector<Target> m_TouchedList;
+	std::vector<Target> m_Changed;
+};
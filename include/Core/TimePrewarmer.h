@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Config.h"
+#include "EffectGroups.h"
+#include "EffectRuntime.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// Counts prediction errors (actual minus predicted activation, real seconds) into fixed bins
+class PredictionHistogram
+{
+public:
+	// Upper bin edges, everything above the last one lands in the overflow bin
+	static constexpr std::array<double, 8> kEdges = { -60.0, -30.0, -10.0, -3.0, 3.0, 10.0, 30.0, 60.0 };
+
+	void Add(double error);
+	void AddMissed() { m_Missed++; }
+
+	std::size_t GetCount() const { return m_Count; }
+	std::size_t GetMissed() const { return m_Missed; }
+	const std::array<std::size_t, kEdges.size() + 1>& GetBins() const { return m_Bins; }
+
+	// One line, eg. "<-60s:0 -60..-30s:1 ... >60s:0 missed:2"
+	std::string Format() const;
+
+private:
+	std::array<std::size_t, kEdges.size() + 1> m_Bins{};
+	std::size_t m_Count = 0;
+	std::size_t m_Missed = 0;
+};
+
+// Looks ahead on the Specific time rules and warms up effects that are about to be turned on.
+// Warming means enabling the effect for a few frames while a loading screen hides it, so ReShade
+// compiles it there and not when the rule fires. Every prediction is checked against the actual
+// activation and the error goes into a histogram.
+class TimePrewarmer
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	struct Activation
+	{
+		std::string effect;
+		double seconds = 0.0; // Real seconds until the rule turns it on
+	};
+
+	// Effects the time rules will turn on within lookahead real seconds, soonest first
+	static std::vector<Activation> PredictActivations(float hour, float timeScale, double lookahead);
+	// Whether the time rule leaves its effect on at the given hour
+	static bool IsEffectOn(const TechniqueInfo& info, float hour);
+
+	// Call after every time rule pass. Matches activations to predictions and makes new ones.
+	void Observe(float hour, float timeScale, Clock::time_point now);
+	// Loading screen opened: enables what is coming up and hasn't been warmed yet. Rules targeting a group need the groups.
+	void Prewarm(IEffectRuntime& runtime, float hour, float timeScale, EffectGroups* groups = nullptr);
+	// Call every present, puts warmed effects back to what the rules want after warmFrames
+	void OnPresent(IEffectRuntime& runtime, float hour);
+	// The runtime reloaded its effects, everything needs warming again
+	void Reset();
+
+	void SetWarmFrames(int warmFrames) { m_WarmFrames = warmFrames; }
+	PredictionHistogram GetHistogram();
+	std::size_t GetWarmingCount();
+
+private:
+	struct Prediction
+	{
+		std::optional<Clock::time_point> activation; // Set once the activation entered the lookahead window
+		bool wasOn = false;
+	};
+
+	struct Warming
+	{
+		std::string effect;
+		std::vector<EffectTechnique> techniques; // Only the ones we switched on
+		int framesLeft = 0;
+	};
+
+	std::mutex m_Mutex;
+	int m_WarmFrames = 3;
+
+	std::vector<Prediction> m_Predictions; // Parallel to techniqueTimeInfoList
+	std::vector<Warming> m_Warming;
+	std::unordered_set<std::string> m_Warmed;
+	PredictionHistogram m_Histogram;
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "GameState.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class TimelineEventType : std::uint8_t
+{
+	kMenuOpen,
+	kMenuClose,
+	kHour,
+	kCell,
+	kWeather
+};
+
+// One condition input as the RuleEngine read it
+struct TimelineEvent
+{
+	std::uint32_t time = 0; // Milliseconds since the recording started
+	TimelineEventType type = TimelineEventType::kHour;
+
+	std::uint32_t menu = 0; // Index into Timeline::menuNames
+	float hour = 0.0f;
+	CellType cellType = CellType::kNone;
+	std::optional<std::uint32_t> weatherFlags;
+
+	bool operator==(const TimelineEvent&) const = default;
+};
+
+// Recorded sequence of condition inputs, replayable off-game.
+//
+// Binary layout (little endian):
+//   "RETL", u16 version
+//   per event: varint time delta, u8 type, payload
+//     menu:    varint menu index, a new index is followed by varint length + name bytes
+//     hour:    f32
+//     cell:    u8
+//     weather: u8 has weather, varint flags if it has
+struct Timeline
+{
+	static constexpr std::uint16_t kVersion = 1;
+
+	std::vector<std::string> menuNames;
+	std::vector<TimelineEvent> events;
+
+	std::vector<std::uint8_t> Serialize() const;
+	// Returns false and leaves the timeline empty on malformed data
+	bool Deserialize(const std::vector<std::uint8_t>& data);
+
+	bool Save(const std::string& path) const;
+	bool Load(const std::string& path);
+
+	// Index of the menu name, added to the table if it's new.
+	// Serialize expects menus to be first used in table order, which this guarantees when called per event.
+	std::uint32_t InternMenu(std::string_view menuName);
+};
+
+// Collects condition inputs while running. Thread safe, menu events arrive on the game thread
+// while the polled categories run on the update thread.
+class TimelineRecorder
+{
+public:
+	void Start();
+	void Stop();
+	bool IsRecording() const { return m_Recording; }
+
+	void RecordMenu(std::string_view menuName, bool opening);
+	void RecordHour(float hour);
+	void RecordCell(CellType cellType);
+	void RecordWeather(std::optional<std::uint32_t> weatherFlags);
+
+	// Copy of everything recorded since the last Start()
+	Timeline GetTimeline();
+	std::size_t GetEventCount();
+
+private:
+	void Push(TimelineEvent& event);
+
+	Timeline m_Timeline;
+	std::chrono::steady_clock::time_point m_Start;
+	std::mutex m_Mutex;
+	std::atomic<bool> m_Recording = false;
+};
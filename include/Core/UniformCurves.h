@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Config.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Evaluates many time-of-day curves at once. Compile packs every curve's keys into straight segments,
+// each with its value and slope. One row holds the segment each curve is in right now, so Evaluate is
+// a range check and one multiply-add per curve, done four at a time with SSE. A curve only seeks its
+// next segment when the hour passes one of its keys, which is rare as the hour moves slowly.
+// Memory is the total key count plus one row.
+class UniformCurves
+{
+public:
+	// Lays the curves out for Evaluate, curves without keys are left out
+	void Compile(const std::vector<CurveInfo>& curves);
+	// Value of every compiled curve at the given hour, in compile order. Doesn't allocate.
+	const float* Evaluate(float hour);
+
+	std::size_t GetCurveCount() const { return m_Sources.size(); }
+	// Index into the list passed to Compile for each compiled curve
+	const std::vector<std::size_t>& GetSources() const { return m_Sources; }
+
+	// Reference evaluation of a single curve, also used to build the grid
+	static double EvaluateKeys(const std::vector<CurveKey>& keys, double hour);
+	// "hour:value" pairs separated by commas, eg. "6:0.2,12:1,20:0.3". Sorted, out of range hours dropped.
+	static std::vector<CurveKey> ParseKeys(std::string_view text);
+	static std::string FormatKeys(const std::vector<CurveKey>& keys);
+
+private:
+	struct Segment
+	{
+		float start = 0.0f; // Key hour
+		float end = 0.0f;   // Next key hour, past 24 for the last segment of a curve
+		float value = 0.0f; // At start
+		float slope = 0.0f; // Per hour
+	};
+
+	// Whether the curve's segment in the row holds the hour
+	bool Contains(std::size_t curve, float hour) const;
+	// Moves the curve to the segment holding the hour and puts it in the row
+	void Seek(std::size_t curve, float hour);
+	float ValueAt(std::size_t curve, float hour) const;
+
+	std::vector<Segment> m_Segments;      // One per key, curve after curve
+	std::vector<std::uint32_t> m_First;   // Per curve its first segment, plus one past the last curve
+	std::vector<std::uint32_t> m_Cursors; // Per curve the segment in the row
+	// The row, padded with segments that hold every hour
+	std::vector<float> m_Starts;
+	std::vector<float> m_Ends;
+	std::vector<float> m_Values;
+	std::vector<float> m_Slopes;
+	std::vector<float> m_Output;
+	std::vector<std::size_t> m_Sources;
+	std::size_t m_Stride = 0; // Curve count rounded up to a multiple of 4
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "EffectRuntime.h"
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+// Collects uniform values from any thread and writes them once per frame on the render thread.
+// Variable handles are looked up on first use and cached until the effects reload. Only the
+// last value set during a frame is written, and not at all if it matches what was written before.
+class UniformWriter
+{
+public:
+	using Value = std::variant<float, std::int32_t, bool>;
+	using Slot = std::size_t;
+
+	// Slot for a variable, lets callers that write every frame skip the name lookup
+	Slot GetSlot(const std::string& effect, const std::string& variable);
+
+	// Queue values for the next Flush
+	void Set(const std::string& effect, const std::string& variable, Value value);
+	void Set(Slot slot, Value value);
+	// Many floats under one lock, slots and values are parallel
+	void SetFloats(const Slot* slots, const float* values, std::size_t count);
+	// Call every present, returns the number of variables written
+	std::size_t Flush(IEffectRuntime& runtime);
+	// The effects reloaded, handles are gone and ReShade reset the values, so everything gets written again
+	void Reset();
+
+	std::size_t GetWriteCount() const { return m_WriteCount; }
+	std::size_t GetSkippedCount() const { return m_SkippedCount; }
+
+private:
+	struct Entry
+	{
+		std::string effect;
+		std::string variable;
+		std::optional<EffectUniform> handle; // Empty until looked up
+		Value value;
+		std::optional<Value> written;
+		bool dirty = false;
+	};
+
+	// Caller holds m_Mutex
+	Slot FindSlot(const std::string& effect, const std::string& variable);
+	void Queue(Slot slot, Value value);
+
+	std::mutex m_Mutex;
+	std::vector<Entry> m_Entries; // Indexed by slot
+	std::unordered_map<std::string, Slot> m_Slots; // By "effect:variable"
+	std::vector<Slot> m_Dirty;
+	std::size_t m_WriteCount = 0;
+	std::size_t m_SkippedCount = 0;
+};
@@ -0,0 +1,22 @@
+#pragma once
+#include "PCH.h"
+#include "Core/GameState.h"
+
+// Reads the game state for the RuleEngine from the RE:: singletons
+class GameStateProvider : public IGameStateProvider
+{
+public:
+	float GetHour() const override;
+	float GetTimeScale() const override;
+	GameDate GetDate() const override;
+	CellType GetCellType() const override;
+	std::uint32_t GetPlayerState() const override;
+	CameraState GetCameraState() const override;
+	std::optional<float> GetCellLightLevel() const override;
+	LocationSnapshot GetLocation() const override;
+	std::uint32_t LookupFormID(std::string_view name) const override;
+	SceneSample GetSceneSample() const override;
+	std::optional<std::uint32_t> GetWeatherFlags() const override;
+	float GetWeatherTransition() const override;
+	bool IsMenuOpen() const override;
+};
@@ -1,5 +1,7 @@
 #pragma once
 
+struct StateRuleKind;
+
 class Menu
 {
 public:
@@ -13,6 +15,9 @@ public:
 
 private:
 	bool CreateCombo(const char* label, std::string& currentItem, std::vector<std::string>& items, ImGuiComboFlags_ flags);
+	bool CreateInput(const char* label, std::string& value, float width = 150.0f, ImGuiInputTextFlags flags = 0);
+	// Effect files plus "@Group" names for the rule combos, rebuilt when the groups change
+	void RefreshEffectTargets();
 
 	void Save(const std::string& filename);
 	void SaveConfig();
@@ -22,6 +27,28 @@ private:
 	void RenderTimePage();
 	void RenderInteriorPage();
 	void RenderWeatherPage();
+	void RenderRecordingControls();
+	void RenderPerformancePage();
+	void RenderGovernorSettings();
+	void RenderProfilerPage();
+	void RenderDeferralPage();
+	void RenderDefinitionsPage();
+	void RenderUniformsPage();
+	void RenderCurvesPage();
+	void RenderFadesPage();
+	void RenderReshadePresetsPage();
+	void RenderGroupsPage();
+	void RenderExpressionsPage();
+	void RenderCalendarPage();
+	void RenderLocationPage();
+	void RenderScenePage();
+	// Rule list of a StateRuleKind, for its page
+	void RenderStateRules(const StateRuleKind& kind);
+	void RenderPlayerPage();
+	void RenderCameraPage();
+	void RenderLightPage();
+	void RenderHotkeysPage();
+	void RenderPrewarmSettings();
 
 private:
 	double minTime = 0.0;
@@ -33,5 +60,10 @@ private:
 	char inputBuffer[256] = { 0 };    // Initialize the input buffer
 
 	bool m_LoadPresetPopupOpen = false;
+
+	int m_StatsWindowFrames = 600; // Frames per percentile window
+
+	std::vector<std::string> m_EffectTargets;
+	std::uint32_t m_EffectTargetsRevision = ~0u;
 };
 
@@ -2,8 +2,25 @@
 #include "PCH.h"
 #include "Globals.h"
 #include "ReShadeToggler.h"
+#include "ReshadeIntegration.h"
+#include "GameStateProvider.h"
+#include "Core/CostProfiler.h"
+#include "Core/DeferredEffectRuntime.h"
+#include "Core/DefinitionBatchRuntime.h"
+#include "Core/EffectGroups.h"
+#include "Core/FadeEffectRuntime.h"
+#include "Core/FrameStats.h"
+#include "Core/GameUniformFeed.h"
+#include "Core/Hotkeys.h"
+#include "Core/PresetSwitcher.h"
+#include "Core/RuleEngine.h"
+#include "Core/TimePrewarmer.h"
+#include "Core/UniformCurves.h"
 
-class Processor : public RE::BSTEventSink<RE::MenuOpenCloseEvent>
+class Processor :
+	public RE::BSTEventSink<RE::MenuOpenCloseEvent>,
+	public RE::BSTEventSink<RE::BGSActorCellEvent>,
+	public RE::BSTEventSink<RE::TESActorLocationChangeEvent>
 {
 public:
 	static Processor& GetSingleton()
@@ -13,21 +30,89 @@ public:
 	}
 
 	RE::BSEventNotifyControl ProcessEvent(const RE::MenuOpenCloseEvent* a_event, RE::BSTEventSource<RE::MenuOpenCloseEvent>* a_source) override;
+	// The player entered a cell or location, runs the location rules
+	RE::BSEventNotifyControl ProcessEvent(const RE::BGSActorCellEvent* a_event, RE::BSTEventSource<RE::BGSActorCellEvent>* a_source) override;
+	RE::BSEventNotifyControl ProcessEvent(const RE::TESActorLocationChangeEvent* a_event, RE::BSTEventSource<RE::TESActorLocationChangeEvent>* a_source) override;
 	RE::BSEventNotifyControl ProcessTimeBasedToggling();
 	RE::BSEventNotifyControl ProcessInteriorBasedToggling();
 	RE::BSEventNotifyControl ProcessWeatherBasedToggling();
+	RE::BSEventNotifyControl ProcessSceneBasedToggling();
+	// Called on kDataLoaded, registers the cell and location sinks
+	void OnDataLoaded();
+	// Called from reshade_present, feeds frame stats and the performance governor
+	void OnPresent();
 
-private:
-	bool IsTimeWithinRange(double currentTime, double startTime, double endTime);
+	// Called once ReShade created its effect runtime
+	void AttachRuntime(reshade::api::effect_runtime* runtime);
+	// Called after ReShade reloaded its effects, every handle we kept is stale
+	void OnEffectsReloaded();
+	// Called from reshade_begin_effects, polls the hotkeys
+	void OnBeginEffects();
+
+	// A suspended toggler leaves the effects as they are until it resumes
+	void SetSuspended(bool suspended);
+	bool IsSuspended() const { return m_RuleEngine.IsSuspended(); }
+	// Turns the effects the performance governor shed back on, when it's switched off or another preset loads
+	void ResetGovernor() { m_RuleEngine.ResetGovernor(); }
+
+	TimelineRecorder& GetRecorder() { return m_Recorder; }
+	FrameStats& GetFrameStats() { return m_FrameStats; }
+	const RuleEngine& GetRuleEngine() const { return m_RuleEngine; }
+
+	// Effect cost profiling, runs off the present callback. Start returns false without a runtime.
+	bool StartProfiling(const std::vector<std::string>& effects);
+	void StopProfiling();
+	CostProfiler& GetProfiler() { return m_Profiler; }
 
+	DeferredEffectRuntime& GetDeferredRuntime() { return m_DeferredRuntime; }
+	DefinitionBatchRuntime& GetDefinitionRuntime() { return m_DefinitionRuntime; }
+	FadeEffectRuntime& GetFadeRuntime() { return m_FadeRuntime; }
+	TimePrewarmer& GetPrewarmer() { return m_Prewarmer; }
+	UniformWriter& GetUniformWriter() { return m_Uniforms; }
+	GameUniformFeed& GetGameUniforms() { return m_GameUniforms; }
+	PresetSwitcher& GetPresetSwitcher() { return m_Presets; }
+	EffectGroups& GetGroups() { return m_Groups; }
+	// Menu events are needed for menu rules and for spotting loading screens
+	static bool NeedsMenuEvents() { return EnableMenus || EnableDeferral || EnableTimePrewarm || EnableDefinitions || EnableReshadePresets || EnableExpressions; }
 
-	Processor() = default;
+private:
+	Processor()
+	{
+		m_RuleEngine.SetRecorder(&m_Recorder);
+		m_RuleEngine.SetUniformWriter(&m_Uniforms);
+		m_RuleEngine.SetPresetSwitcher(&m_Presets);
+		m_RuleEngine.SetGroups(&m_Groups);
+	}
 	~Processor() = default;
 	Processor(const Processor&) = delete;
 	Processor(Processor&&) = delete;
 	Processor& operator=(const Processor&) = delete;
 	Processor& operator=(Processor&&) = delete;
 
-	std::unordered_set<std::string> m_OpenMenus;
-	bool m_IsMenuOpen = false;
-};
\ No newline at end of file
+	// Compiles the curves again if they changed and queues this frame's values
+	void UpdateCurves();
+	// Resolves the groups again after a reload or when they changed
+	void UpdateGroups();
+
+	GameStateProvider m_GameState;
+	ReshadeEffectRuntime m_Runtime;
+	TimelineRecorder m_Recorder;
+	FrameStats m_FrameStats;
+	FrameStatsEffectRuntime m_StatsRuntime{ m_Runtime, m_FrameStats };
+	FadeEffectRuntime m_FadeRuntime{ m_StatsRuntime };
+	DeferredEffectRuntime m_DeferredRuntime{ m_FadeRuntime };
+	DefinitionBatchRuntime m_DefinitionRuntime{ m_DeferredRuntime };
+	CostProfiler m_Profiler;
+	TimePrewarmer m_Prewarmer;
+	UniformWriter m_Uniforms;
+	GameUniformFeed m_GameUniforms;
+	PresetSwitcher m_Presets;
+	UniformCurves m_Curves;
+	std::vector<UniformWriter::Slot> m_CurveSlots; // Parallel to the compiled curves
+	std::uint32_t m_CurveRevision = ~0u;
+	EffectGroups m_Groups;
+	std::uint32_t m_GroupRevision = ~0u;
+	Hotkeys m_Hotkeys;
+	std::uint32_t m_HotkeyRevision = ~0u;
+	RuleEngine m_RuleEngine{ m_GameState };
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include "Globals.h"
+#include "Core/EffectRuntime.h"
 
 class EffectRuntime : public reshade::api::effect_runtime
 {
@@ -21,13 +22,162 @@ public:
 };
 
 
+// Forwards the core's IEffectRuntime to the live ReShade runtime
+class ReshadeEffectRuntime : public IEffectRuntime
+{
+public:
+	void SetRuntime(reshade::api::effect_runtime* runtime) { m_Runtime = runtime; }
+	bool IsAttached() const { return m_Runtime != nullptr; }
+
+	void SetEffectsState(bool enabled) override
+	{
+		m_Runtime->set_effects_state(enabled);
+	}
+
+	void EnumerateTechniques(const char* effectName, const TechniqueCallback& callback) override
+	{
+		m_Runtime->enumerate_techniques(effectName, [&callback](reshade::api::effect_runtime*, reshade::api::effect_technique technique)
+			{
+				callback(EffectTechnique{ technique.handle });
+			});
+	}
+
+	void SetTechniqueState(EffectTechnique technique, bool enabled) override
+	{
+		m_Runtime->set_technique_state(reshade::api::effect_technique{ technique.handle }, enabled);
+	}
+
+	bool GetTechniqueState(EffectTechnique technique) const override
+	{
+		return m_Runtime->get_technique_state(reshade::api::effect_technique{ technique.handle });
+	}
+
+	std::string GetTechniqueName(EffectTechnique technique) const override
+	{
+		const reshade::api::effect_technique handle{ technique.handle };
+		size_t size = 0;
+		m_Runtime->get_technique_name(handle, nullptr, &size);
+
+		std::string name(size, '\0');
+		m_Runtime->get_technique_name(handle, name.data(), &size);
+		name.resize(size > 0 ? size - 1 : 0);
+		return name;
+	}
+
+	std::optional<std::string> GetTechniqueAnnotation(EffectTechnique technique, const char* name) const override
+	{
+		const reshade::api::effect_technique handle{ technique.handle };
+		size_t size = 0;
+		if (!m_Runtime->get_annotation_string_from_technique(handle, name, nullptr, &size))
+		{
+			return std::nullopt;
+		}
+
+		std::string value(size, '\0');
+		m_Runtime->get_annotation_string_from_technique(handle, name, value.data(), &size);
+		value.resize(size > 0 ? size - 1 : 0);
+		return value;
+	}
+
+	void SetPreprocessorDefinition(const char* effectName, const char* name, const char* value) override
+	{
+		m_Runtime->set_preprocessor_definition_for_effect(effectName, name, value);
+	}
+
+	std::optional<std::string> GetPreprocessorDefinition(const char* effectName, const char* name) const override
+	{
+		// Ask for the size first, definitions can be longer than any fixed buffer
+		size_t size = 0;
+		if (!m_Runtime->get_preprocessor_definition_for_effect(effectName, name, nullptr, &size))
+		{
+			return std::nullopt;
+		}
+
+		std::string value(size, '\0');
+		m_Runtime->get_preprocessor_definition_for_effect(effectName, name, value.data(), &size);
+		value.resize(size > 0 ? size - 1 : 0); // Size includes the null terminator
+		return value;
+	}
+
+	EffectUniform FindUniformVariable(const char* effectName, const char* variableName) const override
+	{
+		return EffectUniform{ m_Runtime->find_uniform_variable(effectName, variableName).handle };
+	}
+
+	void SetUniformValueFloat(EffectUniform variable, const float* values, std::size_t count) override
+	{
+		m_Runtime->set_uniform_value_float(reshade::api::effect_uniform_variable{ variable.handle }, values, count);
+	}
+
+	void SetUniformValueInt(EffectUniform variable, const std::int32_t* values, std::size_t count) override
+	{
+		m_Runtime->set_uniform_value_int(reshade::api::effect_uniform_variable{ variable.handle }, values, count);
+	}
+
+	void SetUniformValueBool(EffectUniform variable, const bool* values, std::size_t count) override
+	{
+		m_Runtime->set_uniform_value_bool(reshade::api::effect_uniform_variable{ variable.handle }, values, count);
+	}
+
+	void EnumerateUniformVariables(const char* effectName, const UniformCallback& callback) override
+	{
+		m_Runtime->enumerate_uniform_variables(effectName, [&callback](reshade::api::effect_runtime*, reshade::api::effect_uniform_variable variable)
+			{
+				callback(EffectUniform{ variable.handle });
+			});
+	}
+
+	std::optional<std::string> GetUniformAnnotation(EffectUniform variable, const char* name) const override
+	{
+		// Same two step read as the definitions
+		const reshade::api::effect_uniform_variable uniform{ variable.handle };
+		size_t size = 0;
+		if (!m_Runtime->get_annotation_string_from_uniform_variable(uniform, name, nullptr, &size))
+		{
+			return std::nullopt;
+		}
+
+		std::string value(size, '\0');
+		m_Runtime->get_annotation_string_from_uniform_variable(uniform, name, value.data(), &size);
+		value.resize(size > 0 ? size - 1 : 0);
+		return value;
+	}
+
+	std::string GetCurrentPresetPath() const override
+	{
+		size_t size = 0;
+		m_Runtime->get_current_preset_path(nullptr, &size);
+
+		std::string path(size, '\0');
+		m_Runtime->get_current_preset_path(path.data(), &size);
+		path.resize(size > 0 ? size - 1 : 0);
+		return path;
+	}
+
+	void SetCurrentPresetPath(const char* path) override
+	{
+		m_Runtime->set_current_preset_path(path);
+	}
+
+	bool IsKeyDown(std::uint32_t keycode) const override
+	{
+		return m_Runtime->is_key_down(keycode);
+	}
+
+	bool IsKeyPressed(std::uint32_t keycode) const override
+	{
+		return m_Runtime->is_key_pressed(keycode);
+	}
+
+private:
+	reshade::api::effect_runtime* m_Runtime = nullptr;
+};
+
+
 class ReshadeIntegration
 {
 public:
 
-	static void ApplyTechniqueState(bool enableReshade, const TechniqueInfo& info);
-	static void ApplySpecificReshadeStates(bool enableReshade, Categories ProcessState);
-	static void ApplyReshadeState(bool enableReshade, const std::string& toggleState);
 	static void EnumerateEffects();
 	static void EnumeratePresets();
 	static void EnumerateMenus();
@@ -1,5 +1,6 @@
 #pragma once
 #include "Globals.h"
+#include "Core/Scheduler.h"
 
 class ReshadeToggler
 {
@@ -11,7 +12,7 @@ public:
 		return &toggler;
 	}
 
-	using FunctionToExecute = RE::BSEventNotifyControl(*)();
+	using FunctionToExecute = Scheduler::Task;
 
 	void Setup();
 	void SetupLog();
@@ -23,6 +24,5 @@ public:
 	void Run();
 
 private:
-	std::unordered_map <std::string, FunctionToExecute> m_MainThreadQueue;
-	std::mutex m_MainThreadQueueMutex;
+	Scheduler m_MainThreadQueue;
 };
\ No newline at end of file
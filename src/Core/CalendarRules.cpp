@@ -0,0 +1,204 @@
+#include "Core/CalendarRules.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+	constexpr std::array<std::uint32_t, 12> kMonthDays = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+	// Winter runs Evening Star through Sun's Dawn
+	constexpr std::array<std::pair<const char*, std::uint16_t>, 4> kSeasons = { {
+		{ "Winter", (1 << 11) | (1 << 0) | (1 << 1) },
+		{ "Spring", (1 << 2) | (1 << 3) | (1 << 4) },
+		{ "Summer", (1 << 5) | (1 << 6) | (1 << 7) },
+		{ "Autumn", (1 << 8) | (1 << 9) | (1 << 10) },
+	} };
+
+	std::string_view Trim(std::string_view text)
+	{
+		while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front())))
+		{
+			text.remove_prefix(1);
+		}
+		while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back())))
+		{
+			text.remove_suffix(1);
+		}
+		return text;
+	}
+
+	template <std::size_t N>
+	std::string FormatMask(std::uint32_t mask, const std::array<const char*, N>& names)
+	{
+		std::string text;
+		for (std::size_t i = 0; i < N; i++)
+		{
+			if (mask & (1u << i))
+			{
+				if (!text.empty())
+				{
+					text += ", ";
+				}
+				text += names[i];
+			}
+		}
+		return text;
+	}
+}
+
+void CalendarRules::Compile(const std::vector<CalendarInfo>& rules)
+{
+	m_Rules.clear();
+	m_AnyWeekday = false;
+	m_AnyMonth = false;
+
+	for (const CalendarInfo& info : rules)
+	{
+		Rule rule;
+		rule.months = info.months & kAllMonths;
+		rule.weekdays = info.weekdays & kAllWeekdays;
+		rule.firstDay = info.firstDay;
+		rule.lastDay = info.lastDay;
+		m_Rules.push_back(rule);
+
+		m_AnyWeekday |= rule.weekdays != kAllWeekdays;
+		m_AnyMonth |= rule.months != kAllMonths;
+	}
+
+	m_Active.assign(m_Rules.size(), 0);
+	m_Valid = false;
+}
+
+const std::vector<std::size_t>& CalendarRules::Update(const GameDate& date, float hour)
+{
+	m_Changed.clear();
+
+	// Nothing can change before the boundary, unless a save from earlier was loaded
+	const double daysPassed = date.daysPassed;
+	if (m_Valid && daysPassed < m_NextBoundary && daysPassed >= m_LastDaysPassed)
+	{
+		m_LastDaysPassed = daysPassed;
+		return m_Changed;
+	}
+	m_LastDaysPassed = daysPassed;
+	m_EvaluationCount++;
+
+	const double today = std::floor(daysPassed);
+	m_NextBoundary = std::numeric_limits<double>::infinity();
+
+	for (std::size_t i = 0; i < m_Rules.size(); i++)
+	{
+		const Rule& rule = m_Rules[i];
+		const std::uint8_t active = Matches(rule, date) ? 1 : 0;
+		if (!m_Valid || m_Active[i] != active)
+		{
+			m_Active[i] = active;
+			m_Changed.push_back(i);
+		}
+
+		// Day ranges switch as the days passed count reaches their ends
+		if (rule.firstDay > today)
+		{
+			m_NextBoundary = std::min(m_NextBoundary, static_cast<double>(rule.firstDay));
+		}
+		else if (rule.lastDay >= 0 && rule.lastDay >= today)
+		{
+			m_NextBoundary = std::min(m_NextBoundary, static_cast<double>(rule.lastDay) + 1.0);
+		}
+	}
+
+	// The weekday and month only change at midnight
+	const double midnight = daysPassed + (24.0 - std::clamp(static_cast<double>(hour), 0.0, 24.0)) / 24.0;
+	if (m_AnyWeekday)
+	{
+		m_NextBoundary = std::min(m_NextBoundary, midnight);
+	}
+	else if (m_AnyMonth)
+	{
+		const std::uint32_t monthDays = kMonthDays[std::min<std::uint32_t>(date.month, 11)];
+		const std::uint32_t daysLeft = monthDays > date.day ? monthDays - date.day : 0;
+		m_NextBoundary = std::min(m_NextBoundary, midnight + daysLeft);
+	}
+
+	m_Valid = true;
+	return m_Changed;
+}
+
+bool CalendarRules::Matches(const CalendarInfo& info, const GameDate& date)
+{
+	Rule rule;
+	rule.months = info.months;
+	rule.weekdays = info.weekdays;
+	rule.firstDay = info.firstDay;
+	rule.lastDay = info.lastDay;
+	return Matches(rule, date);
+}
+
+bool CalendarRules::Matches(const Rule& rule, const GameDate& date)
+{
+	const double day = std::floor(date.daysPassed);
+	return (rule.months & (1u << std::min<std::uint32_t>(date.month, 15))) != 0 &&
+		(rule.weekdays & (1u << std::min<std::uint32_t>(date.dayOfWeek, 7))) != 0 &&
+		day >= rule.firstDay &&
+		(rule.lastDay < 0 || day <= rule.lastDay);
+}
+
+std::uint16_t CalendarRules::ParseMonths(std::string_view text)
+{
+	std::uint16_t months = 0;
+	while (!text.empty())
+	{
+		const std::size_t comma = text.find(',');
+		const std::string_view name = Trim(text.substr(0, comma));
+		text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+
+		for (std::size_t i = 0; i < kMonthNames.size(); i++)
+		{
+			if (name == kMonthNames[i])
+			{
+				months |= 1 << i;
+			}
+		}
+		for (const auto& [season, mask] : kSeasons)
+		{
+			if (name == season)
+			{
+				months |= mask;
+			}
+		}
+	}
+	return months;
+}
+
+std::string CalendarRules::FormatMonths(std::uint16_t months)
+{
+	return FormatMask(months, kMonthNames);
+}
+
+std::uint8_t CalendarRules::ParseWeekdays(std::string_view text)
+{
+	std::uint8_t weekdays = 0;
+	while (!text.empty())
+	{
+		const std::size_t comma = text.find(',');
+		const std::string_view name = Trim(text.substr(0, comma));
+		text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+
+		for (std::size_t i = 0; i < kWeekdayNames.size(); i++)
+		{
+			if (name == kWeekdayNames[i])
+			{
+				weekdays |= 1 << i;
+			}
+		}
+	}
+	return weekdays;
+}
+
+std::string CalendarRules::FormatWeekdays(std::uint8_t weekdays)
+{
+	return FormatMask(weekdays, kWeekdayNames);
+}
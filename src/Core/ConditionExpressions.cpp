@@ -0,0 +1,534 @@
+#include "Core/ConditionExpressions.h"
+#include "Core/GameState.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <utility>
+
+// Recursive descent straight to postfix
+class ConditionExpressions::Parser
+{
+public:
+	Parser(ConditionExpressions& owner, std::string_view text) : m_Owner(owner), m_Text(text) {}
+
+	bool Parse(std::vector<Instruction>& code, std::string& error)
+	{
+		m_Code = &code;
+		if (!ParseOr())
+		{
+			error = m_Error;
+			return false;
+		}
+
+		SkipSpace();
+		if (m_Position != m_Text.size())
+		{
+			error = fmt::format("unexpected '{}' at {}", m_Text.substr(m_Position, 1), m_Position);
+			return false;
+		}
+		if (m_MaxDepth > kMaxDepth)
+		{
+			error = "expression too deep";
+			return false;
+		}
+		return true;
+	}
+
+private:
+	bool ParseOr()
+	{
+		if (!ParseAnd())
+		{
+			return false;
+		}
+		while (Accept("||") || AcceptWord("or"))
+		{
+			if (!ParseAnd())
+			{
+				return false;
+			}
+			Emit(OpCode::kOr);
+		}
+		return true;
+	}
+
+	bool ParseAnd()
+	{
+		if (!ParseUnary())
+		{
+			return false;
+		}
+		while (Accept("&&") || AcceptWord("and"))
+		{
+			if (!ParseUnary())
+			{
+				return false;
+			}
+			Emit(OpCode::kAnd);
+		}
+		return true;
+	}
+
+	bool ParseUnary()
+	{
+		if (Accept("!") || AcceptWord("not"))
+		{
+			if (!Nest() || !ParseUnary())
+			{
+				return false;
+			}
+			m_Nesting--;
+			Emit(OpCode::kNot);
+			return true;
+		}
+		return ParsePrimary();
+	}
+
+	// Checked on the way down, a deep enough nesting would overflow the stack before Parse could check m_MaxDepth
+	bool Nest()
+	{
+		return ++m_Nesting <= kMaxDepth || Fail("expression too deep");
+	}
+
+	bool ParsePrimary()
+	{
+		if (Accept("("))
+		{
+			if (!Nest() || !ParseOr())
+			{
+				return false;
+			}
+			m_Nesting--;
+			return Expect(")");
+		}
+
+		SkipSpace();
+		const std::size_t start = m_Position;
+		while (m_Position < m_Text.size() && (std::isalnum(static_cast<unsigned char>(m_Text[m_Position])) || m_Text[m_Position] == '_'))
+		{
+			m_Position++;
+		}
+		const std::string_view word = m_Text.substr(start, m_Position - start);
+
+		if (word == "true" || word == "false")
+		{
+			Emit(word == "true" ? OpCode::kTrue : OpCode::kFalse);
+			return true;
+		}
+		if (word == "interior" || word == "exterior")
+		{
+			EmitInput(MakeInput(InputType::kInterior));
+			if (word == "exterior")
+			{
+				Emit(OpCode::kNot);
+			}
+			return true;
+		}
+		if (word == "menu" || word == "weather")
+		{
+			std::string name;
+			if (!ParseArgument(name))
+			{
+				return false;
+			}
+			EmitInput(MakeInput(word == "menu" ? InputType::kMenu : InputType::kWeather, std::move(name)));
+			return true;
+		}
+		if (word == "hour")
+		{
+			std::string range;
+			if (!ParseArgument(range))
+			{
+				return false;
+			}
+
+			char* end = nullptr;
+			Input input = MakeInput(InputType::kHour);
+			input.start = std::strtod(range.c_str(), &end);
+			if (end == range.c_str() || *end != ',')
+			{
+				return Fail("hour needs (start, stop)");
+			}
+			const char* stopStart = end + 1;
+			input.stop = std::strtod(stopStart, &end);
+			if (end == stopStart || input.start < 0.0 || input.start > 24.0 || input.stop < 0.0 || input.stop > 24.0)
+			{
+				return Fail("hour needs (start, stop) between 0 and 24");
+			}
+			EmitInput(input);
+			return true;
+		}
+		if (word == "player")
+		{
+			Input input = MakeInput(InputType::kPlayer);
+			if (!ParseArgument(input.name))
+			{
+				return false;
+			}
+			for (std::size_t bit = 0; bit < kPlayerStateNames.size(); bit++)
+			{
+				if (input.name == kPlayerStateNames[bit])
+				{
+					input.flag = 1u << bit;
+				}
+			}
+			if (input.flag == 0)
+			{
+				return Fail(fmt::format("unknown player state '{}'", input.name));
+			}
+			EmitInput(input);
+			return true;
+		}
+		if (word == "camera")
+		{
+			Input input = MakeInput(InputType::kCamera);
+			if (!ParseArgument(input.name))
+			{
+				return false;
+			}
+			const auto it = std::find(kCameraStateNames.begin(), kCameraStateNames.end(), std::string_view(input.name));
+			if (it == kCameraStateNames.end())
+			{
+				return Fail(fmt::format("unknown camera state '{}'", input.name));
+			}
+			input.flag = static_cast<std::uint32_t>(it - kCameraStateNames.begin());
+			EmitInput(input);
+			return true;
+		}
+		if (word == "light")
+		{
+			Input input = MakeInput(InputType::kLight);
+			if (!ParseArgument(input.name))
+			{
+				return false;
+			}
+			const auto it = std::find(kLightBandNames.begin(), kLightBandNames.end(), std::string_view(input.name));
+			if (it == kLightBandNames.end())
+			{
+				return Fail(fmt::format("unknown light band '{}'", input.name));
+			}
+			input.flag = static_cast<std::uint32_t>(it - kLightBandNames.begin());
+			EmitInput(input);
+			return true;
+		}
+
+		return Fail(word.empty() ? fmt::format("expected a condition at {}", start) : fmt::format("unknown condition '{}'", word));
+	}
+
+	// Everything up to the closing parenthesis, trimmed and without quotes. Menu names have spaces.
+	bool ParseArgument(std::string& argument)
+	{
+		if (!Expect("("))
+		{
+			return false;
+		}
+
+		const std::size_t close = m_Text.find(')', m_Position);
+		if (close == std::string_view::npos)
+		{
+			return Fail("missing ')'");
+		}
+
+		std::string_view text = m_Text.substr(m_Position, close - m_Position);
+		m_Position = close + 1;
+
+		while (!text.empty() && (std::isspace(static_cast<unsigned char>(text.front())) || text.front() == '"'))
+		{
+			text.remove_prefix(1);
+		}
+		while (!text.empty() && (std::isspace(static_cast<unsigned char>(text.back())) || text.back() == '"'))
+		{
+			text.remove_suffix(1);
+		}
+		if (text.empty())
+		{
+			return Fail("empty argument");
+		}
+
+		argument = text;
+		return true;
+	}
+
+	void Emit(OpCode op, std::uint32_t input = 0)
+	{
+		m_Code->push_back(Instruction{ op, input });
+
+		// Operands push one, binary operators pop one, not leaves the depth alone
+		if (op == OpCode::kAnd || op == OpCode::kOr)
+		{
+			m_Depth--;
+		}
+		else if (op != OpCode::kNot)
+		{
+			m_MaxDepth = std::max(m_MaxDepth, ++m_Depth);
+		}
+	}
+
+	static Input MakeInput(InputType type, std::string name = {})
+	{
+		Input input;
+		input.type = type;
+		input.name = std::move(name);
+		return input;
+	}
+
+	void EmitInput(const Input& input)
+	{
+		Emit(OpCode::kInput, m_Owner.Intern(input));
+	}
+
+	void SkipSpace()
+	{
+		while (m_Position < m_Text.size() && std::isspace(static_cast<unsigned char>(m_Text[m_Position])))
+		{
+			m_Position++;
+		}
+	}
+
+	bool Accept(std::string_view token)
+	{
+		SkipSpace();
+		if (m_Text.substr(m_Position).starts_with(token))
+		{
+			m_Position += token.size();
+			return true;
+		}
+		return false;
+	}
+
+	// Only whole words, so "order" isn't "or" followed by "der"
+	bool AcceptWord(std::string_view word)
+	{
+		SkipSpace();
+		const std::size_t end = m_Position + word.size();
+		if (m_Text.substr(m_Position).starts_with(word) &&
+			(end == m_Text.size() || !(std::isalnum(static_cast<unsigned char>(m_Text[end])) || m_Text[end] == '_')))
+		{
+			m_Position = end;
+			return true;
+		}
+		return false;
+	}
+
+	bool Expect(std::string_view token)
+	{
+		return Accept(token) || Fail(fmt::format("expected '{}' at {}", token, m_Position));
+	}
+
+	bool Fail(std::string error)
+	{
+		if (m_Error.empty())
+		{
+			m_Error = std::move(error);
+		}
+		return false;
+	}
+
+	ConditionExpressions& m_Owner;
+	std::string_view m_Text;
+	std::size_t m_Position = 0;
+	std::vector<Instruction>* m_Code = nullptr;
+	std::size_t m_Depth = 0;
+	std::size_t m_MaxDepth = 0;
+	std::size_t m_Nesting = 0; // Parentheses and nots the parser is inside of
+	std::string m_Error;
+};
+
+std::optional<ConditionExpressions::Index> ConditionExpressions::Add(std::string_view text, std::string* error)
+{
+	// Inputs interned by a failed parse stay, they just have no dependents
+	std::vector<Instruction> code;
+	std::string parseError;
+	Parser parser(*this, text);
+	if (!parser.Parse(code, parseError))
+	{
+		if (error != nullptr)
+		{
+			*error = std::move(parseError);
+		}
+		return std::nullopt;
+	}
+
+	const Index index = m_Expressions.size();
+	m_Expressions.push_back(Expression{ static_cast<std::uint32_t>(m_Code.size()), static_cast<std::uint32_t>(code.size()) });
+	m_Code.insert(m_Code.end(), code.begin(), code.end());
+	m_Results.push_back(0);
+	m_Evaluated.push_back(0);
+	m_Dirty.push_back(0);
+
+	for (const Instruction& instruction : code)
+	{
+		if (instruction.op != OpCode::kInput)
+		{
+			continue;
+		}
+
+		auto& dependents = m_Dependents[instruction.input];
+		if (dependents.empty() || dependents.back() != index)
+		{
+			dependents.push_back(index);
+		}
+	}
+
+	MarkDirty(index);
+	return index;
+}
+
+void ConditionExpressions::Clear()
+{
+	m_Inputs.clear();
+	m_InputIndex.clear();
+	m_Values.clear();
+	m_Dependents.clear();
+	m_KnownInputs = 0;
+	m_Code.clear();
+	m_Expressions.clear();
+	m_Results.clear();
+	m_Evaluated.clear();
+	m_Dirty.clear();
+	m_DirtyList.clear();
+	m_Changed.clear();
+	m_EvaluatedCount = 0;
+}
+
+void ConditionExpressions::Invalidate()
+{
+	for (Index index = 0; index < m_Expressions.size(); index++)
+	{
+		m_Evaluated[index] = 0;
+		MarkDirty(index);
+	}
+}
+
+const std::vector<ConditionExpressions::Index>& ConditionExpressions::Update(const ConditionSnapshot& snapshot)
+{
+	for (std::size_t input = 0; input < m_Inputs.size(); input++)
+	{
+		const std::uint8_t value = ReadInput(m_Inputs[input], snapshot) ? 1 : 0;
+		if (input < m_KnownInputs && m_Values[input] == value)
+		{
+			continue;
+		}
+
+		m_Values[input] = value;
+		for (const Index index : m_Dependents[input])
+		{
+			MarkDirty(index);
+		}
+	}
+	m_KnownInputs = m_Inputs.size();
+
+	// Index order, so callers applying the changes do it in rule order
+	std::sort(m_DirtyList.begin(), m_DirtyList.end());
+
+	m_Changed.clear();
+	m_EvaluatedCount = m_DirtyList.size();
+	for (const Index index : m_DirtyList)
+	{
+		m_Dirty[index] = 0;
+
+		const std::uint8_t result = Evaluate(m_Expressions[index]) ? 1 : 0;
+		if (!m_Evaluated[index] || m_Results[index] != result)
+		{
+			m_Results[index] = result;
+			m_Evaluated[index] = 1;
+			m_Changed.push_back(index);
+		}
+	}
+	m_DirtyList.clear();
+
+	return m_Changed;
+}
+
+bool ConditionExpressions::IsHourInRange(float hour, double start, double stop)
+{
+	if (start <= stop)
+	{
+		return hour >= start && hour <= stop;
+	}
+	return hour >= start || hour <= stop;
+}
+
+std::uint32_t ConditionExpressions::Intern(const Input& input)
+{
+	const auto [it, inserted] = m_InputIndex.try_emplace(fmt::format("{}:{}:{}:{}", static_cast<int>(input.type), input.name, input.start, input.stop), static_cast<std::uint32_t>(m_Inputs.size()));
+	if (!inserted)
+	{
+		return it->second;
+	}
+
+	m_Inputs.push_back(input);
+	m_Values.push_back(0);
+	m_Dependents.emplace_back();
+	return static_cast<std::uint32_t>(m_Inputs.size() - 1);
+}
+
+bool ConditionExpressions::ReadInput(const Input& input, const ConditionSnapshot& snapshot) const
+{
+	switch (input.type)
+	{
+	case InputType::kInterior:
+		return snapshot.interior;
+	case InputType::kMenu:
+		return snapshot.menus != nullptr && snapshot.menus->find(input.name) != snapshot.menus->end();
+	case InputType::kWeather:
+		return snapshot.weather == input.name;
+	case InputType::kHour:
+		return IsHourInRange(snapshot.hour, input.start, input.stop);
+	case InputType::kPlayer:
+		return (snapshot.player & input.flag) != 0;
+	case InputType::kCamera:
+		return snapshot.camera == input.flag;
+	case InputType::kLight:
+		return snapshot.light == input.flag;
+	}
+	return false;
+}
+
+bool ConditionExpressions::Evaluate(const Expression& expression) const
+{
+	bool stack[kMaxDepth];
+	std::size_t top = 0;
+
+	const Instruction* instruction = m_Code.data() + expression.first;
+	const Instruction* end = instruction + expression.count;
+	for (; instruction != end; ++instruction)
+	{
+		switch (instruction->op)
+		{
+		case OpCode::kFalse:
+			stack[top++] = false;
+			break;
+		case OpCode::kTrue:
+			stack[top++] = true;
+			break;
+		case OpCode::kInput:
+			stack[top++] = m_Values[instruction->input] != 0;
+			break;
+		case OpCode::kNot:
+			stack[top - 1] = !stack[top - 1];
+			break;
+		case OpCode::kAnd:
+			top--;
+			stack[top - 1] = stack[top - 1] && stack[top];
+			break;
+		case OpCode::kOr:
+			top--;
+			stack[top - 1] = stack[top - 1] || stack[top];
+			break;
+		}
+	}
+
+	return top > 0 && stack[top - 1];
+}
+
+void ConditionExpressions::MarkDirty(Index index)
+{
+	if (!m_Dirty[index])
+	{
+		m_Dirty[index] = 1;
+		m_DirtyList.push_back(index);
+	}
+}
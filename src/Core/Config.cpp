@@ -0,0 +1,131 @@
+#include "Core/Config.h"
+
+void Config::Clear()
+{
+	EnableMenus = false;
+	EnableTime = false;
+	EnableInterior = false;
+	EnableWeather = false;
+	EnablePerformance = false;
+	EnableDeferral = false;
+	EnableDefinitions = false;
+	EnableUniforms = false;
+	EnableCurves = false;
+	EnableFades = false;
+	EnableGameUniforms = false;
+	EnableReshadePresets = false;
+	EnableExpressions = false;
+	EnableCalendar = false;
+	EnableLocation = false;
+	EnableScene = false;
+	EnablePlayer = false;
+	EnableCamera = false;
+	EnableLight = false;
+	EnableHotkeys = false;
+
+	// Empty every vector
+	g_MenuToggleFile.clear();
+	g_MenuToggleState.clear();
+	g_MenuSpecificMenu.clear();
+	g_SpecificMenu.clear();
+	g_INImenus.clear();
+	techniqueMenuInfoList.clear();
+	menuList.clear();
+	ToggleStateMenus.clear();
+	ToggleAllStateMenus.clear();
+	itemMenuShaderToToggle = nullptr; // itemMenuShaderToToggle is a pointer, set it to nullptr.
+	itemMenuStateValue = nullptr; // Similarly, set itemMenuStateValue to nullptr.
+	itemSpecificMenu = nullptr;
+
+	g_TimeToggleFile.clear();
+	g_TimeToggleState.clear();
+	techniqueTimeInfoList.clear();
+	techniqueTimeInfoListAll.clear();
+	g_SpecificTime.clear();
+	ToggleStateTime.clear();
+	ToggleAllStateTime.clear();
+	itemTimeShaderToToggle = nullptr; // Set to nullptr.
+	itemTimeStateValue = nullptr; // Set to nullptr.
+	itemTimeStartHour = 0.0;
+	itemTimeStopHour = 0.0;
+	itemTimeStartHourAll = 0.0;
+	itemTimeStopHourAll = 0.0;
+	TimeUpdateIntervalTime = 0;
+	EnableTimePrewarm = false;
+	TimePrewarmLookahead = 120.0;
+
+	g_InteriorToggleFile.clear();
+	g_InteriorToggleState.clear();
+	techniqueInteriorInfoList.clear();
+	g_SpecificInterior.clear();
+	ToggleStateInterior.clear();
+	ToggleAllStateInterior.clear();
+	itemInteriorShaderToToggle = nullptr;
+	itemInteriorStateValue = nullptr;
+	TimeUpdateIntervalInterior = 0;
+
+	g_WeatherValue.clear();
+	g_WeatherToggleFile.clear();
+	g_WeatherToggleState.clear();
+	g_WeatherSpecificWeather.clear();
+	g_SpecificWeather.clear();
+	g_INIweather.clear();
+	weatherList.clear();
+	techniqueWeatherInfoList.clear();
+	ToggleStateWeather.clear();
+	ToggleAllStateWeather.clear();
+	weatherflags.clear();
+	itemWeatherShaderToToggle = nullptr; // Set to nullptr.
+	itemWeatherStateValue = nullptr; // Set to nullptr.
+	itemSpecificWeather = nullptr;
+	TimeUpdateIntervalWeather = 0;
+
+	ruleRevision++;
+
+	techniquePerformanceInfoList.clear();
+	PerformanceTargetFrameTime = 16.6;
+	PerformanceHeadroom = 0.1;
+	PerformanceWindowFrames = 30;
+
+	deferredEffectList.clear();
+	DeferralTimeout = 120;
+
+	definitionInfoList.clear();
+	DefinitionBatchDelay = 10;
+
+	uniformInfoList.clear();
+
+	curveInfoList.clear();
+	curveRevision++;
+
+	fadeInfoList.clear();
+
+	groupInfoList.clear();
+	groupRevision++;
+
+	calendarInfoList.clear();
+
+	locationInfoList.clear();
+
+	playerInfoList.clear();
+
+	cameraInfoList.clear();
+
+	lightInfoList.clear();
+	LightDarkThreshold = 0.12f;
+	LightBrightThreshold = 0.35f;
+
+	hotkeyInfoList.clear();
+	hotkeyRevision++;
+
+	sceneInfoList.clear();
+	TimeUpdateIntervalScene = 5;
+
+	expressionInfoList.clear();
+	expressionRevision++;
+
+	reshadePresetInfoList.clear();
+	DefaultReshadePreset.clear();
+	PresetSwitchInterval = 60;
+	PresetSwitchTimeout = 120;
+}
@@ -0,0 +1,1141 @@
+#include "Core/CalendarRules.h"
+#include "Core/Config.h"
+#include "Core/EffectGroups.h"
+#include "Core/StateRules.h"
+#include "Core/UniformCurves.h"
+
+#include <algorithm>
+#include <cstring>
+#include <SimpleIni.h>
+#include <spdlog/spdlog.h>
+
+// Rules of one StateRuleKind live in their own section as <Name>File<N>, <Name>State<N> and <conditionKey><N>
+static void LoadStateRules(CSimpleIniA& ini, const StateRuleKind& kind)
+{
+	CSimpleIniA::TNamesDepend keys;
+	ini.GetAllKeys(kind.name, keys);
+
+	const std::string filePrefix = std::string(kind.name) + "File";
+	const std::string statePrefix = std::string(kind.name) + "State";
+
+	for (const auto& key : keys)
+	{
+		if (strncmp(key.pItem, filePrefix.c_str(), filePrefix.size()) == 0)
+		{
+			const std::string ruleIndex = key.pItem + filePrefix.size();
+
+			StateRuleInfo rule;
+			rule.filename = ini.GetValue(kind.name, key.pItem, "");
+			rule.state = ini.GetValue(kind.name, (statePrefix + ruleIndex).c_str(), "off");
+			rule.condition = ini.GetValue(kind.name, (kind.conditionKey + ruleIndex).c_str(), "");
+			kind.rules.push_back(rule);
+			SPDLOG_DEBUG("Populated {} StateRuleInfo: {} {} while {}", kind.name, rule.filename, rule.state, rule.condition);
+		}
+	}
+
+	SPDLOG_DEBUG("\n");
+}
+
+static void SaveStateRules(CSimpleIniA& ini, const StateRuleKind& kind)
+{
+	const std::string filePrefix = std::string(kind.name) + "File";
+	const std::string statePrefix = std::string(kind.name) + "State";
+
+	for (size_t i = 0; i < kind.rules.size(); i++)
+	{
+		const auto& rule = kind.rules[i];
+		const std::string ruleIndex = std::to_string(i + 1);
+
+		ini.SetValue(kind.name, (filePrefix + ruleIndex).c_str(), rule.filename.c_str());
+		ini.SetValue(kind.name, (statePrefix + ruleIndex).c_str(), rule.state.c_str());
+		ini.SetValue(kind.name, (kind.conditionKey + ruleIndex).c_str(), rule.condition.c_str());
+	}
+}
+
+void Config::LoadINI(const std::string& presetPath)
+{
+	SPDLOG_DEBUG("Starting to load: {}", presetPath.c_str());
+
+	CSimpleIniA ini;
+	ini.SetUnicode(false);
+	ini.LoadFile(presetPath.c_str());
+
+	const char* sectionGeneral = "General";
+	const char* sectionMenusGeneral = "MenusGeneral";
+	const char* sectionMenusProcess = "MenusProcess";
+	const char* sectionTimeGeneral = "Time";
+	const char* sectionInteriorGeneral = "Interior";
+	const char* sectionWeatherGeneral = "Weather";
+	const char* sectionWeatherProcess = "WeatherProcess";
+	const char* sectionPerformanceGeneral = "Performance";
+	const char* sectionDeferralGeneral = "Deferral";
+	const char* sectionDefinitionsGeneral = "Definitions";
+	const char* sectionUniformsGeneral = "Uniforms";
+	const char* sectionCurvesGeneral = "Curves";
+	const char* sectionFadesGeneral = "Fades";
+	const char* sectionReshadePresetsGeneral = "ReShadePresets";
+	const char* sectionGroupsGeneral = "Groups";
+	const char* sectionExpressionsGeneral = "Expressions";
+	const char* sectionCalendarGeneral = "Calendar";
+	const char* sectionLocationGeneral = "Location";
+	const char* sectionSceneGeneral = "Scene";
+	const char* sectionLightGeneral = "Light";
+	const char* sectionHotkeysGeneral = "Hotkeys";
+
+	CSimpleIniA::TNamesDepend MenusGeneral_keys;
+	CSimpleIniA::TNamesDepend MenusProcess_keys;
+	CSimpleIniA::TNamesDepend TimeGeneral_keys;
+	CSimpleIniA::TNamesDepend InteriorGeneral_keys;
+	CSimpleIniA::TNamesDepend WeatherGeneral_keys;
+	CSimpleIniA::TNamesDepend WeatherProcess_keys;
+	CSimpleIniA::TNamesDepend PerformanceGeneral_keys;
+	CSimpleIniA::TNamesDepend DeferralGeneral_keys;
+	CSimpleIniA::TNamesDepend DefinitionsGeneral_keys;
+	CSimpleIniA::TNamesDepend UniformsGeneral_keys;
+	CSimpleIniA::TNamesDepend CurvesGeneral_keys;
+	CSimpleIniA::TNamesDepend FadesGeneral_keys;
+	CSimpleIniA::TNamesDepend ReshadePresetsGeneral_keys;
+	CSimpleIniA::TNamesDepend GroupsGeneral_keys;
+	CSimpleIniA::TNamesDepend ExpressionsGeneral_keys;
+	CSimpleIniA::TNamesDepend CalendarGeneral_keys;
+	CSimpleIniA::TNamesDepend LocationGeneral_keys;
+	CSimpleIniA::TNamesDepend SceneGeneral_keys;
+	CSimpleIniA::TNamesDepend HotkeysGeneral_keys;
+
+	//General
+	EnableMenus = ini.GetBoolValue(sectionGeneral, "EnableMenus");
+	EnableTime = ini.GetBoolValue(sectionGeneral, "EnableTime");
+	EnableInterior = ini.GetBoolValue(sectionGeneral, "EnableInterior");
+	EnableWeather = ini.GetBoolValue(sectionGeneral, "EnableWeather");
+	EnablePerformance = ini.GetBoolValue(sectionGeneral, "EnablePerformance");
+	EnableDeferral = ini.GetBoolValue(sectionGeneral, "EnableDeferral");
+	EnableDefinitions = ini.GetBoolValue(sectionGeneral, "EnableDefinitions");
+	EnableUniforms = ini.GetBoolValue(sectionGeneral, "EnableUniforms");
+	EnableCurves = ini.GetBoolValue(sectionGeneral, "EnableCurves");
+	EnableFades = ini.GetBoolValue(sectionGeneral, "EnableFades");
+	EnableGameUniforms = ini.GetBoolValue(sectionGeneral, "EnableGameUniforms");
+	EnableReshadePresets = ini.GetBoolValue(sectionGeneral, "EnableReshadePresets");
+	EnableExpressions = ini.GetBoolValue(sectionGeneral, "EnableExpressions");
+	EnableCalendar = ini.GetBoolValue(sectionGeneral, "EnableCalendar");
+	EnableLocation = ini.GetBoolValue(sectionGeneral, "EnableLocation");
+	EnableScene = ini.GetBoolValue(sectionGeneral, "EnableScene");
+	EnablePlayer = ini.GetBoolValue(sectionGeneral, "EnablePlayer");
+	EnableCamera = ini.GetBoolValue(sectionGeneral, "EnableCamera");
+	EnableLight = ini.GetBoolValue(sectionGeneral, "EnableLight");
+	EnableHotkeys = ini.GetBoolValue(sectionGeneral, "EnableHotkeys");
+
+
+	SPDLOG_DEBUG("{}: EnableMenus: {} - EnableTime: {} - EnableInterior: {} - EnableWeather: {}", sectionGeneral, EnableMenus, EnableTime, EnableInterior, EnableWeather);
+
+	SPDLOG_DEBUG("\n");
+
+#pragma region Menus
+
+	// MenusGeneral
+	ToggleStateMenus = ini.GetValue(sectionMenusGeneral, "MenuToggleOption");
+	ToggleAllStateMenus = ini.GetValue(sectionMenusGeneral, "MenuToggleAllState");
+
+	SPDLOG_DEBUG("General MenuToggleOption:  {} - MenuToggleAllState: {}", ToggleStateMenus, ToggleAllStateMenus);
+
+	ini.GetAllKeys(sectionMenusGeneral, MenusGeneral_keys);
+	g_SpecificMenu.reserve(MenusGeneral_keys.size()); // Reserve space for vector
+
+	const char* togglePrefix01 = "MenuToggleSpecificFile";
+	const char* togglePrefix02 = "MenuToggleSpecificState";
+	const char* togglePrefixMenu = "MenuToggleSpecificMenu";
+
+	for (const auto& key : MenusGeneral_keys)
+	{
+		if (strcmp(key.pItem, "MenuToggleOption") != 0 && strcmp(key.pItem, "MenuToggleAllState") != 0)
+		{
+			g_SpecificMenu.push_back(key.pItem);
+			//const char* menuItemgeneral = g_SpecificMenu.back().c_str();
+
+			// Check if the key starts with MenuToggleSpecificFile
+			if (strncmp(key.pItem, togglePrefix01, strlen(togglePrefix01)) == 0)
+			{
+				// The other keys of this rule share the number behind the prefix
+				const std::string ruleIndex = key.pItem + strlen(togglePrefix01);
+
+				itemMenuShaderToToggle = ini.GetValue(sectionMenusGeneral, key.pItem, nullptr);
+				g_MenuToggleFile.emplace(itemMenuShaderToToggle);
+				//SPDLOG_DEBUG("MenuToggleSpecificFile:  {} - Value: {}", menuItemgeneral, itemMenuShaderToToggle);
+
+				// Construct the corresponding key for the state
+				std::string stateKeyName = togglePrefix02 + ruleIndex;
+
+				// Retrieve the state using the constructed key
+				itemMenuStateValue = ini.GetValue(sectionMenusGeneral, stateKeyName.c_str(), nullptr);
+				g_MenuToggleState.emplace(itemMenuStateValue);
+
+				std::string menuKeyName = togglePrefixMenu + ruleIndex;
+				itemSpecificMenu = ini.GetValue(sectionMenusGeneral, menuKeyName.c_str(), nullptr);
+				g_MenuSpecificMenu.emplace(itemSpecificMenu);
+
+				// Populate the technique info
+				TechniqueInfo MenuInfo;
+				MenuInfo.filename = itemMenuShaderToToggle;
+				MenuInfo.state = itemMenuStateValue;
+				MenuInfo.Name = itemSpecificMenu;
+				techniqueMenuInfoList.push_back(MenuInfo);
+				SPDLOG_DEBUG("Populated TechniqueMenuInfo: {} - {}", itemMenuShaderToToggle, itemMenuStateValue);
+			}
+		}
+	}
+
+	SPDLOG_DEBUG("\n");
+
+
+	//MenusProcess
+	ini.GetAllKeys(sectionMenusProcess, MenusProcess_keys);
+	g_INImenus.reserve(MenusProcess_keys.size()); // Reserve space for vector
+
+	for (const auto& key : MenusProcess_keys)
+	{
+		Info menus;
+		g_INImenus.push_back(key.pItem);
+		const char* menuItem = g_INImenus.back().c_str();
+		const char* itemValue = ini.GetValue(sectionMenusProcess, key.pItem, nullptr);
+
+		menus.Index = menuItem;
+		menus.Name = itemValue;
+		menuList.push_back(menus);
+
+		SPDLOG_DEBUG("Menu:  {} - Value: {}", menuItem, itemValue);
+	}
+
+	SPDLOG_DEBUG("\n");
+#pragma endregion
+
+#pragma region Time
+	//Time
+	ToggleStateTime = ini.GetValue(sectionTimeGeneral, "TimeToggleOption");
+	TimeUpdateIntervalTime = ini.GetLongValue(sectionTimeGeneral, "TimeUpdateInterval");
+
+	SPDLOG_DEBUG("General TimeToggleOption:  {} - TimeUpdateInterval: {}", ToggleStateTime, TimeUpdateIntervalTime);
+
+	EnableTimePrewarm = ini.GetBoolValue(sectionTimeGeneral, "TimePrewarm");
+	TimePrewarmLookahead = ini.GetDoubleValue(sectionTimeGeneral, "TimePrewarmLookahead", 120.0);
+
+	// All Time
+	ToggleAllStateTime = ini.GetValue(sectionTimeGeneral, "TimeToggleAllState");
+	itemTimeStartHourAll = ini.GetDoubleValue(sectionTimeGeneral, "TimeToggleAllTimeStart");
+	itemTimeStopHourAll = ini.GetDoubleValue(sectionTimeGeneral, "TimeToggleAllTimeStop");
+
+	TechniqueInfo TimeInfoAll;
+	TimeInfoAll.state = ToggleAllStateTime;
+	TimeInfoAll.startTime = itemTimeStartHourAll;
+	TimeInfoAll.stopTime = itemTimeStopHourAll;
+	techniqueTimeInfoListAll.push_back(TimeInfoAll);
+	SPDLOG_DEBUG("Set all effects to {} from {} - {}", ToggleAllStateTime, itemTimeStartHourAll, itemTimeStopHourAll);
+
+
+	// Specific Time
+	ini.GetAllKeys(sectionTimeGeneral, TimeGeneral_keys);
+	g_SpecificTime.reserve(TimeGeneral_keys.size()); // Reserve space for vector
+
+	const char* togglePrefix03 = "TimeToggleSpecificFile";
+	const char* togglePrefix04 = "TimeToggleSpecificState";
+	const char* togglePrefix05 = "TimeToggleSpecificTimeStart";
+	const char* togglePrefix06 = "TimeToggleSpecificTimeStop";
+
+	for (const auto& key : TimeGeneral_keys)
+	{
+		if (strcmp(key.pItem, "TimeToggleOption") != 0 && strcmp(key.pItem, "TimeToggleAllState") != 0 && strcmp(key.pItem, "TimeToggleAllTimeStart") != 0 && strcmp(key.pItem, "TimeToggleAllTimeStop") != 0 &&
+			strcmp(key.pItem, "TimePrewarm") != 0 && strcmp(key.pItem, "TimePrewarmLookahead") != 0)
+		{
+			g_SpecificTime.push_back(key.pItem);
+
+			// SPDLOG_DEBUG("Size of m_SpecificTime: {} ", m_SpecificTime.size());
+
+			//const char* timeItemGeneral = g_SpecificTime.back().c_str();
+
+			if (strncmp(key.pItem, togglePrefix03, strlen(togglePrefix03)) == 0)
+			{
+				// The other keys of this rule share the number behind the prefix
+				const std::string ruleIndex = key.pItem + strlen(togglePrefix03);
+
+				itemTimeShaderToToggle = ini.GetValue(sectionTimeGeneral, key.pItem, nullptr);
+				g_TimeToggleFile.emplace(itemTimeShaderToToggle);
+				//SPDLOG_DEBUG("TimeToggleSpecificFile:  {} - Value: {}", timeItemGeneral, itemTimeShaderToToggle);
+
+				// Construct the corresponding key for the state
+				std::string stateKeyName = togglePrefix04 + ruleIndex;
+
+				// Retrieve the state using the constructed key
+				itemTimeStateValue = ini.GetValue(sectionTimeGeneral, stateKeyName.c_str(), nullptr);
+				g_TimeToggleState.emplace(itemTimeStateValue);
+
+				// Construct the corresponding key for the the start and stop times
+				std::string startTimeKey = togglePrefix05 + ruleIndex;
+				std::string endTimeKey = togglePrefix06 + ruleIndex;
+				itemTimeStartHour = ini.GetDoubleValue(sectionTimeGeneral, startTimeKey.c_str());
+				itemTimeStopHour = ini.GetDoubleValue(sectionTimeGeneral, endTimeKey.c_str());
+				SPDLOG_DEBUG("startTime: {}; stopTimeKey: {} ", itemTimeStartHour, itemTimeStopHour);
+
+
+				// Populate the technique info
+				TechniqueInfo TimeInfo;
+				TimeInfo.filename = itemTimeShaderToToggle;
+				TimeInfo.state = itemTimeStateValue;
+				TimeInfo.startTime = itemTimeStartHour;
+				TimeInfo.stopTime = itemTimeStopHour;
+				techniqueTimeInfoList.push_back(TimeInfo);
+				SPDLOG_DEBUG("Set effect {} to {} from {} - {}", itemTimeShaderToToggle, itemTimeStateValue, itemTimeStartHour, itemTimeStopHour);
+			}
+		}
+	}
+
+
+	SPDLOG_DEBUG("\n");
+#pragma endregion 
+
+#pragma region Interior
+	//Interior
+	ToggleStateInterior = ini.GetValue(sectionInteriorGeneral, "InteriorToggleOption");
+	ToggleAllStateInterior = ini.GetValue(sectionInteriorGeneral, "InteriorToggleAllState");
+	TimeUpdateIntervalInterior = ini.GetLongValue(sectionInteriorGeneral, "InteriorUpdateInterval");
+
+	SPDLOG_DEBUG("General InteriorToggleOption:  {} - InteriorToggleAllState: {} - InteriorUpdateInterval: {}", ToggleStateInterior, ToggleAllStateInterior, TimeUpdateIntervalInterior);
+
+	ini.GetAllKeys(sectionInteriorGeneral, InteriorGeneral_keys);
+	g_SpecificInterior.reserve(InteriorGeneral_keys.size()); // Reserve space for vector
+
+	const char* togglePrefix07 = "InteriorToggleSpecificFile";
+	const char* togglePrefix08 = "InteriorToggleSpecificState";
+
+	for (const auto& key : InteriorGeneral_keys)
+	{
+		if (strcmp(key.pItem, "InteriorToggleOption") != 0 && strcmp(key.pItem, "InteriorToggleAllState") != 0)
+		{
+			g_SpecificInterior.push_back(key.pItem);
+			//const char* interiorItemgeneral = g_SpecificInterior.back().c_str();
+
+			// Check if the key starts with InteriorToggleSpecificFile
+			if (strncmp(key.pItem, togglePrefix07, strlen(togglePrefix07)) == 0)
+			{
+				// The other keys of this rule share the number behind the prefix
+				const std::string ruleIndex = key.pItem + strlen(togglePrefix07);
+
+				itemInteriorShaderToToggle = ini.GetValue(sectionInteriorGeneral, key.pItem, nullptr);
+				g_InteriorToggleFile.emplace(itemInteriorShaderToToggle);
+				//SPDLOG_DEBUG("InteriorToggleSpecificFile:  {} - Value: {}", interiorItemgeneral, itemInteriorShaderToToggle);
+
+				// Construct the corresponding key for the state
+				std::string stateKeyName = togglePrefix08 + ruleIndex;
+
+				// Retrieve the state using the constructed key
+				itemInteriorStateValue = ini.GetValue(sectionInteriorGeneral, stateKeyName.c_str(), nullptr);
+				g_InteriorToggleState.emplace(itemInteriorStateValue);
+
+				// Populate the technique info
+				TechniqueInfo InteriorInfo;
+				InteriorInfo.filename = itemInteriorShaderToToggle;
+				InteriorInfo.state = itemInteriorStateValue;
+				techniqueInteriorInfoList.push_back(InteriorInfo);
+				SPDLOG_DEBUG("Populated TechniqueInteriorInfo: {} - {}", itemInteriorShaderToToggle, itemInteriorStateValue);
+			}
+		}
+	}
+
+	SPDLOG_DEBUG("\n");
+#pragma endregion
+
+#pragma region Weather
+	//Weather
+	ToggleStateWeather = ini.GetValue(sectionWeatherGeneral, "WeatherToggleOption");
+	ToggleAllStateWeather = ini.GetValue(sectionWeatherGeneral, "WeatherToggleAllState");
+	TimeUpdateIntervalWeather = ini.GetLongValue(sectionWeatherGeneral, "WeatherUpdateInterval");
+
+	SPDLOG_DEBUG("General WeatherToggleOption:  {} - WeatherToggleAllState: {} - WeatherUpdateInterval: {}", ToggleStateWeather, ToggleAllStateWeather, TimeUpdateIntervalWeather);
+
+	ini.GetAllKeys(sectionWeatherGeneral, WeatherGeneral_keys);
+	g_SpecificWeather.reserve(WeatherGeneral_keys.size());
+
+	const char* togglePrefix09 = "WeatherToggleSpecificFile";
+	const char* togglePrefix10 = "WeatherToggleSpecificState";
+	const char* togglePrefixItemWeather = "WeatherToggleSpecificWeather";
+
+	for (const auto& key : WeatherGeneral_keys)
+	{
+		if (strcmp(key.pItem, "WeatherToggleOption") != 0 && strcmp(key.pItem, "WeatherToggleAllState") != 0)
+		{
+			g_SpecificWeather.push_back(key.pItem);
+			//const char* weatherItemgeneral = g_SpecificWeather.back().c_str();
+
+			if (strncmp(key.pItem, togglePrefix09, strlen(togglePrefix09)) == 0)
+			{
+				// The other keys of this rule share the number behind the prefix
+				const std::string ruleIndex = key.pItem + strlen(togglePrefix09);
+
+				itemWeatherShaderToToggle = ini.GetValue(sectionWeatherGeneral, key.pItem, nullptr);
+				g_WeatherToggleFile.emplace(itemWeatherShaderToToggle);
+				//SPDLOG_DEBUG("WeatherToggleSpecificFile:  {} - Value: {}", weatherItemgeneral, itemWeatherShaderToToggle);
+
+				std::string stateKeyName = togglePrefix10 + ruleIndex;
+
+				itemWeatherStateValue = ini.GetValue(sectionWeatherGeneral, stateKeyName.c_str(), nullptr);
+				g_WeatherToggleState.emplace(itemWeatherStateValue);
+
+				std::string weatherKeyName = togglePrefixItemWeather + ruleIndex;
+				itemSpecificWeather = ini.GetValue(sectionWeatherGeneral, weatherKeyName.c_str(), nullptr);
+				g_WeatherSpecificWeather.emplace(itemSpecificWeather);
+
+				TechniqueInfo WeatherInfo;
+				WeatherInfo.filename = itemWeatherShaderToToggle;
+				WeatherInfo.state = itemWeatherStateValue;
+				WeatherInfo.Name = itemSpecificWeather;
+				techniqueWeatherInfoList.push_back(WeatherInfo);
+				SPDLOG_DEBUG("Populated TechniqueWeatherInfo: {} - {}", itemWeatherShaderToToggle, itemWeatherStateValue);
+			}
+		}
+	}
+
+	SPDLOG_DEBUG("\n");
+
+	//WeatherProcess
+	ini.GetAllKeys(sectionWeatherProcess, WeatherProcess_keys);
+	g_INIweather.reserve(WeatherProcess_keys.size()); // Reserve space for vector
+
+	for (const auto& key : WeatherProcess_keys)
+	{
+		Info weather;
+		g_INIweather.push_back(key.pItem);
+		const char* weatherItem = g_INIweather.back().c_str();
+		const char* weatheritemValue = ini.GetValue(sectionWeatherProcess, key.pItem, nullptr);
+		g_WeatherValue.emplace(weatheritemValue);
+
+		weather.Index = weatherItem;
+		weather.Name = weatheritemValue;
+		weatherList.push_back(weather);
+
+		SPDLOG_DEBUG("Weather:  {} - Value: {}", weatherItem, weatheritemValue);
+	}
+
+	SPDLOG_DEBUG("\n");
+#pragma endregion
+
+#pragma region Performance
+	//Performance
+	PerformanceTargetFrameTime = ini.GetDoubleValue(sectionPerformanceGeneral, "PerformanceTargetFrameTime", 16.6);
+	PerformanceHeadroom = ini.GetDoubleValue(sectionPerformanceGeneral, "PerformanceHeadroom", 0.1);
+	PerformanceWindowFrames = ini.GetLongValue(sectionPerformanceGeneral, "PerformanceWindowFrames", 30);
+
+	SPDLOG_DEBUG("General PerformanceTargetFrameTime: {} - PerformanceHeadroom: {} - PerformanceWindowFrames: {}", PerformanceTargetFrameTime, PerformanceHeadroom, PerformanceWindowFrames);
+
+	ini.GetAllKeys(sectionPerformanceGeneral, PerformanceGeneral_keys);
+
+	const char* togglePrefixPerformanceFile = "PerformanceToggleSpecificFile";
+	const char* togglePrefixPerformancePriority = "PerformanceToggleSpecificPriority";
+
+	for (const auto& key : PerformanceGeneral_keys)
+	{
+		if (strncmp(key.pItem, togglePrefixPerformanceFile, strlen(togglePrefixPerformanceFile)) == 0)
+		{
+			const std::string ruleIndex = key.pItem + strlen(togglePrefixPerformanceFile);
+			std::string priorityKeyName = togglePrefixPerformancePriority + ruleIndex;
+
+			// The governor only ever turns effects off, there is no state to pick
+			TechniqueInfo PerformanceInfo;
+			PerformanceInfo.filename = ini.GetValue(sectionPerformanceGeneral, key.pItem, "");
+			PerformanceInfo.state = "off";
+			PerformanceInfo.priority = ini.GetLongValue(sectionPerformanceGeneral, priorityKeyName.c_str());
+			techniquePerformanceInfoList.push_back(PerformanceInfo);
+			SPDLOG_DEBUG("Populated TechniquePerformanceInfo: {} - priority {}", PerformanceInfo.filename, PerformanceInfo.priority);
+		}
+	}
+
+	SPDLOG_DEBUG("\n");
+#pragma endregion
+
+#pragma region Deferral
+	//Deferral
+	DeferralTimeout = ini.GetLongValue(sectionDeferralGeneral, "DeferralTimeout", 120);
+
+	ini.GetAllKeys(sectionDeferralGeneral, DeferralGeneral_keys);
+
+	const char* togglePrefixDeferral = "DeferralEffect";
+
+	for (const auto& key : DeferralGeneral_keys)
+	{
+		if (strncmp(key.pItem, togglePrefixDeferral, strlen(togglePrefixDeferral)) == 0)
+		{
+			deferredEffectList.push_back(ini.GetValue(sectionDeferralGeneral, key.pItem, ""));
+			SPDLOG_DEBUG("Deferring enables of {}", deferredEffectList.back());
+		}
+	}
+
+	SPDLOG_DEBUG("\n");
+#pragma endregion
+
+#pragma region Definitions
+	//Definitions
+	DefinitionBatchDelay = ini.GetLongValue(sectionDefinitionsGeneral, "DefinitionBatchDelay", 10);
+
+	ini.GetAllKeys(sectionDefinitionsGeneral, DefinitionsGeneral_keys);
+
+	const char* togglePrefixDefinitionFile = "DefinitionFile";
+
+	for (const auto& key : DefinitionsGeneral_keys)
+	{
+		if (strncmp(key.pItem, togglePrefixDefinitionFile, strlen(togglePrefixDefinitionFile)) == 0)
+		{
+			const std::string ruleIndex = key.pItem + strlen(togglePrefixDefinitionFile);
+			const auto getValue = [&ini, sectionDefinitionsGeneral, &ruleIndex](const char* prefix)
+				{
+					return ini.GetValue(sectionDefinitionsGeneral, (prefix + ruleIndex).c_str(), "");
+				};
+
+			DefinitionInfo Definition;
+			Definition.filename = ini.GetValue(sectionDefinitionsGeneral, key.pItem, "");
+			Definition.name = getValue("DefinitionName");
+			Definition.value = getValue("DefinitionValue");
+			Definition.defaultValue = getValue("DefinitionDefault");
+			Definition.category = getValue("DefinitionCategory");
+			Definition.condition = getValue("DefinitionCondition");
+			Definition.startTime = ini.GetDoubleValue(sectionDefinitionsGeneral, ("DefinitionTimeStart" + ruleIndex).c_str());
+			Definition.stopTime = ini.GetDoubleValue(sectionDefinitionsGeneral, ("DefinitionTimeStop" + ruleIndex).c_str());
+			definitionInfoList.push_back(Definition);
+			SPDLOG_DEBUG("Populated DefinitionInfo: {} {}={} on {} {}", Definition.filename, Definition.name, Definition.value, Definition.category, Definition.condition);
+		}
+	}
+
+	SPDLOG_DEBUG("\n");
+#pragma endregion
+
+#pragma region Uniforms
+	//Uniforms
+	ini.GetAllKeys(sectionUniformsGeneral, UniformsGeneral_keys);
+
+	const char* togglePrefixUniformFile = "UniformFile";
+
+	for (const auto& key : UniformsGeneral_keys)
+	{
+		if (strncmp(key.pItem, togglePrefixUniformFile, strlen(togglePrefixUniformFile)) == 0)
+		{
+			const std::string ruleIndex = key.pItem + strlen(togglePrefixUniformFile);
+			const auto getValue = [&ini, sectionUniformsGeneral, &ruleIndex](const char* prefix, const char* defaultValue = "")
+				{
+					return ini.GetValue(sectionUniformsGeneral, (prefix + ruleIndex).c_str(), defaultValue);
+				};
+			const auto getDouble = [&ini, sectionUniformsGeneral, &ruleIndex](const char* prefix)
+				{
+					return ini.GetDoubleValue(sectionUniformsGeneral, (prefix + ruleIndex).c_str());
+				};
+
+			UniformInfo Uniform;
+			Uniform.filename = ini.GetValue(sectionUniformsGeneral, key.pItem, "");
+			Uniform.name = getValue("UniformName");
+			Uniform.type = getValue("UniformType", "float");
+			Uniform.value = getDouble("UniformValue");
+			Uniform.defaultValue = getDouble("UniformDefault");
+			Uniform.category = getValue("UniformCategory");
+			Uniform.condition = getValue("UniformCondition");
+			Uniform.startTime = getDouble("UniformTimeStart");
+			Uniform.stopTime = getDouble("UniformTimeStop");
+			uniformInfoList.push_back(Uniform);
+			SPDLOG_DEBUG("Populated UniformInfo: {} {} {}={} on {} {}", Uniform.filename, Uniform.type, Uniform.name, Uniform.value, Uniform.category, Uniform.condition);
+		}
+	}
+
+	SPDLOG_DEBUG("\n");
+#pragma endregion
+
+#pragma region Curves
+	//Curves
+	ini.GetAllKeys(sectionCurvesGeneral, CurvesGeneral_keys);
+
+	const char* togglePrefixCurveFile = "CurveFile";
+
+	for (const auto& key : CurvesGeneral_keys)
+	{
+		if (strncmp(key.pItem, togglePrefixCurveFile, strlen(togglePrefixCurveFile)) == 0)
+		{
+			const std::string ruleIndex = key.pItem + strlen(togglePrefixCurveFile);
+
+			CurveInfo Curve;
+			Curve.filename = ini.GetValue(sectionCurvesGeneral, key.pItem, "");
+			Curve.name = ini.GetValue(sectionCurvesGeneral, ("CurveName" + ruleIndex).c_str(), "");
+			Curve.keys = UniformCurves::ParseKeys(ini.GetValue(sectionCurvesGeneral, ("CurveKeys" + ruleIndex).c_str(), ""));
+			curveInfoList.push_back(Curve);
+			SPDLOG_DEBUG("Populated CurveInfo: {} {} with {} keys", Curve.filename, Curve.name, Curve.keys.size());
+		}
+	}
+	curveRevision++;
+
+	SPDLOG_DEBUG("\n");
+#pragma endregion
+
+#pragma region Fades
+	//Fades
+	ini.GetAllKeys(sectionFadesGeneral, FadesGeneral_keys);
+
+	const char* togglePrefixFadeFile = "FadeFile";
+
+	for (const auto& key : FadesGeneral_keys)
+	{
+		if (strncmp(key.pItem, togglePrefixFadeFile, strlen(togglePrefixFadeFile)) == 0)
+		{
+			const std::string ruleIndex = key.pItem + strlen(togglePrefixFadeFile);
+
+			FadeInfo Fade;
+			Fade.filename = ini.GetValue(sectionFadesGeneral, key.pItem, "");
+			Fade.uniform = ini.GetValue(sectionFadesGeneral, ("FadeUniform" + ruleIndex).c_str(), "");
+			Fade.duration = std::max(ini.GetDoubleValue(sectionFadesGeneral, ("FadeTime" + ruleIndex).c_str(), 500.0), 0.0);
+			Fade.maxValue = ini.GetDoubleValue(sectionFadesGeneral, ("FadeMax" + ruleIndex).c_str(), 1.0);
+			fadeInfoList.push_back(Fade);
+			SPDLOG_DEBUG("Populated FadeInfo: {} {} over {} ms", Fade.filename, Fade.uniform, Fade.duration);
+		}
+	}
+
+	SPDLOG_DEBUG("\n");
+#pragma endregion
+
+#pragma region Groups
+	//Groups
+	ini.GetAllKeys(sectionGroupsGeneral, GroupsGeneral_keys);
+
+	const char* togglePrefixGroupName = "GroupName";
+
+	for (const auto& key : GroupsGeneral_keys)
+	{
+		if (strncmp(key.pItem, togglePrefixGroupName, strlen(togglePrefixGroupName)) == 0)
+		{
+			const std::string ruleIndex = key.pItem + strlen(togglePrefixGroupName);
+
+			GroupInfo Group;
+			Group.name = ini.GetValue(sectionGroupsGeneral, key.pItem, "");
+			Group.members = EffectGroups::ParseMembers(ini.GetValue(sectionGroupsGeneral, ("GroupMembers" + ruleIndex).c_str(), ""));
+			groupInfoList.push_back(Group);
+			SPDLOG_DEBUG("Populated GroupInfo: {} with {} members", Group.name, Group.members.size());
+		}
+	}
+	groupRevision++;
+
+	SPDLOG_DEBUG("\n");
+#pragma endregion
+
+#pragma region Expressions
+	//Expressions
+	ini.GetAllKeys(sectionExpressionsGeneral, ExpressionsGeneral_keys);
+
+	const char* togglePrefixExpressionFile = "ExpressionFile";
+
+	for (const auto& key : ExpressionsGeneral_keys)
+	{
+		if (strncmp(key.pItem, togglePrefixExpressionFile, strlen(togglePrefixExpressionFile)) == 0)
+		{
+			const std::string ruleIndex = key.pItem + strlen(togglePrefixExpressionFile);
+
+			ExpressionInfo Expression;
+			Expression.filename = ini.GetValue(sectionExpressionsGeneral, key.pItem, "");
+			Expression.state = ini.GetValue(sectionExpressionsGeneral, ("ExpressionState" + ruleIndex).c_str(), "off");
+			Expression.expression = ini.GetValue(sectionExpressionsGeneral, ("Expression" + ruleIndex).c_str(), "");
+			expressionInfoList.push_back(Expression);
+			SPDLOG_DEBUG("Populated ExpressionInfo: {} {} while {}", Expression.filename, Expression.state, Expression.expression);
+		}
+	}
+	expressionRevision++;
+
+	SPDLOG_DEBUG("\n");
+#pragma endregion
+
+#pragma region Calendar
+	//Calendar
+	ini.GetAllKeys(sectionCalendarGeneral, CalendarGeneral_keys);
+
+	const char* togglePrefixCalendarFile = "CalendarFile";
+
+	for (const auto& key : CalendarGeneral_keys)
+	{
+		if (strncmp(key.pItem, togglePrefixCalendarFile, strlen(togglePrefixCalendarFile)) == 0)
+		{
+			const std::string ruleIndex = key.pItem + strlen(togglePrefixCalendarFile);
+
+			CalendarInfo Calendar;
+			Calendar.filename = ini.GetValue(sectionCalendarGeneral, key.pItem, "");
+			Calendar.state = ini.GetValue(sectionCalendarGeneral, ("CalendarState" + ruleIndex).c_str(), "off");
+			Calendar.firstDay = ini.GetLongValue(sectionCalendarGeneral, ("CalendarFirstDay" + ruleIndex).c_str(), 0);
+			Calendar.lastDay = ini.GetLongValue(sectionCalendarGeneral, ("CalendarLastDay" + ruleIndex).c_str(), -1);
+
+			// Missing or empty lists mean any month or day
+			const std::string months = ini.GetValue(sectionCalendarGeneral, ("CalendarMonths" + ruleIndex).c_str(), "");
+			const std::string weekdays = ini.GetValue(sectionCalendarGeneral, ("CalendarWeekdays" + ruleIndex).c_str(), "");
+			if (!months.empty())
+			{
+				Calendar.months = CalendarRules::ParseMonths(months);
+			}
+			if (!weekdays.empty())
+			{
+				Calendar.weekdays = CalendarRules::ParseWeekdays(weekdays);
+			}
+
+			calendarInfoList.push_back(Calendar);
+			SPDLOG_DEBUG("Populated CalendarInfo: {} {} in {} on {}", Calendar.filename, Calendar.state, months, weekdays);
+		}
+	}
+
+	SPDLOG_DEBUG("\n");
+#pragma endregion
+
+#pragma region Location
+	//Location
+	ini.GetAllKeys(sectionLocationGeneral, LocationGeneral_keys);
+
+	const char* togglePrefixLocationFile = "LocationFile";
+
+	for (const auto& key : LocationGeneral_keys)
+	{
+		if (strncmp(key.pItem, togglePrefixLocationFile, strlen(togglePrefixLocationFile)) == 0)
+		{
+			const std::string ruleIndex = key.pItem + strlen(togglePrefixLocationFile);
+
+			LocationInfo Location;
+			Location.filename = ini.GetValue(sectionLocationGeneral, key.pItem, "");
+			Location.state = ini.GetValue(sectionLocationGeneral, ("LocationState" + ruleIndex).c_str(), "off");
+			Location.type = ini.GetValue(sectionLocationGeneral, ("LocationType" + ruleIndex).c_str(), "Worldspace");
+			Location.name = ini.GetValue(sectionLocationGeneral, ("LocationName" + ruleIndex).c_str(), "");
+			locationInfoList.push_back(Location);
+			SPDLOG_DEBUG("Populated LocationInfo: {} {} in {} {}", Location.filename, Location.state, Location.type, Location.name);
+		}
+	}
+
+	SPDLOG_DEBUG("\n");
+#pragma endregion
+
+#pragma region Player
+	//Player
+	LoadStateRules(ini, kPlayerRules);
+#pragma endregion
+
+#pragma region Camera
+	//Camera
+	LoadStateRules(ini, kCameraRules);
+#pragma endregion
+
+#pragma region Light
+	//Light
+	LightDarkThreshold = static_cast<float>(ini.GetDoubleValue(sectionLightGeneral, "DarkThreshold", 0.12));
+	LightBrightThreshold = static_cast<float>(ini.GetDoubleValue(sectionLightGeneral, "BrightThreshold", 0.35));
+
+	LoadStateRules(ini, kLightRules);
+#pragma endregion
+
+#pragma region Hotkeys
+	//Hotkeys
+	ini.GetAllKeys(sectionHotkeysGeneral, HotkeysGeneral_keys);
+
+	const char* togglePrefixHotkeyKey = "HotkeyKey";
+
+	for (const auto& key : HotkeysGeneral_keys)
+	{
+		if (strncmp(key.pItem, togglePrefixHotkeyKey, strlen(togglePrefixHotkeyKey)) == 0)
+		{
+			const std::string ruleIndex = key.pItem + strlen(togglePrefixHotkeyKey);
+
+			HotkeyInfo Hotkey;
+			Hotkey.key = ini.GetValue(sectionHotkeysGeneral, key.pItem, "");
+			Hotkey.action = ini.GetValue(sectionHotkeysGeneral, ("HotkeyAction" + ruleIndex).c_str(), "Toggle");
+			Hotkey.target = ini.GetValue(sectionHotkeysGeneral, ("HotkeyTarget" + ruleIndex).c_str(), "");
+			hotkeyInfoList.push_back(Hotkey);
+			SPDLOG_DEBUG("Populated HotkeyInfo: {} {} {}", Hotkey.key, Hotkey.action, Hotkey.target);
+		}
+	}
+	hotkeyRevision++;
+
+	SPDLOG_DEBUG("\n");
+#pragma endregion
+
+#pragma region Scene
+	//Scene
+	TimeUpdateIntervalScene = ini.GetLongValue(sectionSceneGeneral, "SceneUpdateInterval", 5);
+
+	ini.GetAllKeys(sectionSceneGeneral, SceneGeneral_keys);
+
+	const char* togglePrefixSceneFile = "SceneFile";
+
+	for (const auto& key : SceneGeneral_keys)
+	{
+		if (strncmp(key.pItem, togglePrefixSceneFile, strlen(togglePrefixSceneFile)) == 0)
+		{
+			const std::string ruleIndex = key.pItem + strlen(togglePrefixSceneFile);
+
+			SceneInfo Scene;
+			Scene.filename = ini.GetValue(sectionSceneGeneral, key.pItem, "");
+			Scene.state = ini.GetValue(sectionSceneGeneral, ("SceneState" + ruleIndex).c_str(), "off");
+			Scene.metric = ini.GetValue(sectionSceneGeneral, ("SceneMetric" + ruleIndex).c_str(), "Actors");
+			Scene.threshold = ini.GetDoubleValue(sectionSceneGeneral, ("SceneThreshold" + ruleIndex).c_str(), 30.0);
+			Scene.hysteresis = ini.GetDoubleValue(sectionSceneGeneral, ("SceneHysteresis" + ruleIndex).c_str(), 5.0);
+			sceneInfoList.push_back(Scene);
+			SPDLOG_DEBUG("Populated SceneInfo: {} {} from {} {} down to {}", Scene.filename, Scene.state, Scene.threshold, Scene.metric, Scene.threshold - Scene.hysteresis);
+		}
+	}
+
+	SPDLOG_DEBUG("\n");
+#pragma endregion
+
+#pragma region ReShadePresets
+	//ReShade presets
+	DefaultReshadePreset = ini.GetValue(sectionReshadePresetsGeneral, "DefaultPreset", "");
+	PresetSwitchInterval = ini.GetLongValue(sectionReshadePresetsGeneral, "PresetSwitchInterval", 60);
+	PresetSwitchTimeout = ini.GetLongValue(sectionReshadePresetsGeneral, "PresetSwitchTimeout", 120);
+
+	ini.GetAllKeys(sectionReshadePresetsGeneral, ReshadePresetsGeneral_keys);
+
+	const char* togglePrefixPresetPath = "PresetPath";
+
+	for (const auto& key : ReshadePresetsGeneral_keys)
+	{
+		if (strncmp(key.pItem, togglePrefixPresetPath, strlen(togglePrefixPresetPath)) == 0)
+		{
+			const std::string ruleIndex = key.pItem + strlen(togglePrefixPresetPath);
+
+			ReshadePresetInfo Preset;
+			Preset.path = ini.GetValue(sectionReshadePresetsGeneral, key.pItem, "");
+			Preset.category = ini.GetValue(sectionReshadePresetsGeneral, ("PresetCategory" + ruleIndex).c_str(), "");
+			Preset.condition = ini.GetValue(sectionReshadePresetsGeneral, ("PresetCondition" + ruleIndex).c_str(), "");
+			Preset.startTime = ini.GetDoubleValue(sectionReshadePresetsGeneral, ("PresetTimeStart" + ruleIndex).c_str());
+			Preset.stopTime = ini.GetDoubleValue(sectionReshadePresetsGeneral, ("PresetTimeStop" + ruleIndex).c_str());
+			reshadePresetInfoList.push_back(Preset);
+			SPDLOG_DEBUG("Populated ReshadePresetInfo: {} on {} {}", Preset.path, Preset.category, Preset.condition);
+		}
+	}
+
+	SPDLOG_DEBUG("\n");
+#pragma endregion
+
+	if (TimeUpdateIntervalTime < 0) { TimeUpdateIntervalTime = 0; }
+	if (TimeUpdateIntervalInterior < 0) { TimeUpdateIntervalInterior = 0; }
+	if (TimeUpdateIntervalWeather < 0) { TimeUpdateIntervalWeather = 0; }
+	if (TimeUpdateIntervalScene < 1) { TimeUpdateIntervalScene = 1; }
+	if (LightBrightThreshold < LightDarkThreshold) { LightBrightThreshold = LightDarkThreshold; }
+	if (PerformanceWindowFrames < 1) { PerformanceWindowFrames = 1; }
+	if (DeferralTimeout < 0) { DeferralTimeout = 0; }
+	if (DefinitionBatchDelay < 0) { DefinitionBatchDelay = 0; }
+	if (PresetSwitchInterval < 0) { PresetSwitchInterval = 0; }
+	if (PresetSwitchTimeout < 0) { PresetSwitchTimeout = 0; }
+
+	ruleRevision++;
+}
+
+// I LOVE THIS. ALL HAIL SimpleINI!!!!!!
+static void WriteINI(CSimpleIniA& ini)
+{
+	// Save General section
+	ini.SetBoolValue("General", "EnableMenus", EnableMenus);
+	ini.SetBoolValue("General", "EnableTime", EnableTime);
+	ini.SetBoolValue("General", "EnableInterior", EnableInterior);
+	ini.SetBoolValue("General", "EnableWeather", EnableWeather);
+	ini.SetBoolValue("General", "EnablePerformance", EnablePerformance);
+	ini.SetBoolValue("General", "EnableDeferral", EnableDeferral);
+	ini.SetBoolValue("General", "EnableDefinitions", EnableDefinitions);
+	ini.SetBoolValue("General", "EnableUniforms", EnableUniforms);
+	ini.SetBoolValue("General", "EnableCurves", EnableCurves);
+	ini.SetBoolValue("General", "EnableFades", EnableFades);
+	ini.SetBoolValue("General", "EnableGameUniforms", EnableGameUniforms);
+	ini.SetBoolValue("General", "EnableReshadePresets", EnableReshadePresets);
+	ini.SetBoolValue("General", "EnableExpressions", EnableExpressions);
+	ini.SetBoolValue("General", "EnableCalendar", EnableCalendar);
+	ini.SetBoolValue("General", "EnableLocation", EnableLocation);
+	ini.SetBoolValue("General", "EnableScene", EnableScene);
+	ini.SetBoolValue("General", "EnablePlayer", EnablePlayer);
+	ini.SetBoolValue("General", "EnableCamera", EnableCamera);
+	ini.SetBoolValue("General", "EnableLight", EnableLight);
+	ini.SetBoolValue("General", "EnableHotkeys", EnableHotkeys);
+
+	// MenusGeneral Section
+	ini.SetValue("MenusGeneral", "MenuToggleOption", ToggleStateMenus.c_str());
+	ini.SetValue("MenusGeneral", "MenuToggleAllState", ToggleAllStateMenus.c_str());
+
+	for (size_t i = 0; i < techniqueMenuInfoList.size(); i++)
+	{
+		const auto& menuInfo = techniqueMenuInfoList[i];
+		std::string effectFileKey = "MenuToggleSpecificFile" + std::to_string(i + 1);
+		std::string effectStateKey = "MenuToggleSpecificState" + std::to_string(i + 1);
+		std::string effectMenuKey = "MenuToggleSpecificMenu" + std::to_string(i + 1);
+
+		ini.SetValue("MenusGeneral", effectFileKey.c_str(), menuInfo.filename.c_str());
+		ini.SetValue("MenusGeneral", effectStateKey.c_str(), menuInfo.state.c_str());
+		ini.SetValue("MenusGeneral", effectMenuKey.c_str(), menuInfo.Name.c_str());
+	}
+
+	// Save MenusProcess section
+	for (size_t i = 0; i < menuList.size(); i++)
+	{
+		const auto& menuData = menuList[i];
+		std::string menuKey = "Menu" + std::to_string(i + 1);
+		ini.SetValue("MenusProcess", menuKey.c_str(), menuData.Name.c_str());
+	}
+
+	// Save Time Section
+	ini.SetValue("Time", "TimeUpdateInterval", std::to_string(TimeUpdateIntervalTime).c_str());
+
+	ini.SetValue("Time", "TimeToggleOption", ToggleStateTime.c_str());
+	ini.SetValue("Time", "TimeToggleAllState", ToggleAllStateTime.c_str());
+	ini.SetBoolValue("Time", "TimePrewarm", EnableTimePrewarm);
+	ini.SetDoubleValue("Time", "TimePrewarmLookahead", TimePrewarmLookahead);
+
+	for (const auto& info : techniqueTimeInfoListAll)
+	{
+		ini.SetDoubleValue("Time", "TimeToggleAllTimeStart", info.startTime);
+		ini.SetDoubleValue("Time", "TimeToggleAllTimeStop", info.stopTime);
+	}
+
+	for (size_t i = 0; i < techniqueTimeInfoList.size(); i++)
+	{
+		const auto& timeInfo = techniqueTimeInfoList[i];
+		std::string effectFileKey = "TimeToggleSpecificFile" + std::to_string(i + 1);
+		std::string effectStateKey = "TimeToggleSpecificState" + std::to_string(i + 1);
+		std::string effectStartTimeKey = "TimeToggleSpecificTimeStart" + std::to_string(i + 1);
+		std::string effectStopTimeKey = "TimeToggleSpecificTimeStop" + std::to_string(i + 1);
+
+		ini.SetValue("Time", effectFileKey.c_str(), timeInfo.filename.c_str());
+		ini.SetValue("Time", effectStateKey.c_str(), timeInfo.state.c_str());
+		ini.SetDoubleValue("Time", effectStartTimeKey.c_str(), timeInfo.startTime);
+		ini.SetDoubleValue("Time", effectStopTimeKey.c_str(), timeInfo.stopTime);
+	}
+
+	// Save Interior section
+	ini.SetValue("Interior", "InteriorUpdateInterval", std::to_string(TimeUpdateIntervalInterior).c_str());
+	ini.SetValue("Interior", "InteriorToggleOption", ToggleStateInterior.c_str());
+	ini.SetValue("Interior", "InteriorToggleAllState", ToggleAllStateInterior.c_str());
+
+	for (size_t i = 0; i < techniqueInteriorInfoList.size(); i++)
+	{
+		const auto& interiorInfo = techniqueInteriorInfoList[i];
+		std::string effectFileKey = "InteriorToggleSpecificFile" + std::to_string(i + 1);
+		std::string effectStateKey = "InteriorToggleSpecificState" + std::to_string(i + 1);
+
+		ini.SetValue("Interior", effectFileKey.c_str(), interiorInfo.filename.c_str());
+		ini.SetValue("Interior", effectStateKey.c_str(), interiorInfo.state.c_str());
+	}
+
+	// Save Weather section
+	ini.SetValue("Weather", "WeatherUpdateInterval", std::to_string(TimeUpdateIntervalWeather).c_str());
+	ini.SetValue("Weather", "WeatherToggleOption", ToggleStateWeather.c_str());
+	ini.SetValue("Weather", "WeatherToggleAllState", ToggleAllStateWeather.c_str());
+
+	for (size_t i = 0; i < techniqueWeatherInfoList.size(); i++)
+	{
+		const auto& weatherInfo = techniqueWeatherInfoList[i];
+		std::string effectFileKey = "WeatherToggleSpecificFile" + std::to_string(i + 1);
+		std::string effectStateKey = "WeatherToggleSpecificState" + std::to_string(i + 1);
+		std::string effectWeatherKey = "WeatherToggleSpecificWeather" + std::to_string(i + 1);
+
+		ini.SetValue("Weather", effectFileKey.c_str(), weatherInfo.filename.c_str());
+		ini.SetValue("Weather", effectStateKey.c_str(), weatherInfo.state.c_str());
+		ini.SetValue("Weather", effectWeatherKey.c_str(), weatherInfo.Name.c_str());
+	}
+
+	// Save WeatherProcess section
+	for (size_t i = 0; i < weatherList.size(); i++)
+	{
+		const auto& weatherData = weatherList[i];
+		std::string weatherKey = "Weather" + std::to_string(i + 1);
+		ini.SetValue("WeatherProcess", weatherKey.c_str(), weatherData.Name.c_str());
+	}
+
+	// Save Performance section
+	ini.SetDoubleValue("Performance", "PerformanceTargetFrameTime", PerformanceTargetFrameTime);
+	ini.SetDoubleValue("Performance", "PerformanceHeadroom", PerformanceHeadroom);
+	ini.SetLongValue("Performance", "PerformanceWindowFrames", PerformanceWindowFrames);
+
+	for (size_t i = 0; i < techniquePerformanceInfoList.size(); i++)
+	{
+		const auto& performanceInfo = techniquePerformanceInfoList[i];
+		std::string effectFileKey = "PerformanceToggleSpecificFile" + std::to_string(i + 1);
+		std::string effectPriorityKey = "PerformanceToggleSpecificPriority" + std::to_string(i + 1);
+
+		ini.SetValue("Performance", effectFileKey.c_str(), performanceInfo.filename.c_str());
+		ini.SetLongValue("Performance", effectPriorityKey.c_str(), performanceInfo.priority);
+	}
+
+	// Save Deferral section
+	ini.SetLongValue("Deferral", "DeferralTimeout", DeferralTimeout);
+
+	for (size_t i = 0; i < deferredEffectList.size(); i++)
+	{
+		std::string effectKey = "DeferralEffect" + std::to_string(i + 1);
+		ini.SetValue("Deferral", effectKey.c_str(), deferredEffectList[i].c_str());
+	}
+
+	// Save Definitions section
+	ini.SetLongValue("Definitions", "DefinitionBatchDelay", DefinitionBatchDelay);
+
+	for (size_t i = 0; i < definitionInfoList.size(); i++)
+	{
+		const auto& definitionInfo = definitionInfoList[i];
+		const std::string ruleIndex = std::to_string(i + 1);
+
+		ini.SetValue("Definitions", ("DefinitionFile" + ruleIndex).c_str(), definitionInfo.filename.c_str());
+		ini.SetValue("Definitions", ("DefinitionName" + ruleIndex).c_str(), definitionInfo.name.c_str());
+		ini.SetValue("Definitions", ("DefinitionValue" + ruleIndex).c_str(), definitionInfo.value.c_str());
+		ini.SetValue("Definitions", ("DefinitionDefault" + ruleIndex).c_str(), definitionInfo.defaultValue.c_str());
+		ini.SetValue("Definitions", ("DefinitionCategory" + ruleIndex).c_str(), definitionInfo.category.c_str());
+		ini.SetValue("Definitions", ("DefinitionCondition" + ruleIndex).c_str(), definitionInfo.condition.c_str());
+		ini.SetDoubleValue("Definitions", ("DefinitionTimeStart" + ruleIndex).c_str(), definitionInfo.startTime);
+		ini.SetDoubleValue("Definitions", ("DefinitionTimeStop" + ruleIndex).c_str(), definitionInfo.stopTime);
+	}
+
+	// Save Uniforms section
+	for (size_t i = 0; i < uniformInfoList.size(); i++)
+	{
+		const auto& uniformInfo = uniformInfoList[i];
+		const std::string ruleIndex = std::to_string(i + 1);
+
+		ini.SetValue("Uniforms", ("UniformFile" + ruleIndex).c_str(), uniformInfo.filename.c_str());
+		ini.SetValue("Uniforms", ("UniformName" + ruleIndex).c_str(), uniformInfo.name.c_str());
+		ini.SetValue("Uniforms", ("UniformType" + ruleIndex).c_str(), uniformInfo.type.c_str());
+		ini.SetDoubleValue("Uniforms", ("UniformValue" + ruleIndex).c_str(), uniformInfo.value);
+		ini.SetDoubleValue("Uniforms", ("UniformDefault" + ruleIndex).c_str(), uniformInfo.defaultValue);
+		ini.SetValue("Uniforms", ("UniformCategory" + ruleIndex).c_str(), uniformInfo.category.c_str());
+		ini.SetValue("Uniforms", ("UniformCondition" + ruleIndex).c_str(), uniformInfo.condition.c_str());
+		ini.SetDoubleValue("Uniforms", ("UniformTimeStart" + ruleIndex).c_str(), uniformInfo.startTime);
+		ini.SetDoubleValue("Uniforms", ("UniformTimeStop" + ruleIndex).c_str(), uniformInfo.stopTime);
+	}
+
+	// Save Curves section
+	for (size_t i = 0; i < curveInfoList.size(); i++)
+	{
+		const auto& curveInfo = curveInfoList[i];
+		const std::string ruleIndex = std::to_string(i + 1);
+
+		ini.SetValue("Curves", ("CurveFile" + ruleIndex).c_str(), curveInfo.filename.c_str());
+		ini.SetValue("Curves", ("CurveName" + ruleIndex).c_str(), curveInfo.name.c_str());
+		ini.SetValue("Curves", ("CurveKeys" + ruleIndex).c_str(), UniformCurves::FormatKeys(curveInfo.keys).c_str());
+	}
+
+	// Save Fades section
+	for (size_t i = 0; i < fadeInfoList.size(); i++)
+	{
+		const auto& fadeInfo = fadeInfoList[i];
+		const std::string ruleIndex = std::to_string(i + 1);
+
+		ini.SetValue("Fades", ("FadeFile" + ruleIndex).c_str(), fadeInfo.filename.c_str());
+		ini.SetValue("Fades", ("FadeUniform" + ruleIndex).c_str(), fadeInfo.uniform.c_str());
+		ini.SetDoubleValue("Fades", ("FadeTime" + ruleIndex).c_str(), fadeInfo.duration);
+		ini.SetDoubleValue("Fades", ("FadeMax" + ruleIndex).c_str(), fadeInfo.maxValue);
+	}
+
+	// Save Groups section
+	for (size_t i = 0; i < groupInfoList.size(); i++)
+	{
+		const auto& groupInfo = groupInfoList[i];
+		const std::string ruleIndex = std::to_string(i + 1);
+
+		ini.SetValue("Groups", ("GroupName" + ruleIndex).c_str(), groupInfo.name.c_str());
+		ini.SetValue("Groups", ("GroupMembers" + ruleIndex).c_str(), EffectGroups::FormatMembers(groupInfo.members).c_str());
+	}
+
+	// Save Expressions section
+	for (size_t i = 0; i < expressionInfoList.size(); i++)
+	{
+		const auto& expressionInfo = expressionInfoList[i];
+		const std::string ruleIndex = std::to_string(i + 1);
+
+		ini.SetValue("Expressions", ("ExpressionFile" + ruleIndex).c_str(), expressionInfo.filename.c_str());
+		ini.SetValue("Expressions", ("ExpressionState" + ruleIndex).c_str(), expressionInfo.state.c_str());
+		ini.SetValue("Expressions", ("Expression" + ruleIndex).c_str(), expressionInfo.expression.c_str());
+	}
+
+	// Save Calendar section
+	for (size_t i = 0; i < calendarInfoList.size(); i++)
+	{
+		const auto& calendarInfo = calendarInfoList[i];
+		const std::string ruleIndex = std::to_string(i + 1);
+
+		ini.SetValue("Calendar", ("CalendarFile" + ruleIndex).c_str(), calendarInfo.filename.c_str());
+		ini.SetValue("Calendar", ("CalendarState" + ruleIndex).c_str(), calendarInfo.state.c_str());
+		ini.SetValue("Calendar", ("CalendarMonths" + ruleIndex).c_str(), CalendarRules::FormatMonths(calendarInfo.months).c_str());
+		ini.SetValue("Calendar", ("CalendarWeekdays" + ruleIndex).c_str(), CalendarRules::FormatWeekdays(calendarInfo.weekdays).c_str());
+		ini.SetLongValue("Calendar", ("CalendarFirstDay" + ruleIndex).c_str(), calendarInfo.firstDay);
+		ini.SetLongValue("Calendar", ("CalendarLastDay" + ruleIndex).c_str(), calendarInfo.lastDay);
+	}
+
+	// Save Location section
+	for (size_t i = 0; i < locationInfoList.size(); i++)
+	{
+		const auto& locationInfo = locationInfoList[i];
+		const std::string ruleIndex = std::to_string(i + 1);
+
+		ini.SetValue("Location", ("LocationFile" + ruleIndex).c_str(), locationInfo.filename.c_str());
+		ini.SetValue("Location", ("LocationState" + ruleIndex).c_str(), locationInfo.state.c_str());
+		ini.SetValue("Location", ("LocationType" + ruleIndex).c_str(), locationInfo.type.c_str());
+		ini.SetValue("Location", ("LocationName" + ruleIndex).c_str(), locationInfo.name.c_str());
+	}
+
+	// Save Player section
+	SaveStateRules(ini, kPlayerRules);
+
+	// Save Camera section
+	SaveStateRules(ini, kCameraRules);
+
+	// Save Light section
+	ini.SetDoubleValue("Light", "DarkThreshold", LightDarkThreshold);
+	ini.SetDoubleValue("Light", "BrightThreshold", LightBrightThreshold);
+	SaveStateRules(ini, kLightRules);
+
+	// Save Hotkeys section
+	for (size_t i = 0; i < hotkeyInfoList.size(); i++)
+	{
+		const auto& hotkeyInfo = hotkeyInfoList[i];
+		const std::string ruleIndex = std::to_string(i + 1);
+
+		ini.SetValue("Hotkeys", ("HotkeyKey" + ruleIndex).c_str(), hotkeyInfo.key.c_str());
+		ini.SetValue("Hotkeys", ("HotkeyAction" + ruleIndex).c_str(), hotkeyInfo.action.c_str());
+		ini.SetValue("Hotkeys", ("HotkeyTarget" + ruleIndex).c_str(), hotkeyInfo.target.c_str());
+	}
+
+	// Save Scene section
+	ini.SetLongValue("Scene", "SceneUpdateInterval", TimeUpdateIntervalScene);
+
+	for (size_t i = 0; i < sceneInfoList.size(); i++)
+	{
+		const auto& sceneInfo = sceneInfoList[i];
+		const std::string ruleIndex = std::to_string(i + 1);
+
+		ini.SetValue("Scene", ("SceneFile" + ruleIndex).c_str(), sceneInfo.filename.c_str());
+		ini.SetValue("Scene", ("SceneState" + ruleIndex).c_str(), sceneInfo.state.c_str());
+		ini.SetValue("Scene", ("SceneMetric" + ruleIndex).c_str(), sceneInfo.metric.c_str());
+		ini.SetDoubleValue("Scene", ("SceneThreshold" + ruleIndex).c_str(), sceneInfo.threshold);
+		ini.SetDoubleValue("Scene", ("SceneHysteresis" + ruleIndex).c_str(), sceneInfo.hysteresis);
+	}
+
+	// Save ReShade presets section
+	ini.SetValue("ReShadePresets", "DefaultPreset", DefaultReshadePreset.c_str());
+	ini.SetLongValue("ReShadePresets", "PresetSwitchInterval", PresetSwitchInterval);
+	ini.SetLongValue("ReShadePresets", "PresetSwitchTimeout", PresetSwitchTimeout);
+
+	for (size_t i = 0; i < reshadePresetInfoList.size(); i++)
+	{
+		const auto& presetInfo = reshadePresetInfoList[i];
+		const std::string ruleIndex = std::to_string(i + 1);
+
+		ini.SetValue("ReShadePresets", ("PresetPath" + ruleIndex).c_str(), presetInfo.path.c_str());
+		ini.SetValue("ReShadePresets", ("PresetCategory" + ruleIndex).c_str(), presetInfo.category.c_str());
+		ini.SetValue("ReShadePresets", ("PresetCondition" + ruleIndex).c_str(), presetInfo.condition.c_str());
+		ini.SetDoubleValue("ReShadePresets", ("PresetTimeStart" + ruleIndex).c_str(), presetInfo.startTime);
+		ini.SetDoubleValue("ReShadePresets", ("PresetTimeStop" + ruleIndex).c_str(), presetInfo.stopTime);
+	}
+
+}
+
+void Config::Save(const std::string& presetPath)
+{
+	CSimpleIniA ini;
+	ini.SetUnicode(false);
+	WriteINI(ini);
+
+	ini.SaveFile(presetPath.c_str());
+}
+
+std::string Config::Serialize()
+{
+	CSimpleIniA ini;
+	ini.SetUnicode(false);
+	WriteINI(ini);
+
+	std::string data;
+	ini.Save(data);
+	return data;
+}
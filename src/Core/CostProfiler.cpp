@@ -0,0 +1,178 @@
+#include "Core/CostProfiler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// Two sided 95% critical values of Student's t for 1 to 30 degrees of freedom
+	constexpr double s_TCritical95[] = {
+		12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+		2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+		2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+	};
+}
+
+void CostStats::Add(double sample)
+{
+	m_Count++;
+	const double delta = sample - m_Mean;
+	m_Mean += delta / static_cast<double>(m_Count);
+	m_M2 += delta * (sample - m_Mean);
+}
+
+double CostStats::GetStandardDeviation() const
+{
+	return m_Count > 1 ? std::sqrt(m_M2 / static_cast<double>(m_Count - 1)) : 0.0;
+}
+
+double CostStats::GetConfidenceHalfWidth() const
+{
+	if (m_Count < 2)
+	{
+		return 0.0;
+	}
+
+	const std::size_t degrees = m_Count - 1;
+	const double t = degrees <= std::size(s_TCritical95) ? s_TCritical95[degrees - 1] : 1.96;
+	return t * GetStandardDeviation() / std::sqrt(static_cast<double>(m_Count));
+}
+
+void CostProfiler::Start(IEffectRuntime& runtime, const std::vector<std::string>& effects)
+{
+	Stop(runtime);
+	m_Subjects.clear();
+
+	for (const std::string& effect : effects)
+	{
+		Subject subject;
+		subject.effect = effect;
+		runtime.EnumerateTechniques(effect.c_str(), [&runtime, &subject](EffectTechnique technique)
+			{
+				if (runtime.GetTechniqueState(technique))
+				{
+					subject.techniques.push_back(technique);
+				}
+			});
+
+		if (!subject.techniques.empty())
+		{
+			m_Subjects.push_back(std::move(subject));
+		}
+	}
+
+	if (m_Subjects.empty() || m_Settings.rounds == 0)
+	{
+		return;
+	}
+
+	m_Phase = Phase::kBaseline;
+	m_Current = 0;
+	m_Round = 0;
+	m_PhaseFrames = 0;
+	m_WindowSum = 0.0;
+	m_WindowCount = 0;
+	m_PendingOff = -1.0;
+}
+
+void CostProfiler::Stop(IEffectRuntime& runtime)
+{
+	if (m_Phase == Phase::kDisabled)
+	{
+		SetSubjectState(runtime, m_Subjects[m_Current], true);
+	}
+	m_Phase = Phase::kIdle;
+}
+
+void CostProfiler::Abort()
+{
+	m_Phase = Phase::kIdle;
+}
+
+void CostProfiler::AddFrame(IEffectRuntime& runtime, float frameTime)
+{
+	if (m_Phase == Phase::kIdle)
+	{
+		return;
+	}
+
+	// The frame a toggle lands in and the next few still carry the old state or the switch itself
+	if (++m_PhaseFrames <= m_Settings.settleFrames)
+	{
+		return;
+	}
+
+	m_WindowSum += frameTime;
+	if (++m_WindowCount < std::max<std::size_t>(m_Settings.windowFrames, 1))
+	{
+		return;
+	}
+
+	const double mean = m_WindowSum / static_cast<double>(m_WindowCount);
+	m_PhaseFrames = 0;
+	m_WindowSum = 0.0;
+	m_WindowCount = 0;
+
+	if (m_Phase == Phase::kBaseline)
+	{
+		if (m_PendingOff >= 0.0)
+		{
+			m_Subjects[m_PendingSubject].stats.Add((m_LastBaseline + mean) / 2.0 - m_PendingOff);
+			m_PendingOff = -1.0;
+		}
+		m_LastBaseline = mean;
+
+		if (m_Round >= m_Settings.rounds)
+		{
+			m_Phase = Phase::kIdle;
+			return;
+		}
+
+		SetSubjectState(runtime, m_Subjects[m_Current], false);
+		m_Phase = Phase::kDisabled;
+	}
+	else
+	{
+		SetSubjectState(runtime, m_Subjects[m_Current], true);
+		m_PendingOff = mean;
+		m_PendingSubject = m_Current;
+
+		if (++m_Current == m_Subjects.size())
+		{
+			m_Current = 0;
+			m_Round++;
+		}
+		m_Phase = Phase::kBaseline;
+	}
+}
+
+std::vector<CostProfiler::Result> CostProfiler::GetResults() const
+{
+	std::vector<Result> results;
+	for (const Subject& subject : m_Subjects)
+	{
+		results.push_back(Result{ subject.effect, subject.stats.GetMean(), subject.stats.GetConfidenceHalfWidth(), subject.stats.GetCount() });
+	}
+
+	std::stable_sort(results.begin(), results.end(), [](const Result& a, const Result& b) { return a.cost > b.cost; });
+	return results;
+}
+
+float CostProfiler::GetProgress() const
+{
+	if (m_Subjects.empty() || m_Settings.rounds == 0)
+	{
+		return 0.0f;
+	}
+
+	const std::size_t done = std::min(m_Round * m_Subjects.size() + m_Current, m_Settings.rounds * m_Subjects.size());
+	return static_cast<float>(done) / static_cast<float>(m_Settings.rounds * m_Subjects.size());
+}
+
+void CostProfiler::SetSubjectState(IEffectRuntime& runtime, Subject& subject, bool enabled)
+{
+	for (const EffectTechnique technique : subject.techniques)
+	{
+		runtime.SetTechniqueState(technique, enabled);
+	}
+}
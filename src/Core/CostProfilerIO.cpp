@@ -0,0 +1,40 @@
+#include "Core/CostProfiler.h"
+
+#include <exception>
+#include <rapidcsv.h>
+#include <spdlog/spdlog.h>
+
+bool CostProfiler::SaveCSV(const std::string& path) const
+{
+	const std::vector<Result> results = GetResults();
+
+	rapidcsv::Document csv("", rapidcsv::LabelParams(0, -1));
+	const char* columns[] = { "Rank", "Effect", "Cost", "Low95", "High95", "Samples" };
+	for (std::size_t column = 0; column < std::size(columns); column++)
+	{
+		csv.SetColumnName(column, columns[column]);
+	}
+
+	for (std::size_t row = 0; row < results.size(); row++)
+	{
+		const Result& result = results[row];
+		csv.SetCell<std::size_t>(0, row, row + 1);
+		csv.SetCell<std::string>(1, row, result.effect);
+		csv.SetCell<double>(2, row, result.cost);
+		csv.SetCell<double>(3, row, result.cost - result.confidence);
+		csv.SetCell<double>(4, row, result.cost + result.confidence);
+		csv.SetCell<std::size_t>(5, row, result.samples);
+	}
+
+	try
+	{
+		csv.Save(path);
+	}
+	catch (const std::exception& e)
+	{
+		spdlog::info("Failed to write effect costs to {}: {}", path, e.what());
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,107 @@
+#include "Core/DeferredEffectRuntime.h"
+#include "Core/Config.h"
+
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+void DeferredEffectRuntime::SetTechniqueState(EffectTechnique technique, bool enabled)
+{
+	const std::string effect = GetCurrentEffect();
+
+	{
+		std::scoped_lock<std::mutex> lock(m_PendingMutex);
+
+		const auto it = m_Pending.find(effect);
+		if (!enabled)
+		{
+			// A later disable wins over a queued enable
+			if (it != m_Pending.end())
+			{
+				std::erase(it->second.techniques, technique.handle);
+				if (it->second.techniques.empty())
+				{
+					m_Pending.erase(it);
+				}
+			}
+		}
+		else if (EnableDeferral && !m_Runtime.GetTechniqueState(technique) &&
+			std::find(deferredEffectList.begin(), deferredEffectList.end(), effect) != deferredEffectList.end())
+		{
+			Pending& pending = it != m_Pending.end() ? it->second : m_Pending[effect];
+			if (pending.techniques.empty())
+			{
+				pending.queued = Clock::now();
+				SPDLOG_DEBUG("Deferring enable of {}", effect);
+			}
+			if (std::find(pending.techniques.begin(), pending.techniques.end(), technique.handle) == pending.techniques.end())
+			{
+				pending.techniques.push_back(technique.handle);
+			}
+			return;
+		}
+	}
+
+	m_Runtime.SetTechniqueState(technique, enabled);
+}
+
+void DeferredEffectRuntime::Flush()
+{
+	std::unordered_map<std::string, Pending> pending;
+	{
+		std::scoped_lock<std::mutex> lock(m_PendingMutex);
+		pending.swap(m_Pending);
+	}
+
+	Apply(pending);
+}
+
+void DeferredEffectRuntime::Update(Clock::time_point now)
+{
+	std::unordered_map<std::string, Pending> expired;
+	{
+		std::scoped_lock<std::mutex> lock(m_PendingMutex);
+
+		if (m_Pending.empty() || (EnableDeferral && DeferralTimeout <= 0))
+		{
+			return;
+		}
+
+		for (auto it = m_Pending.begin(); it != m_Pending.end();)
+		{
+			if (!EnableDeferral || now - it->second.queued >= std::chrono::seconds(DeferralTimeout))
+			{
+				expired.insert(m_Pending.extract(it++));
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	Apply(expired);
+}
+
+std::size_t DeferredEffectRuntime::GetPendingCount()
+{
+	std::scoped_lock<std::mutex> lock(m_PendingMutex);
+
+	return m_Pending.size();
+}
+
+void DeferredEffectRuntime::Apply(std::unordered_map<std::string, Pending>& pending)
+{
+	for (const auto& [effect, entry] : pending)
+	{
+		SPDLOG_DEBUG("Applying deferred enable of {}", effect);
+
+		// Through EnumerateTechniques so runtimes further down still see which effect this is
+		m_Runtime.EnumerateTechniques(effect.c_str(), [this, &entry](EffectTechnique technique)
+			{
+				if (std::find(entry.techniques.begin(), entry.techniques.end(), technique.handle) != entry.techniques.end())
+				{
+					m_Runtime.SetTechniqueState(technique, true);
+				}
+			});
+	}
+}
@@ -0,0 +1,108 @@
+#include "Core/DefinitionBatchRuntime.h"
+#include "Core/Config.h"
+
+#include <spdlog/spdlog.h>
+
+void DefinitionBatchRuntime::SetPreprocessorDefinition(const char* effectName, const char* name, const char* value)
+{
+	const bool current = m_Runtime.GetPreprocessorDefinition(effectName, name) == value;
+
+	std::scoped_lock<std::mutex> lock(m_PendingMutex);
+
+	if (current)
+	{
+		// Changed back before the batch went out, nothing left to do for it
+		if (const auto effect = m_Pending.find(effectName); effect != m_Pending.end())
+		{
+			effect->second.erase(name);
+			if (effect->second.empty())
+			{
+				m_Pending.erase(effect);
+			}
+		}
+		return;
+	}
+
+	if (m_Pending.empty())
+	{
+		m_Queued = Clock::now();
+	}
+	m_Pending[effectName][name] = value;
+	SPDLOG_DEBUG("Queued {} {}={}", effectName, name, value);
+}
+
+std::optional<std::string> DefinitionBatchRuntime::GetPreprocessorDefinition(const char* effectName, const char* name) const
+{
+	{
+		std::scoped_lock<std::mutex> lock(m_PendingMutex);
+
+		if (const auto effect = m_Pending.find(effectName); effect != m_Pending.end())
+		{
+			if (const auto it = effect->second.find(name); it != effect->second.end())
+			{
+				return it->second;
+			}
+		}
+	}
+
+	return m_Runtime.GetPreprocessorDefinition(effectName, name);
+}
+
+std::size_t DefinitionBatchRuntime::Flush()
+{
+	std::map<std::string, std::map<std::string, std::string>> pending;
+	{
+		std::scoped_lock<std::mutex> lock(m_PendingMutex);
+		pending.swap(m_Pending);
+		if (!pending.empty())
+		{
+			m_BatchCount++;
+		}
+	}
+
+	// One effect after the other, all of its definitions back to back
+	for (const auto& [effect, definitions] : pending)
+	{
+		for (const auto& [name, value] : definitions)
+		{
+			m_Runtime.SetPreprocessorDefinition(effect.c_str(), name.c_str(), value.c_str());
+		}
+	}
+
+	if (!pending.empty())
+	{
+		spdlog::info("Applied preprocessor definitions to {} effects", pending.size());
+	}
+	return pending.size();
+}
+
+void DefinitionBatchRuntime::Update(Clock::time_point now)
+{
+	{
+		std::scoped_lock<std::mutex> lock(m_PendingMutex);
+
+		if (m_Pending.empty())
+		{
+			return;
+		}
+
+		if (EnableDefinitions && (DefinitionBatchDelay <= 0 || now - m_Queued < std::chrono::seconds(DefinitionBatchDelay)))
+		{
+			return;
+		}
+	}
+
+	Flush();
+}
+
+std::size_t DefinitionBatchRuntime::GetPendingCount()
+{
+	std::scoped_lock<std::mutex> lock(m_PendingMutex);
+
+	std::size_t count = 0;
+	for (const auto& [effect, definitions] : m_Pending)
+	{
+		count += definitions.size();
+	}
+	return count;
+}
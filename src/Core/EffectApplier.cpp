@@ -0,0 +1,56 @@
+#include "Core/EffectApplier.h"
+
+#include <spdlog/spdlog.h>
+
+void EffectApplier::ApplyTechniqueState(IEffectRuntime& runtime, bool enableReshade, const TechniqueInfo& info, EffectGroups* groups)
+{
+	if (EffectGroups::IsGroup(info.filename))
+	{
+		if (groups != nullptr && (info.state == "off" || info.state == "on"))
+		{
+			groups->Apply(runtime, info.filename, info.state == "off" ? enableReshade : !enableReshade);
+		}
+		return;
+	}
+
+	runtime.EnumerateTechniques(info.filename.c_str(), [&runtime, &enableReshade, &info](EffectTechnique technique)
+		{
+			//SPDLOG_DEBUG("State: {} for: {}", info.state.c_str(), info.filename.c_str());
+			if (info.state == "off")
+			{
+				runtime.SetTechniqueState(technique, enableReshade);
+			}
+			else if (info.state == "on")
+			{
+				runtime.SetTechniqueState(technique, !enableReshade);
+			}
+		});
+}
+
+void EffectApplier::ApplyReshadeState(IEffectRuntime& runtime, bool enableReshade, const std::string& toggleState)
+{
+	//SPDLOG_DEBUG("All is enabled! - EnableReshade: {}", enableReshade);
+
+	if (toggleState == "off")
+	{
+		runtime.SetEffectsState(enableReshade);
+	}
+	else if (toggleState == "on")
+	{
+		runtime.SetEffectsState(!enableReshade);
+	}
+}
+
+void EffectApplier::EnumerateTechniques(IEffectRuntime& runtime, const std::string& target, EffectGroups* groups, const IEffectRuntime::TechniqueCallback& callback)
+{
+	if (EffectGroups::IsGroup(target))
+	{
+		if (groups != nullptr)
+		{
+			groups->Enumerate(runtime, target, callback);
+		}
+		return;
+	}
+
+	runtime.EnumerateTechniques(target.c_str(), callback);
+}
@@ -0,0 +1,259 @@
+#include "Core/EffectGroups.h"
+
+#include <algorithm>
+#include <bit>
+#include <spdlog/spdlog.h>
+
+namespace
+{
+	std::string_view Trim(std::string_view text)
+	{
+		const auto first = text.find_first_not_of(" \t");
+		if (first == std::string_view::npos)
+		{
+			return {};
+		}
+		return text.substr(first, text.find_last_not_of(" \t") - first + 1);
+	}
+}
+
+void EffectGroups::Build(IEffectRuntime& runtime, const std::vector<std::string>& effects, const std::vector<GroupInfo>& groups)
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	m_Effects.clear();
+	m_FirstTechnique.clear();
+	m_Groups.clear();
+
+	for (const GroupInfo& group : groups)
+	{
+		m_Groups.try_emplace(group.name);
+	}
+
+	// Numbers the techniques and picks up annotated members on the way
+	std::size_t techniqueCount = 0;
+	for (const std::string& effect : effects)
+	{
+		const std::size_t effectIndex = m_Effects.size();
+		m_Effects.push_back(effect);
+		m_FirstTechnique.push_back(techniqueCount);
+
+		runtime.EnumerateTechniques(effect.c_str(), [&](EffectTechnique technique)
+			{
+				const std::size_t id = techniqueCount++;
+				const auto annotation = runtime.GetTechniqueAnnotation(technique, "toggler_group");
+				if (!annotation)
+				{
+					return;
+				}
+
+				for (const std::string& name : ParseMembers(*annotation))
+				{
+					Group& group = m_Groups[name];
+					SetBit(group.techniques, id);
+					SetBit(group.effects, effectIndex);
+				}
+			});
+	}
+	m_FirstTechnique.push_back(techniqueCount);
+
+	for (const GroupInfo& info : groups)
+	{
+		Group& group = m_Groups[info.name];
+
+		for (const std::string& member : info.members)
+		{
+			const std::size_t colon = member.find(':');
+			const std::string effect = member.substr(0, colon);
+			const auto it = std::find(m_Effects.begin(), m_Effects.end(), effect);
+			if (it == m_Effects.end())
+			{
+				continue;
+			}
+
+			const std::size_t effectIndex = it - m_Effects.begin();
+			std::size_t id = m_FirstTechnique[effectIndex];
+			if (colon == std::string::npos)
+			{
+				for (; id < m_FirstTechnique[effectIndex + 1]; id++)
+				{
+					SetBit(group.techniques, id);
+				}
+				SetBit(group.effects, effectIndex);
+				continue;
+			}
+
+			// Names are only read for effects that list single techniques
+			const std::string_view technique = std::string_view(member).substr(colon + 1);
+			runtime.EnumerateTechniques(effect.c_str(), [&](EffectTechnique handle)
+				{
+					if (runtime.GetTechniqueName(handle) == technique)
+					{
+						SetBit(group.techniques, id);
+						SetBit(group.effects, effectIndex);
+					}
+					id++;
+				});
+		}
+	}
+
+	m_Revision++;
+	spdlog::info("Resolved {} groups over {} techniques", m_Groups.size(), techniqueCount);
+}
+
+std::size_t EffectGroups::Apply(IEffectRuntime& runtime, std::string_view name, bool enabled)
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	const Group* group = FindGroup(name);
+	if (group == nullptr)
+	{
+		return 0;
+	}
+
+	std::size_t count = 0;
+	EnumerateMembers(runtime, *group, [&](EffectTechnique technique)
+		{
+			runtime.SetTechniqueState(technique, enabled);
+			count++;
+		});
+	return count;
+}
+
+bool EffectGroups::IsEnabled(IEffectRuntime& runtime, std::string_view name)
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	const Group* group = FindGroup(name);
+	if (group == nullptr)
+	{
+		return false;
+	}
+
+	bool enabled = false;
+	EnumerateMembers(runtime, *group, [&](EffectTechnique technique)
+		{
+			enabled = enabled || runtime.GetTechniqueState(technique);
+		});
+	return enabled;
+}
+
+void EffectGroups::Enumerate(IEffectRuntime& runtime, std::string_view name, const IEffectRuntime::TechniqueCallback& callback)
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	if (const Group* group = FindGroup(name); group != nullptr)
+	{
+		EnumerateMembers(runtime, *group, callback);
+	}
+}
+
+void EffectGroups::EnumerateMembers(IEffectRuntime& runtime, const Group& group, const IEffectRuntime::TechniqueCallback& callback)
+{
+	// Whole words of effects without members are skipped at once
+	for (std::size_t word = 0; word < group.effects.size(); word++)
+	{
+		for (std::uint64_t bits = group.effects[word]; bits != 0; bits &= bits - 1)
+		{
+			const std::size_t effectIndex = word * 64 + std::countr_zero(bits);
+			std::size_t id = m_FirstTechnique[effectIndex];
+			const std::size_t end = m_FirstTechnique[effectIndex + 1];
+
+			runtime.EnumerateTechniques(m_Effects[effectIndex].c_str(), [&](EffectTechnique technique)
+				{
+					// A reload that added techniques is caught by the next Build
+					if (id < end && TestBit(group.techniques, id))
+					{
+						callback(technique);
+					}
+					id++;
+				});
+		}
+	}
+}
+
+const EffectGroups::Group* EffectGroups::FindGroup(std::string_view name) const
+{
+	if (IsGroup(name))
+	{
+		name.remove_prefix(1);
+	}
+
+	const auto it = m_Groups.find(std::string(name));
+	return it != m_Groups.end() ? &it->second : nullptr;
+}
+
+std::size_t EffectGroups::GetTechniqueCount()
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	return m_FirstTechnique.empty() ? 0 : m_FirstTechnique.back();
+}
+
+EffectGroups::Bits EffectGroups::GetTechniques(std::string_view name)
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	const Group* group = FindGroup(name);
+	return group != nullptr ? group->techniques : Bits();
+}
+
+std::vector<std::string> EffectGroups::GetGroupNames()
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	std::vector<std::string> names;
+	for (const auto& [name, group] : m_Groups)
+	{
+		names.push_back(name);
+	}
+	std::sort(names.begin(), names.end());
+	return names;
+}
+
+std::vector<std::string> EffectGroups::ParseMembers(std::string_view text)
+{
+	std::vector<std::string> members;
+
+	while (!text.empty())
+	{
+		const std::size_t comma = text.find(',');
+		const std::string_view member = Trim(text.substr(0, comma));
+		text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+
+		if (!member.empty())
+		{
+			members.emplace_back(member);
+		}
+	}
+
+	return members;
+}
+
+std::string EffectGroups::FormatMembers(const std::vector<std::string>& members)
+{
+	std::string text;
+	for (const std::string& member : members)
+	{
+		if (!text.empty())
+		{
+			text += ',';
+		}
+		text += member;
+	}
+	return text;
+}
+
+void EffectGroups::SetBit(Bits& bits, std::size_t index)
+{
+	if (bits.size() <= index / 64)
+	{
+		bits.resize(index / 64 + 1);
+	}
+	bits[index / 64] |= std::uint64_t{ 1 } << (index % 64);
+}
+
+bool EffectGroups::TestBit(const Bits& bits, std::size_t index)
+{
+	return index / 64 < bits.size() && (bits[index / 64] >> (index % 64) & 1) != 0;
+}
@@ -0,0 +1,31 @@
+#include "Core/EffectRuntime.h"
+
+namespace
+{
+	thread_local const char* s_CurrentEffect = nullptr;
+}
+
+void EffectRuntimeDecorator::EnumerateTechniques(const char* effectName, const TechniqueCallback& callback)
+{
+	m_Runtime.EnumerateTechniques(effectName, [effectName, &callback](EffectTechnique technique)
+		{
+			// Restored afterwards, decorators can be stacked and callbacks may enumerate again
+			const char* previous = s_CurrentEffect;
+			s_CurrentEffect = effectName;
+			callback(technique);
+			s_CurrentEffect = previous;
+		});
+}
+
+const char* EffectRuntimeDecorator::GetCurrentEffect()
+{
+	return s_CurrentEffect != nullptr ? s_CurrentEffect : "";
+}
+
+void EffectRuntimeDecorator::SetEffectTechniqueState(const char* effectName, EffectTechnique technique, bool enabled)
+{
+	const char* previous = s_CurrentEffect;
+	s_CurrentEffect = effectName;
+	m_Runtime.SetTechniqueState(technique, enabled);
+	s_CurrentEffect = previous;
+}
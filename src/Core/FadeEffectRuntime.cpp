@@ -0,0 +1,175 @@
+#include "Core/FadeEffectRuntime.h"
+#include "Core/Config.h"
+
+#include <algorithm>
+#include <cmath>
+#include <spdlog/spdlog.h>
+
+void FadeEffectRuntime::SetTechniqueState(EffectTechnique technique, bool enabled)
+{
+	const std::string_view effect = GetCurrentEffect();
+
+	// Held for the whole call, info points into fadeInfoList
+	std::unique_lock<std::mutex> fadesLock(timeMutexFades, std::defer_lock);
+	const FadeInfo* info = nullptr;
+	if (EnableFades)
+	{
+		fadesLock.lock();
+
+		const auto it = std::find_if(fadeInfoList.begin(), fadeInfoList.end(), [effect](const FadeInfo& fadeInfo) { return fadeInfo.filename == effect; });
+		if (it != fadeInfoList.end() && !it->uniform.empty())
+		{
+			info = &*it;
+		}
+	}
+
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	Fade* fade = FindFade(technique);
+	const auto now = Clock::now();
+	const float target = enabled ? static_cast<float>(info ? info->maxValue : 0.0) : 0.0f;
+	float level = 0.0f;
+
+	if (fade != nullptr && info)
+	{
+		// Already on its way there, otherwise turn around from where it is
+		if (fade->disable == !enabled)
+		{
+			return;
+		}
+		level = GetLevel(*fade, now);
+	}
+	else
+	{
+		if (fade != nullptr)
+		{
+			// Fades got turned off mid ramp
+			fade->active = false;
+		}
+
+		const bool on = m_Runtime.GetTechniqueState(technique);
+		if (!info || on == enabled)
+		{
+			m_Runtime.SetTechniqueState(technique, enabled);
+			return;
+		}
+
+		auto cached = m_Uniforms.find(effect);
+		if (cached == m_Uniforms.end() || cached->second.name != info->uniform)
+		{
+			const std::string effectName(effect);
+			cached = m_Uniforms.insert_or_assign(effectName, CachedUniform{ info->uniform, m_Runtime.FindUniformVariable(effectName.c_str(), info->uniform.c_str()) }).first;
+			if (cached->second.uniform.handle == 0)
+			{
+				spdlog::info("Fade uniform {} not found in {}, toggling it hard", info->uniform, effect);
+			}
+		}
+
+		fade = FindFreeFade();
+		if (cached->second.uniform.handle == 0 || fade == nullptr)
+		{
+			m_Runtime.SetTechniqueState(technique, enabled);
+			return;
+		}
+
+		fade->technique = technique;
+		fade->effect = cached->first.c_str();
+		fade->uniform = cached->second.uniform;
+		level = enabled ? 0.0f : static_cast<float>(info->maxValue);
+	}
+
+	// A reversed fade only takes as long as the part it has to undo
+	const double maxValue = info->maxValue != 0.0 ? std::abs(info->maxValue) : 1.0;
+	const double fraction = std::min(std::abs(target - level) / maxValue, 1.0);
+
+	fade->active = true;
+	fade->from = level;
+	fade->to = target;
+	fade->start = now;
+	fade->duration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(info->duration * fraction));
+	fade->disable = !enabled;
+
+	if (enabled)
+	{
+		m_Runtime.SetUniformValueFloat(fade->uniform, &level, 1);
+		m_Runtime.SetTechniqueState(technique, true);
+	}
+}
+
+void FadeEffectRuntime::Update(Clock::time_point now)
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	for (Fade& fade : m_Fades)
+	{
+		if (!fade.active)
+		{
+			continue;
+		}
+
+		const float level = GetLevel(fade, now);
+		m_Runtime.SetUniformValueFloat(fade.uniform, &level, 1);
+
+		if (now - fade.start >= fade.duration)
+		{
+			if (fade.disable)
+			{
+				SetEffectTechniqueState(fade.effect, fade.technique, false);
+			}
+			fade.active = false;
+		}
+	}
+}
+
+void FadeEffectRuntime::Reset()
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	for (Fade& fade : m_Fades)
+	{
+		fade.active = false;
+	}
+	m_Uniforms.clear();
+}
+
+std::size_t FadeEffectRuntime::GetActiveCount()
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	return std::count_if(m_Fades.begin(), m_Fades.end(), [](const Fade& fade) { return fade.active; });
+}
+
+float FadeEffectRuntime::GetLevel(const Fade& fade, Clock::time_point now)
+{
+	if (fade.duration <= Clock::duration::zero())
+	{
+		return fade.to;
+	}
+
+	const double progress = std::clamp(std::chrono::duration<double>(now - fade.start) / fade.duration, 0.0, 1.0);
+	return fade.from + (fade.to - fade.from) * static_cast<float>(progress);
+}
+
+FadeEffectRuntime::Fade* FadeEffectRuntime::FindFade(EffectTechnique technique)
+{
+	for (Fade& fade : m_Fades)
+	{
+		if (fade.active && fade.technique.handle == technique.handle)
+		{
+			return &fade;
+		}
+	}
+	return nullptr;
+}
+
+FadeEffectRuntime::Fade* FadeEffectRuntime::FindFreeFade()
+{
+	for (Fade& fade : m_Fades)
+	{
+		if (!fade.active)
+		{
+			return &fade;
+		}
+	}
+	return nullptr;
+}
@@ -0,0 +1,145 @@
+#include "Core/FrameStats.h"
+
+#include <algorithm>
+#include <cmath>
+
+std::uint64_t FrameTimeRing::CopyLatest(std::size_t count, std::vector<float>& out) const
+{
+	const std::uint64_t total = GetCount();
+	const std::uint64_t copied = std::min<std::uint64_t>({ count, total, kCapacity });
+	const std::uint64_t first = total - copied;
+
+	out.clear();
+	out.reserve(copied);
+	for (std::uint64_t frame = first; frame < total; frame++)
+	{
+		out.push_back(m_Samples[frame % kCapacity].load(std::memory_order_relaxed));
+	}
+
+	return first;
+}
+
+std::optional<float> FrameStats::OnPresent(std::chrono::steady_clock::time_point now)
+{
+	std::optional<float> frameTime;
+	if (m_LastPresent != std::chrono::steady_clock::time_point())
+	{
+		frameTime = std::chrono::duration<float, std::milli>(now - m_LastPresent).count();
+		RecordFrameTime(*frameTime);
+	}
+	m_LastPresent = now;
+	return frameTime;
+}
+
+void FrameStats::RecordChange(std::string effect, bool enabled)
+{
+	std::scoped_lock<std::mutex> lock(m_ChangesMutex);
+
+	if (m_Changes.size() >= kMaxChanges)
+	{
+		m_Changes.erase(m_Changes.begin(), m_Changes.begin() + kMaxChanges / 2);
+	}
+	m_Changes.push_back(TechniqueChange{ m_Frames.GetCount(), std::move(effect), enabled });
+}
+
+FrameStats::Window FrameStats::GetWindow(std::size_t frameCount) const
+{
+	std::vector<float> samples;
+	const std::uint64_t firstFrame = m_Frames.CopyLatest(frameCount, samples);
+	return MakeWindow(firstFrame, std::move(samples));
+}
+
+std::vector<FrameStats::Window> FrameStats::GetWindows(std::size_t frameCount) const
+{
+	std::vector<Window> windows;
+	if (frameCount == 0)
+	{
+		return windows;
+	}
+
+	std::vector<float> samples;
+	const std::uint64_t firstFrame = m_Frames.CopyLatest(FrameTimeRing::kCapacity, samples);
+
+	for (std::size_t offset = 0; offset < samples.size(); offset += frameCount)
+	{
+		const std::size_t end = std::min(offset + frameCount, samples.size());
+		windows.push_back(MakeWindow(firstFrame + offset, std::vector<float>(samples.begin() + offset, samples.begin() + end)));
+	}
+
+	return windows;
+}
+
+FrameStats::Window FrameStats::MakeWindow(std::uint64_t firstFrame, std::vector<float> samples) const
+{
+	Window window;
+	window.firstFrame = firstFrame;
+	window.frames = samples.size();
+	window.p50 = Percentile(samples, 50.0f);
+	window.p95 = Percentile(samples, 95.0f);
+	window.p99 = Percentile(samples, 99.0f);
+
+	std::scoped_lock<std::mutex> lock(m_ChangesMutex);
+
+	for (const TechniqueChange& change : m_Changes)
+	{
+		if (change.frame >= firstFrame && change.frame < firstFrame + window.frames)
+		{
+			window.changes.push_back(change);
+		}
+	}
+
+	return window;
+}
+
+float FrameStats::Percentile(std::vector<float>& samples, float percentile)
+{
+	if (samples.empty())
+	{
+		return 0.0f;
+	}
+
+	const auto rank = static_cast<std::size_t>(std::ceil(percentile / 100.0f * static_cast<float>(samples.size())));
+	const auto nth = samples.begin() + (rank > 0 ? rank - 1 : 0);
+	std::nth_element(samples.begin(), nth, samples.end());
+	return *nth;
+}
+
+void FrameStatsEffectRuntime::SetEffectsState(bool enabled)
+{
+	m_Runtime.SetEffectsState(enabled);
+
+	std::scoped_lock<std::mutex> lock(m_StateMutex);
+
+	if (m_EffectsState != static_cast<int>(enabled))
+	{
+		m_EffectsState = enabled;
+		m_Stats.RecordChange("", enabled);
+	}
+}
+
+void FrameStatsEffectRuntime::SetTechniqueState(EffectTechnique technique, bool enabled)
+{
+	std::scoped_lock<std::mutex> lock(m_StateMutex);
+
+	// Seeded from the runtime the first time, so only real transitions count
+	auto [it, inserted] = m_TechniqueStates.try_emplace(technique.handle, false);
+	if (inserted)
+	{
+		it->second = m_Runtime.GetTechniqueState(technique);
+	}
+
+	m_Runtime.SetTechniqueState(technique, enabled);
+
+	if (it->second != enabled)
+	{
+		it->second = enabled;
+		m_Stats.RecordChange(GetCurrentEffect(), enabled);
+	}
+}
+
+void FrameStatsEffectRuntime::Reset()
+{
+	std::scoped_lock<std::mutex> lock(m_StateMutex);
+
+	m_TechniqueStates.clear();
+}
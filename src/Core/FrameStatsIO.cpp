@@ -0,0 +1,52 @@
+#include "Core/FrameStats.h"
+
+#include <exception>
+#include <rapidcsv.h>
+#include <spdlog/spdlog.h>
+
+bool FrameStats::SaveCSV(const std::string& path, std::size_t frameCount) const
+{
+	const std::vector<Window> windows = GetWindows(frameCount);
+
+	rapidcsv::Document csv("", rapidcsv::LabelParams(0, -1));
+	const char* columns[] = { "FirstFrame", "Frames", "P50", "P95", "P99", "Changes" };
+	for (std::size_t column = 0; column < std::size(columns); column++)
+	{
+		csv.SetColumnName(column, columns[column]);
+	}
+
+	for (std::size_t row = 0; row < windows.size(); row++)
+	{
+		const Window& window = windows[row];
+
+		std::string changes;
+		for (const TechniqueChange& change : window.changes)
+		{
+			if (!changes.empty())
+			{
+				changes += ';';
+			}
+			changes += change.effect.empty() ? "All" : change.effect;
+			changes += change.enabled ? "=on" : "=off";
+		}
+
+		csv.SetCell<std::uint64_t>(0, row, window.firstFrame);
+		csv.SetCell<std::size_t>(1, row, window.frames);
+		csv.SetCell<float>(2, row, window.p50);
+		csv.SetCell<float>(3, row, window.p95);
+		csv.SetCell<float>(4, row, window.p99);
+		csv.SetCell<std::string>(5, row, changes);
+	}
+
+	try
+	{
+		csv.Save(path);
+	}
+	catch (const std::exception& e)
+	{
+		spdlog::info("Failed to write frame stats to {}: {}", path, e.what());
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,108 @@
+#include "Core/GameUniformFeed.h"
+
+#include <spdlog/spdlog.h>
+
+std::size_t GameUniformFeed::Update(IEffectRuntime& runtime, const IGameStateProvider& gameState)
+{
+	if (!m_Discovered)
+	{
+		Discover(runtime);
+	}
+
+	std::array<float, kSourceCount> values{};
+	values[static_cast<std::size_t>(GameUniformSource::kHour)] = gameState.GetHour();
+	values[static_cast<std::size_t>(GameUniformSource::kInterior)] = gameState.GetCellType() == CellType::kInterior ? 1.0f : 0.0f;
+	values[static_cast<std::size_t>(GameUniformSource::kWeatherFlags)] = static_cast<float>(gameState.GetWeatherFlags().value_or(0));
+	values[static_cast<std::size_t>(GameUniformSource::kWeatherTransition)] = gameState.GetWeatherTransition();
+	values[static_cast<std::size_t>(GameUniformSource::kMenuOpen)] = gameState.IsMenuOpen() ? 1.0f : 0.0f;
+
+	std::size_t written = 0;
+	for (std::size_t source = 0; source < kSourceCount; source++)
+	{
+		if (m_Uniforms[source].empty() || m_Written[source] == values[source])
+		{
+			continue;
+		}
+
+		// ReShade converts to the declared type, so ints and bools can take the float as well
+		for (const EffectUniform uniform : m_Uniforms[source])
+		{
+			runtime.SetUniformValueFloat(uniform, &values[source], 1);
+		}
+		m_Written[source] = values[source];
+		written += m_Uniforms[source].size();
+	}
+
+	m_WriteCount += written;
+	return written;
+}
+
+void GameUniformFeed::Reset()
+{
+	m_Discovered = false;
+	for (auto& uniforms : m_Uniforms)
+	{
+		uniforms.clear();
+	}
+	m_Written.fill(std::nullopt);
+}
+
+std::size_t GameUniformFeed::GetUniformCount() const
+{
+	std::size_t count = 0;
+	for (const auto& uniforms : m_Uniforms)
+	{
+		count += uniforms.size();
+	}
+	return count;
+}
+
+const char* GameUniformFeed::GetSourceName(GameUniformSource source)
+{
+	switch (source)
+	{
+	case GameUniformSource::kHour:
+		return "toggler_hour";
+	case GameUniformSource::kInterior:
+		return "toggler_interior";
+	case GameUniformSource::kWeatherFlags:
+		return "toggler_weather";
+	case GameUniformSource::kWeatherTransition:
+		return "toggler_weather_transition";
+	case GameUniformSource::kMenuOpen:
+		return "toggler_menu_open";
+	case GameUniformSource::kCount:
+		break;
+	}
+	return "";
+}
+
+std::optional<GameUniformSource> GameUniformFeed::ParseSource(std::string_view name)
+{
+	for (std::size_t source = 0; source < kSourceCount; source++)
+	{
+		if (name == GetSourceName(static_cast<GameUniformSource>(source)))
+		{
+			return static_cast<GameUniformSource>(source);
+		}
+	}
+	return std::nullopt;
+}
+
+void GameUniformFeed::Discover(IEffectRuntime& runtime)
+{
+	// ReShade's own sources like "timer" share the annotation, those just don't parse
+	runtime.EnumerateUniformVariables(nullptr, [this, &runtime](EffectUniform uniform)
+		{
+			if (const auto annotation = runtime.GetUniformAnnotation(uniform, "source"))
+			{
+				if (const auto source = ParseSource(*annotation))
+				{
+					m_Uniforms[static_cast<std::size_t>(*source)].push_back(uniform);
+				}
+			}
+		});
+
+	m_Discovered = true;
+	spdlog::info("Found {} game state uniforms", GetUniformCount());
+}
@@ -0,0 +1,336 @@
+#include "Core/Hotkeys.h"
+
+#include "Core/EffectApplier.h"
+
+#include <array>
+#include <cctype>
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+#include <utility>
+
+namespace
+{
+	// Windows virtual key codes of the modifiers
+	constexpr std::uint32_t kKeyShift = 0x10;
+	constexpr std::uint32_t kKeyCtrl = 0x11;
+	constexpr std::uint32_t kKeyAlt = 0x12;
+
+	// Named keys besides letters, digits and F1 to F24
+	constexpr std::array<std::pair<std::string_view, std::uint32_t>, 19> kKeyNames = { {
+		{ "Backspace", 0x08 },
+		{ "Tab", 0x09 },
+		{ "Enter", 0x0D },
+		{ "Pause", 0x13 },
+		{ "Space", 0x20 },
+		{ "PageUp", 0x21 },
+		{ "PageDown", 0x22 },
+		{ "End", 0x23 },
+		{ "Home", 0x24 },
+		{ "Left", 0x25 },
+		{ "Up", 0x26 },
+		{ "Right", 0x27 },
+		{ "Down", 0x28 },
+		{ "Insert", 0x2D },
+		{ "Delete", 0x2E },
+		{ "Multiply", 0x6A },
+		{ "Add", 0x6B },
+		{ "Subtract", 0x6D },
+		{ "ScrollLock", 0x91 },
+	} };
+
+	bool EqualsNoCase(std::string_view a, std::string_view b)
+	{
+		if (a.size() != b.size())
+		{
+			return false;
+		}
+		for (std::size_t i = 0; i < a.size(); i++)
+		{
+			if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i])))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	std::string_view Trim(std::string_view text)
+	{
+		while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front())))
+		{
+			text.remove_prefix(1);
+		}
+		while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back())))
+		{
+			text.remove_suffix(1);
+		}
+		return text;
+	}
+
+	// Number after the prefix, eg. 10 for "F10" with prefix "F"
+	std::optional<std::uint32_t> ParseNumbered(std::string_view text, std::string_view prefix)
+	{
+		if (text.size() <= prefix.size() || !EqualsNoCase(text.substr(0, prefix.size()), prefix))
+		{
+			return std::nullopt;
+		}
+
+		std::uint32_t number = 0;
+		for (const char c : text.substr(prefix.size()))
+		{
+			if (!std::isdigit(static_cast<unsigned char>(c)) || number > 100)
+			{
+				return std::nullopt;
+			}
+			number = number * 10 + (c - '0');
+		}
+		return number;
+	}
+
+	std::optional<std::uint32_t> ParseKeycode(std::string_view name)
+	{
+		if (name.size() == 1)
+		{
+			const char c = static_cast<char>(std::toupper(static_cast<unsigned char>(name[0])));
+			if ((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))
+			{
+				return static_cast<std::uint32_t>(c); // Same as their virtual key codes
+			}
+			return std::nullopt;
+		}
+
+		if (const auto number = ParseNumbered(name, "Numpad"); number && *number <= 9)
+		{
+			return 0x60 + *number;
+		}
+		if (const auto number = ParseNumbered(name, "F"); number && *number >= 1 && *number <= 24)
+		{
+			return 0x70 + *number - 1;
+		}
+
+		for (const auto& [keyName, keycode] : kKeyNames)
+		{
+			if (EqualsNoCase(name, keyName))
+			{
+				return keycode;
+			}
+		}
+		return std::nullopt;
+	}
+}
+
+void Hotkeys::Compile(const std::vector<HotkeyInfo>& hotkeys)
+{
+	m_Bindings.clear();
+	m_Targets.clear();
+	m_Invalid.clear();
+
+	for (std::size_t i = 0; i < hotkeys.size(); i++)
+	{
+		const HotkeyInfo& info = hotkeys[i];
+		const std::optional<Key> key = ParseKey(info.key);
+		const std::optional<Action> action = ParseAction(info.action);
+		if (!key || !action)
+		{
+			m_Invalid.push_back(i);
+			continue;
+		}
+
+		Binding binding;
+		binding.key = *key;
+		binding.action = *action;
+		binding.first = static_cast<std::uint32_t>(m_Targets.size());
+
+		// Toggles take the whole target, preset lists are split on commas
+		std::string_view targets = info.target;
+		while (*action != Action::kSuspend && !targets.empty())
+		{
+			const std::size_t comma = *action == Action::kCyclePreset ? targets.find(',') : std::string_view::npos;
+			const std::string_view target = Trim(targets.substr(0, comma));
+			targets = comma == std::string_view::npos ? std::string_view() : targets.substr(comma + 1);
+
+			if (!target.empty())
+			{
+				m_Targets.emplace_back(target);
+			}
+		}
+		binding.count = static_cast<std::uint32_t>(m_Targets.size()) - binding.first;
+
+		if (*action != Action::kSuspend && binding.count == 0)
+		{
+			m_Invalid.push_back(i);
+			continue;
+		}
+		m_Bindings.push_back(binding);
+	}
+}
+
+bool Hotkeys::Poll(IEffectRuntime& runtime, EffectGroups* groups, PresetSwitcher& presets)
+{
+	std::optional<std::uint8_t> modifiers; // Read once a key went down
+	bool suspend = false;
+
+	for (Binding& binding : m_Bindings)
+	{
+		if (!runtime.IsKeyPressed(binding.key.keycode))
+		{
+			continue;
+		}
+
+		if (!modifiers)
+		{
+			modifiers = static_cast<std::uint8_t>((runtime.IsKeyDown(kKeyCtrl) ? kCtrl : 0) | (runtime.IsKeyDown(kKeyShift) ? kShift : 0) | (runtime.IsKeyDown(kKeyAlt) ? kAlt : 0));
+		}
+		if (*modifiers != binding.key.modifiers)
+		{
+			continue;
+		}
+
+		if (binding.action == Action::kSuspend)
+		{
+			suspend = true;
+			continue;
+		}
+		Fire(binding, runtime, groups, presets);
+	}
+
+	return suspend;
+}
+
+void Hotkeys::Fire(Binding& binding, IEffectRuntime& runtime, EffectGroups* groups, PresetSwitcher& presets)
+{
+	switch (binding.action)
+	{
+	case Action::kToggle:
+	{
+		const std::string& target = m_Targets[binding.first];
+
+		// Read back rather than remembered, rules and the overlay change it too
+		bool enabled = false;
+		if (EffectGroups::IsGroup(target))
+		{
+			enabled = groups != nullptr && groups->IsEnabled(runtime, target);
+		}
+		else
+		{
+			runtime.EnumerateTechniques(target.c_str(), [&](EffectTechnique technique)
+				{
+					enabled = enabled || runtime.GetTechniqueState(technique);
+				});
+		}
+		SPDLOG_DEBUG("Hotkey {} turns {} {}", FormatKey(binding.key), target, enabled ? "off" : "on");
+
+		TechniqueInfo info;
+		info.filename = target;
+		info.state = "on";
+		EffectApplier::ApplyTechniqueState(runtime, enabled, info, groups);
+		break;
+	}
+	case Action::kCyclePreset:
+	{
+		const std::string& preset = m_Targets[binding.first + binding.next];
+		binding.next = (binding.next + 1) % binding.count;
+		SPDLOG_DEBUG("Hotkey {} switches to {}", FormatKey(binding.key), preset);
+
+		// Whoever pressed the key expects it now, not at the next loading screen
+		presets.RequestNow(preset);
+		break;
+	}
+	case Action::kSuspend:
+		break;
+	}
+}
+
+std::optional<Hotkeys::Key> Hotkeys::ParseKey(std::string_view text)
+{
+	Key key;
+
+	while (true)
+	{
+		const std::size_t plus = text.find('+');
+		const std::string_view part = Trim(text.substr(0, plus));
+		if (plus == std::string_view::npos)
+		{
+			const std::optional<std::uint32_t> keycode = ParseKeycode(part);
+			if (!keycode)
+			{
+				return std::nullopt;
+			}
+			key.keycode = *keycode;
+			return key;
+		}
+		text.remove_prefix(plus + 1);
+
+		if (EqualsNoCase(part, "Ctrl"))
+		{
+			key.modifiers |= kCtrl;
+		}
+		else if (EqualsNoCase(part, "Shift"))
+		{
+			key.modifiers |= kShift;
+		}
+		else if (EqualsNoCase(part, "Alt"))
+		{
+			key.modifiers |= kAlt;
+		}
+		else
+		{
+			return std::nullopt;
+		}
+	}
+}
+
+std::string Hotkeys::FormatKey(Key key)
+{
+	std::string text;
+	if (key.modifiers & kCtrl)
+	{
+		text += "Ctrl+";
+	}
+	if (key.modifiers & kShift)
+	{
+		text += "Shift+";
+	}
+	if (key.modifiers & kAlt)
+	{
+		text += "Alt+";
+	}
+
+	if ((key.keycode >= 'A' && key.keycode <= 'Z') || (key.keycode >= '0' && key.keycode <= '9'))
+	{
+		return text + static_cast<char>(key.keycode);
+	}
+	if (key.keycode >= 0x60 && key.keycode <= 0x69)
+	{
+		return text + fmt::format("Numpad{}", key.keycode - 0x60);
+	}
+	if (key.keycode >= 0x70 && key.keycode <= 0x87)
+	{
+		return text + fmt::format("F{}", key.keycode - 0x70 + 1);
+	}
+	for (const auto& [keyName, keycode] : kKeyNames)
+	{
+		if (keycode == key.keycode)
+		{
+			return text + std::string(keyName);
+		}
+	}
+	return text + fmt::format("{:#x}", key.keycode);
+}
+
+std::optional<Hotkeys::Action> Hotkeys::ParseAction(std::string_view action)
+{
+	if (action == "Toggle")
+	{
+		return Action::kToggle;
+	}
+	if (action == "CyclePreset")
+	{
+		return Action::kCyclePreset;
+	}
+	if (action == "Suspend")
+	{
+		return Action::kSuspend;
+	}
+	return std::nullopt;
+}
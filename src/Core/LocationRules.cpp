@@ -0,0 +1,121 @@
+#include "Core/LocationRules.h"
+
+#include <charconv>
+
+namespace
+{
+	std::optional<std::uint32_t> ParseFormID(std::string_view name)
+	{
+		if (name.size() < 3 || name[0] != '0' || (name[1] != 'x' && name[1] != 'X'))
+		{
+			return std::nullopt;
+		}
+
+		std::uint32_t formID = 0;
+		const char* end = name.data() + name.size();
+		const auto [ptr, error] = std::from_chars(name.data() + 2, end, formID, 16);
+		if (error != std::errc() || ptr != end)
+		{
+			return std::nullopt;
+		}
+		return formID;
+	}
+}
+
+void LocationRules::Compile(const std::vector<LocationInfo>& rules, const Resolver& resolve)
+{
+	for (Index& index : m_Index)
+	{
+		index.clear();
+	}
+	m_Unresolved.clear();
+	m_RuleCount = rules.size();
+
+	for (std::size_t i = 0; i < rules.size(); i++)
+	{
+		const std::optional<Type> type = ParseType(rules[i].type);
+		std::uint32_t formID = 0;
+		if (const std::optional<std::uint32_t> parsed = ParseFormID(rules[i].name))
+		{
+			formID = *parsed;
+		}
+		else if (!rules[i].name.empty() && resolve)
+		{
+			formID = resolve(rules[i].name);
+		}
+
+		if (!type || formID == 0)
+		{
+			m_Unresolved.push_back(i);
+			continue;
+		}
+		m_Index[static_cast<std::size_t>(*type)][formID].push_back(static_cast<std::uint32_t>(i));
+	}
+
+	m_Active.assign(m_RuleCount, 0);
+	m_Valid = false;
+}
+
+const std::vector<std::size_t>& LocationRules::Update(const LocationSnapshot& location)
+{
+	m_Changed.clear();
+
+	// Cell changes inside the same location are the common case
+	if (m_Valid && location == m_Last)
+	{
+		return m_Changed;
+	}
+
+	m_Next.assign(m_RuleCount, 0);
+	Mark(Type::kWorldspace, location.worldspace);
+	for (const std::uint32_t formID : location.locations)
+	{
+		Mark(Type::kLocation, formID);
+	}
+	for (const std::uint32_t formID : location.keywords)
+	{
+		Mark(Type::kKeyword, formID);
+	}
+
+	for (std::size_t i = 0; i < m_RuleCount; i++)
+	{
+		if (!m_Valid || m_Active[i] != m_Next[i])
+		{
+			m_Changed.push_back(i);
+		}
+	}
+
+	m_Active.swap(m_Next);
+	m_Last = location;
+	m_Valid = true;
+	return m_Changed;
+}
+
+void LocationRules::Mark(Type type, std::uint32_t formID)
+{
+	const Index& index = m_Index[static_cast<std::size_t>(type)];
+	if (const auto it = index.find(formID); it != index.end())
+	{
+		for (const std::uint32_t rule : it->second)
+		{
+			m_Next[rule] = 1;
+		}
+	}
+}
+
+std::optional<LocationRules::Type> LocationRules::ParseType(std::string_view type)
+{
+	if (type == "Worldspace")
+	{
+		return Type::kWorldspace;
+	}
+	if (type == "Location")
+	{
+		return Type::kLocation;
+	}
+	if (type == "Keyword")
+	{
+		return Type::kKeyword;
+	}
+	return std::nullopt;
+}
@@ -0,0 +1,60 @@
+#include "Core/PerformanceGovernor.h"
+#include "Core/FrameStats.h"
+
+#include <algorithm>
+
+PerformanceGovernor::Action PerformanceGovernor::AddFrame(float frameTime)
+{
+	m_Window.push_back(frameTime);
+	if (m_Window.size() < std::max<std::size_t>(m_Settings.windowFrames, 1))
+	{
+		return Action::kNone;
+	}
+
+	m_LastFrameTime = FrameStats::Percentile(m_Window, 95.0f);
+	m_Window.clear();
+
+	return Decide(m_LastFrameTime);
+}
+
+PerformanceGovernor::Action PerformanceGovernor::Decide(float frameTime)
+{
+	if (m_BeforeShed >= 0.0f)
+	{
+		m_Costs.back() = std::max(m_BeforeShed - frameTime, 0.0f);
+		m_BeforeShed = -1.0f;
+	}
+
+	if (m_Costs.size() > m_LevelCount)
+	{
+		m_Costs.pop_back();
+		return Action::kRestore;
+	}
+
+	if (frameTime > m_Settings.targetFrameTime)
+	{
+		if (m_Costs.size() < m_LevelCount)
+		{
+			m_Costs.push_back(0.0f);
+			m_BeforeShed = frameTime;
+			return Action::kShed;
+		}
+		return Action::kNone;
+	}
+
+	if (!m_Costs.empty() && frameTime + m_Costs.back() <= m_Settings.targetFrameTime * (1.0f - m_Settings.headroom))
+	{
+		m_Costs.pop_back();
+		return Action::kRestore;
+	}
+
+	return Action::kNone;
+}
+
+void PerformanceGovernor::Reset()
+{
+	m_Window.clear();
+	m_Costs.clear();
+	m_BeforeShed = -1.0f;
+	m_LastFrameTime = 0.0f;
+}
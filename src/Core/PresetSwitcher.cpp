@@ -0,0 +1,127 @@
+#include "Core/PresetSwitcher.h"
+#include "Core/Config.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <spdlog/spdlog.h>
+
+void PresetSwitcher::Request(const std::string& path)
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	if (path == m_Target)
+	{
+		return;
+	}
+
+	m_Target = path;
+	m_NormalTarget = Normalize(path);
+	m_Requested = Clock::now();
+	m_Manual = false;
+	SPDLOG_DEBUG("Rules ask for ReShade preset {}", path);
+}
+
+void PresetSwitcher::RequestNow(const std::string& path)
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	m_Target = path;
+	m_NormalTarget = Normalize(path);
+	m_Requested = Clock::now();
+	m_Manual = true;
+	m_Flush = IsPending();
+	SPDLOG_DEBUG("ReShade preset {} asked for outside of the rules", path);
+}
+
+void PresetSwitcher::Flush()
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	m_Flush = IsPending();
+}
+
+void PresetSwitcher::Update(IEffectRuntime& runtime, Clock::time_point now)
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	if (m_Measuring)
+	{
+		m_LastLatency = std::chrono::duration<double, std::milli>(now - *m_Measuring).count();
+		m_MaxLatency = std::max(m_MaxLatency, m_LastLatency);
+		m_TotalLatency += m_LastLatency;
+		m_Measuring.reset();
+		spdlog::info("ReShade preset switch took {:.1f} ms", m_LastLatency);
+	}
+
+	if ((!EnableReshadePresets && !m_Manual) || !IsPending())
+	{
+		m_Flush = false;
+		return;
+	}
+
+	if (!m_Flush)
+	{
+		if (PresetSwitchTimeout <= 0 || now - m_Requested < std::chrono::seconds(PresetSwitchTimeout))
+		{
+			return;
+		}
+		if (m_LastSwitch && now - *m_LastSwitch < std::chrono::seconds(PresetSwitchInterval))
+		{
+			return;
+		}
+	}
+
+	Switch(runtime, now);
+}
+
+std::string PresetSwitcher::GetPending()
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	return IsPending() ? m_Target : std::string();
+}
+
+bool PresetSwitcher::IsSamePreset(std::string_view a, std::string_view b)
+{
+	return Normalize(a) == Normalize(b);
+}
+
+std::string PresetSwitcher::Normalize(std::string_view path)
+{
+	if (path.empty())
+	{
+		return std::string();
+	}
+
+	std::error_code error;
+	std::string normal = std::filesystem::absolute(std::filesystem::path(path), error).lexically_normal().generic_string();
+	std::transform(normal.begin(), normal.end(), normal.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	return normal;
+}
+
+bool PresetSwitcher::IsPending() const
+{
+	return !m_NormalTarget.empty() && m_NormalTarget != m_NormalActive;
+}
+
+void PresetSwitcher::Switch(IEffectRuntime& runtime, Clock::time_point now)
+{
+	m_Flush = false;
+
+	// Already there, eg. on the first request after startup
+	if (Normalize(runtime.GetCurrentPresetPath()) == m_NormalTarget)
+	{
+		m_NormalActive = m_NormalTarget;
+		return;
+	}
+
+	m_LastWait = std::chrono::duration<double>(now - m_Requested).count();
+	spdlog::info("Switching ReShade preset to {} after {:.0f} s", m_Target, m_LastWait);
+
+	runtime.SetCurrentPresetPath(m_Target.c_str());
+	m_NormalActive = m_NormalTarget;
+	m_LastSwitch = now;
+	m_Measuring = now;
+	m_SwitchCount++;
+}
@@ -0,0 +1,97 @@
+#include "Core/Replay.h"
+#include "Core/RuleEngine.h"
+
+void ReplayEffectRuntime::SetEffectsState(bool enabled)
+{
+	m_CallCount++;
+	if (m_Logging)
+	{
+		m_Calls.push_back(Call{ m_Time, "", enabled });
+	}
+}
+
+void ReplayEffectRuntime::EnumerateTechniques(const char* effectName, const TechniqueCallback& callback)
+{
+	auto [it, inserted] = m_Handles.try_emplace(effectName, m_Effects.size());
+	if (inserted)
+	{
+		m_Effects.emplace_back(effectName);
+		m_States.push_back(true);
+	}
+	callback(EffectTechnique{ it->second });
+}
+
+void ReplayEffectRuntime::SetTechniqueState(EffectTechnique technique, bool enabled)
+{
+	m_States[technique.handle] = enabled;
+	m_CallCount++;
+	if (m_Logging)
+	{
+		m_Calls.push_back(Call{ m_Time, m_Effects[technique.handle], enabled });
+	}
+}
+
+void ReplayEffectRuntime::SetPreprocessorDefinition(const char* effectName, const char* name, const char* value)
+{
+	m_Definitions[std::string(effectName) + ':' + name] = value;
+}
+
+std::optional<std::string> ReplayEffectRuntime::GetPreprocessorDefinition(const char* effectName, const char* name) const
+{
+	if (const auto it = m_Definitions.find(std::string(effectName) + ':' + name); it != m_Definitions.end())
+	{
+		return it->second;
+	}
+	return std::nullopt;
+}
+
+EffectUniform ReplayEffectRuntime::FindUniformVariable(const char* effectName, const char* variableName) const
+{
+	const auto [it, inserted] = m_Uniforms.try_emplace(std::string(effectName) + ':' + variableName, m_Uniforms.size() + 1);
+	return EffectUniform{ it->second };
+}
+
+void ReplayEffectRuntime::EnumerateUniformVariables(const char* effectName, const UniformCallback& callback)
+{
+	const std::string prefix = effectName != nullptr ? std::string(effectName) + ':' : std::string();
+	for (const auto& [name, handle] : m_Uniforms)
+	{
+		if (name.starts_with(prefix))
+		{
+			callback(EffectUniform{ handle });
+		}
+	}
+}
+
+std::size_t TimelineReplayer::Replay(const Timeline& timeline, ReplayEffectRuntime& runtime)
+{
+	// Straight onto the runtime, see the class comment for why no decorators
+	RuleEngine engine(*this, &runtime);
+
+	for (const TimelineEvent& event : timeline.events)
+	{
+		runtime.SetTime(event.time);
+
+		switch (event.type)
+		{
+		case TimelineEventType::kMenuOpen:
+		case TimelineEventType::kMenuClose:
+			engine.ProcessMenuEvent(timeline.menuNames[event.menu], event.type == TimelineEventType::kMenuOpen);
+			break;
+		case TimelineEventType::kHour:
+			m_Hour = event.hour;
+			engine.ProcessTimeBasedToggling();
+			break;
+		case TimelineEventType::kCell:
+			m_CellType = event.cellType;
+			engine.ProcessInteriorBasedToggling();
+			break;
+		case TimelineEventType::kWeather:
+			m_WeatherFlags = event.weatherFlags;
+			engine.ProcessWeatherBasedToggling();
+			break;
+		}
+	}
+
+	return timeline.events.size();
+}
@@ -0,0 +1,927 @@
+#include "Core/RuleEngine.h"
+#include "Core/EffectApplier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fmt/format.h>
+#include <map>
+#include <spdlog/spdlog.h>
+
+void RuleEngine::ProcessMenuEvent(std::string_view menuName, bool opening)
+{
+	IEffectRuntime* const runtime = GetActiveRuntime();
+
+	if (m_Recorder)
+	{
+		m_Recorder->RecordMenu(menuName, opening);
+	}
+
+	auto [it, inserted] = m_OpenMenus.emplace(menuName);
+
+	if (!opening)
+	{
+		m_IsMenuOpen = false;
+		m_OpenMenus.erase(it); // Mark menu as closed using the iterator
+	}
+	else { m_IsMenuOpen = true; }
+
+	{
+		std::lock_guard<std::mutex> lock(m_ConditionMutex);
+		m_ConditionMenus = m_OpenMenus;
+	}
+	ProcessValueRules();
+
+	if (m_OpenMenus.empty())
+	{
+		return; // Skip if no open menus
+	}
+
+	bool enableReshadeMenu = true;
+
+	if (runtime != nullptr)
+	{
+		if (ToggleStateMenus.find("All") != std::string::npos)
+		{
+			for (const Info& menu : menuList)
+			{
+				if (m_OpenMenus.find(menu.Name) != m_OpenMenus.end())
+				{
+					enableReshadeMenu = false;
+				}
+			}
+
+			EffectApplier::ApplyReshadeState(*runtime, enableReshadeMenu, ToggleAllStateMenus);
+			m_MenuRules.generation = ~0u; // Back to Specific applies every rule again
+		}
+		else if (ToggleStateMenus.find("Specific") != std::string::npos)
+		{
+			ConditionSnapshot snapshot;
+			snapshot.menus = &m_OpenMenus;
+
+			// Only rules naming a menu that opened or closed
+			for (const ConditionExpressions::Index index : UpdateRules(runtime, m_MenuRules, techniqueMenuInfoList, Categories::Menu, snapshot))
+			{
+				enableReshadeMenu = !m_MenuRules.expressions.GetResult(index);
+				EffectApplier::ApplyTechniqueState(*runtime, enableReshadeMenu, techniqueMenuInfoList[index], m_Groups);
+			}
+		}
+
+		SPDLOG_DEBUG("Menu {} {}", menuName, opening ? "open" : "closed");
+		SPDLOG_DEBUG("Reshade {}", enableReshadeMenu ? "enabled" : "disabled");
+	}
+	else if (!m_Suspended)
+	{
+		spdlog::critical("Uhm, what? How? s_pRuntime was null. How the fuck did this happen");
+	}
+}
+
+void RuleEngine::ProcessTimeBasedToggling()
+{
+	std::lock_guard<std::mutex> timeLock(timeMutexTime);
+
+	IEffectRuntime* const runtime = GetActiveRuntime();
+
+	if (m_IsMenuOpen)
+	{
+		return;
+	}
+
+	SPDLOG_DEBUG("Started ProcessTimeBasedToggling");
+
+	float TimecurrentTime = m_GameState.GetHour();
+	if (m_Recorder)
+	{
+		m_Recorder->RecordHour(TimecurrentTime);
+	}
+	SPDLOG_DEBUG("currentTime: {} ", TimecurrentTime);
+
+	// Specific, only effects whose merged ranges were entered or left
+	std::vector<TimeIntervals::Target> changedTime;
+	if (ToggleStateTime.find("Specific") != std::string::npos)
+	{
+		const std::uint32_t revision = ruleRevision;
+		const std::uint32_t generation = m_RuleGeneration;
+		if (revision != m_TimeRevision || generation != m_TimeGeneration || m_TimeIntervals.GetRuleCount() != techniqueTimeInfoList.size())
+		{
+			m_TimeRevision = revision;
+			m_TimeGeneration = generation;
+			m_TimeIntervals.Build(techniqueTimeInfoList);
+			SPDLOG_DEBUG("{} time rules in {} ranges, {} boundaries", techniqueTimeInfoList.size(), m_TimeIntervals.GetIntervalCount(), m_TimeIntervals.GetBoundaryCount());
+		}
+
+		changedTime = m_TimeIntervals.Update(TimecurrentTime);
+		for (const TimeIntervals::Target target : changedTime)
+		{
+			const bool enable = !m_TimeIntervals.IsActive(target);
+			for (const std::size_t rule : m_TimeIntervals.GetRules(target))
+			{
+				techniqueTimeInfoList[rule].enable = enable;
+			}
+		}
+
+		// Same as UpdateRules, nothing is applied without a runtime
+		if (runtime == nullptr)
+		{
+			m_TimeIntervals.Invalidate();
+		}
+	}
+	else
+	{
+		m_TimeGeneration = ~0u; // Back to Specific applies every rule again
+	}
+
+	// All
+	bool enableReshadeTime = true;
+	if (ToggleStateTime.find("All") != std::string::npos)
+	{
+		for (auto& allInfo : techniqueTimeInfoListAll)
+		{
+			enableReshadeTime = !IsTimeWithinRange(TimecurrentTime, allInfo.startTime, allInfo.stopTime);
+			SPDLOG_DEBUG("State: {} for time: {} - {}. ReshadeBool: {}", allInfo.state, allInfo.startTime, allInfo.stopTime, enableReshadeTime);
+		}
+	}
+
+	if (runtime != nullptr)
+	{
+		if (ToggleStateTime.find("All") != std::string::npos)
+		{
+			EffectApplier::ApplyReshadeState(*runtime, enableReshadeTime, ToggleAllStateTime);
+		}
+		else if (ToggleStateTime.find("Specific") != std::string::npos)
+		{
+			// Rules sharing a target only differ in their ranges, one of them does
+			for (const TimeIntervals::Target target : changedTime)
+			{
+				const TechniqueInfo& info = techniqueTimeInfoList[m_TimeIntervals.GetRules(target).front()];
+				EffectApplier::ApplyTechniqueState(*runtime, info.enable, info, m_Groups);
+			}
+		}
+	}
+
+	if (EnableCalendar)
+	{
+		ProcessCalendar();
+	}
+
+	ProcessValueRules();
+}
+
+bool RuleEngine::IsTimeWithinRange(double currentTime, double startTime, double endTime)
+{
+	// A start after the stop runs over midnight
+	if (startTime > endTime)
+	{
+		return currentTime >= startTime || currentTime <= endTime;
+	}
+	return currentTime >= startTime && currentTime <= endTime;
+}
+
+void RuleEngine::ProcessInteriorBasedToggling()
+{
+	std::lock_guard<std::mutex> lock(timeMutexInterior);
+
+	IEffectRuntime* const runtime = GetActiveRuntime();
+
+	if (m_IsMenuOpen)
+	{
+		return;
+	}
+
+	const CellType cellType = m_GameState.GetCellType();
+	if (m_Recorder)
+	{
+		m_Recorder->RecordCell(cellType);
+	}
+
+	if (cellType != CellType::kNone)
+	{
+		bool enableReshade = [cellType]()
+			{
+				if (cellType == CellType::kInterior)
+				{
+					SPDLOG_DEBUG("Player is in interior cell");
+					IsInInteriorCell = true;
+					return false;
+				}
+				else
+				{
+					SPDLOG_DEBUG("Player is in exterior cell");
+					IsInInteriorCell = false;
+					return true;
+				}
+
+			}
+		();
+
+		if (runtime != nullptr)
+		{
+			if (ToggleStateInterior.find("All") != std::string::npos)
+			{
+				EffectApplier::ApplyReshadeState(*runtime, enableReshade, ToggleAllStateInterior);
+				m_InteriorRules.generation = ~0u; // Back to Specific applies every rule again
+			}
+			else if (ToggleStateInterior.find("Specific") != std::string::npos)
+			{
+				ConditionSnapshot snapshot;
+				snapshot.interior = cellType == CellType::kInterior;
+
+				// Nothing unless the player went in or out
+				for (const ConditionExpressions::Index index : UpdateRules(runtime, m_InteriorRules, techniqueInteriorInfoList, Categories::Interior, snapshot))
+				{
+					EffectApplier::ApplyTechniqueState(*runtime, !m_InteriorRules.expressions.GetResult(index), techniqueInteriorInfoList[index], m_Groups);
+				}
+			}
+		}
+
+		ProcessValueRules();
+	}
+}
+
+void RuleEngine::ProcessWeatherBasedToggling()
+{
+	std::lock_guard<std::mutex> lock(timeMutexWeather);
+
+	IEffectRuntime* const runtime = GetActiveRuntime();
+
+	if (m_IsMenuOpen)
+	{
+		return;
+	}
+
+	const auto flags = m_GameState.GetWeatherFlags();
+	if (m_Recorder)
+	{
+		m_Recorder->RecordWeather(flags);
+	}
+
+	if (flags)
+	{
+		// Combined flags don't match any preset name, keep the last known weather in that case
+		if (const char* flagName = GetWeatherFlagName(*flags))
+		{
+			weatherflags = flagName;
+		}
+
+		//SPDLOG_DEBUG("weatherflag {}", weatherflags);
+
+		bool enableReshadeWeather = true;
+
+		if (runtime != nullptr)
+		{
+			if (ToggleStateWeather.find("All") != std::string::npos)
+			{
+				for (const Info& weather : weatherList)
+				{
+					if (weather.Name == weatherflags)
+					{
+						enableReshadeWeather = false;
+					}
+
+				}
+				EffectApplier::ApplyReshadeState(*runtime, enableReshadeWeather, ToggleAllStateWeather);
+				m_WeatherRules.generation = ~0u; // Back to Specific applies every rule again
+
+			}
+			else if (ToggleStateWeather.find("Specific") != std::string::npos)
+			{
+				ConditionSnapshot snapshot;
+				snapshot.weather = weatherflags;
+
+				// Only rules for the weather that ended or the one that started
+				for (const ConditionExpressions::Index index : UpdateRules(runtime, m_WeatherRules, techniqueWeatherInfoList, Categories::Weather, snapshot))
+				{
+					enableReshadeWeather = !m_WeatherRules.expressions.GetResult(index);
+					EffectApplier::ApplyTechniqueState(*runtime, enableReshadeWeather, techniqueWeatherInfoList[index], m_Groups);
+				}
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> conditionLock(m_ConditionMutex);
+			m_ConditionWeather = weatherflags;
+		}
+		ProcessValueRules();
+	}
+}
+
+void RuleEngine::ProcessPerformanceBasedToggling(float frameTime)
+{
+	std::lock_guard<std::mutex> lock(timeMutexPerformance);
+
+	IEffectRuntime* const runtime = GetActiveRuntime();
+
+	// Menus have their own frame times and the shed effects aren't visible anyway
+	if (m_IsMenuOpen || runtime == nullptr)
+	{
+		return;
+	}
+
+	PerformanceGovernor::Settings settings;
+	settings.targetFrameTime = static_cast<float>(PerformanceTargetFrameTime);
+	settings.headroom = static_cast<float>(PerformanceHeadroom);
+	settings.windowFrames = static_cast<std::size_t>(std::max(PerformanceWindowFrames, 1));
+	m_Governor.SetSettings(settings);
+	m_Governor.SetLevelCount(techniquePerformanceInfoList.size());
+
+	const PerformanceGovernor::Action action = m_Governor.AddFrame(frameTime);
+
+	if (action == PerformanceGovernor::Action::kShed)
+	{
+		// Lowest priority goes first, equal priorities in preset order
+		std::vector<const TechniqueInfo*> order;
+		for (const TechniqueInfo& info : techniquePerformanceInfoList)
+		{
+			order.push_back(&info);
+		}
+		std::stable_sort(order.begin(), order.end(), [](const TechniqueInfo* a, const TechniqueInfo* b) { return a->priority < b->priority; });
+
+		const TechniqueInfo& info = *order[m_Governor.GetShedCount() - 1];
+
+		// Only what is on now, restoring must not turn on what a rule or the user turned off
+		ShedEffect shed{ info.filename, {} };
+		std::uint32_t position = 0;
+		EffectApplier::EnumerateTechniques(*runtime, info.filename, m_Groups, [runtime, &shed, &position](EffectTechnique technique)
+			{
+				if (runtime->GetTechniqueState(technique))
+				{
+					runtime->SetTechniqueState(technique, false);
+					shed.techniques.push_back(position);
+				}
+				position++;
+			});
+
+		SPDLOG_DEBUG("Frame time {} ms over budget, disabled {} techniques of {}", m_Governor.GetLastFrameTime(), shed.techniques.size(), info.filename);
+		m_ShedEffects.push_back(std::move(shed));
+	}
+	else if (action == PerformanceGovernor::Action::kRestore && !m_ShedEffects.empty())
+	{
+		// Restored by name, the list may have changed since shedding
+		const ShedEffect shed = std::move(m_ShedEffects.back());
+		m_ShedEffects.pop_back();
+
+		[[maybe_unused]] const std::size_t restored = RestoreShedEffect(*runtime, shed);
+		SPDLOG_DEBUG("Frame time {} ms back under budget, enabled {} techniques of {}", m_Governor.GetLastFrameTime(), restored, shed.filename);
+	}
+}
+
+void RuleEngine::ResetGovernor(bool restore)
+{
+	std::lock_guard<std::mutex> lock(timeMutexPerformance);
+
+	// Also while suspended, these are only undone and nothing else turns them back on
+	if (restore && m_Runtime != nullptr)
+	{
+		for (auto shed = m_ShedEffects.rbegin(); shed != m_ShedEffects.rend(); ++shed)
+		{
+			RestoreShedEffect(*m_Runtime, *shed);
+		}
+	}
+
+	if (!m_ShedEffects.empty())
+	{
+		spdlog::info("Performance governor reset, {} {} shed effects", restore ? "restored" : "forgot", m_ShedEffects.size());
+	}
+	m_ShedEffects.clear();
+	m_Governor.Reset();
+}
+
+std::size_t RuleEngine::RestoreShedEffect(IEffectRuntime& runtime, const ShedEffect& shed) const
+{
+	std::uint32_t position = 0;
+	std::size_t next = 0;
+	EffectApplier::EnumerateTechniques(runtime, shed.filename, m_Groups, [&runtime, &shed, &position, &next](EffectTechnique technique)
+		{
+			if (next < shed.techniques.size() && shed.techniques[next] == position)
+			{
+				runtime.SetTechniqueState(technique, true);
+				next++;
+			}
+			position++;
+		});
+	return next;
+}
+
+void RuleEngine::ProcessDefinitions()
+{
+	std::scoped_lock<std::mutex, std::mutex> lock(timeMutexDefinitions, m_ConditionMutex);
+
+	IEffectRuntime* const runtime = GetActiveRuntime();
+
+	if (runtime == nullptr || definitionInfoList.empty())
+	{
+		return;
+	}
+
+	const float hour = m_GameState.GetHour();
+
+	// A definition takes the value of the last rule that holds, or the default of its first rule
+	std::map<std::pair<std::string, std::string>, const std::string*> values;
+	for (const DefinitionInfo& info : definitionInfoList)
+	{
+		auto key = std::make_pair(info.filename, info.name);
+		if (IsConditionActive(info, hour))
+		{
+			values[std::move(key)] = &info.value;
+		}
+		else
+		{
+			values.try_emplace(std::move(key), &info.defaultValue);
+		}
+	}
+
+	// Unchanged values are dropped further down, only actual changes cost a recompile
+	for (const auto& [key, value] : values)
+	{
+		runtime->SetPreprocessorDefinition(key.first.c_str(), key.second.c_str(), value->c_str());
+	}
+}
+
+void RuleEngine::ProcessUniforms()
+{
+	std::scoped_lock<std::mutex, std::mutex> lock(timeMutexUniforms, m_ConditionMutex);
+
+	if (m_Uniforms == nullptr || uniformInfoList.empty())
+	{
+		return;
+	}
+
+	const float hour = m_GameState.GetHour();
+
+	// Same precedence as the definitions
+	std::map<std::pair<std::string, std::string>, const UniformInfo*> rules;
+	std::map<std::pair<std::string, std::string>, double> values;
+	for (const UniformInfo& info : uniformInfoList)
+	{
+		auto key = std::make_pair(info.filename, info.name);
+		if (IsConditionActive(info, hour))
+		{
+			rules[key] = &info;
+			values[std::move(key)] = info.value;
+		}
+		else if (rules.try_emplace(key, &info).second)
+		{
+			values[std::move(key)] = info.defaultValue;
+		}
+	}
+
+	// Repeats of the last value are dropped by the writer
+	for (const auto& [key, value] : values)
+	{
+		const std::string& type = rules[key]->type;
+		if (type == "int")
+		{
+			m_Uniforms->Set(key.first, key.second, static_cast<std::int32_t>(std::lround(value)));
+		}
+		else if (type == "bool")
+		{
+			m_Uniforms->Set(key.first, key.second, value != 0.0);
+		}
+		else
+		{
+			m_Uniforms->Set(key.first, key.second, static_cast<float>(value));
+		}
+	}
+}
+
+void RuleEngine::ProcessReshadePresets()
+{
+	std::scoped_lock<std::mutex, std::mutex> lock(timeMutexReshadePresets, m_ConditionMutex);
+
+	if (m_Presets == nullptr)
+	{
+		return;
+	}
+
+	const float hour = m_GameState.GetHour();
+
+	// The last rule that holds picks the preset
+	const std::string* path = &DefaultReshadePreset;
+	for (const ReshadePresetInfo& info : reshadePresetInfoList)
+	{
+		if (IsConditionActive(info, hour))
+		{
+			path = &info.path;
+		}
+	}
+
+	m_Presets->Request(*path);
+}
+
+void RuleEngine::ProcessExpressions()
+{
+	std::scoped_lock<std::mutex, std::mutex> lock(timeMutexExpressions, m_ConditionMutex);
+
+	IEffectRuntime* const runtime = GetActiveRuntime();
+
+	if (runtime == nullptr)
+	{
+		return;
+	}
+
+	const std::uint32_t revision = expressionRevision;
+	if (revision != m_ExpressionRevision)
+	{
+		m_ExpressionRevision = revision;
+		m_Expressions.Clear();
+		m_ExpressionSources.clear();
+
+		for (std::size_t i = 0; i < expressionInfoList.size(); i++)
+		{
+			std::string error;
+			if (!m_Expressions.Add(expressionInfoList[i].expression, &error))
+			{
+				spdlog::info("Skipping expression for {}: {}", expressionInfoList[i].filename, error);
+				continue;
+			}
+			m_ExpressionSources.push_back(i);
+		}
+	}
+
+	ConditionSnapshot snapshot;
+	snapshot.hour = m_GameState.GetHour();
+	snapshot.interior = IsInInteriorCell;
+	snapshot.menus = &m_ConditionMenus;
+	snapshot.weather = m_ConditionWeather;
+	snapshot.player = m_ConditionPlayer;
+	snapshot.camera = m_ConditionCamera;
+	snapshot.light = m_ConditionLight;
+
+	// Applied in rule order, so with several rules on one effect the last one that changed wins
+	for (const ConditionExpressions::Index index : m_Expressions.Update(snapshot))
+	{
+		const ExpressionInfo& info = expressionInfoList[m_ExpressionSources[index]];
+
+		TechniqueInfo technique;
+		technique.filename = info.filename;
+		technique.state = info.state;
+		EffectApplier::ApplyTechniqueState(*runtime, !m_Expressions.GetResult(index), technique, m_Groups);
+	}
+}
+
+void RuleEngine::ProcessLocationBasedToggling()
+{
+	std::lock_guard<std::mutex> lock(timeMutexLocation);
+
+	IEffectRuntime* const runtime = GetActiveRuntime();
+
+	// Runs during loading screens as well, that's when the player changes worldspace
+	const std::uint32_t revision = ruleRevision;
+	if (revision != m_LocationRevision || m_LocationRules.GetRuleCount() != locationInfoList.size())
+	{
+		m_LocationRevision = revision;
+		m_LocationRules.Compile(locationInfoList, [this](std::string_view name) { return m_GameState.LookupFormID(name); });
+
+		for (const std::size_t index : m_LocationRules.GetUnresolved())
+		{
+			spdlog::info("Location rule for {} never holds, {} {} not found", locationInfoList[index].filename, locationInfoList[index].type, locationInfoList[index].name);
+		}
+	}
+
+	// The techniques were reset, the FormIDs are still good
+	const std::uint32_t generation = m_RuleGeneration;
+	if (generation != m_LocationGeneration)
+	{
+		m_LocationGeneration = generation;
+		m_LocationRules.Invalidate();
+	}
+
+	const std::vector<std::size_t>& changed = m_LocationRules.Update(m_GameState.GetLocation());
+	if (changed.empty())
+	{
+		return;
+	}
+	SPDLOG_DEBUG("{} location rules changed", changed.size());
+
+	// Same as UpdateRules, nothing is applied without a runtime
+	if (runtime == nullptr)
+	{
+		m_LocationRules.Invalidate();
+		return;
+	}
+
+	for (const std::size_t index : changed)
+	{
+		const LocationInfo& info = locationInfoList[index];
+
+		TechniqueInfo technique;
+		technique.filename = info.filename;
+		technique.state = info.state;
+		EffectApplier::ApplyTechniqueState(*runtime, !m_LocationRules.IsActive(index), technique, m_Groups);
+	}
+}
+
+void RuleEngine::ProcessPlayerBasedToggling()
+{
+	std::lock_guard<std::mutex> lock(timeMutexPlayer);
+
+	if (m_IsMenuOpen)
+	{
+		return;
+	}
+
+	const std::uint32_t state = m_GameState.GetPlayerState();
+	if (!ProcessStateRules(m_PlayerRules, m_PlayerState, state, kPlayerRules))
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> conditionLock(m_ConditionMutex);
+		m_ConditionPlayer = state;
+	}
+
+	// Expressions can read the player state too
+	if (EnableExpressions)
+	{
+		ProcessExpressions();
+	}
+}
+
+void RuleEngine::ProcessCameraBasedToggling()
+{
+	std::lock_guard<std::mutex> lock(timeMutexCamera);
+
+	if (m_IsMenuOpen)
+	{
+		return;
+	}
+
+	// A killcam switches back and forth within a few frames, each frame sees only where it ended up
+	const std::uint32_t state = static_cast<std::uint32_t>(m_GameState.GetCameraState());
+	if (!ProcessStateRules(m_CameraRules, m_CameraState, state, kCameraRules))
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> conditionLock(m_ConditionMutex);
+		m_ConditionCamera = state;
+	}
+
+	if (EnableExpressions)
+	{
+		ProcessExpressions();
+	}
+}
+
+void RuleEngine::SampleCellLight()
+{
+	const std::optional<float> level = m_GameState.GetCellLightLevel();
+
+	std::lock_guard<std::mutex> lock(timeMutexLight);
+	m_CellLightLevel = level;
+	SPDLOG_DEBUG("Cell light level: {}", level ? fmt::format("{:.3f}", *level) : "none");
+}
+
+void RuleEngine::ProcessLightBasedToggling()
+{
+	std::lock_guard<std::mutex> lock(timeMutexLight);
+
+	if (m_IsMenuOpen)
+	{
+		return;
+	}
+
+	// The thresholds can change in the menu, bucketing again is cheaper than tracking them
+	const std::uint32_t band = static_cast<std::uint32_t>(GetLightBand(m_CellLightLevel, LightDarkThreshold, LightBrightThreshold));
+	if (!ProcessStateRules(m_LightRules, m_LightBand, band, kLightRules))
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> conditionLock(m_ConditionMutex);
+		m_ConditionLight = band;
+	}
+
+	if (EnableExpressions)
+	{
+		ProcessExpressions();
+	}
+}
+
+std::optional<float> RuleEngine::GetCellLightLevel() const
+{
+	std::lock_guard<std::mutex> lock(timeMutexLight);
+	return m_CellLightLevel;
+}
+
+bool RuleEngine::ProcessStateRules(CompiledRules& rules, std::uint32_t& last, std::uint32_t state, const StateRuleKind& kind)
+{
+	IEffectRuntime* const runtime = GetActiveRuntime();
+
+	// Nearly every frame ends here
+	if (state == last && ruleRevision == rules.revision && m_RuleGeneration == rules.generation)
+	{
+		return false;
+	}
+	last = state;
+	SPDLOG_DEBUG("{} state: {:#x}", kind.name, state);
+
+	// Only the field of this kind is read
+	ConditionSnapshot snapshot;
+	snapshot.player = state;
+	snapshot.camera = state;
+	snapshot.light = state;
+	const std::vector<ConditionExpressions::Index>& changed = UpdateRules(runtime, rules, kind.rules, kind, snapshot);
+
+	if (runtime != nullptr)
+	{
+		for (const ConditionExpressions::Index index : changed)
+		{
+			TechniqueInfo technique;
+			technique.filename = kind.rules[index].filename;
+			technique.state = kind.rules[index].state;
+			EffectApplier::ApplyTechniqueState(*runtime, !rules.expressions.GetResult(index), technique, m_Groups);
+		}
+	}
+	return true;
+}
+
+void RuleEngine::ProcessSceneBasedToggling(const SceneSample& sample, double sampleCost)
+{
+	std::lock_guard<std::mutex> lock(timeMutexScene);
+
+	IEffectRuntime* const runtime = GetActiveRuntime();
+
+	if (m_IsMenuOpen)
+	{
+		return;
+	}
+
+	const std::uint32_t revision = ruleRevision;
+	const std::uint32_t generation = m_RuleGeneration;
+	if (revision != m_SceneRevision || generation != m_SceneGeneration || m_SceneRules.GetRuleCount() != sceneInfoList.size())
+	{
+		m_SceneRevision = revision;
+		m_SceneGeneration = generation;
+		m_SceneRules.Compile(sceneInfoList);
+	}
+
+	m_SceneStats.sample = sample;
+	m_SceneStats.samples++;
+	m_SceneStats.lastCost = sampleCost;
+	m_SceneStats.maxCost = std::max(m_SceneStats.maxCost, sampleCost);
+	m_SceneStats.averageCost += (sampleCost - m_SceneStats.averageCost) / m_SceneStats.samples;
+	SPDLOG_DEBUG("Scene: {} actors, {} references, sampled in {} ms", sample.actors, sample.references, sampleCost);
+
+	const std::vector<std::size_t>& changed = m_SceneRules.Update(sample);
+
+	// Same as UpdateRules, nothing is applied without a runtime
+	if (runtime == nullptr)
+	{
+		m_SceneRules.Invalidate();
+		return;
+	}
+
+	for (const std::size_t index : changed)
+	{
+		const SceneInfo& info = sceneInfoList[index];
+
+		TechniqueInfo technique;
+		technique.filename = info.filename;
+		technique.state = info.state;
+		EffectApplier::ApplyTechniqueState(*runtime, !m_SceneRules.IsActive(index), technique, m_Groups);
+	}
+}
+
+SceneStats RuleEngine::GetSceneStats() const
+{
+	std::lock_guard<std::mutex> lock(timeMutexScene);
+	return m_SceneStats;
+}
+
+void RuleEngine::ProcessCalendar()
+{
+	std::lock_guard<std::mutex> lock(timeMutexCalendar);
+
+	IEffectRuntime* const runtime = GetActiveRuntime();
+
+	const std::uint32_t revision = ruleRevision;
+	const std::uint32_t generation = m_RuleGeneration;
+	if (revision != m_CalendarRevision || generation != m_CalendarGeneration || m_CalendarRules.GetRuleCount() != calendarInfoList.size())
+	{
+		m_CalendarRevision = revision;
+		m_CalendarGeneration = generation;
+		m_CalendarRules.Compile(calendarInfoList);
+	}
+
+	const GameDate date = m_GameState.GetDate();
+	const std::vector<std::size_t>& changed = m_CalendarRules.Update(date, m_GameState.GetHour());
+	if (changed.empty())
+	{
+		return;
+	}
+	SPDLOG_DEBUG("{} calendar rules changed on day {}, next check at {}", changed.size(), date.daysPassed, m_CalendarRules.GetNextBoundary());
+
+	// Same as UpdateRules, nothing is applied without a runtime
+	if (runtime == nullptr)
+	{
+		m_CalendarRules.Invalidate();
+		return;
+	}
+
+	for (const std::size_t index : changed)
+	{
+		const CalendarInfo& info = calendarInfoList[index];
+
+		TechniqueInfo technique;
+		technique.filename = info.filename;
+		technique.state = info.state;
+		EffectApplier::ApplyTechniqueState(*runtime, !m_CalendarRules.IsActive(index), technique, m_Groups);
+	}
+}
+
+template <class Info, class Kind>
+const std::vector<ConditionExpressions::Index>& RuleEngine::UpdateRules(IEffectRuntime* runtime, CompiledRules& rules, const std::vector<Info>& list, const Kind& kind, const ConditionSnapshot& snapshot)
+{
+	const std::uint32_t revision = ruleRevision;
+	const std::uint32_t generation = m_RuleGeneration;
+	if (revision != rules.revision || generation != rules.generation || rules.expressions.GetCount() != list.size())
+	{
+		rules.revision = revision;
+		rules.generation = generation;
+		rules.expressions.Clear();
+
+		// Rules that can't hold compile to false, so indices stay those of the list
+		for (const Info& info : list)
+		{
+			if (!rules.expressions.Add(GetRuleExpression(info, kind)))
+			{
+				rules.expressions.Add("false");
+			}
+		}
+	}
+
+	const std::vector<ConditionExpressions::Index>& changed = rules.expressions.Update(snapshot);
+
+	// Nothing gets applied without a runtime, once there is one every rule is reported again
+	if (runtime == nullptr)
+	{
+		rules.expressions.Invalidate();
+	}
+
+	return changed;
+}
+
+std::string RuleEngine::GetRuleExpression(const TechniqueInfo& info, Categories category)
+{
+	switch (category)
+	{
+	case Categories::Menu:
+		return fmt::format("menu({})", info.Name);
+	case Categories::Weather:
+		return fmt::format("weather({})", info.Name);
+	case Categories::Interior:
+		return "interior";
+	default:
+		return "false";
+	}
+}
+
+std::string RuleEngine::GetRuleExpression(const StateRuleInfo& info, const StateRuleKind& kind)
+{
+	return fmt::format("{}({})", kind.term, info.condition);
+}
+
+void RuleEngine::ProcessValueRules()
+{
+	if (EnableDefinitions)
+	{
+		ProcessDefinitions();
+	}
+	if (EnableUniforms)
+	{
+		ProcessUniforms();
+	}
+	if (EnableReshadePresets)
+	{
+		ProcessReshadePresets();
+	}
+	if (EnableExpressions)
+	{
+		ProcessExpressions();
+	}
+}
+
+template <class T>
+bool RuleEngine::IsConditionActive(const T& info, float hour) const
+{
+	if (info.category == "Menu")
+	{
+		return m_ConditionMenus.find(info.condition) != m_ConditionMenus.end();
+	}
+	else if (info.category == "Time")
+	{
+		return IsTimeWithinRange(hour, info.startTime, info.stopTime);
+	}
+	else if (info.category == "Interior")
+	{
+		return IsInInteriorCell;
+	}
+	else if (info.category == "Weather")
+	{
+		return m_ConditionWeather == info.condition;
+	}
+	return false;
+}
@@ -0,0 +1,72 @@
+#include "Core/SceneRules.h"
+
+#include <algorithm>
+
+void SceneRules::Compile(const std::vector<SceneInfo>& rules)
+{
+	m_Rules.clear();
+
+	for (const SceneInfo& info : rules)
+	{
+		Rule rule;
+		if (const std::optional<Metric> metric = ParseMetric(info.metric))
+		{
+			rule.metric = *metric;
+			rule.valid = true;
+		}
+		rule.on = info.threshold;
+		rule.off = info.threshold - std::max(info.hysteresis, 0.0);
+		m_Rules.push_back(rule);
+	}
+
+	m_Active.assign(m_Rules.size(), 0);
+	m_Valid = false;
+}
+
+const std::vector<std::size_t>& SceneRules::Update(const SceneSample& sample)
+{
+	m_Changed.clear();
+
+	for (std::size_t i = 0; i < m_Rules.size(); i++)
+	{
+		const Rule& rule = m_Rules[i];
+		const double value = rule.metric == Metric::kActors ? sample.actors : sample.references;
+
+		// Between off and on the rule keeps what it was, not holding after a compile
+		std::uint8_t active = m_Active[i];
+		if (!rule.valid)
+		{
+			active = 0;
+		}
+		else if (value >= rule.on)
+		{
+			active = 1;
+		}
+		else if (value <= rule.off)
+		{
+			active = 0;
+		}
+
+		if (!m_Valid || active != m_Active[i])
+		{
+			m_Active[i] = active;
+			m_Changed.push_back(i);
+		}
+	}
+
+	m_Valid = true;
+	return m_Changed;
+}
+
+std::optional<SceneRules::Metric> SceneRules::ParseMetric(std::string_view metric)
+{
+	if (metric == "Actors")
+	{
+		return Metric::kActors;
+	}
+	if (metric == "References")
+	{
+		return Metric::kReferences;
+	}
+	return std::nullopt;
+}
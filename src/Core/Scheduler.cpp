@@ -0,0 +1,26 @@
+#include "Core/Scheduler.h"
+
+void Scheduler::Submit(const std::string& name, Task task)
+{
+	std::scoped_lock<std::mutex> lock(m_QueueMutex);
+
+	m_Queue[name] = task;
+}
+
+bool Scheduler::IsQueued(const std::string& name)
+{
+	std::scoped_lock<std::mutex> lock(m_QueueMutex);
+
+	return m_Queue.find(name) != m_Queue.end();
+}
+
+void Scheduler::Execute()
+{
+	std::scoped_lock<std::mutex> lock(m_QueueMutex);
+
+	for (const auto& task : m_Queue)
+	{
+		task.second();
+	}
+	m_Queue.clear();
+}
@@ -0,0 +1,223 @@
+#include "Core/TimeIntervals.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+	constexpr double kDay = 24.0;
+
+	double WrapHour(double hour)
+	{
+		hour = std::fmod(hour, kDay);
+		return hour < 0.0 ? hour + kDay : hour;
+	}
+}
+
+void TimeIntervals::Build(const std::vector<TechniqueInfo>& rules)
+{
+	m_RuleCount = rules.size();
+	m_TargetRules.clear();
+	m_Intervals.clear();
+	m_TargetFirst.clear();
+	m_Boundaries.clear();
+	m_EventFirst.clear();
+	m_Events.clear();
+
+	// Ranges of every target on the plain day, before merging
+	std::unordered_map<std::string, Target> targets;
+	std::vector<std::vector<Interval>> ranges;
+	for (std::size_t rule = 0; rule < rules.size(); rule++)
+	{
+		const TechniqueInfo& info = rules[rule];
+		const auto [it, inserted] = targets.try_emplace(info.filename + '\0' + info.state, m_TargetRules.size());
+		if (inserted)
+		{
+			m_TargetRules.emplace_back();
+			ranges.emplace_back();
+		}
+		m_TargetRules[it->second].push_back(rule);
+
+		// The stop hour is still in range, so the range ends just after it
+		const double start = std::clamp(info.startTime, 0.0, kDay);
+		const double stop = std::clamp(info.stopTime, 0.0, kDay);
+		const double end = std::min(std::nextafter(stop, std::numeric_limits<double>::infinity()), kDay);
+		auto& targetRanges = ranges[it->second];
+		if (start <= stop)
+		{
+			if (start < end)
+			{
+				targetRanges.push_back(Interval{ start, end });
+			}
+		}
+		else
+		{
+			if (start < kDay)
+			{
+				targetRanges.push_back(Interval{ start, kDay });
+			}
+			targetRanges.push_back(Interval{ 0.0, end });
+		}
+	}
+
+	struct Switch
+	{
+		double hour = 0.0;
+		Event event;
+	};
+	std::vector<Switch> switches;
+
+	for (Target target = 0; target < ranges.size(); target++)
+	{
+		auto& targetRanges = ranges[target];
+		std::sort(targetRanges.begin(), targetRanges.end(), [](const Interval& a, const Interval& b) { return a.start < b.start; });
+
+		const std::size_t first = m_Intervals.size();
+		m_TargetFirst.push_back(static_cast<std::uint32_t>(first));
+		for (const Interval& range : targetRanges)
+		{
+			if (m_Intervals.size() > first && range.start <= m_Intervals.back().stop)
+			{
+				m_Intervals.back().stop = std::max(m_Intervals.back().stop, range.stop);
+			}
+			else
+			{
+				m_Intervals.push_back(range);
+			}
+		}
+
+		// A range up to midnight and one from midnight are the same range
+		if (m_Intervals.size() - first > 1 && m_Intervals[first].start == 0.0 && m_Intervals.back().stop >= kDay)
+		{
+			m_Intervals[first].start = m_Intervals.back().start;
+			m_Intervals.pop_back();
+		}
+
+		for (std::size_t i = first; i < m_Intervals.size(); i++)
+		{
+			const Interval& interval = m_Intervals[i];
+			if (interval.start == 0.0 && interval.stop >= kDay)
+			{
+				continue; // All day, never switches
+			}
+			switches.push_back(Switch{ interval.start, Event{ static_cast<std::uint32_t>(target), true } });
+			switches.push_back(Switch{ WrapHour(interval.stop), Event{ static_cast<std::uint32_t>(target), false } });
+		}
+	}
+	m_TargetFirst.push_back(static_cast<std::uint32_t>(m_Intervals.size()));
+
+	std::stable_sort(switches.begin(), switches.end(), [](const Switch& a, const Switch& b) { return a.hour < b.hour; });
+	for (const Switch& entry : switches)
+	{
+		if (m_Boundaries.empty() || m_Boundaries.back() != entry.hour)
+		{
+			m_Boundaries.push_back(entry.hour);
+			m_EventFirst.push_back(static_cast<std::uint32_t>(m_Events.size()));
+		}
+		m_Events.push_back(entry.event);
+	}
+	m_EventFirst.push_back(static_cast<std::uint32_t>(m_Events.size()));
+
+	m_Active.assign(m_TargetRules.size(), 0);
+	m_Touched.assign(m_TargetRules.size(), 0);
+	m_Valid = false;
+}
+
+const std::vector<TimeIntervals::Target>& TimeIntervals::Update(float hour)
+{
+	m_Changed.clear();
+
+	const double wrapped = WrapHour(hour);
+	const std::size_t segment = FindSegment(static_cast<float>(wrapped));
+
+	if (!m_Valid)
+	{
+		for (Target target = 0; target < m_Active.size(); target++)
+		{
+			m_Active[target] = Contains(target, wrapped) ? 1 : 0;
+			m_Changed.push_back(target);
+		}
+		m_Segment = segment;
+		m_Valid = true;
+		return m_Changed;
+	}
+
+	if (segment == m_Segment || m_Boundaries.empty())
+	{
+		return m_Changed;
+	}
+
+	// Forward to the new segment, over midnight if the hour went back. A whole day of switches nets out to nothing.
+	std::size_t boundary = m_Segment;
+	do
+	{
+		boundary = (boundary + 1) % m_Boundaries.size();
+		for (std::uint32_t i = m_EventFirst[boundary]; i < m_EventFirst[boundary + 1]; i++)
+		{
+			const Event& event = m_Events[i];
+			if (!m_Touched[event.target])
+			{
+				// Remember the state before this Update in the touched flag
+				m_Touched[event.target] = m_Active[event.target] ? 2 : 1;
+				m_TouchedList.push_back(event.target);
+			}
+			m_Active[event.target] = event.active ? 1 : 0;
+		}
+	} while (boundary != segment);
+	m_Segment = segment;
+
+	for (const Target target : m_TouchedList)
+	{
+		if ((m_Touched[target] == 2) != (m_Active[target] != 0))
+		{
+			m_Changed.push_back(target);
+		}
+		m_Touched[target] = 0;
+	}
+	m_TouchedList.clear();
+
+	// Targets are numbered by their first rule
+	std::sort(m_Changed.begin(), m_Changed.end());
+	return m_Changed;
+}
+
+std::size_t TimeIntervals::FindSegment(float hour) const
+{
+	if (m_Boundaries.empty())
+	{
+		return 0;
+	}
+
+	const auto next = std::upper_bound(m_Boundaries.begin(), m_Boundaries.end(), static_cast<double>(hour));
+	if (next == m_Boundaries.begin())
+	{
+		return m_Boundaries.size() - 1;
+	}
+	return static_cast<std::size_t>(next - m_Boundaries.begin()) - 1;
+}
+
+std::optional<double> TimeIntervals::GetNextBoundary(float hour) const
+{
+	if (m_Boundaries.empty())
+	{
+		return std::nullopt;
+	}
+	return m_Boundaries[(FindSegment(static_cast<float>(WrapHour(hour))) + 1) % m_Boundaries.size()];
+}
+
+bool TimeIntervals::Contains(Target target, double hour) const
+{
+	for (std::uint32_t i = m_TargetFirst[target]; i < m_TargetFirst[target + 1]; i++)
+	{
+		const Interval& interval = m_Intervals[i];
+		const bool inside = interval.start <= interval.stop ? hour >= interval.start && hour < interval.stop : hour >= interval.start || hour < interval.stop;
+		if (inside)
+		{
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,229 @@
+#include "Core/TimePrewarmer.h"
+#include "Core/EffectApplier.h"
+#include "Core/RuleEngine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+namespace
+{
+	// Game hours until the rule turns its effect on, empty if it's on already or never will be
+	std::optional<double> HoursUntilOn(const TechniqueInfo& info, float hour)
+	{
+		if ((info.state != "on" && info.state != "off") || TimePrewarmer::IsEffectOn(info, hour))
+		{
+			return std::nullopt;
+		}
+
+		// "on" rules light up when the range starts, "off" rules once it's over
+		const double target = info.state == "on" ? info.startTime : info.stopTime;
+		return std::fmod(target - hour + 24.0, 24.0);
+	}
+
+	// Same as PredictActivations, caller holds timeMutexTime
+	std::vector<TimePrewarmer::Activation> Predict(float hour, float timeScale, double lookahead)
+	{
+		std::vector<TimePrewarmer::Activation> activations;
+		if (timeScale <= 0.0f || ToggleStateTime.find("Specific") == std::string::npos)
+		{
+			return activations;
+		}
+
+		for (const TechniqueInfo& info : techniqueTimeInfoList)
+		{
+			if (const auto hours = HoursUntilOn(info, hour))
+			{
+				const double seconds = *hours * 3600.0 / timeScale;
+				if (seconds <= lookahead)
+				{
+					activations.push_back(TimePrewarmer::Activation{ info.filename, seconds });
+				}
+			}
+		}
+
+		std::sort(activations.begin(), activations.end(), [](const auto& a, const auto& b) { return a.seconds < b.seconds; });
+		return activations;
+	}
+}
+
+void PredictionHistogram::Add(double error)
+{
+	const auto bin = std::upper_bound(kEdges.begin(), kEdges.end(), error) - kEdges.begin();
+	m_Bins[bin]++;
+	m_Count++;
+}
+
+std::string PredictionHistogram::Format() const
+{
+	std::string result = fmt::format("<{}s:{}", kEdges.front(), m_Bins.front());
+	for (std::size_t i = 1; i < kEdges.size(); i++)
+	{
+		result += fmt::format(" {}..{}s:{}", kEdges[i - 1], kEdges[i], m_Bins[i]);
+	}
+	result += fmt::format(" >{}s:{} missed:{}", kEdges.back(), m_Bins.back(), m_Missed);
+	return result;
+}
+
+std::vector<TimePrewarmer::Activation> TimePrewarmer::PredictActivations(float hour, float timeScale, double lookahead)
+{
+	std::lock_guard<std::mutex> timeLock(timeMutexTime);
+
+	return Predict(hour, timeScale, lookahead);
+}
+
+bool TimePrewarmer::IsEffectOn(const TechniqueInfo& info, float hour)
+{
+	// Mirrors ProcessTimeBasedToggling + ApplyTechniqueState
+	const bool enable = !RuleEngine::IsTimeWithinRange(hour, info.startTime, info.stopTime);
+	return info.state == "on" ? !enable : enable;
+}
+
+void TimePrewarmer::Observe(float hour, float timeScale, Clock::time_point now)
+{
+	std::scoped_lock<std::mutex, std::mutex> lock(timeMutexTime, m_Mutex);
+
+	// New preset, start over without counting the switch as activations
+	if (m_Predictions.size() != techniqueTimeInfoList.size())
+	{
+		m_Predictions.assign(techniqueTimeInfoList.size(), Prediction{});
+		for (std::size_t i = 0; i < techniqueTimeInfoList.size(); i++)
+		{
+			m_Predictions[i].wasOn = IsEffectOn(techniqueTimeInfoList[i], hour);
+		}
+	}
+
+	const auto lookahead = std::chrono::duration<double>(TimePrewarmLookahead);
+
+	for (std::size_t i = 0; i < techniqueTimeInfoList.size(); i++)
+	{
+		const TechniqueInfo& info = techniqueTimeInfoList[i];
+		Prediction& prediction = m_Predictions[i];
+		const bool on = IsEffectOn(info, hour);
+
+		if (on && !prediction.wasOn && prediction.activation)
+		{
+			const double error = std::chrono::duration<double>(now - *prediction.activation).count();
+			m_Histogram.Add(error);
+			prediction.activation.reset();
+
+			spdlog::info("{} activated {:.1f}s off prediction. Prediction errors: {}", info.filename, error, m_Histogram.Format());
+		}
+		else if (!on && prediction.activation && now - *prediction.activation > std::max(lookahead, std::chrono::duration<double>(60.0)))
+		{
+			// Time scale changed, the player waited or the rule was edited
+			m_Histogram.AddMissed();
+			prediction.activation.reset();
+		}
+		prediction.wasOn = on;
+
+		if (!on && !prediction.activation && timeScale > 0.0f && ToggleStateTime.find("Specific") != std::string::npos)
+		{
+			if (const auto hours = HoursUntilOn(info, hour))
+			{
+				const std::chrono::duration<double> seconds(*hours * 3600.0 / timeScale);
+				if (seconds <= lookahead)
+				{
+					prediction.activation = now + std::chrono::duration_cast<Clock::duration>(seconds);
+					SPDLOG_DEBUG("{} predicted to turn on in {:.1f}s", info.filename, seconds.count());
+				}
+			}
+		}
+	}
+}
+
+void TimePrewarmer::Prewarm(IEffectRuntime& runtime, float hour, float timeScale, EffectGroups* groups)
+{
+	if (!EnableTimePrewarm)
+	{
+		return;
+	}
+
+	std::scoped_lock<std::mutex, std::mutex> lock(timeMutexTime, m_Mutex);
+
+	for (const Activation& activation : Predict(hour, timeScale, TimePrewarmLookahead))
+	{
+		if (!m_Warmed.insert(activation.effect).second)
+		{
+			continue;
+		}
+
+		Warming warming;
+		warming.effect = activation.effect;
+		warming.framesLeft = m_WarmFrames;
+		EffectApplier::EnumerateTechniques(runtime, activation.effect, groups, [&runtime, &warming](EffectTechnique technique)
+			{
+				if (!runtime.GetTechniqueState(technique))
+				{
+					runtime.SetTechniqueState(technique, true);
+					warming.techniques.push_back(technique);
+				}
+			});
+
+		if (!warming.techniques.empty())
+		{
+			SPDLOG_DEBUG("Warming {} ahead of its activation in {:.1f}s", activation.effect, activation.seconds);
+			m_Warming.push_back(std::move(warming));
+		}
+	}
+}
+
+void TimePrewarmer::OnPresent(IEffectRuntime& runtime, float hour)
+{
+	{
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+		if (m_Warming.empty())
+		{
+			return;
+		}
+	}
+
+	std::scoped_lock<std::mutex, std::mutex> lock(timeMutexTime, m_Mutex);
+
+	for (auto it = m_Warming.begin(); it != m_Warming.end();)
+	{
+		if (--it->framesLeft > 0)
+		{
+			++it;
+			continue;
+		}
+
+		// The rule may have fired in the meantime, leave it on then
+		const bool wanted = std::any_of(techniqueTimeInfoList.begin(), techniqueTimeInfoList.end(), [&it, hour](const TechniqueInfo& info)
+			{
+				return info.filename == it->effect && IsEffectOn(info, hour);
+			});
+
+		if (!wanted)
+		{
+			for (const EffectTechnique technique : it->techniques)
+			{
+				runtime.SetTechniqueState(technique, false);
+			}
+		}
+		it = m_Warming.erase(it);
+	}
+}
+
+void TimePrewarmer::Reset()
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	m_Warmed.clear();
+	m_Warming.clear();
+}
+
+PredictionHistogram TimePrewarmer::GetHistogram()
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	return m_Histogram;
+}
+
+std::size_t TimePrewarmer::GetWarmingCount()
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	return m_Warming.size();
+}
@@ -0,0 +1,365 @@
+#include "Core/Timeline.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+	constexpr char s_Magic[4] = { 'R', 'E', 'T', 'L' };
+
+	void WriteVarint(std::vector<std::uint8_t>& out, std::uint32_t value)
+	{
+		while (value >= 0x80)
+		{
+			out.push_back(static_cast<std::uint8_t>(value | 0x80));
+			value >>= 7;
+		}
+		out.push_back(static_cast<std::uint8_t>(value));
+	}
+
+	void WriteU32(std::vector<std::uint8_t>& out, std::uint32_t value)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			out.push_back(static_cast<std::uint8_t>(value >> (i * 8)));
+		}
+	}
+
+	class Reader
+	{
+	public:
+		explicit Reader(const std::vector<std::uint8_t>& data) : m_Data(data) {}
+
+		bool AtEnd() const { return m_Offset >= m_Data.size(); }
+
+		bool ReadByte(std::uint8_t& value)
+		{
+			if (AtEnd())
+			{
+				return false;
+			}
+			value = m_Data[m_Offset++];
+			return true;
+		}
+
+		bool ReadVarint(std::uint32_t& value)
+		{
+			value = 0;
+			for (int shift = 0; shift < 35; shift += 7)
+			{
+				std::uint8_t byte = 0;
+				if (!ReadByte(byte))
+				{
+					return false;
+				}
+				value |= static_cast<std::uint32_t>(byte & 0x7F) << shift;
+				if ((byte & 0x80) == 0)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		bool ReadU32(std::uint32_t& value)
+		{
+			value = 0;
+			for (int i = 0; i < 4; i++)
+			{
+				std::uint8_t byte = 0;
+				if (!ReadByte(byte))
+				{
+					return false;
+				}
+				value |= static_cast<std::uint32_t>(byte) << (i * 8);
+			}
+			return true;
+		}
+
+		bool ReadBytes(std::size_t count, std::string& value)
+		{
+			if (m_Data.size() - m_Offset < count)
+			{
+				return false;
+			}
+			value.assign(reinterpret_cast<const char*>(m_Data.data() + m_Offset), count);
+			m_Offset += count;
+			return true;
+		}
+
+	private:
+		const std::vector<std::uint8_t>& m_Data;
+		std::size_t m_Offset = 0;
+	};
+}
+
+std::vector<std::uint8_t> Timeline::Serialize() const
+{
+	std::vector<std::uint8_t> out(std::begin(s_Magic), std::end(s_Magic));
+	out.push_back(static_cast<std::uint8_t>(kVersion));
+	out.push_back(static_cast<std::uint8_t>(kVersion >> 8));
+
+	std::uint32_t lastTime = 0;
+	std::uint32_t writtenMenus = 0;
+
+	for (const TimelineEvent& event : events)
+	{
+		WriteVarint(out, event.time - lastTime);
+		lastTime = event.time;
+		out.push_back(static_cast<std::uint8_t>(event.type));
+
+		switch (event.type)
+		{
+		case TimelineEventType::kMenuOpen:
+		case TimelineEventType::kMenuClose:
+			WriteVarint(out, event.menu);
+			// Names are written the first time they are used, so the log stays readable as a stream
+			if (event.menu == writtenMenus)
+			{
+				const std::string& name = menuNames[event.menu];
+				WriteVarint(out, static_cast<std::uint32_t>(name.size()));
+				out.insert(out.end(), name.begin(), name.end());
+				writtenMenus++;
+			}
+			break;
+		case TimelineEventType::kHour:
+		{
+			std::uint32_t bits = 0;
+			std::memcpy(&bits, &event.hour, sizeof(bits));
+			WriteU32(out, bits);
+			break;
+		}
+		case TimelineEventType::kCell:
+			out.push_back(static_cast<std::uint8_t>(event.cellType));
+			break;
+		case TimelineEventType::kWeather:
+			out.push_back(event.weatherFlags.has_value() ? 1 : 0);
+			if (event.weatherFlags)
+			{
+				WriteVarint(out, *event.weatherFlags);
+			}
+			break;
+		}
+	}
+
+	return out;
+}
+
+bool Timeline::Deserialize(const std::vector<std::uint8_t>& data)
+{
+	menuNames.clear();
+	events.clear();
+
+	Reader reader(data);
+	std::string magic;
+	std::uint8_t versionLow = 0;
+	std::uint8_t versionHigh = 0;
+	if (!reader.ReadBytes(sizeof(s_Magic), magic) || magic != std::string_view(s_Magic, sizeof(s_Magic)) ||
+		!reader.ReadByte(versionLow) || !reader.ReadByte(versionHigh) ||
+		(versionLow | versionHigh << 8) != kVersion)
+	{
+		return false;
+	}
+
+	std::uint32_t time = 0;
+	while (!reader.AtEnd())
+	{
+		TimelineEvent event;
+		std::uint32_t delta = 0;
+		std::uint8_t type = 0;
+		bool valid = reader.ReadVarint(delta) && reader.ReadByte(type);
+		time += delta;
+		event.time = time;
+		event.type = static_cast<TimelineEventType>(type);
+
+		switch (event.type)
+		{
+		case TimelineEventType::kMenuOpen:
+		case TimelineEventType::kMenuClose:
+			valid = valid && reader.ReadVarint(event.menu);
+			if (valid && event.menu == menuNames.size())
+			{
+				std::uint32_t length = 0;
+				std::string name;
+				valid = reader.ReadVarint(length) && reader.ReadBytes(length, name);
+				menuNames.push_back(std::move(name));
+			}
+			valid = valid && event.menu < menuNames.size();
+			break;
+		case TimelineEventType::kHour:
+		{
+			std::uint32_t bits = 0;
+			valid = valid && reader.ReadU32(bits);
+			std::memcpy(&event.hour, &bits, sizeof(bits));
+			break;
+		}
+		case TimelineEventType::kCell:
+		{
+			std::uint8_t cellType = 0;
+			valid = valid && reader.ReadByte(cellType) && cellType <= static_cast<std::uint8_t>(CellType::kExterior);
+			event.cellType = static_cast<CellType>(cellType);
+			break;
+		}
+		case TimelineEventType::kWeather:
+		{
+			std::uint8_t hasWeather = 0;
+			valid = valid && reader.ReadByte(hasWeather);
+			if (valid && hasWeather)
+			{
+				std::uint32_t flags = 0;
+				valid = reader.ReadVarint(flags);
+				event.weatherFlags = flags;
+			}
+			break;
+		}
+		default:
+			valid = false;
+		}
+
+		if (!valid)
+		{
+			menuNames.clear();
+			events.clear();
+			return false;
+		}
+		events.push_back(event);
+	}
+
+	return true;
+}
+
+bool Timeline::Save(const std::string& path) const
+{
+	const auto data = Serialize();
+
+	std::ofstream file(path, std::ios::binary);
+	file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+	return file.good();
+}
+
+bool Timeline::Load(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+
+	const std::vector<std::uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	return Deserialize(data);
+}
+
+std::uint32_t Timeline::InternMenu(std::string_view menuName)
+{
+	for (std::uint32_t i = 0; i < menuNames.size(); i++)
+	{
+		if (menuNames[i] == menuName)
+		{
+			return i;
+		}
+	}
+	menuNames.emplace_back(menuName);
+	return static_cast<std::uint32_t>(menuNames.size() - 1);
+}
+
+void TimelineRecorder::Start()
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	m_Timeline = Timeline();
+	m_Start = std::chrono::steady_clock::now();
+	m_Recording = true;
+}
+
+void TimelineRecorder::Stop()
+{
+	m_Recording = false;
+}
+
+void TimelineRecorder::RecordMenu(std::string_view menuName, bool opening)
+{
+	if (!m_Recording)
+	{
+		return;
+	}
+
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	TimelineEvent event;
+	event.type = opening ? TimelineEventType::kMenuOpen : TimelineEventType::kMenuClose;
+	event.menu = m_Timeline.InternMenu(menuName);
+	Push(event);
+}
+
+void TimelineRecorder::RecordHour(float hour)
+{
+	if (!m_Recording)
+	{
+		return;
+	}
+
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	TimelineEvent event;
+	event.type = TimelineEventType::kHour;
+	event.hour = hour;
+	Push(event);
+}
+
+void TimelineRecorder::RecordCell(CellType cellType)
+{
+	if (!m_Recording)
+	{
+		return;
+	}
+
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	TimelineEvent event;
+	event.type = TimelineEventType::kCell;
+	event.cellType = cellType;
+	Push(event);
+}
+
+void TimelineRecorder::RecordWeather(std::optional<std::uint32_t> weatherFlags)
+{
+	if (!m_Recording)
+	{
+		return;
+	}
+
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	TimelineEvent event;
+	event.type = TimelineEventType::kWeather;
+	event.weatherFlags = weatherFlags;
+	Push(event);
+}
+
+Timeline TimelineRecorder::GetTimeline()
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	return m_Timeline;
+}
+
+std::size_t TimelineRecorder::GetEventCount()
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	return m_Timeline.events.size();
+}
+
+void TimelineRecorder::Push(TimelineEvent& event)
+{
+	const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_Start);
+	event.time = static_cast<std::uint32_t>(elapsed.count());
+
+	// Events from two threads can race for the lock, keep the log monotonic
+	if (!m_Timeline.events.empty() && event.time < m_Timeline.events.back().time)
+	{
+		event.time = m_Timeline.events.back().time;
+	}
+	m_Timeline.events.push_back(event);
+}
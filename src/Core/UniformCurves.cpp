@@ -0,0 +1,236 @@
+#include "Core/UniformCurves.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fmt/format.h>
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64)
+#include <xmmintrin.h>
+#define TOGGLER_CURVES_SSE
+#endif
+
+namespace
+{
+	// Hour wrapped into [0, 24)
+	double WrapHour(double hour)
+	{
+		hour = std::fmod(hour, 24.0);
+		return hour < 0.0 ? hour + 24.0 : hour;
+	}
+}
+
+void UniformCurves::Compile(const std::vector<CurveInfo>& curves)
+{
+	m_Segments.clear();
+	m_First.clear();
+	m_Sources.clear();
+
+	for (std::size_t i = 0; i < curves.size(); i++)
+	{
+		const std::vector<CurveKey>& keys = curves[i].keys;
+		if (keys.empty())
+		{
+			continue;
+		}
+
+		m_Sources.push_back(i);
+		m_First.push_back(static_cast<std::uint32_t>(m_Segments.size()));
+
+		for (std::size_t key = 0; key < keys.size(); key++)
+		{
+			// The last segment runs over midnight into the first key
+			const CurveKey& from = keys[key];
+			CurveKey to = key + 1 < keys.size() ? keys[key + 1] : keys.front();
+			if (key + 1 == keys.size())
+			{
+				to.hour += 24.0;
+			}
+			const double span = to.hour - from.hour;
+
+			Segment segment;
+			segment.start = static_cast<float>(from.hour);
+			segment.end = static_cast<float>(to.hour);
+			segment.value = static_cast<float>(from.value);
+			segment.slope = span > 0.0 ? static_cast<float>((to.value - from.value) / span) : 0.0f;
+			m_Segments.push_back(segment);
+		}
+	}
+	m_First.push_back(static_cast<std::uint32_t>(m_Segments.size()));
+
+	// Empty segments in the row, the first Evaluate seeks every curve
+	m_Stride = (m_Sources.size() + 3) / 4 * 4;
+	m_Cursors.assign(m_Sources.size(), 0);
+	m_Starts.assign(m_Stride, 0.0f);
+	m_Ends.assign(m_Stride, 0.0f);
+	m_Values.assign(m_Stride, 0.0f);
+	m_Slopes.assign(m_Stride, 0.0f);
+	m_Output.assign(m_Stride, 0.0f);
+	std::fill(m_Ends.begin() + m_Sources.size(), m_Ends.end(), 48.0f);
+}
+
+const float* UniformCurves::Evaluate(float hour)
+{
+	hour = static_cast<float>(WrapHour(hour));
+	float* output = m_Output.data();
+
+#ifdef TOGGLER_CURVES_SSE
+	const __m128 today = _mm_set1_ps(hour);
+	const __m128 tomorrow = _mm_set1_ps(hour + 24.0f);
+	for (std::size_t i = 0; i < m_Stride; i += 4)
+	{
+		// Before a segment's start is the part of it past midnight
+		const __m128 starts = _mm_loadu_ps(m_Starts.data() + i);
+		const __m128 after = _mm_cmpge_ps(today, starts);
+		const __m128 x = _mm_or_ps(_mm_and_ps(after, today), _mm_andnot_ps(after, tomorrow));
+
+		if (_mm_movemask_ps(_mm_cmplt_ps(x, _mm_loadu_ps(m_Ends.data() + i))) != 0xF)
+		{
+			for (std::size_t curve = i; curve < i + 4; curve++)
+			{
+				if (!Contains(curve, hour))
+				{
+					Seek(curve, hour);
+				}
+				output[curve] = ValueAt(curve, hour);
+			}
+			continue;
+		}
+
+		const __m128 offset = _mm_sub_ps(x, starts);
+		const __m128 result = _mm_add_ps(_mm_loadu_ps(m_Values.data() + i), _mm_mul_ps(offset, _mm_loadu_ps(m_Slopes.data() + i)));
+		_mm_storeu_ps(output + i, result);
+	}
+#else
+	for (std::size_t curve = 0; curve < m_Sources.size(); curve++)
+	{
+		if (!Contains(curve, hour))
+		{
+			Seek(curve, hour);
+		}
+		output[curve] = ValueAt(curve, hour);
+	}
+#endif
+
+	return output;
+}
+
+bool UniformCurves::Contains(std::size_t curve, float hour) const
+{
+	const float x = hour >= m_Starts[curve] ? hour : hour + 24.0f;
+	return x < m_Ends[curve];
+}
+
+void UniformCurves::Seek(std::size_t curve, float hour)
+{
+	const std::uint32_t first = m_First[curve];
+	const std::uint32_t last = m_First[curve + 1] - 1;
+
+	// Mostly the hour just moved on to the next key
+	std::uint32_t index = m_Cursors[curve] >= first && m_Cursors[curve] < last ? m_Cursors[curve] + 1 : first;
+	const Segment* segment = &m_Segments[index];
+	const float x = hour >= segment->start ? hour : hour + 24.0f;
+	if (x >= segment->end)
+	{
+		// Before the first key is the last segment
+		const auto begin = m_Segments.begin() + first;
+		const auto end = m_Segments.begin() + last + 1;
+		const auto next = std::upper_bound(begin, end, hour, [](float value, const Segment& candidate) { return value < candidate.start; });
+		index = next == begin ? last : static_cast<std::uint32_t>(next - m_Segments.begin()) - 1;
+		segment = &m_Segments[index];
+	}
+
+	m_Cursors[curve] = index;
+	m_Starts[curve] = segment->start;
+	m_Ends[curve] = segment->end;
+	m_Values[curve] = segment->value;
+	m_Slopes[curve] = segment->slope;
+}
+
+float UniformCurves::ValueAt(std::size_t curve, float hour) const
+{
+	const float offset = hour >= m_Starts[curve] ? hour - m_Starts[curve] : hour + 24.0f - m_Starts[curve];
+	return m_Values[curve] + offset * m_Slopes[curve];
+}
+
+double UniformCurves::EvaluateKeys(const std::vector<CurveKey>& keys, double hour)
+{
+	if (keys.empty())
+	{
+		return 0.0;
+	}
+
+	const auto next = std::upper_bound(keys.begin(), keys.end(), hour, [](double value, const CurveKey& key) { return value < key.hour; });
+
+	CurveKey from;
+	CurveKey to;
+	if (next == keys.begin() || next == keys.end())
+	{
+		// Between the last key and the first one of the next day
+		from = keys.back();
+		to = keys.front();
+		to.hour += 24.0;
+		if (hour < from.hour)
+		{
+			hour += 24.0;
+		}
+	}
+	else
+	{
+		from = *(next - 1);
+		to = *next;
+	}
+
+	const double span = to.hour - from.hour;
+	if (span <= 0.0)
+	{
+		return from.value;
+	}
+	return from.value + (to.value - from.value) * (hour - from.hour) / span;
+}
+
+std::vector<CurveKey> UniformCurves::ParseKeys(std::string_view text)
+{
+	std::vector<CurveKey> keys;
+
+	while (!text.empty())
+	{
+		const std::size_t comma = text.find(',');
+		const std::string pair(text.substr(0, comma));
+		text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+
+		char* end = nullptr;
+		CurveKey key;
+		key.hour = std::strtod(pair.c_str(), &end);
+		if (end == pair.c_str() || *end != ':')
+		{
+			continue;
+		}
+
+		const char* valueStart = end + 1;
+		key.value = std::strtod(valueStart, &end);
+		if (end == valueStart || key.hour < 0.0 || key.hour >= 24.0)
+		{
+			continue;
+		}
+
+		keys.push_back(key);
+	}
+
+	std::stable_sort(keys.begin(), keys.end(), [](const CurveKey& a, const CurveKey& b) { return a.hour < b.hour; });
+	return keys;
+}
+
+std::string UniformCurves::FormatKeys(const std::vector<CurveKey>& keys)
+{
+	std::string text;
+	for (const CurveKey& key : keys)
+	{
+		if (!text.empty())
+		{
+			text += ',';
+		}
+		text += fmt::format("{}:{}", key.hour, key.value);
+	}
+	return text;
+}
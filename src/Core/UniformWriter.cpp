@@ -0,0 +1,137 @@
+#include "Core/UniformWriter.h"
+
+#include <spdlog/spdlog.h>
+#include <type_traits>
+
+UniformWriter::Slot UniformWriter::GetSlot(const std::string& effect, const std::string& variable)
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	return FindSlot(effect, variable);
+}
+
+void UniformWriter::Set(const std::string& effect, const std::string& variable, Value value)
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	Queue(FindSlot(effect, variable), value);
+}
+
+void UniformWriter::Set(Slot slot, Value value)
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	Queue(slot, value);
+}
+
+void UniformWriter::SetFloats(const Slot* slots, const float* values, std::size_t count)
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	for (std::size_t i = 0; i < count; i++)
+	{
+		Queue(slots[i], values[i]);
+	}
+}
+
+std::size_t UniformWriter::Flush(IEffectRuntime& runtime)
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	std::size_t written = 0;
+	for (const Slot slot : m_Dirty)
+	{
+		Entry& entry = m_Entries[slot];
+		entry.dirty = false;
+
+		// Set and set back within the frame
+		if (entry.written == entry.value)
+		{
+			m_SkippedCount++;
+			continue;
+		}
+
+		if (!entry.handle)
+		{
+			entry.handle = runtime.FindUniformVariable(entry.effect.c_str(), entry.variable.c_str());
+			if (entry.handle->handle == 0)
+			{
+				spdlog::info("Uniform {} not found in {}", entry.variable, entry.effect);
+			}
+		}
+
+		if (entry.handle->handle == 0)
+		{
+			continue;
+		}
+
+		std::visit([&runtime, &entry](auto value)
+			{
+				using T = decltype(value);
+				if constexpr (std::is_same_v<T, float>)
+				{
+					runtime.SetUniformValueFloat(*entry.handle, &value, 1);
+				}
+				else if constexpr (std::is_same_v<T, std::int32_t>)
+				{
+					runtime.SetUniformValueInt(*entry.handle, &value, 1);
+				}
+				else
+				{
+					runtime.SetUniformValueBool(*entry.handle, &value, 1);
+				}
+			}, entry.value);
+
+		entry.written = entry.value;
+		written++;
+	}
+	m_Dirty.clear();
+
+	m_WriteCount += written;
+	return written;
+}
+
+void UniformWriter::Reset()
+{
+	std::scoped_lock<std::mutex> lock(m_Mutex);
+
+	for (Slot slot = 0; slot < m_Entries.size(); slot++)
+	{
+		Entry& entry = m_Entries[slot];
+		entry.handle.reset();
+		entry.written.reset();
+		if (!entry.dirty)
+		{
+			entry.dirty = true;
+			m_Dirty.push_back(slot);
+		}
+	}
+}
+
+UniformWriter::Slot UniformWriter::FindSlot(const std::string& effect, const std::string& variable)
+{
+	const auto [it, inserted] = m_Slots.try_emplace(effect + ':' + variable, m_Entries.size());
+	if (inserted)
+	{
+		Entry& entry = m_Entries.emplace_back();
+		entry.effect = effect;
+		entry.variable = variable;
+	}
+	return it->second;
+}
+
+void UniformWriter::Queue(Slot slot, Value value)
+{
+	Entry& entry = m_Entries[slot];
+	if (!entry.dirty && entry.written == value)
+	{
+		return;
+	}
+
+	entry.value = value;
+	if (!entry.dirty)
+	{
+		entry.dirty = true;
+		m_Dirty.push_back(slot);
+	}
+}
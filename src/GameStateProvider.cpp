@@ -0,0 +1,227 @@
+#include "../include/GameStateProvider.h"
+
+float GameStateProvider::GetHour() const
+{
+	const auto time = RE::Calendar::GetSingleton();
+
+	return time->GetHour();
+}
+
+float GameStateProvider::GetTimeScale() const
+{
+	const auto time = RE::Calendar::GetSingleton();
+
+	return time->GetTimescale();
+}
+
+GameDate GameStateProvider::GetDate() const
+{
+	const auto time = RE::Calendar::GetSingleton();
+
+	GameDate date;
+	date.month = time->GetMonth();
+	date.day = time->GetDay();
+	date.daysPassed = time->GetDaysPassed();
+	// Same as Calendar::GetDayName, the week doesn't restart with the month
+	date.dayOfWeek = static_cast<std::uint32_t>(date.daysPassed) % 7;
+	return date;
+}
+
+CellType GameStateProvider::GetCellType() const
+{
+	const auto player = RE::PlayerCharacter::GetSingleton();
+
+	if (const auto cell = player->GetParentCell())
+	{
+		return cell->IsInteriorCell() ? CellType::kInterior : CellType::kExterior;
+	}
+	return CellType::kNone;
+}
+
+std::uint32_t GameStateProvider::GetPlayerState() const
+{
+	const auto player = RE::PlayerCharacter::GetSingleton();
+
+	// Beast form races, looked up once
+	static const auto werewolfRace = RE::TESForm::LookupByID<RE::TESRace>(0x000CDD84);
+	static const auto vampireLordRace = RE::TESDataHandler::GetSingleton()->LookupForm<RE::TESRace>(0x00283A, "Dawnguard.esm");
+
+	std::uint32_t state = 0;
+	if (player->IsInCombat())
+	{
+		state |= static_cast<std::uint32_t>(PlayerState::kCombat);
+	}
+	if (player->IsSneaking())
+	{
+		state |= static_cast<std::uint32_t>(PlayerState::kSneaking);
+	}
+	if (player->AsActorState()->IsSwimming())
+	{
+		state |= static_cast<std::uint32_t>(PlayerState::kSwimming);
+	}
+	if (player->IsOnMount())
+	{
+		state |= static_cast<std::uint32_t>(PlayerState::kMounted);
+	}
+	if (const auto race = player->GetRace(); race && (race == werewolfRace || race == vampireLordRace))
+	{
+		state |= static_cast<std::uint32_t>(PlayerState::kTransformed);
+	}
+	return state;
+}
+
+CameraState GameStateProvider::GetCameraState() const
+{
+	const auto camera = RE::PlayerCamera::GetSingleton();
+	if (!camera || !camera->currentState)
+	{
+		return CameraState::kOther;
+	}
+
+	switch (camera->currentState->id)
+	{
+	case RE::CameraState::kFirstPerson:
+	case RE::CameraState::kIronSights:
+		return CameraState::kFirstPerson;
+	case RE::CameraState::kThirdPerson:
+	case RE::CameraState::kMount:
+	case RE::CameraState::kDragon:
+		return CameraState::kThirdPerson;
+	case RE::CameraState::kFree:
+		return CameraState::kFree;
+	case RE::CameraState::kVATS:
+		return CameraState::kKillcam;
+	default:
+		return CameraState::kOther;
+	}
+}
+
+std::optional<float> GameStateProvider::GetCellLightLevel() const
+{
+	const auto player = RE::PlayerCharacter::GetSingleton();
+	const auto cell = player ? player->GetParentCell() : nullptr;
+	if (!cell || !cell->IsInteriorCell() || !cell->GetLighting())
+	{
+		return std::nullopt;
+	}
+
+	using Inherit = RE::INTERIOR_DATA::Inherit;
+	const RE::INTERIOR_DATA& lighting = *cell->GetLighting();
+	const RE::INTERIOR_DATA* lightingTemplate = cell->lightingTemplate ? &cell->lightingTemplate->data : nullptr;
+
+	const auto luminance = [](const RE::Color& color) {
+		return (0.2126f * color.red + 0.7152f * color.green + 0.0722f * color.blue) / 255.0f;
+	};
+	// Each value comes from the template if the cell inherits it
+	const auto inherited = [&](Inherit flag) {
+		return lightingTemplate && lighting.lightingTemplateInheritanceFlags.all(flag) ? *lightingTemplate : lighting;
+	};
+
+	const RE::INTERIOR_DATA& ambient = inherited(Inherit::kAmbientColor);
+	const RE::INTERIOR_DATA& directional = inherited(Inherit::kDirectionalColor);
+	const float fade = inherited(Inherit::kDirectionalFade).directionalFade;
+
+	return std::min(1.0f, luminance(ambient.ambient) + luminance(directional.directional) * fade);
+}
+
+LocationSnapshot GameStateProvider::GetLocation() const
+{
+	const auto player = RE::PlayerCharacter::GetSingleton();
+
+	LocationSnapshot snapshot;
+	if (const auto worldspace = player->GetWorldspace())
+	{
+		snapshot.worldspace = worldspace->GetFormID();
+	}
+
+	// Parents are few, the limit only guards against a broken plugin looping them
+	auto location = player->GetCurrentLocation();
+	for (int depth = 0; location && depth < 16; depth++)
+	{
+		snapshot.locations.push_back(location->GetFormID());
+		for (std::uint32_t i = 0; i < location->numKeywords; i++)
+		{
+			if (const auto keyword = location->keywords[i])
+			{
+				snapshot.keywords.push_back(keyword->GetFormID());
+			}
+		}
+		location = location->parentLoc;
+	}
+	return snapshot;
+}
+
+std::uint32_t GameStateProvider::LookupFormID(std::string_view name) const
+{
+	// Most locations have no editor ID in memory, those are given by plugin and local FormID
+	if (const auto separator = name.find('|'); separator != std::string_view::npos)
+	{
+		const std::string plugin(name.substr(0, separator));
+		const std::string localID(name.substr(separator + 1));
+		const auto form = RE::TESDataHandler::GetSingleton()->LookupForm(static_cast<RE::FormID>(std::strtoul(localID.c_str(), nullptr, 16)), plugin);
+		return form ? form->GetFormID() : 0;
+	}
+
+	const auto form = RE::TESForm::LookupByEditorID(name);
+	return form ? form->GetFormID() : 0;
+}
+
+SceneSample GameStateProvider::GetSceneSample() const
+{
+	SceneSample sample;
+	if (const auto processLists = RE::ProcessLists::GetSingleton())
+	{
+		sample.actors = processLists->highActorHandles.size();
+	}
+
+	const auto tes = RE::TES::GetSingleton();
+	if (!tes)
+	{
+		return sample;
+	}
+
+	// At most uGridsToLoad squared cells
+	if (const auto interior = tes->interiorCell)
+	{
+		sample.references = interior->GetRuntimeData().references.size();
+	}
+	else if (const auto grid = tes->gridCells)
+	{
+		for (std::uint32_t x = 0; x < grid->length; x++)
+		{
+			for (std::uint32_t y = 0; y < grid->length; y++)
+			{
+				if (const auto cell = grid->GetCell(x, y); cell && cell->IsAttached())
+				{
+					sample.references += cell->GetRuntimeData().references.size();
+				}
+			}
+		}
+	}
+	return sample;
+}
+
+std::optional<std::uint32_t> GameStateProvider::GetWeatherFlags() const
+{
+	const auto sky = RE::Sky::GetSingleton();
+
+	if (const auto currentWeather = sky->currentWeather)
+	{
+		return static_cast<std::uint32_t>(currentWeather->data.flags.underlying());
+	}
+	return std::nullopt;
+}
+
+float GameStateProvider::GetWeatherTransition() const
+{
+	const auto sky = RE::Sky::GetSingleton();
+
+	return sky->currentWeatherPct;
+}
+
+bool GameStateProvider::IsMenuOpen() const
+{
+	const auto ui = RE::UI::GetSingleton();
+
+	return ui->GameIsPaused();
+}
@@ -3,6 +3,7 @@
 #include "../include/ReshadeToggler.h"
 #include "../include/ReshadeIntegration.h"
 #include "../include/Processor.h"
+#include "../include/Core/StateRules.h"
 
 bool Menu::CreateCombo(const char* label, std::string& currentItem, std::vector<std::string>& items, ImGuiComboFlags_ flags)
 {
@@ -34,8 +35,44 @@ bool Menu::CreateCombo(const char* label, std::string& currentItem, std::vector<
 	return itemChanged;
 }
 
+void Menu::RefreshEffectTargets()
+{
+	auto& groups = Processor::GetSingleton().GetGroups();
+	if (groups.GetRevision() == m_EffectTargetsRevision && m_EffectTargets.size() >= g_Effects.size())
+	{
+		return;
+	}
+	m_EffectTargetsRevision = groups.GetRevision();
+
+	// Groups first, they're fewer and what you'd usually pick
+	m_EffectTargets.clear();
+	for (const std::string& group : groups.GetGroupNames())
+	{
+		m_EffectTargets.push_back("@" + group);
+	}
+	m_EffectTargets.insert(m_EffectTargets.end(), g_Effects.begin(), g_Effects.end());
+}
+
+bool Menu::CreateInput(const char* label, std::string& value, float width, ImGuiInputTextFlags flags)
+{
+	char buffer[256] = { 0 };
+	value.copy(buffer, sizeof(buffer) - 1);
+
+	ImGui::PushItemWidth(width);
+	const bool changed = ImGui::InputText(label, buffer, sizeof(buffer), flags);
+	ImGui::PopItemWidth();
+
+	if (changed)
+	{
+		value = buffer;
+	}
+	return changed;
+}
+
 void Menu::SettingsMenu()
 {
+	RefreshEffectTargets();
+
 	if (ImGui::Button("Save"))
 	{
 		saveConfigPopupOpen = true; // Open the Save Config popup
@@ -108,120 +145,142 @@ void Menu::SettingsMenu()
 			RenderWeatherPage();
 		}
 	}
-}
-
-// I LOVE THIS. ALL HAIL SimpleINI!!!!!!
-void Menu::Save(const std::string& filename)
-{
-	// Define the path to your mod's TogglerConfigs directory
-	std::string configDirectory = "Data\\SKSE\\Plugins\\TogglerConfigs"; // Update this path as needed
-
-	// Ensure that the directory exists, create it if necessary
-	std::filesystem::create_directories(configDirectory);
-
-	// Combine the directory path and the provided filename
-	std::string fullPath = configDirectory + "\\" + filename + ".ini";
-
-	CSimpleIniA ini;
-	ini.SetUnicode(false);
 
-	// Save General section
-	ini.SetBoolValue("General", "EnableMenus", EnableMenus);
-	ini.SetBoolValue("General", "EnableTime", EnableTime);
-	ini.SetBoolValue("General", "EnableInterior", EnableInterior);
-	ini.SetBoolValue("General", "EnableWeather", EnableWeather);
-
-	// MenusGeneral Section
-	ini.SetValue("MenusGeneral", "MenuToggleOption", ToggleStateMenus.c_str());
-	ini.SetValue("MenusGeneral", "MenuToggleAllState", ToggleAllStateMenus.c_str());
+	if (EnableDeferral)
+	{
+		if (ImGui::CollapsingHeader("Deferred Enables", ImGuiTreeNodeFlags_CollapsingHeader))
+		{
+			RenderDeferralPage();
+		}
+	}
 
-	for (size_t i = 0; i < techniqueMenuInfoList.size(); i++)
+	if (EnableDefinitions)
 	{
-		const auto& menuInfo = techniqueMenuInfoList[i];
-		std::string effectFileKey = "MenuToggleSpecificFile" + std::to_string(i + 1);
-		std::string effectStateKey = "MenuToggleSpecificState" + std::to_string(i + 1);
-		std::string effectMenuKey = "MenuToggleSpecificMenu" + std::to_string(i + 1);
+		if (ImGui::CollapsingHeader("Definitions", ImGuiTreeNodeFlags_CollapsingHeader))
+		{
+			RenderDefinitionsPage();
+		}
+	}
 
-		ini.SetValue("MenusGeneral", effectFileKey.c_str(), menuInfo.filename.c_str());
-		ini.SetValue("MenusGeneral", effectStateKey.c_str(), menuInfo.state.c_str());
-		ini.SetValue("MenusGeneral", effectMenuKey.c_str(), menuInfo.Name.c_str());
+	if (EnableUniforms)
+	{
+		if (ImGui::CollapsingHeader("Uniforms", ImGuiTreeNodeFlags_CollapsingHeader))
+		{
+			RenderUniformsPage();
+		}
 	}
 
-	// Save MenusProcess section
-	for (size_t i = 0; i < menuList.size(); i++)
+	if (EnableCurves)
 	{
-		const auto& menuData = menuList[i];
-		std::string menuKey = "Menu" + std::to_string(i + 1);
-		ini.SetValue("MenusProcess", menuKey.c_str(), menuData.Name.c_str());
+		if (ImGui::CollapsingHeader("Curves", ImGuiTreeNodeFlags_CollapsingHeader))
+		{
+			RenderCurvesPage();
+		}
 	}
 
-	// Save Time Section
-	ini.SetValue("Time", "TimeUpdateInterval", std::to_string(TimeUpdateIntervalTime).c_str());
+	if (EnableFades)
+	{
+		if (ImGui::CollapsingHeader("Fades", ImGuiTreeNodeFlags_CollapsingHeader))
+		{
+			RenderFadesPage();
+		}
+	}
 
-	ini.SetValue("Time", "TimeToggleOption", ToggleStateTime.c_str());
-	ini.SetValue("Time", "TimeToggleAllState", ToggleAllStateTime.c_str());
+	if (EnableReshadePresets)
+	{
+		if (ImGui::CollapsingHeader("ReShade Presets", ImGuiTreeNodeFlags_CollapsingHeader))
+		{
+			RenderReshadePresetsPage();
+		}
+	}
 
-	for (const auto& info : techniqueTimeInfoListAll)
+	if (EnableExpressions)
 	{
-		ini.SetDoubleValue("Time", "TimeToggleAllTimeStart", info.startTime);
-		ini.SetDoubleValue("Time", "TimeToggleAllTimeStop", info.stopTime);
+		if (ImGui::CollapsingHeader("Expressions", ImGuiTreeNodeFlags_CollapsingHeader))
+		{
+			RenderExpressionsPage();
+		}
 	}
 
-	for (size_t i = 0; i < techniqueTimeInfoList.size(); i++)
+	if (EnableCalendar)
 	{
-		const auto& timeInfo = techniqueTimeInfoList[i];
-		std::string effectFileKey = "TimeToggleSpecificFile" + std::to_string(i + 1);
-		std::string effectStateKey = "TimeToggleSpecificState" + std::to_string(i + 1);
-		std::string effectStartTimeKey = "TimeToggleSpecificTimeStart" + std::to_string(i + 1);
-		std::string effectStopTimeKey = "TimeToggleSpecificTimeStop" + std::to_string(i + 1);
+		if (ImGui::CollapsingHeader("Calendar", ImGuiTreeNodeFlags_CollapsingHeader))
+		{
+			RenderCalendarPage();
+		}
+	}
 
-		ini.SetValue("Time", effectFileKey.c_str(), timeInfo.filename.c_str());
-		ini.SetValue("Time", effectStateKey.c_str(), timeInfo.state.c_str());
-		ini.SetDoubleValue("Time", effectStartTimeKey.c_str(), timeInfo.startTime);
-		ini.SetDoubleValue("Time", effectStopTimeKey.c_str(), timeInfo.stopTime);
+	if (EnableLocation)
+	{
+		if (ImGui::CollapsingHeader("Location", ImGuiTreeNodeFlags_CollapsingHeader))
+		{
+			RenderLocationPage();
+		}
 	}
 
-	// Save Interior section
-	ini.SetValue("Interior", "InteriorUpdateInterval", std::to_string(TimeUpdateIntervalInterior).c_str());
-	ini.SetValue("Interior", "InteriorToggleOption", ToggleStateInterior.c_str());
-	ini.SetValue("Interior", "InteriorToggleAllState", ToggleAllStateInterior.c_str());
+	if (EnableScene)
+	{
+		if (ImGui::CollapsingHeader("Scene", ImGuiTreeNodeFlags_CollapsingHeader))
+		{
+			RenderScenePage();
+		}
+	}
 
-	for (size_t i = 0; i < techniqueInteriorInfoList.size(); i++)
+	if (EnablePlayer)
 	{
-		const auto& interiorInfo = techniqueInteriorInfoList[i];
-		std::string effectFileKey = "InteriorToggleSpecificFile" + std::to_string(i + 1);
-		std::string effectStateKey = "InteriorToggleSpecificState" + std::to_string(i + 1);
+		if (ImGui::CollapsingHeader("Player", ImGuiTreeNodeFlags_CollapsingHeader))
+		{
+			RenderPlayerPage();
+		}
+	}
 
-		ini.SetValue("Interior", effectFileKey.c_str(), interiorInfo.filename.c_str());
-		ini.SetValue("Interior", effectStateKey.c_str(), interiorInfo.state.c_str());
+	if (EnableCamera)
+	{
+		if (ImGui::CollapsingHeader("Camera", ImGuiTreeNodeFlags_CollapsingHeader))
+		{
+			RenderCameraPage();
+		}
 	}
 
-	// Save Weather section
-	ini.SetValue("Weather", "WeatherUpdateInterval", std::to_string(TimeUpdateIntervalWeather).c_str());
-	ini.SetValue("Weather", "WeatherToggleOption", ToggleStateWeather.c_str());
-	ini.SetValue("Weather", "WeatherToggleAllState", ToggleAllStateWeather.c_str());
+	if (EnableLight)
+	{
+		if (ImGui::CollapsingHeader("Light", ImGuiTreeNodeFlags_CollapsingHeader))
+		{
+			RenderLightPage();
+		}
+	}
 
-	for (size_t i = 0; i < techniqueWeatherInfoList.size(); i++)
+	if (EnableHotkeys)
 	{
-		const auto& weatherInfo = techniqueWeatherInfoList[i];
-		std::string effectFileKey = "WeatherToggleSpecificFile" + std::to_string(i + 1);
-		std::string effectStateKey = "WeatherToggleSpecificState" + std::to_string(i + 1);
-		std::string effectWeatherKey = "WeatherToggleSpecificWeather" + std::to_string(i + 1);
+		if (ImGui::CollapsingHeader("Hotkeys", ImGuiTreeNodeFlags_CollapsingHeader))
+		{
+			RenderHotkeysPage();
+		}
+	}
 
-		ini.SetValue("Weather", effectFileKey.c_str(), weatherInfo.filename.c_str());
-		ini.SetValue("Weather", effectStateKey.c_str(), weatherInfo.state.c_str());
-		ini.SetValue("Weather", effectWeatherKey.c_str(), weatherInfo.Name.c_str());
+	if (ImGui::CollapsingHeader("Groups", ImGuiTreeNodeFlags_CollapsingHeader))
+	{
+		RenderGroupsPage();
 	}
 
-	// Save WeatherProcess section
-	for (size_t i = 0; i < weatherList.size(); i++)
+	if (ImGui::CollapsingHeader("Performance", ImGuiTreeNodeFlags_CollapsingHeader))
 	{
-		const auto& weatherData = weatherList[i];
-		std::string weatherKey = "Weather" + std::to_string(i + 1);
-		ini.SetValue("WeatherProcess", weatherKey.c_str(), weatherData.Name.c_str());
+		RenderPerformancePage();
 	}
+}
+
+void Menu::Save(const std::string& filename)
+{
+	// Define the path to your mod's TogglerConfigs directory
+	std::string configDirectory = "Data\\SKSE\\Plugins\\TogglerConfigs"; // Update this path as needed
+
+	// Ensure that the directory exists, create it if necessary
+	std::filesystem::create_directories(configDirectory);
+
+	// Combine the directory path and the provided filename
+	std::string fullPath = configDirectory + "\\" + filename + ".ini";
 
-	ini.SaveFile(fullPath.c_str());
+	Config::Save(fullPath);
 }
 
 void Menu::SaveConfig()
@@ -274,7 +333,7 @@ void Menu::RenderInfoPage()
 	if (ImGui::Checkbox("Enable Menu", &EnableMenus))
 	{
 		auto& eventProcessorMenu = Processor::GetSingleton();
-		if (EnableMenus)
+		if (Processor::NeedsMenuEvents())
 		{
 			RE::UI::GetSingleton()->AddEventSink<RE::MenuOpenCloseEvent>(&eventProcessorMenu);
 		}
@@ -308,7 +367,95 @@ void Menu::RenderInfoPage()
 		}
 	}
 
-	if (EnableTime || EnableInterior || EnableWeather)
+	if (ImGui::Checkbox("Enable Performance", &EnablePerformance))
+	{
+		// Nothing would turn the shed effects back on
+		if (!EnablePerformance)
+		{
+			Processor::GetSingleton().ResetGovernor();
+		}
+	}
+
+	if (ImGui::Checkbox("Enable Deferred Enables", &EnableDeferral))
+	{
+		// Loading screens are only seen through menu events
+		auto& eventProcessorMenu = Processor::GetSingleton();
+		if (Processor::NeedsMenuEvents())
+		{
+			RE::UI::GetSingleton()->AddEventSink<RE::MenuOpenCloseEvent>(&eventProcessorMenu);
+		}
+		else
+		{
+			RE::UI::GetSingleton()->RemoveEventSink<RE::MenuOpenCloseEvent>(&eventProcessorMenu);
+		}
+	}
+
+	if (ImGui::Checkbox("Enable Definitions", &EnableDefinitions))
+	{
+		// Batches go out on loading screens
+		auto& eventProcessorMenu = Processor::GetSingleton();
+		if (Processor::NeedsMenuEvents())
+		{
+			RE::UI::GetSingleton()->AddEventSink<RE::MenuOpenCloseEvent>(&eventProcessorMenu);
+		}
+		else
+		{
+			RE::UI::GetSingleton()->RemoveEventSink<RE::MenuOpenCloseEvent>(&eventProcessorMenu);
+		}
+	}
+
+	ImGui::Checkbox("Enable Uniforms", &EnableUniforms);
+	ImGui::Checkbox("Enable Curves", &EnableCurves);
+	ImGui::Checkbox("Enable Fades", &EnableFades);
+	if (ImGui::Checkbox("Enable ReShade Presets", &EnableReshadePresets))
+	{
+		// Switches wait for loading screens
+		auto& eventProcessorMenu = Processor::GetSingleton();
+		if (Processor::NeedsMenuEvents())
+		{
+			RE::UI::GetSingleton()->AddEventSink<RE::MenuOpenCloseEvent>(&eventProcessorMenu);
+		}
+		else
+		{
+			RE::UI::GetSingleton()->RemoveEventSink<RE::MenuOpenCloseEvent>(&eventProcessorMenu);
+		}
+	}
+	if (ImGui::Checkbox("Enable Expressions", &EnableExpressions))
+	{
+		// Expressions can read menus
+		auto& eventProcessorMenu = Processor::GetSingleton();
+		if (Processor::NeedsMenuEvents())
+		{
+			RE::UI::GetSingleton()->AddEventSink<RE::MenuOpenCloseEvent>(&eventProcessorMenu);
+		}
+		else
+		{
+			RE::UI::GetSingleton()->RemoveEventSink<RE::MenuOpenCloseEvent>(&eventProcessorMenu);
+		}
+	}
+
+	ImGui::Checkbox("Enable Calendar", &EnableCalendar);
+	ImGui::Checkbox("Enable Location", &EnableLocation);
+	ImGui::Checkbox("Enable Scene", &EnableScene);
+	ImGui::Checkbox("Enable Player", &EnablePlayer);
+	ImGui::Checkbox("Enable Camera", &EnableCamera);
+	ImGui::Checkbox("Enable Light", &EnableLight);
+	ImGui::Checkbox("Enable Hotkeys", &EnableHotkeys);
+
+	ImGui::Checkbox("Enable Game Uniforms", &EnableGameUniforms);
+	if (EnableGameUniforms && ImGui::IsItemHovered())
+	{
+		// The annotations shaders can use, found again on every reload
+		std::string sources;
+		for (std::size_t i = 0; i < static_cast<std::size_t>(GameUniformSource::kCount); i++)
+		{
+			sources += std::format("\n  source = \"{}\"", GameUniformFeed::GetSourceName(static_cast<GameUniformSource>(i)));
+		}
+		const auto& gameUniforms = Processor::GetSingleton().GetGameUniforms();
+		ImGui::SetTooltip("%zu uniforms fed, %zu writes%s", gameUniforms.GetUniformCount(), gameUniforms.GetWriteCount(), sources.c_str());
+	}
+
+	if (EnableTime || EnableInterior || EnableWeather || EnableScene)
 		ImGui::SeparatorText("Update Intervals");
 	if (EnableTime)
 		ImGui::SliderInt("Time Update Interval", &TimeUpdateIntervalTime, 0, 120, "%d");
@@ -316,6 +463,49 @@ void Menu::RenderInfoPage()
 		ImGui::SliderInt("Interior Update Interval", &TimeUpdateIntervalInterior, 0, 120, "%d");
 	if (EnableWeather)
 		ImGui::SliderInt("Weather Update Interval", &TimeUpdateIntervalWeather, 0, 120, "%d");
+	if (EnableScene)
+		ImGui::SliderInt("Scene Update Interval", &TimeUpdateIntervalScene, 1, 120, "%d");
+
+	RenderRecordingControls();
+}
+
+void Menu::RenderRecordingControls()
+{
+	ImGui::SeparatorText("Timeline Recording");
+
+	auto& recorder = Processor::GetSingleton().GetRecorder();
+
+	if (!recorder.IsRecording())
+	{
+		if (ImGui::Button("Start Recording"))
+		{
+			recorder.Start();
+		}
+		return;
+	}
+
+	ImGui::Text("Recording... %zu events", recorder.GetEventCount());
+	ImGui::SameLine();
+	if (ImGui::Button("Stop and Save"))
+	{
+		recorder.Stop();
+
+		// Lives next to the presets but with its own extension so preset enumeration skips it
+		const std::string timelineDirectory = "Data\\SKSE\\Plugins\\TogglerTimelines";
+		std::filesystem::create_directories(timelineDirectory);
+
+		const auto now = std::chrono::system_clock::now().time_since_epoch();
+		const std::string timelinePath = std::format("{}\\Timeline_{}.retl", timelineDirectory, std::chrono::duration_cast<std::chrono::seconds>(now).count());
+
+		if (recorder.GetTimeline().Save(timelinePath))
+		{
+			g_Logger->info("Saved timeline to {}", timelinePath);
+		}
+		else
+		{
+			g_Logger->info("Failed to save timeline to {}", timelinePath);
+		}
+	}
 }
 
 void Menu::RenderMenusPage()
@@ -403,7 +593,7 @@ void Menu::RenderMenusPage()
 					std::string currentEffectState = menuInfo.state;
 					std::string currentEffectMenu = menuInfo.Name;
 
-					if (CreateCombo(effectComboID.c_str(), currentEffectFileName, g_Effects, ImGuiComboFlags_None)) { valueChanged = true; }
+					if (CreateCombo(effectComboID.c_str(), currentEffectFileName, m_EffectTargets, ImGuiComboFlags_None)) { valueChanged = true; }
 					ImGui::SameLine();
 					if (CreateCombo(effectStateID.c_str(), currentEffectState, g_EffectStateMenu, ImGuiComboFlags_None)) { valueChanged = true; }
 					if (CreateCombo(menuID.c_str(), currentEffectMenu, g_MenuNames, ImGuiComboFlags_None)) { valueChanged = true; }
@@ -423,6 +613,7 @@ void Menu::RenderMenusPage()
 						menuInfo.filename = currentEffectFileName;
 						menuInfo.state = currentEffectState;
 						menuInfo.Name = currentEffectMenu;
+						ruleRevision++;
 					}
 				}
 			}
@@ -447,6 +638,12 @@ void Menu::RenderTimePage()
 {
 	ImGui::SeparatorText("Toggle State");
 	CreateCombo("Time Toggle State", ToggleStateTime, g_ToggleState, ImGuiComboFlags_None);
+	ImGui::SameLine();
+	ImGui::TextDisabled("(?)");
+	if (ImGui::IsItemHovered())
+	{
+		ImGui::SetTooltip("A start time after the stop time runs over midnight, eg. 22.00 to 5.00.");
+	}
 
 	if (ToggleStateTime.find("All") != std::string::npos)
 	{
@@ -479,6 +676,8 @@ void Menu::RenderTimePage()
 	// Wtf happened to this... holy crap this nesting!
 	if (ToggleStateTime.find("Specific") != std::string::npos)
 	{
+		RenderPrewarmSettings();
+
 		ImGui::SeparatorText("Effects");
 		if (!techniqueTimeInfoList.empty())
 		{
@@ -503,7 +702,7 @@ void Menu::RenderTimePage()
 
 					bool valueChanged = false;
 
-					if (CreateCombo(effectComboID.c_str(), currentEffectFileName, g_Effects, ImGuiComboFlags_None)) { valueChanged = true; }
+					if (CreateCombo(effectComboID.c_str(), currentEffectFileName, m_EffectTargets, ImGuiComboFlags_None)) { valueChanged = true; }
 					ImGui::SameLine();
 					if (CreateCombo(effectStateID.c_str(), currentEffectState, g_EffectStateTime, ImGuiComboFlags_None)) { valueChanged = true; }
 					ImGui::SetNextItemWidth(200.0f);
@@ -531,6 +730,7 @@ void Menu::RenderTimePage()
 						timeInfo.state = currentEffectState;
 						timeInfo.startTime = currentStartTime;
 						timeInfo.stopTime = currentStopTime;
+						ruleRevision++;
 
 						//ImGui::Text("New Values for %i: Effect: %s - State: %s - Start: %.2f - Stop: %.2f", i, timeInfo.filename.c_str(), timeInfo.state.c_str(), timeInfo.startTime, timeInfo.stopTime);
 					}
@@ -586,7 +786,7 @@ void Menu::RenderInteriorPage()
 					std::string currentEffectFileName = interiorInfo.filename;
 					std::string currentEffectState = interiorInfo.state;
 
-					if (CreateCombo(effectComboID.c_str(), currentEffectFileName, g_Effects, ImGuiComboFlags_None)) { valueChanged = true; }
+					if (CreateCombo(effectComboID.c_str(), currentEffectFileName, m_EffectTargets, ImGuiComboFlags_None)) { valueChanged = true; }
 					ImGui::SameLine();
 					if (CreateCombo(effectStateID.c_str(), currentEffectState, g_EffectStateInterior, ImGuiComboFlags_None)) { valueChanged = true; }
 
@@ -604,6 +804,7 @@ void Menu::RenderInteriorPage()
 					{
 						interiorInfo.filename = currentEffectFileName;
 						interiorInfo.state = currentEffectState;
+						ruleRevision++;
 					}
 				}
 			}
@@ -706,7 +907,7 @@ void Menu::RenderWeatherPage()
 					std::string currentEffectState = weatherInfo.state;
 					std::string currentWeatherFlag = weatherInfo.Name;
 
-					if (CreateCombo(effectComboID.c_str(), currentEffectFileName, g_Effects, ImGuiComboFlags_None)) { valueChanged = true; }
+					if (CreateCombo(effectComboID.c_str(), currentEffectFileName, m_EffectTargets, ImGuiComboFlags_None)) { valueChanged = true; }
 					ImGui::SameLine();
 					if (CreateCombo(effectStateID.c_str(), currentEffectState, g_EffectStateWeather, ImGuiComboFlags_None)) { valueChanged = true; }
 					if (CreateCombo(weatherID.c_str(), currentWeatherFlag, g_WeatherFlags, ImGuiComboFlags_None)) { valueChanged = true; }
@@ -725,6 +926,7 @@ void Menu::RenderWeatherPage()
 						weatherInfo.filename = currentEffectFileName;
 						weatherInfo.state = currentEffectState;
 						weatherInfo.Name = currentWeatherFlag;
+						ruleRevision++;
 					}
 				}
 			}
@@ -742,4 +944,1021 @@ void Menu::RenderWeatherPage()
 			techniqueWeatherInfoList.push_back(info);
 		}
 	}
-}
\ No newline at end of file
+}
+
+void Menu::RenderPerformancePage()
+{
+	auto& frameStats = Processor::GetSingleton().GetFrameStats();
+
+	if (EnablePerformance)
+	{
+		RenderGovernorSettings();
+	}
+
+	ImGui::SeparatorText("Frame Times");
+
+	ImGui::SliderInt("Window (frames)", &m_StatsWindowFrames, 60, static_cast<int>(FrameTimeRing::kCapacity), "%d");
+
+	const FrameStats::Window window = frameStats.GetWindow(static_cast<std::size_t>(m_StatsWindowFrames));
+	ImGui::Text("p50 %.2f ms   p95 %.2f ms   p99 %.2f ms   (%zu frames)", window.p50, window.p95, window.p99, window.frames);
+
+	if (window.changes.empty())
+	{
+		ImGui::TextDisabled("No technique changes in this window");
+	}
+	else if (ImGui::TreeNode("Changes", "%zu technique changes in this window", window.changes.size()))
+	{
+		for (const TechniqueChange& change : window.changes)
+		{
+			ImGui::Text("Frame %llu: %s %s", static_cast<unsigned long long>(change.frame),
+				change.effect.empty() ? "All effects" : change.effect.c_str(), change.enabled ? "on" : "off");
+		}
+		ImGui::TreePop();
+	}
+
+	if (ImGui::Button("Export CSV##FrameStats"))
+	{
+		const std::string statsDirectory = "Data\\SKSE\\Plugins\\TogglerFrameStats";
+		std::filesystem::create_directories(statsDirectory);
+
+		const auto now = std::chrono::system_clock::now().time_since_epoch();
+		const std::string statsPath = std::format("{}\\FrameStats_{}.csv", statsDirectory, std::chrono::duration_cast<std::chrono::seconds>(now).count());
+
+		if (frameStats.SaveCSV(statsPath, static_cast<std::size_t>(m_StatsWindowFrames)))
+		{
+			g_Logger->info("Saved frame stats to {}", statsPath);
+		}
+	}
+
+	RenderProfilerPage();
+}
+
+void Menu::RenderProfilerPage()
+{
+	ImGui::SeparatorText("Effect Costs");
+
+	auto& processor = Processor::GetSingleton();
+	auto& profiler = processor.GetProfiler();
+
+	if (!profiler.IsRunning())
+	{
+		CostProfiler::Settings settings = profiler.GetSettings();
+		int windowFrames = static_cast<int>(settings.windowFrames);
+		int rounds = static_cast<int>(settings.rounds);
+		ImGui::SliderInt("Frames per sample", &windowFrames, 10, 240, "%d");
+		ImGui::SliderInt("Rounds", &rounds, 2, 30, "%d");
+		settings.windowFrames = static_cast<std::size_t>(windowFrames);
+		settings.rounds = static_cast<std::size_t>(rounds);
+		profiler.SetSettings(settings);
+
+		if (ImGui::Button("Profile Enabled Effects"))
+		{
+			if (!processor.StartProfiling(g_Effects))
+			{
+				g_Logger->info("Nothing to profile, no enabled effects or no runtime yet");
+			}
+		}
+	}
+	else
+	{
+		ImGui::ProgressBar(profiler.GetProgress());
+		ImGui::TextDisabled("Keep the camera still, effects are switched off one at a time");
+		if (ImGui::Button("Stop Profiling"))
+		{
+			processor.StopProfiling();
+		}
+	}
+
+	const auto results = profiler.GetResults();
+	if (results.empty())
+	{
+		return;
+	}
+
+	if (ImGui::BeginTable("EffectCosts", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+	{
+		ImGui::TableSetupColumn("Effect");
+		ImGui::TableSetupColumn("Cost (ms)");
+		ImGui::TableSetupColumn("Samples");
+		ImGui::TableHeadersRow();
+
+		for (const CostProfiler::Result& result : results)
+		{
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(result.effect.c_str());
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f +- %.3f", result.cost, result.confidence);
+			ImGui::TableNextColumn();
+			ImGui::Text("%zu", result.samples);
+		}
+		ImGui::EndTable();
+	}
+
+	if (ImGui::Button("Export CSV##EffectCosts"))
+	{
+		const std::string statsDirectory = "Data\\SKSE\\Plugins\\TogglerFrameStats";
+		std::filesystem::create_directories(statsDirectory);
+
+		const auto now = std::chrono::system_clock::now().time_since_epoch();
+		const std::string costsPath = std::format("{}\\EffectCosts_{}.csv", statsDirectory, std::chrono::duration_cast<std::chrono::seconds>(now).count());
+
+		if (profiler.SaveCSV(costsPath))
+		{
+			g_Logger->info("Saved effect costs to {}", costsPath);
+		}
+	}
+}
+
+void Menu::RenderGovernorSettings()
+{
+	ImGui::SeparatorText("Frame Budget");
+
+	float targetFrameTime = static_cast<float>(PerformanceTargetFrameTime);
+	if (ImGui::SliderFloat("Target Frame Time (ms)", &targetFrameTime, 4.0f, 50.0f, "%.1f"))
+	{
+		PerformanceTargetFrameTime = targetFrameTime;
+	}
+
+	float headroom = static_cast<float>(PerformanceHeadroom * 100.0);
+	if (ImGui::SliderFloat("Headroom (%)", &headroom, 0.0f, 50.0f, "%.0f"))
+	{
+		PerformanceHeadroom = headroom / 100.0;
+	}
+
+	ImGui::SliderInt("Window (frames)##Governor", &PerformanceWindowFrames, 1, 240, "%d");
+
+	const auto& ruleEngine = Processor::GetSingleton().GetRuleEngine();
+	ImGui::Text("Last window p95: %.2f ms - %zu effects shed", ruleEngine.GetGovernor().GetLastFrameTime(), ruleEngine.GetShedEffects().size());
+
+	ImGui::SeparatorText("Effects (lowest priority is disabled first)");
+	for (int i = 0; i < techniquePerformanceInfoList.size(); i++)
+	{
+		auto& performanceInfo = techniquePerformanceInfoList[i];
+
+		std::string effectComboID = "Effect##Perf" + std::to_string(i);
+		std::string priorityID = "Priority##Perf" + std::to_string(i);
+		std::string removeID = "Remove Effect##Perf" + std::to_string(i);
+
+		CreateCombo(effectComboID.c_str(), performanceInfo.filename, g_Effects, ImGuiComboFlags_None);
+		ImGui::SameLine();
+		ImGui::PushItemWidth(100.0f);
+		ImGui::InputInt(priorityID.c_str(), &performanceInfo.priority);
+		ImGui::PopItemWidth();
+
+		if (ImGui::Button(removeID.c_str()))
+		{
+			techniquePerformanceInfoList.erase(techniquePerformanceInfoList.begin() + i);
+			i--;
+		}
+	}
+
+	ImGui::Separator();
+
+	if (ImGui::Button("Add New Effect##Perf"))
+	{
+		TechniqueInfo info;
+		info.filename = "Default.fx";
+		info.state = "off";
+
+		techniquePerformanceInfoList.push_back(info);
+	}
+}
+
+void Menu::RenderDeferralPage()
+{
+	ImGui::TextWrapped("Enabling these effects waits for the next loading screen, so a shader compile doesn't hitch gameplay. Disabling is always immediate.");
+
+	ImGui::SliderInt("Timeout (s, 0 = none)", &DeferralTimeout, 0, 600, "%d");
+	ImGui::Text("Waiting: %zu effects", Processor::GetSingleton().GetDeferredRuntime().GetPendingCount());
+
+	ImGui::SeparatorText("Effects");
+	for (int i = 0; i < deferredEffectList.size(); i++)
+	{
+		std::string effectComboID = "Effect##Defer" + std::to_string(i);
+		std::string removeID = "Remove Effect##Defer" + std::to_string(i);
+
+		CreateCombo(effectComboID.c_str(), deferredEffectList[i], g_Effects, ImGuiComboFlags_None);
+		ImGui::SameLine();
+		if (ImGui::Button(removeID.c_str()))
+		{
+			deferredEffectList.erase(deferredEffectList.begin() + i);
+			i--;
+		}
+	}
+
+	ImGui::Separator();
+
+	if (ImGui::Button("Add New Effect##Defer"))
+	{
+		deferredEffectList.push_back("Default.fx");
+	}
+}
+
+void Menu::RenderDefinitionsPage()
+{
+	ImGui::TextWrapped("Switches effect preprocessor definitions, eg. a cheaper quality tier indoors. Changes are collected and applied together on the next loading screen or after the delay, so every effect recompiles once.");
+
+	ImGui::SliderInt("Delay (s, 0 = loading screens only)", &DefinitionBatchDelay, 0, 600, "%d");
+
+	auto& definitionRuntime = Processor::GetSingleton().GetDefinitionRuntime();
+	ImGui::Text("Waiting: %zu definitions - %zu batches applied", definitionRuntime.GetPendingCount(), definitionRuntime.GetBatchCount());
+	if (ImGui::Button("Apply Now##Define"))
+	{
+		definitionRuntime.Flush();
+	}
+
+	ImGui::SeparatorText("Definitions");
+	for (int i = 0; i < definitionInfoList.size(); i++)
+	{
+		auto& definitionInfo = definitionInfoList[i];
+
+		std::string effectComboID = "Effect##Define" + std::to_string(i);
+		std::string nameID = "Name##Define" + std::to_string(i);
+		std::string valueID = "Value##Define" + std::to_string(i);
+		std::string defaultID = "Default##Define" + std::to_string(i);
+		std::string categoryID = "When##Define" + std::to_string(i);
+		std::string conditionID = "Condition##Define" + std::to_string(i);
+		std::string startTimeID = "StartTime##Define" + std::to_string(i);
+		std::string stopTimeID = "StopTime##Define" + std::to_string(i);
+		std::string removeID = "Remove##Define" + std::to_string(i);
+
+		CreateCombo(effectComboID.c_str(), definitionInfo.filename, g_Effects, ImGuiComboFlags_None);
+		ImGui::SameLine();
+		CreateInput(nameID.c_str(), definitionInfo.name);
+		CreateInput(valueID.c_str(), definitionInfo.value);
+		ImGui::SameLine();
+		CreateInput(defaultID.c_str(), definitionInfo.defaultValue);
+		CreateCombo(categoryID.c_str(), definitionInfo.category, g_DefinitionCategory, ImGuiComboFlags_None);
+
+		if (definitionInfo.category == "Menu")
+		{
+			ImGui::SameLine();
+			CreateCombo(conditionID.c_str(), definitionInfo.condition, g_MenuNames, ImGuiComboFlags_None);
+		}
+		else if (definitionInfo.category == "Weather")
+		{
+			ImGui::SameLine();
+			CreateCombo(conditionID.c_str(), definitionInfo.condition, g_WeatherFlags, ImGuiComboFlags_None);
+		}
+		else if (definitionInfo.category == "Time")
+		{
+			ImGui::SetNextItemWidth(200.0f);
+			ImGui::SliderScalar(startTimeID.c_str(), ImGuiDataType_Double, &definitionInfo.startTime, &minTime, &maxTime, "%.2f");
+			ImGui::SameLine();
+			ImGui::SetNextItemWidth(200.0f);
+			ImGui::SliderScalar(stopTimeID.c_str(), ImGuiDataType_Double, &definitionInfo.stopTime, &minTime, &maxTime, "%.2f");
+		}
+
+		if (ImGui::Button(removeID.c_str()))
+		{
+			definitionInfoList.erase(definitionInfoList.begin() + i);
+			i--;
+		}
+
+		ImGui::Separator();
+	}
+
+	if (ImGui::Button("Add New Definition##Define"))
+	{
+		DefinitionInfo info;
+		info.filename = "Default.fx";
+		info.category = "Interior";
+
+		definitionInfoList.push_back(info);
+	}
+}
+
+void Menu::RenderUniformsPage()
+{
+	ImGui::TextWrapped("Sets effect uniforms while a condition holds, eg. weaker bloom at night, so one effect can stand in for several variants.");
+
+	const auto& uniforms = Processor::GetSingleton().GetUniformWriter();
+	ImGui::Text("%zu writes - %zu repeats dropped", uniforms.GetWriteCount(), uniforms.GetSkippedCount());
+
+	ImGui::SeparatorText("Uniforms");
+	for (int i = 0; i < uniformInfoList.size(); i++)
+	{
+		auto& uniformInfo = uniformInfoList[i];
+
+		std::string effectComboID = "Effect##Uniform" + std::to_string(i);
+		std::string nameID = "Name##Uniform" + std::to_string(i);
+		std::string typeID = "Type##Uniform" + std::to_string(i);
+		std::string valueID = "Value##Uniform" + std::to_string(i);
+		std::string defaultID = "Default##Uniform" + std::to_string(i);
+		std::string categoryID = "When##Uniform" + std::to_string(i);
+		std::string conditionID = "Condition##Uniform" + std::to_string(i);
+		std::string startTimeID = "StartTime##Uniform" + std::to_string(i);
+		std::string stopTimeID = "StopTime##Uniform" + std::to_string(i);
+		std::string removeID = "Remove##Uniform" + std::to_string(i);
+
+		CreateCombo(effectComboID.c_str(), uniformInfo.filename, g_Effects, ImGuiComboFlags_None);
+		ImGui::SameLine();
+		CreateInput(nameID.c_str(), uniformInfo.name);
+		CreateCombo(typeID.c_str(), uniformInfo.type, g_UniformType, ImGuiComboFlags_None);
+		ImGui::SetNextItemWidth(150.0f);
+		ImGui::InputDouble(valueID.c_str(), &uniformInfo.value, 0.0, 0.0, "%.3f");
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(150.0f);
+		ImGui::InputDouble(defaultID.c_str(), &uniformInfo.defaultValue, 0.0, 0.0, "%.3f");
+		CreateCombo(categoryID.c_str(), uniformInfo.category, g_DefinitionCategory, ImGuiComboFlags_None);
+
+		if (uniformInfo.category == "Menu")
+		{
+			ImGui::SameLine();
+			CreateCombo(conditionID.c_str(), uniformInfo.condition, g_MenuNames, ImGuiComboFlags_None);
+		}
+		else if (uniformInfo.category == "Weather")
+		{
+			ImGui::SameLine();
+			CreateCombo(conditionID.c_str(), uniformInfo.condition, g_WeatherFlags, ImGuiComboFlags_None);
+		}
+		else if (uniformInfo.category == "Time")
+		{
+			ImGui::SetNextItemWidth(200.0f);
+			ImGui::SliderScalar(startTimeID.c_str(), ImGuiDataType_Double, &uniformInfo.startTime, &minTime, &maxTime, "%.2f");
+			ImGui::SameLine();
+			ImGui::SetNextItemWidth(200.0f);
+			ImGui::SliderScalar(stopTimeID.c_str(), ImGuiDataType_Double, &uniformInfo.stopTime, &minTime, &maxTime, "%.2f");
+		}
+
+		if (ImGui::Button(removeID.c_str()))
+		{
+			uniformInfoList.erase(uniformInfoList.begin() + i);
+			i--;
+		}
+
+		ImGui::Separator();
+	}
+
+	if (ImGui::Button("Add New Uniform##Uniform"))
+	{
+		UniformInfo info;
+		info.filename = "Default.fx";
+		info.category = "Interior";
+
+		uniformInfoList.push_back(info);
+	}
+}
+
+void Menu::RenderCurvesPage()
+{
+	ImGui::TextWrapped("Float uniforms that follow keyframes over the day, eg. \"6:0.2,12:1,20:0.3\" (hour:value, press enter to apply). Values are linear in between and wrap around midnight.");
+
+	const float hour = RE::Calendar::GetSingleton()->GetHour();
+	bool curvesChanged = false;
+
+	ImGui::SeparatorText("Curves");
+	for (int i = 0; i < curveInfoList.size(); i++)
+	{
+		auto& curveInfo = curveInfoList[i];
+
+		std::string effectComboID = "Effect##Curve" + std::to_string(i);
+		std::string nameID = "Name##Curve" + std::to_string(i);
+		std::string keysID = "Keys##Curve" + std::to_string(i);
+		std::string plotID = "##CurvePlot" + std::to_string(i);
+		std::string removeID = "Remove##Curve" + std::to_string(i);
+
+		if (CreateCombo(effectComboID.c_str(), curveInfo.filename, g_Effects, ImGuiComboFlags_None)) { curvesChanged = true; }
+		ImGui::SameLine();
+		if (CreateInput(nameID.c_str(), curveInfo.name)) { curvesChanged = true; }
+
+		std::string keys = UniformCurves::FormatKeys(curveInfo.keys);
+		if (CreateInput(keysID.c_str(), keys, 400.0f, ImGuiInputTextFlags_EnterReturnsTrue))
+		{
+			curveInfo.keys = UniformCurves::ParseKeys(keys);
+			curvesChanged = true;
+		}
+
+		// Half hour steps over the whole day
+		float samples[48];
+		for (int sample = 0; sample < 48; sample++)
+		{
+			samples[sample] = static_cast<float>(UniformCurves::EvaluateKeys(curveInfo.keys, sample * 0.5));
+		}
+		const std::string overlay = std::format("{:.3f} now", UniformCurves::EvaluateKeys(curveInfo.keys, hour));
+		ImGui::PlotLines(plotID.c_str(), samples, 48, 0, overlay.c_str(), FLT_MAX, FLT_MAX, ImVec2(400.0f, 60.0f));
+
+		if (ImGui::Button(removeID.c_str()))
+		{
+			curveInfoList.erase(curveInfoList.begin() + i);
+			i--;
+			curvesChanged = true;
+		}
+
+		ImGui::Separator();
+	}
+
+	if (ImGui::Button("Add New Curve##Curve"))
+	{
+		CurveInfo info;
+		info.filename = "Default.fx";
+
+		curveInfoList.push_back(info);
+		curvesChanged = true;
+	}
+
+	if (curvesChanged)
+	{
+		curveRevision++;
+	}
+}
+
+void Menu::RenderFadesPage()
+{
+	ImGui::TextWrapped("Ramps an intensity uniform of the effect instead of switching it on and off at once. The effect has to scale its output by the uniform, 0 is off.");
+
+	ImGui::Text("%zu fades running", Processor::GetSingleton().GetFadeRuntime().GetActiveCount());
+
+	ImGui::SeparatorText("Fades");
+	for (int i = 0; i < fadeInfoList.size(); i++)
+	{
+		auto& fadeInfo = fadeInfoList[i];
+
+		std::string effectComboID = "Effect##Fade" + std::to_string(i);
+		std::string uniformID = "Uniform##Fade" + std::to_string(i);
+		std::string durationID = "Duration (ms)##Fade" + std::to_string(i);
+		std::string maxID = "Max##Fade" + std::to_string(i);
+		std::string removeID = "Remove##Fade" + std::to_string(i);
+
+		CreateCombo(effectComboID.c_str(), fadeInfo.filename, g_Effects, ImGuiComboFlags_None);
+		ImGui::SameLine();
+		CreateInput(uniformID.c_str(), fadeInfo.uniform);
+		ImGui::SetNextItemWidth(200.0f);
+		double minDuration = 0.0;
+		double maxDuration = 5000.0;
+		ImGui::SliderScalar(durationID.c_str(), ImGuiDataType_Double, &fadeInfo.duration, &minDuration, &maxDuration, "%.0f");
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(150.0f);
+		ImGui::InputDouble(maxID.c_str(), &fadeInfo.maxValue, 0.0, 0.0, "%.3f");
+
+		if (ImGui::Button(removeID.c_str()))
+		{
+			fadeInfoList.erase(fadeInfoList.begin() + i);
+			i--;
+		}
+
+		ImGui::Separator();
+	}
+
+	if (ImGui::Button("Add New Fade##Fade"))
+	{
+		FadeInfo info;
+		info.filename = "Default.fx";
+
+		fadeInfoList.push_back(info);
+	}
+}
+
+void Menu::RenderGroupsPage()
+{
+	ImGui::TextWrapped("Named sets of effects that Menu, Time, Interior and Weather rules can target as @Name. Members are effect files or \"Effect.fx:Technique\", separated by commas (press enter to apply). Techniques can also join with a toggler_group = \"Name\" annotation.");
+
+	auto& groups = Processor::GetSingleton().GetGroups();
+	ImGui::Text("%zu groups over %zu techniques", groups.GetGroupNames().size(), groups.GetTechniqueCount());
+
+	bool groupsChanged = false;
+
+	ImGui::SeparatorText("Groups");
+	for (int i = 0; i < groupInfoList.size(); i++)
+	{
+		auto& groupInfo = groupInfoList[i];
+
+		std::string nameID = "Name##Group" + std::to_string(i);
+		std::string membersID = "Members##Group" + std::to_string(i);
+		std::string removeID = "Remove##Group" + std::to_string(i);
+
+		if (CreateInput(nameID.c_str(), groupInfo.name, 150.0f, ImGuiInputTextFlags_EnterReturnsTrue)) { groupsChanged = true; }
+
+		std::string members = EffectGroups::FormatMembers(groupInfo.members);
+		if (CreateInput(membersID.c_str(), members, 400.0f, ImGuiInputTextFlags_EnterReturnsTrue))
+		{
+			groupInfo.members = EffectGroups::ParseMembers(members);
+			groupsChanged = true;
+		}
+
+		std::size_t techniqueCount = 0;
+		for (const std::uint64_t word : groups.GetTechniques(groupInfo.name))
+		{
+			techniqueCount += std::popcount(word);
+		}
+		ImGui::Text("%zu techniques", techniqueCount);
+
+		if (ImGui::Button(removeID.c_str()))
+		{
+			groupInfoList.erase(groupInfoList.begin() + i);
+			i--;
+			groupsChanged = true;
+		}
+
+		ImGui::Separator();
+	}
+
+	if (ImGui::Button("Add New Group##Group"))
+	{
+		GroupInfo info;
+		info.name = "Group" + std::to_string(groupInfoList.size() + 1);
+
+		groupInfoList.push_back(info);
+		groupsChanged = true;
+	}
+
+	if (groupsChanged)
+	{
+		groupRevision++;
+	}
+}
+
+void Menu::RenderExpressionsPage()
+{
+	ImGui::TextWrapped("Sets an effect while an expression holds and the opposite otherwise, eg. interior && hour(22, 5) && !menu(MapMenu). Terms are interior, exterior, menu(Name), weather(kName), player(State), camera(State), light(Band) and hour(start, stop), combined with ! && || and parentheses (press enter to apply).");
+
+	bool expressionsChanged = false;
+
+	for (int i = 0; i < expressionInfoList.size(); i++)
+	{
+		auto& expressionInfo = expressionInfoList[i];
+
+		std::string effectID = "Effect##Expression" + std::to_string(i);
+		std::string stateID = "State##Expression" + std::to_string(i);
+		std::string expressionID = "Expression##Expression" + std::to_string(i);
+		std::string removeID = "Remove##Expression" + std::to_string(i);
+
+		if (CreateCombo(effectID.c_str(), expressionInfo.filename, m_EffectTargets, ImGuiComboFlags_None)) { expressionsChanged = true; }
+		ImGui::SameLine();
+		if (CreateCombo(stateID.c_str(), expressionInfo.state, g_EffectStateExpression, ImGuiComboFlags_None)) { expressionsChanged = true; }
+
+		if (CreateInput(expressionID.c_str(), expressionInfo.expression, 400.0f, ImGuiInputTextFlags_EnterReturnsTrue)) { expressionsChanged = true; }
+
+		ConditionExpressions check;
+		std::string error;
+		if (!check.Add(expressionInfo.expression, &error))
+		{
+			ImGui::TextWrapped("Doesn't parse: %s", error.c_str());
+		}
+
+		if (ImGui::Button(removeID.c_str()))
+		{
+			expressionInfoList.erase(expressionInfoList.begin() + i);
+			i--;
+			expressionsChanged = true;
+		}
+
+		ImGui::Separator();
+	}
+
+	if (ImGui::Button("Add New Expression##Expression"))
+	{
+		ExpressionInfo info;
+		info.filename = "Default.fx";
+		info.expression = "interior";
+
+		expressionInfoList.push_back(info);
+		expressionsChanged = true;
+	}
+
+	if (expressionsChanged)
+	{
+		expressionRevision++;
+	}
+}
+
+void Menu::RenderCalendarPage()
+{
+	ImGui::TextWrapped("Sets an effect on the in-game dates that match and the opposite otherwise. A rule matches in the ticked months, on the ticked days of the week and within the days passed range, a last day of -1 has no end.");
+
+	bool calendarChanged = false;
+
+	for (int i = 0; i < calendarInfoList.size(); i++)
+	{
+		auto& calendarInfo = calendarInfoList[i];
+
+		std::string effectID = "Effect##Calendar" + std::to_string(i);
+		std::string stateID = "State##Calendar" + std::to_string(i);
+		std::string firstDayID = "First Day##Calendar" + std::to_string(i);
+		std::string lastDayID = "Last Day##Calendar" + std::to_string(i);
+		std::string removeID = "Remove##Calendar" + std::to_string(i);
+
+		if (CreateCombo(effectID.c_str(), calendarInfo.filename, m_EffectTargets, ImGuiComboFlags_None)) { calendarChanged = true; }
+		ImGui::SameLine();
+		if (CreateCombo(stateID.c_str(), calendarInfo.state, g_EffectStateCalendar, ImGuiComboFlags_None)) { calendarChanged = true; }
+
+		for (int month = 0; month < CalendarRules::kMonthNames.size(); month++)
+		{
+			std::string monthID = std::string(CalendarRules::kMonthNames[month]) + "##Calendar" + std::to_string(i);
+			unsigned int months = calendarInfo.months;
+			if (month % 6 != 0)
+			{
+				ImGui::SameLine();
+			}
+			if (ImGui::CheckboxFlags(monthID.c_str(), &months, 1u << month))
+			{
+				calendarInfo.months = static_cast<std::uint16_t>(months);
+				calendarChanged = true;
+			}
+		}
+
+		for (int weekday = 0; weekday < CalendarRules::kWeekdayNames.size(); weekday++)
+		{
+			std::string weekdayID = std::string(CalendarRules::kWeekdayNames[weekday]) + "##Calendar" + std::to_string(i);
+			unsigned int weekdays = calendarInfo.weekdays;
+			if (weekday != 0)
+			{
+				ImGui::SameLine();
+			}
+			if (ImGui::CheckboxFlags(weekdayID.c_str(), &weekdays, 1u << weekday))
+			{
+				calendarInfo.weekdays = static_cast<std::uint8_t>(weekdays);
+				calendarChanged = true;
+			}
+		}
+
+		ImGui::SetNextItemWidth(150.0f);
+		if (ImGui::InputInt(firstDayID.c_str(), &calendarInfo.firstDay)) { calendarChanged = true; }
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(150.0f);
+		if (ImGui::InputInt(lastDayID.c_str(), &calendarInfo.lastDay)) { calendarChanged = true; }
+
+		if (ImGui::Button(removeID.c_str()))
+		{
+			calendarInfoList.erase(calendarInfoList.begin() + i);
+			i--;
+			calendarChanged = true;
+		}
+
+		ImGui::Separator();
+	}
+
+	if (ImGui::Button("Add New Calendar Rule##Calendar"))
+	{
+		CalendarInfo info;
+		info.filename = "Default.fx";
+
+		calendarInfoList.push_back(info);
+		calendarChanged = true;
+	}
+
+	if (calendarChanged)
+	{
+		ruleRevision++;
+	}
+}
+
+void Menu::RenderLocationPage()
+{
+	ImGui::TextWrapped("Sets an effect while the player is in a worldspace, a location or any of its parent locations, or a location with a keyword, and the opposite otherwise. Names are editor IDs (eg. DLC2SolstheimWorld, LocTypeCity), \"Plugin.esm|0x1234\" for locations without one, or a plain FormID. Applied on the next cell or location change.");
+
+	bool locationChanged = false;
+
+	for (int i = 0; i < locationInfoList.size(); i++)
+	{
+		auto& locationInfo = locationInfoList[i];
+
+		std::string effectID = "Effect##Location" + std::to_string(i);
+		std::string stateID = "State##Location" + std::to_string(i);
+		std::string typeID = "Type##Location" + std::to_string(i);
+		std::string nameID = "Name##Location" + std::to_string(i);
+		std::string removeID = "Remove##Location" + std::to_string(i);
+
+		if (CreateCombo(effectID.c_str(), locationInfo.filename, m_EffectTargets, ImGuiComboFlags_None)) { locationChanged = true; }
+		ImGui::SameLine();
+		if (CreateCombo(stateID.c_str(), locationInfo.state, g_EffectStateLocation, ImGuiComboFlags_None)) { locationChanged = true; }
+
+		if (CreateCombo(typeID.c_str(), locationInfo.type, g_LocationTypes, ImGuiComboFlags_None)) { locationChanged = true; }
+		ImGui::SameLine();
+		if (CreateInput(nameID.c_str(), locationInfo.name, 300.0f, ImGuiInputTextFlags_EnterReturnsTrue)) { locationChanged = true; }
+
+		if (ImGui::Button(removeID.c_str()))
+		{
+			locationInfoList.erase(locationInfoList.begin() + i);
+			i--;
+			locationChanged = true;
+		}
+
+		ImGui::Separator();
+	}
+
+	if (ImGui::Button("Add New Location Rule##Location"))
+	{
+		LocationInfo info;
+		info.filename = "Default.fx";
+
+		locationInfoList.push_back(info);
+		locationChanged = true;
+	}
+
+	if (locationChanged)
+	{
+		ruleRevision++;
+	}
+}
+
+void Menu::RenderStateRules(const StateRuleKind& kind)
+{
+	std::vector<std::string> conditions(kind.states.begin(), kind.states.end());
+
+	bool rulesChanged = false;
+
+	for (int i = 0; i < kind.rules.size(); i++)
+	{
+		auto& rule = kind.rules[i];
+
+		const std::string suffix = "##" + std::string(kind.name) + std::to_string(i);
+		std::string effectID = "Effect" + suffix;
+		std::string stateID = "State" + suffix;
+		std::string conditionID = "While" + suffix;
+		std::string removeID = "Remove" + suffix;
+
+		if (CreateCombo(effectID.c_str(), rule.filename, m_EffectTargets, ImGuiComboFlags_None)) { rulesChanged = true; }
+		ImGui::SameLine();
+		if (CreateCombo(stateID.c_str(), rule.state, g_EffectStateRule, ImGuiComboFlags_None)) { rulesChanged = true; }
+		ImGui::SameLine();
+		if (CreateCombo(conditionID.c_str(), rule.condition, conditions, ImGuiComboFlags_None)) { rulesChanged = true; }
+
+		if (ImGui::Button(removeID.c_str()))
+		{
+			kind.rules.erase(kind.rules.begin() + i);
+			i--;
+			rulesChanged = true;
+		}
+
+		ImGui::Separator();
+	}
+
+	const std::string addID = "Add New " + std::string(kind.name) + " Rule##" + kind.name;
+	if (ImGui::Button(addID.c_str()))
+	{
+		kind.rules.push_back(kind.newRule);
+		rulesChanged = true;
+	}
+
+	if (rulesChanged)
+	{
+		ruleRevision++;
+	}
+}
+
+void Menu::RenderPlayerPage()
+{
+	ImGui::TextWrapped("Sets an effect while the player is in a state and the opposite otherwise, eg. sharper in combat or no DOF while sneaking. Checked every frame, expressions can use the states as player(Combat).");
+
+	RenderStateRules(kPlayerRules);
+}
+
+void Menu::RenderCameraPage()
+{
+	ImGui::TextWrapped("Sets an effect while the camera is in a state and the opposite otherwise, eg. no DOF in first person or a vignette during killcams. Checked every frame, expressions can use the states as camera(FirstPerson).");
+
+	RenderStateRules(kCameraRules);
+}
+
+void Menu::RenderLightPage()
+{
+	ImGui::TextWrapped("Sets an effect while the current interior is in a light band and the opposite otherwise, eg. brightening only in dark caves. The level comes from the cell's lighting template and is read when entering a cell, exteriors are None. Expressions can use the bands as light(Dark).");
+
+	const std::optional<float> level = Processor::GetSingleton().GetRuleEngine().GetCellLightLevel();
+	if (level)
+	{
+		ImGui::Text("Light level %.3f - %s", *level, kLightBandNames[static_cast<std::size_t>(GetLightBand(level, LightDarkThreshold, LightBrightThreshold))]);
+	}
+	else
+	{
+		ImGui::Text("Light level none - exterior");
+	}
+
+	ImGui::SliderFloat("Dark Below##Light", &LightDarkThreshold, 0.0f, 1.0f, "%.3f");
+	ImGui::SliderFloat("Bright From##Light", &LightBrightThreshold, 0.0f, 1.0f, "%.3f");
+	LightBrightThreshold = std::max(LightBrightThreshold, LightDarkThreshold);
+
+	RenderStateRules(kLightRules);
+}
+
+void Menu::RenderHotkeysPage()
+{
+	ImGui::TextWrapped("Runs an action when a key is pressed, eg. Ctrl+F10. Toggle turns an effect or @Group off if any of its techniques is on, otherwise on. CyclePreset switches to the next of its presets separated by commas. Suspend stops the rules from changing anything until pressed again.");
+
+	Processor& processor = Processor::GetSingleton();
+	bool suspended = processor.IsSuspended();
+	if (ImGui::Checkbox("Suspended##Hotkeys", &suspended))
+	{
+		processor.SetSuspended(suspended);
+	}
+
+	bool hotkeysChanged = false;
+
+	for (int i = 0; i < hotkeyInfoList.size(); i++)
+	{
+		auto& hotkeyInfo = hotkeyInfoList[i];
+
+		std::string keyID = "Key##Hotkey" + std::to_string(i);
+		std::string actionID = "Action##Hotkey" + std::to_string(i);
+		std::string targetID = "Target##Hotkey" + std::to_string(i);
+		std::string removeID = "Remove##Hotkey" + std::to_string(i);
+
+		if (CreateInput(keyID.c_str(), hotkeyInfo.key, 150.0f, ImGuiInputTextFlags_EnterReturnsTrue)) { hotkeysChanged = true; }
+		ImGui::SameLine();
+		if (CreateCombo(actionID.c_str(), hotkeyInfo.action, g_HotkeyActions, ImGuiComboFlags_None)) { hotkeysChanged = true; }
+		if (hotkeyInfo.action != "Suspend")
+		{
+			ImGui::SameLine();
+			if (CreateInput(targetID.c_str(), hotkeyInfo.target, 300.0f, ImGuiInputTextFlags_EnterReturnsTrue)) { hotkeysChanged = true; }
+		}
+		if (!Hotkeys::ParseKey(hotkeyInfo.key))
+		{
+			ImGui::TextWrapped("Unknown key: %s", hotkeyInfo.key.c_str());
+		}
+
+		if (ImGui::Button(removeID.c_str()))
+		{
+			hotkeyInfoList.erase(hotkeyInfoList.begin() + i);
+			i--;
+			hotkeysChanged = true;
+		}
+
+		ImGui::Separator();
+	}
+
+	if (ImGui::Button("Add New Hotkey##Hotkeys"))
+	{
+		HotkeyInfo info;
+		info.key = "Ctrl+F10";
+		info.action = "Suspend";
+
+		hotkeyInfoList.push_back(info);
+		hotkeysChanged = true;
+	}
+
+	if (hotkeysChanged)
+	{
+		hotkeyRevision++;
+	}
+}
+
+void Menu::RenderScenePage()
+{
+	ImGui::TextWrapped("Sets an effect while the scene is busy and the opposite otherwise. A rule holds once the actors in high process or the references in the loaded cells reach its threshold, and until they dropped the hysteresis below it again.");
+
+	const SceneStats stats = Processor::GetSingleton().GetRuleEngine().GetSceneStats();
+	ImGui::Text("%u actors, %u references - %zu samples, last %.3f ms, max %.3f ms, average %.3f ms", stats.sample.actors, stats.sample.references, stats.samples, stats.lastCost, stats.maxCost, stats.averageCost);
+
+	bool sceneChanged = false;
+
+	for (int i = 0; i < sceneInfoList.size(); i++)
+	{
+		auto& sceneInfo = sceneInfoList[i];
+
+		std::string effectID = "Effect##Scene" + std::to_string(i);
+		std::string stateID = "State##Scene" + std::to_string(i);
+		std::string metricID = "Metric##Scene" + std::to_string(i);
+		std::string thresholdID = "Threshold##Scene" + std::to_string(i);
+		std::string hysteresisID = "Hysteresis##Scene" + std::to_string(i);
+		std::string removeID = "Remove##Scene" + std::to_string(i);
+
+		if (CreateCombo(effectID.c_str(), sceneInfo.filename, m_EffectTargets, ImGuiComboFlags_None)) { sceneChanged = true; }
+		ImGui::SameLine();
+		if (CreateCombo(stateID.c_str(), sceneInfo.state, g_EffectStateScene, ImGuiComboFlags_None)) { sceneChanged = true; }
+
+		if (CreateCombo(metricID.c_str(), sceneInfo.metric, g_SceneMetrics, ImGuiComboFlags_None)) { sceneChanged = true; }
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(150.0f);
+		if (ImGui::InputDouble(thresholdID.c_str(), &sceneInfo.threshold, 1.0, 10.0, "%.0f")) { sceneChanged = true; }
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(150.0f);
+		if (ImGui::InputDouble(hysteresisID.c_str(), &sceneInfo.hysteresis, 1.0, 10.0, "%.0f")) { sceneChanged = true; }
+
+		if (ImGui::Button(removeID.c_str()))
+		{
+			sceneInfoList.erase(sceneInfoList.begin() + i);
+			i--;
+			sceneChanged = true;
+		}
+
+		ImGui::Separator();
+	}
+
+	if (ImGui::Button("Add New Scene Rule##Scene"))
+	{
+		SceneInfo info;
+		info.filename = "Default.fx";
+
+		sceneInfoList.push_back(info);
+		sceneChanged = true;
+	}
+
+	if (sceneChanged)
+	{
+		ruleRevision++;
+	}
+}
+
+void Menu::RenderReshadePresetsPage()
+{
+	ImGui::TextWrapped("Switches the whole ReShade preset while a condition holds. Switches wait for a loading screen up to the timeout, and outside of loading screens are at least the interval apart.");
+
+	auto& presets = Processor::GetSingleton().GetPresetSwitcher();
+	ImGui::Text("%zu switches - last %.0f ms, max %.0f ms, average %.0f ms", presets.GetSwitchCount(), presets.GetLastLatency(), presets.GetMaxLatency(), presets.GetAverageLatency());
+	if (const std::string pending = presets.GetPending(); !pending.empty())
+	{
+		ImGui::Text("Waiting to switch to %s", pending.c_str());
+	}
+
+	ImGui::SeparatorText("Settings");
+	CreateInput("Default Preset", DefaultReshadePreset, 300.0f);
+	ImGui::SetNextItemWidth(200.0f);
+	ImGui::SliderInt("Switch Interval (s)", &PresetSwitchInterval, 0, 600, "%d");
+	ImGui::SetNextItemWidth(200.0f);
+	ImGui::SliderInt("Loading Screen Timeout (s)", &PresetSwitchTimeout, 0, 600, "%d");
+
+	ImGui::SeparatorText("Presets");
+	for (int i = 0; i < reshadePresetInfoList.size(); i++)
+	{
+		auto& presetInfo = reshadePresetInfoList[i];
+
+		std::string pathID = "Preset##ReshadePreset" + std::to_string(i);
+		std::string categoryID = "When##ReshadePreset" + std::to_string(i);
+		std::string conditionID = "Condition##ReshadePreset" + std::to_string(i);
+		std::string startTimeID = "StartTime##ReshadePreset" + std::to_string(i);
+		std::string stopTimeID = "StopTime##ReshadePreset" + std::to_string(i);
+		std::string removeID = "Remove##ReshadePreset" + std::to_string(i);
+
+		CreateInput(pathID.c_str(), presetInfo.path, 300.0f);
+		CreateCombo(categoryID.c_str(), presetInfo.category, g_DefinitionCategory, ImGuiComboFlags_None);
+
+		if (presetInfo.category == "Menu")
+		{
+			ImGui::SameLine();
+			CreateCombo(conditionID.c_str(), presetInfo.condition, g_MenuNames, ImGuiComboFlags_None);
+		}
+		else if (presetInfo.category == "Weather")
+		{
+			ImGui::SameLine();
+			CreateCombo(conditionID.c_str(), presetInfo.condition, g_WeatherFlags, ImGuiComboFlags_None);
+		}
+		else if (presetInfo.category == "Time")
+		{
+			ImGui::SetNextItemWidth(200.0f);
+			ImGui::SliderScalar(startTimeID.c_str(), ImGuiDataType_Double, &presetInfo.startTime, &minTime, &maxTime, "%.2f");
+			ImGui::SameLine();
+			ImGui::SetNextItemWidth(200.0f);
+			ImGui::SliderScalar(stopTimeID.c_str(), ImGuiDataType_Double, &presetInfo.stopTime, &minTime, &maxTime, "%.2f");
+		}
+
+		if (ImGui::Button(removeID.c_str()))
+		{
+			reshadePresetInfoList.erase(reshadePresetInfoList.begin() + i);
+			i--;
+		}
+
+		ImGui::Separator();
+	}
+
+	if (ImGui::Button("Add New Preset##ReshadePreset"))
+	{
+		ReshadePresetInfo info;
+		info.path = "ReShadePreset.ini";
+		info.category = "Time";
+
+		reshadePresetInfoList.push_back(info);
+	}
+}
+
+void Menu::RenderPrewarmSettings()
+{
+	ImGui::SeparatorText("Pre-warm");
+
+	if (ImGui::Checkbox("Pre-warm upcoming effects on loading screens", &EnableTimePrewarm))
+	{
+		auto& eventProcessorMenu = Processor::GetSingleton();
+		if (Processor::NeedsMenuEvents())
+		{
+			RE::UI::GetSingleton()->AddEventSink<RE::MenuOpenCloseEvent>(&eventProcessorMenu);
+		}
+		else
+		{
+			RE::UI::GetSingleton()->RemoveEventSink<RE::MenuOpenCloseEvent>(&eventProcessorMenu);
+		}
+	}
+
+	if (!EnableTimePrewarm)
+	{
+		return;
+	}
+
+	float lookahead = static_cast<float>(TimePrewarmLookahead);
+	if (ImGui::SliderFloat("Look ahead (s)", &lookahead, 10.0f, 600.0f, "%.0f"))
+	{
+		TimePrewarmLookahead = lookahead;
+	}
+
+	const auto calendar = RE::Calendar::GetSingleton();
+	for (const auto& activation : TimePrewarmer::PredictActivations(calendar->GetHour(), calendar->GetTimescale(), TimePrewarmLookahead))
+	{
+		ImGui::BulletText("%s in %.0f s", activation.effect.c_str(), activation.seconds);
+	}
+
+	const PredictionHistogram histogram = Processor::GetSingleton().GetPrewarmer().GetHistogram();
+	if (histogram.GetCount() > 0 || histogram.GetMissed() > 0)
+	{
+		ImGui::TextWrapped("Prediction error: %s", histogram.Format().c_str());
+	}
+}
@@ -1,5 +1,4 @@
 #include "../include/Processor.h"
-#include "../include/ReshadeIntegration.h"
 
 
 RE::BSEventNotifyControl Processor::ProcessEvent(const RE::MenuOpenCloseEvent* a_event, RE::BSTEventSource<RE::MenuOpenCloseEvent>* a_source)
@@ -9,267 +8,286 @@ RE::BSEventNotifyControl Processor::ProcessEvent(const RE::MenuOpenCloseEvent* a
 		return RE::BSEventNotifyControl::kContinue;
 	}
 
-	const auto& menuName = a_event->menuName;
-	auto& opening = a_event->opening;
+	// Loading screens hide the compile hitch of whatever was held back or is coming up next
+	if (a_event->opening && DeferredEffectRuntime::IsLoadingMenu(a_event->menuName.c_str()))
+	{
+		m_DeferredRuntime.Flush();
+		m_DefinitionRuntime.Flush();
+		m_Presets.Flush();
 
-	auto [it, inserted] = m_OpenMenus.emplace(menuName);
+		if (m_Runtime.IsAttached())
+		{
+			m_Prewarmer.Prewarm(m_Runtime, m_GameState.GetHour(), m_GameState.GetTimeScale(), &m_Groups);
+		}
+	}
 
-	if (!opening)
+	if (EnableMenus)
 	{
-		m_IsMenuOpen = false;
-		m_OpenMenus.erase(it); // Mark menu as closed using the iterator
+		m_RuleEngine.ProcessMenuEvent(a_event->menuName.c_str(), a_event->opening);
 	}
-	else { m_IsMenuOpen = true; }
 
-	if (m_OpenMenus.empty())
+	return RE::BSEventNotifyControl::kContinue;
+}
+
+RE::BSEventNotifyControl Processor::ProcessEvent(const RE::BGSActorCellEvent* a_event, RE::BSTEventSource<RE::BGSActorCellEvent>*)
+{
+	if (!a_event || a_event->flags != RE::BGSActorCellEvent::CellFlag::kEnter)
 	{
-		return RE::BSEventNotifyControl::kContinue; // Skip if no open menus
+		return RE::BSEventNotifyControl::kContinue;
 	}
 
-	bool enableReshadeMenu = true;
-
-	if (s_pRuntime != nullptr)
+	if (EnableLocation)
 	{
-		if (ToggleStateMenus.find("All") != std::string::npos)
-		{
-			for (const Info& menu : menuList)
-			{
-				if (m_OpenMenus.find(menu.Name) != m_OpenMenus.end())
-				{
-					enableReshadeMenu = false;
-				}
-			}
+		m_RuleEngine.ProcessLocationBasedToggling();
+	}
+	// The light rules run every frame from this sample
+	if (EnableLight)
+	{
+		m_RuleEngine.SampleCellLight();
+	}
 
-			ReshadeIntegration::ApplyReshadeState(enableReshadeMenu, ToggleAllStateMenus);
-		}
-		else if (ToggleStateMenus.find("Specific") != std::string::npos)
-		{
-			for (const TechniqueInfo& info : techniqueMenuInfoList)
-			{
-				if (m_OpenMenus.find(info.Name) != m_OpenMenus.end())
-				{
-					enableReshadeMenu = false;
-				}
-				else
-				{
-					enableReshadeMenu = true;
-				}
-
-				ReshadeIntegration::ApplyTechniqueState(enableReshadeMenu, info);
-			}
-		}
+	return RE::BSEventNotifyControl::kContinue;
+}
 
-		DEBUG_LOG(g_Logger, "Menu {} {}", menuName, opening ? "open" : "closed");
-		DEBUG_LOG(g_Logger, "Reshade {}", enableReshadeMenu ? "enabled" : "disabled");
-	}
-	else
+RE::BSEventNotifyControl Processor::ProcessEvent(const RE::TESActorLocationChangeEvent* a_event, RE::BSTEventSource<RE::TESActorLocationChangeEvent>*)
+{
+	if (!a_event || !a_event->actor || !a_event->actor->IsPlayerRef() || !EnableLocation)
 	{
-		g_Logger->critical("Uhm, what? How? s_pRuntime was null. How the fuck did this happen");
+		return RE::BSEventNotifyControl::kContinue;
 	}
 
+	m_RuleEngine.ProcessLocationBasedToggling();
 
 	return RE::BSEventNotifyControl::kContinue;
-
 }
 
 RE::BSEventNotifyControl Processor::ProcessTimeBasedToggling()
 {
+	m_RuleEngine.ProcessTimeBasedToggling();
 
-	std::lock_guard<std::mutex> timeLock(timeMutexTime);
-
-	if (m_IsMenuOpen)
+	if (EnableTimePrewarm)
 	{
-		return RE::BSEventNotifyControl::kContinue;
+		m_Prewarmer.Observe(m_GameState.GetHour(), m_GameState.GetTimeScale(), std::chrono::steady_clock::now());
 	}
 
-	DEBUG_LOG(g_Logger, "Started ProcessTimeBasedToggling", nullptr);
+	return RE::BSEventNotifyControl::kContinue;
+}
 
-	const auto time = RE::Calendar::GetSingleton();
+RE::BSEventNotifyControl Processor::ProcessInteriorBasedToggling()
+{
+	m_RuleEngine.ProcessInteriorBasedToggling();
 
-	float TimecurrentTime = time->GetHour();
-	DEBUG_LOG(g_Logger, "currentTime: {} ", TimecurrentTime);
+	return RE::BSEventNotifyControl::kContinue;
+}
 
-	// Specific
-	std::vector<Bool> enableReshade;
-	if (ToggleStateTime.find("Specific") != std::string::npos)
-	{
-		for (TechniqueInfo& info : techniqueTimeInfoList)
+RE::BSEventNotifyControl Processor::ProcessWeatherBasedToggling()
+{
+	m_RuleEngine.ProcessWeatherBasedToggling();
+
+	return RE::BSEventNotifyControl::kContinue;
+}
+
+RE::BSEventNotifyControl Processor::ProcessSceneBasedToggling()
+{
+	// Queued from the RuntimeThread, the loaded cells may only be read on the main thread
+	SKSE::GetTaskInterface()->AddTask([this]()
 		{
-			DEBUG_LOG(g_Logger, "info.startTime: {} - info.stopTime: {}", info.startTime, info.stopTime);
-			info.enable = !IsTimeWithinRange(TimecurrentTime, info.startTime, info.stopTime);
-		}
+			const auto start = std::chrono::steady_clock::now();
+			const SceneSample sample = m_GameState.GetSceneSample();
+			const double cost = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			m_RuleEngine.ProcessSceneBasedToggling(sample, cost);
+		});
+
+	return RE::BSEventNotifyControl::kContinue;
+}
+
+void Processor::OnDataLoaded()
+{
+	// Only the player sends cell events to this source
+	RE::PlayerCharacter::GetSingleton()->AsBGSActorCellEventSource()->AddEventSink<RE::BGSActorCellEvent>(this);
+	RE::ScriptEventSourceHolder::GetSingleton()->AddEventSink<RE::TESActorLocationChangeEvent>(this);
+
+	// Resolves the location rules while nothing is going on yet
+	if (EnableLocation)
+	{
+		m_RuleEngine.ProcessLocationBasedToggling();
 	}
+}
+
+void Processor::OnPresent()
+{
+	const auto now = std::chrono::steady_clock::now();
+	m_DeferredRuntime.Update(now);
+	m_DefinitionRuntime.Update(now);
 
-	// All
-	bool enableReshadeTime = true;
-	if (ToggleStateTime.find("All") != std::string::npos)
+	if (m_Runtime.IsAttached())
 	{
-		for (auto& allInfo : techniqueTimeInfoListAll)
+		m_Prewarmer.OnPresent(m_Runtime, m_GameState.GetHour());
+		m_Presets.Update(m_Runtime, now);
+		UpdateGroups();
+
+		// A few flag reads, the rules only run when one of them changed
+		if (EnablePlayer && isLoaded)
 		{
-			enableReshadeTime = !IsTimeWithinRange(TimecurrentTime, allInfo.startTime, allInfo.stopTime);
-			DEBUG_LOG(g_Logger, "State: {} for time: {} - {}. ReshadeBool: {}", allInfo.state, allInfo.startTime, allInfo.stopTime, enableReshadeTime);
+			m_RuleEngine.ProcessPlayerBasedToggling();
+		}
+		if (EnableCamera && isLoaded)
+		{
+			m_RuleEngine.ProcessCameraBasedToggling();
+		}
+		if (EnableLight && isLoaded)
+		{
+			m_RuleEngine.ProcessLightBasedToggling();
 		}
-	}
 
-	if (s_pRuntime != nullptr)
-	{
-		if (ToggleStateTime.find("All") != std::string::npos)
+		if (EnableCurves && isLoaded)
 		{
-			ReshadeIntegration::ApplyReshadeState(enableReshadeTime, ToggleAllStateTime);
+			UpdateCurves();
 		}
-		else if (ToggleStateTime.find("Specific") != std::string::npos)
+		m_Uniforms.Flush(m_Runtime);
+		if (EnableGameUniforms && isLoaded)
 		{
-			for (TechniqueInfo& info : techniqueTimeInfoList)
-			{
-				ReshadeIntegration::ApplyTechniqueState(info.enable, info);
-			}
+			m_GameUniforms.Update(m_Runtime, m_GameState);
 		}
+		// After the rules so a running fade owns its uniform
+		m_FadeRuntime.Update(now);
 	}
 
-	return RE::BSEventNotifyControl::kContinue;
-}
+	const auto frameTime = m_FrameStats.OnPresent(now);
+	if (!frameTime)
+	{
+		return;
+	}
 
-bool Processor::IsTimeWithinRange(double currentTime, double startTime, double endTime)
-{
-	if (currentTime >= startTime && currentTime <= endTime)
+	// The governor would fight the profiler over the same effects
+	if (m_Profiler.IsRunning())
 	{
-		return true;
+		m_Profiler.AddFrame(m_Runtime, *frameTime);
 	}
-	else
+	else if (EnablePerformance && isLoaded)
 	{
-		return false;
+		m_RuleEngine.ProcessPerformanceBasedToggling(*frameTime);
 	}
 }
 
-RE::BSEventNotifyControl Processor::ProcessInteriorBasedToggling()
+void Processor::UpdateCurves()
 {
-	std::lock_guard<std::mutex> lock(timeMutexInterior);
-
-	if (m_IsMenuOpen)
-	{
-		return RE::BSEventNotifyControl::kContinue;
-	}
-
-	const auto player = RE::PlayerCharacter::GetSingleton();
-
-	// DEBUG_LOG(g_Logger, "Got player Singleton: {} ", player->GetName());
-
-	if (const auto cell = player->GetParentCell())
 	{
-		bool enableReshade = [this, cell]()
-			{
-				if (cell->IsInteriorCell())
-				{
-					DEBUG_LOG(g_Logger, "Player is in interior cell", nullptr);
-					IsInInteriorCell = true;
-					return false;
-				}
-				else
-				{
-					DEBUG_LOG(g_Logger, "Player is in exterior cell", nullptr);
-					IsInInteriorCell = false;
-					return true;
-				}
+		std::scoped_lock<std::mutex> lock(timeMutexCurves);
 
-			}
-		();
-
-		if (s_pRuntime != nullptr)
+		if (m_CurveRevision != curveRevision)
 		{
-			if (ToggleStateInterior.find("All") != std::string::npos)
-			{
-				ReshadeIntegration::ApplyReshadeState(enableReshade, ToggleAllStateInterior);
-			}
-			else if (ToggleStateInterior.find("Specific") != std::string::npos)
+			m_CurveRevision = curveRevision;
+			m_Curves.Compile(curveInfoList);
+
+			m_CurveSlots.clear();
+			for (const std::size_t source : m_Curves.GetSources())
 			{
-				ReshadeIntegration::ApplySpecificReshadeStates(enableReshade, Categories::Interior);
+				m_CurveSlots.push_back(m_Uniforms.GetSlot(curveInfoList[source].filename, curveInfoList[source].name));
 			}
 		}
 	}
-	return RE::BSEventNotifyControl::kContinue;
+
+	const float* values = m_Curves.Evaluate(m_GameState.GetHour());
+	m_Uniforms.SetFloats(m_CurveSlots.data(), values, m_CurveSlots.size());
 }
 
-RE::BSEventNotifyControl Processor::ProcessWeatherBasedToggling()
+void Processor::UpdateGroups()
 {
-	std::lock_guard<std::mutex> lock(timeMutexWeather);
-
-	if (m_IsMenuOpen)
+	if (m_GroupRevision == groupRevision)
 	{
-		return RE::BSEventNotifyControl::kContinue;
+		return;
 	}
 
-	const auto sky = RE::Sky::GetSingleton();
-
-	if (const auto currentWeather = sky->currentWeather)
+	std::vector<GroupInfo> groups;
 	{
+		std::scoped_lock<std::mutex> lock(timeMutexGroups);
+		groups = groupInfoList;
+		m_GroupRevision = groupRevision;
+	}
 
-		const auto flags = currentWeather->data.flags;
+	m_Groups.Build(m_Runtime, g_Effects, groups);
+}
 
-		switch (flags.get())
-		{
-		case RE::TESWeather::WeatherDataFlag::kNone:
-			weatherflags = "kNone";
-			break;
-		case RE::TESWeather::WeatherDataFlag::kRainy:
-			weatherflags = "kRainy";
-			break;
-		case RE::TESWeather::WeatherDataFlag::kPleasant:
-			weatherflags = "kPleasant";
-			break;
-		case RE::TESWeather::WeatherDataFlag::kCloudy:
-			weatherflags = "kCloudy";
-			break;
-		case RE::TESWeather::WeatherDataFlag::kSnow:
-			weatherflags = "kSnow";
-			break;
-		case RE::TESWeather::WeatherDataFlag::kPermAurora:
-			weatherflags = "kPermAurora";
-			break;
-		case RE::TESWeather::WeatherDataFlag::kAuroraFollowsSun:
-			weatherflags = "kAuroraFollowsSun";
-			break;
-		}
+bool Processor::StartProfiling(const std::vector<std::string>& effects)
+{
+	if (!m_Runtime.IsAttached())
+	{
+		return false;
+	}
 
-		//DEBUG_LOG(g_Logger, "weatherflag {}", weatherflags);
+	m_Profiler.Start(m_Runtime, effects);
+	return m_Profiler.IsRunning();
+}
 
-		bool enableReshadeWeather = true;
+void Processor::StopProfiling()
+{
+	if (m_Runtime.IsAttached())
+	{
+		m_Profiler.Stop(m_Runtime);
+	}
+}
 
-		if (s_pRuntime != nullptr)
-		{
-			if (ToggleStateWeather.find("All") != std::string::npos)
-			{
-				for (const Info& weather : weatherList)
-				{
-					//DEBUG_LOG(g_Logger, "weatherToDisable {}", weatherToDisable);
+void Processor::AttachRuntime(reshade::api::effect_runtime* runtime)
+{
+	m_Runtime.SetRuntime(runtime);
+	m_StatsRuntime.Reset();
+	m_Prewarmer.Reset();
+	m_FadeRuntime.Reset();
+	m_GameUniforms.Reset();
+	m_RuleEngine.SetRuntime(runtime != nullptr ? &m_DefinitionRuntime : nullptr);
+}
 
-					if (weather.Name == weatherflags)
-					{
-						enableReshadeWeather = false;
-					}
+void Processor::OnBeginEffects()
+{
+	if (!EnableHotkeys || !m_Runtime.IsAttached())
+	{
+		return;
+	}
 
-				}
-				ReshadeIntegration::ApplyReshadeState(enableReshadeWeather, ToggleAllStateWeather);
+	if (m_HotkeyRevision != hotkeyRevision)
+	{
+		std::scoped_lock<std::mutex> lock(timeMutexHotkeys);
+		m_HotkeyRevision = hotkeyRevision;
+		m_Hotkeys.Compile(hotkeyInfoList);
 
-			}
-			else if (ToggleStateWeather.find("Specific") != std::string::npos)
-			{
-				for (const TechniqueInfo& info : techniqueWeatherInfoList)
-				{
-					if (info.Name == weatherflags)
-					{
-						enableReshadeWeather = false;
-					}
-					else
-					{
-						enableReshadeWeather = true;
-					}
-
-					ReshadeIntegration::ApplyTechniqueState(enableReshadeWeather, info);
-				}
-			}
+		for (const std::size_t index : m_Hotkeys.GetInvalid())
+		{
+			spdlog::info("Hotkey {} for {} {} ignored, unknown key or action or nothing to act on", hotkeyInfoList[index].key, hotkeyInfoList[index].action, hotkeyInfoList[index].target);
 		}
+	}
 
+	// Toggles go through the same runtime as the rules, so they fade and defer like them
+	if (m_Hotkeys.Poll(m_DefinitionRuntime, &m_Groups, m_Presets))
+	{
+		SetSuspended(!IsSuspended());
 	}
+}
 
-	return RE::BSEventNotifyControl::kContinue;
-}
\ No newline at end of file
+void Processor::SetSuspended(bool suspended)
+{
+	spdlog::info("Toggler {}", suspended ? "suspended" : "resumed");
+	m_RuleEngine.SetSuspended(suspended);
+}
+
+void Processor::OnEffectsReloaded()
+{
+	// Its technique handles died with the old effects, it can't put anything back
+	if (m_Profiler.IsRunning())
+	{
+		m_Profiler.Abort();
+		spdlog::info("Effects reloaded, profiling stopped");
+	}
+	m_Prewarmer.Reset();
+	m_Uniforms.Reset();
+	m_StatsRuntime.Reset();
+	m_FadeRuntime.Reset();
+	m_GameUniforms.Reset();
+	// The shed techniques are back on with the ReShade preset and their positions may have moved
+	m_RuleEngine.ResetGovernor(false);
+	// Technique IDs follow the new enumeration
+	m_GroupRevision = ~0u;
+	// Techniques are back to the ReShade preset
+	m_RuleEngine.InvalidateRules();
+}
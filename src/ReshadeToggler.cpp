@@ -11,10 +11,29 @@ extern "C" DLLEXPORT const char* DESCRIPTION = "ReShade Effect Toggler by SkyHor
 
 reshade::api::effect_runtime* s_pRuntime = nullptr;
 
-// Callback when Reshade begins effects
-static void on_reshade_begin_effects(reshade::api::effect_runtime* runtime)
+// Callback when Reshade created its effect runtime
+static void on_init_effect_runtime(reshade::api::effect_runtime* runtime)
 {
 	s_pRuntime = runtime;
+	Processor::GetSingleton().AttachRuntime(runtime);
+}
+
+// Callback right before ReShade renders the effects, once per frame
+static void on_reshade_begin_effects(reshade::api::effect_runtime*, reshade::api::command_list*, reshade::api::resource_view, reshade::api::resource_view)
+{
+	Processor::GetSingleton().OnBeginEffects();
+}
+
+// Callback after every present, feeds the frame time stats and the performance governor
+static void on_reshade_present(reshade::api::effect_runtime*)
+{
+	Processor::GetSingleton().OnPresent();
+}
+
+// Callback after ReShade (re)compiled its effects, eg. when a preprocessor definition changed
+static void on_reshade_reloaded_effects(reshade::api::effect_runtime*)
+{
+	Processor::GetSingleton().OnEffectsReloaded();
 }
 
 static void DrawMenu(reshade::api::effect_runtime*)
@@ -25,13 +44,19 @@ static void DrawMenu(reshade::api::effect_runtime*)
 // Register and unregister addon events
 void register_addon_events()
 {
-	reshade::register_event<reshade::addon_event::init_effect_runtime>(on_reshade_begin_effects);
+	reshade::register_event<reshade::addon_event::init_effect_runtime>(on_init_effect_runtime);
+	reshade::register_event<reshade::addon_event::reshade_begin_effects>(on_reshade_begin_effects);
+	reshade::register_event<reshade::addon_event::reshade_present>(on_reshade_present);
+	reshade::register_event<reshade::addon_event::reshade_reloaded_effects>(on_reshade_reloaded_effects);
 	reshade::register_overlay(nullptr, &DrawMenu);
 }
 
 void unregister_addon_events()
 {
-	reshade::unregister_event<reshade::addon_event::init_effect_runtime>(on_reshade_begin_effects);
+	reshade::unregister_event<reshade::addon_event::init_effect_runtime>(on_init_effect_runtime);
+	reshade::unregister_event<reshade::addon_event::reshade_begin_effects>(on_reshade_begin_effects);
+	reshade::unregister_event<reshade::addon_event::reshade_present>(on_reshade_present);
+	reshade::unregister_event<reshade::addon_event::reshade_reloaded_effects>(on_reshade_reloaded_effects);
 	reshade::unregister_overlay(nullptr, &DrawMenu);
 }
 
@@ -66,8 +91,8 @@ void RuntimeThread()
 		{
 			//g_Logger->info("Adding Time to Mainqueue");
 			std::this_thread::sleep_for(std::chrono::seconds(TimeUpdateIntervalTime));
-			MainThread->SubmitToMainThread("Time", []() -> RE::BSEventNotifyControl {
-				return Processor::GetSingleton().ProcessTimeBasedToggling();
+			MainThread->SubmitToMainThread("Time", []() {
+				Processor::GetSingleton().ProcessTimeBasedToggling();
 				});
 		}
 
@@ -75,8 +100,8 @@ void RuntimeThread()
 		{
 			//g_Logger->info("Adding Interior to Mainqueue");
 			std::this_thread::sleep_for(std::chrono::seconds(TimeUpdateIntervalInterior));
-			MainThread->SubmitToMainThread("Interior", []() -> RE::BSEventNotifyControl {
-				return Processor::GetSingleton().ProcessInteriorBasedToggling();
+			MainThread->SubmitToMainThread("Interior", []() {
+				Processor::GetSingleton().ProcessInteriorBasedToggling();
 				});
 		}
 
@@ -85,12 +110,21 @@ void RuntimeThread()
 
 			//g_Logger->info("Adding Weather to Mainqueue");
 			std::this_thread::sleep_for(std::chrono::seconds(TimeUpdateIntervalWeather));
-			MainThread->SubmitToMainThread("Weather", []() -> RE::BSEventNotifyControl {
-				return Processor::GetSingleton().ProcessWeatherBasedToggling();
+			MainThread->SubmitToMainThread("Weather", []() {
+				Processor::GetSingleton().ProcessWeatherBasedToggling();
 				});
 
 		}
 
+		if (EnableScene)
+		{
+			// Run() drains the queue on this thread, the pass hands the sampling to the main thread itself
+			std::this_thread::sleep_for(std::chrono::seconds(TimeUpdateIntervalScene));
+			MainThread->SubmitToMainThread("Scene", []() {
+				Processor::GetSingleton().ProcessSceneBasedToggling();
+				});
+		}
+
 		std::this_thread::sleep_for(std::chrono::milliseconds(500));
 		MainThread->Run();
 	}
@@ -98,48 +132,42 @@ void RuntimeThread()
 
 void ReshadeToggler::SubmitToMainThread(const std::string& functionName, FunctionToExecute function)
 {
-	std::scoped_lock<std::mutex> lock(m_MainThreadQueueMutex);
-
-
-	m_MainThreadQueue[functionName] = function;
+	m_MainThreadQueue.Submit(functionName, function);
 	//g_Logger->info("Submit {}", functionName);
 }
 
 void ReshadeToggler::ExecuteMainThreadQueue()
 {
-	std::scoped_lock<std::mutex> lock(m_MainThreadQueueMutex);
-
-	for (const auto& func : m_MainThreadQueue)
-	{
-		//g_Logger->info("Function: {}", func.first.c_str());
-		func.second(); // Funktion ausführen
-	}
-	m_MainThreadQueue.clear();
-
+	m_MainThreadQueue.Execute();
 }
 
 void ReshadeToggler::Run()
 {
-	if (m_MainThreadQueue.find("Weather") != m_MainThreadQueue.end())
+	if (m_MainThreadQueue.IsQueued("Weather"))
 	{
 		//g_Logger->info("Attaching WeatherThread");
 		ExecuteMainThreadQueue();
 	}
 
-	if (m_MainThreadQueue.find("Interior") != m_MainThreadQueue.end())
+	if (m_MainThreadQueue.IsQueued("Interior"))
 	{
 		//g_Logger->info("Attaching InteriorThread");
 		ExecuteMainThreadQueue();
 	}
 
-	if (m_MainThreadQueue.find("Time") != m_MainThreadQueue.end())
+	if (m_MainThreadQueue.IsQueued("Time"))
 	{
 		//g_Logger->info("Attaching TimeThread");
 		ExecuteMainThreadQueue();
 	}
 
+	if (m_MainThreadQueue.IsQueued("Scene"))
+	{
+		ExecuteMainThreadQueue();
+	}
+
 	auto& eventProcessorMenu = Processor::GetSingleton();
-	if (EnableMenus)
+	if (Processor::NeedsMenuEvents())
 	{
 		RE::UI::GetSingleton()->AddEventSink<RE::MenuOpenCloseEvent>(&eventProcessorMenu);
 	}
@@ -165,311 +193,7 @@ void ReshadeToggler::Load()
 
 void ReshadeToggler::LoadINI(const std::string& presetPath)
 {
-	DEBUG_LOG(g_Logger, "Starting to load: {}", presetPath.c_str());
-
-	CSimpleIniA ini;
-	ini.SetUnicode(false);
-	ini.LoadFile(presetPath.c_str());
-
-	const char* sectionGeneral = "General";
-	const char* sectionMenusGeneral = "MenusGeneral";
-	const char* sectionMenusProcess = "MenusProcess";
-	const char* sectionTimeGeneral = "Time";
-	const char* sectionInteriorGeneral = "Interior";
-	const char* sectionWeatherGeneral = "Weather";
-	const char* sectionWeatherProcess = "WeatherProcess";
-
-	CSimpleIniA::TNamesDepend MenusGeneral_keys;
-	CSimpleIniA::TNamesDepend MenusProcess_keys;
-	CSimpleIniA::TNamesDepend TimeGeneral_keys;
-	CSimpleIniA::TNamesDepend InteriorGeneral_keys;
-	CSimpleIniA::TNamesDepend WeatherGeneral_keys;
-	CSimpleIniA::TNamesDepend WeatherProcess_keys;
-
-	//General
-	EnableMenus = ini.GetBoolValue(sectionGeneral, "EnableMenus");
-	EnableTime = ini.GetBoolValue(sectionGeneral, "EnableTime");
-	EnableInterior = ini.GetBoolValue(sectionGeneral, "EnableInterior");
-	EnableWeather = ini.GetBoolValue(sectionGeneral, "EnableWeather");
-
-
-	DEBUG_LOG(g_Logger, "{}: EnableMenus: {} - EnableTime: {} - EnableInterior: {} - EnableWeather: {}", sectionGeneral, EnableMenus, EnableTime, EnableInterior, EnableWeather);
-
-	DEBUG_LOG(g_Logger, "\n", nullptr);
-
-#pragma region Menus
-
-	// MenusGeneral
-	ToggleStateMenus = ini.GetValue(sectionMenusGeneral, "MenuToggleOption");
-	ToggleAllStateMenus = ini.GetValue(sectionMenusGeneral, "MenuToggleAllState");
-
-	DEBUG_LOG(g_Logger, "General MenuToggleOption:  {} - MenuToggleAllState: {}", ToggleStateMenus, ToggleAllStateMenus);
-
-	ini.GetAllKeys(sectionMenusGeneral, MenusGeneral_keys);
-	g_SpecificMenu.reserve(MenusGeneral_keys.size()); // Reserve space for vector
-
-	const char* togglePrefix01 = "MenuToggleSpecificFile";
-	const char* togglePrefix02 = "MenuToggleSpecificState";
-	const char* togglePrefixMenu = "MenuToggleSpecificMenu";
-
-	for (const auto& key : MenusGeneral_keys)
-	{
-		if (strcmp(key.pItem, "MenuToggleOption") != 0 && strcmp(key.pItem, "MenuToggleAllState") != 0)
-		{
-			g_SpecificMenu.push_back(key.pItem);
-			//const char* menuItemgeneral = g_SpecificMenu.back().c_str();
-
-			// Check if the key starts with MenuToggleSpecificFile
-			if (strncmp(key.pItem, togglePrefix01, strlen(togglePrefix01)) == 0)
-			{
-				itemMenuShaderToToggle = ini.GetValue(sectionMenusGeneral, key.pItem, nullptr);
-				g_MenuToggleFile.emplace(itemMenuShaderToToggle);
-				//DEBUG_LOG(g_Logger, "MenuToggleSpecificFile:  {} - Value: {}", menuItemgeneral, itemMenuShaderToToggle);
-
-				// Construct the corresponding key for the state
-				std::string stateKeyName = togglePrefix02 + std::to_string(g_SpecificMenu.size());
-
-				// Retrieve the state using the constructed key
-				itemMenuStateValue = ini.GetValue(sectionMenusGeneral, stateKeyName.c_str(), nullptr);
-				g_MenuToggleState.emplace(itemMenuStateValue);
-
-				std::string menuKeyName = togglePrefixMenu + std::to_string(g_SpecificMenu.size());
-				itemSpecificMenu = ini.GetValue(sectionMenusGeneral, menuKeyName.c_str(), nullptr);
-				g_MenuSpecificMenu.emplace(itemSpecificMenu);
-
-				// Populate the technique info
-				TechniqueInfo MenuInfo;
-				MenuInfo.filename = itemMenuShaderToToggle;
-				MenuInfo.state = itemMenuStateValue;
-				MenuInfo.Name = itemSpecificMenu;
-				techniqueMenuInfoList.push_back(MenuInfo);
-				DEBUG_LOG(g_Logger, "Populated TechniqueMenuInfo: {} - {}", itemMenuShaderToToggle, itemMenuStateValue);
-			}
-		}
-	}
-
-	DEBUG_LOG(g_Logger, "\n", nullptr);
-
-
-	//MenusProcess
-	ini.GetAllKeys(sectionMenusProcess, MenusProcess_keys);
-	g_INImenus.reserve(MenusProcess_keys.size()); // Reserve space for vector
-
-	for (const auto& key : MenusProcess_keys)
-	{
-		Info menus;
-		g_INImenus.push_back(key.pItem);
-		const char* menuItem = g_INImenus.back().c_str();
-		const char* itemValue = ini.GetValue(sectionMenusProcess, key.pItem, nullptr);
-
-		menus.Index = menuItem;
-		menus.Name = itemValue;
-		menuList.push_back(menus);
-
-		DEBUG_LOG(g_Logger, "Menu:  {} - Value: {}", menuItem, itemValue);
-	}
-
-	DEBUG_LOG(g_Logger, "\n", nullptr);
-#pragma endregion
-
-#pragma region Time
-	//Time
-	ToggleStateTime = ini.GetValue(sectionTimeGeneral, "TimeToggleOption");
-	TimeUpdateIntervalTime = ini.GetLongValue(sectionTimeGeneral, "TimeUpdateInterval");
-
-	DEBUG_LOG(g_Logger, "General TimeToggleOption:  {} - TimeUpdateInterval: {}", ToggleStateTime, TimeUpdateIntervalTime);
-
-	// All Time
-	ToggleAllStateTime = ini.GetValue(sectionTimeGeneral, "TimeToggleAllState");
-	itemTimeStartHourAll = ini.GetDoubleValue(sectionTimeGeneral, "TimeToggleAllTimeStart");
-	itemTimeStopHourAll = ini.GetDoubleValue(sectionTimeGeneral, "TimeToggleAllTimeStop");
-
-	TechniqueInfo TimeInfoAll;
-	TimeInfoAll.state = ToggleAllStateTime;
-	TimeInfoAll.startTime = itemTimeStartHourAll;
-	TimeInfoAll.stopTime = itemTimeStopHourAll;
-	techniqueTimeInfoListAll.push_back(TimeInfoAll);
-	DEBUG_LOG(g_Logger, "Set all effects to {} from {} - {}", ToggleAllStateTime, itemTimeStartHourAll, itemTimeStopHourAll);
-
-
-	// Specific Time
-	ini.GetAllKeys(sectionTimeGeneral, TimeGeneral_keys);
-	g_SpecificTime.reserve(TimeGeneral_keys.size()); // Reserve space for vector
-
-	const char* togglePrefix03 = "TimeToggleSpecificFile";
-	const char* togglePrefix04 = "TimeToggleSpecificState";
-	const char* togglePrefix05 = "TimeToggleSpecificTimeStart";
-	const char* togglePrefix06 = "TimeToggleSpecificTimeStop";
-
-	for (const auto& key : TimeGeneral_keys)
-	{
-		if (strcmp(key.pItem, "TimeToggleOption") != 0 && strcmp(key.pItem, "TimeToggleAllState") != 0 && strcmp(key.pItem, "TimeToggleAllTimeStart") != 0 && strcmp(key.pItem, "TimeToggleAllTimeStop") != 0)
-		{
-			g_SpecificTime.push_back(key.pItem);
-
-			// DEBUG_LOG(g_Logger, "Size of m_SpecificTime: {} ", m_SpecificTime.size());
-
-			//const char* timeItemGeneral = g_SpecificTime.back().c_str();
-
-			if (strncmp(key.pItem, togglePrefix03, strlen(togglePrefix03)) == 0)
-			{
-				itemTimeShaderToToggle = ini.GetValue(sectionTimeGeneral, key.pItem, nullptr);
-				g_TimeToggleFile.emplace(itemTimeShaderToToggle);
-				//DEBUG_LOG(g_Logger, "TimeToggleSpecificFile:  {} - Value: {}", timeItemGeneral, itemTimeShaderToToggle);
-
-				// Construct the corresponding key for the state
-				std::string stateKeyName = togglePrefix04 + std::to_string(g_SpecificTime.size());
-
-				// Retrieve the state using the constructed key
-				itemTimeStateValue = ini.GetValue(sectionTimeGeneral, stateKeyName.c_str(), nullptr);
-				g_TimeToggleState.emplace(itemTimeStateValue);
-
-				// Construct the corresponding key for the the start and stop times
-				std::string startTimeKey = togglePrefix05 + std::to_string(g_SpecificTime.size());
-				std::string endTimeKey = togglePrefix06 + std::to_string(g_SpecificTime.size());
-				itemTimeStartHour = ini.GetDoubleValue(sectionTimeGeneral, startTimeKey.c_str());
-				itemTimeStopHour = ini.GetDoubleValue(sectionTimeGeneral, endTimeKey.c_str());
-				DEBUG_LOG(g_Logger, "startTime: {}; stopTimeKey: {} ", itemTimeStartHour, itemTimeStopHour);
-
-
-				// Populate the technique info
-				TechniqueInfo TimeInfo;
-				TimeInfo.filename = itemTimeShaderToToggle;
-				TimeInfo.state = itemTimeStateValue;
-				TimeInfo.startTime = itemTimeStartHour;
-				TimeInfo.stopTime = itemTimeStopHour;
-				techniqueTimeInfoList.push_back(TimeInfo);
-				DEBUG_LOG(g_Logger, "Set effect {} to {} from {} - {}", itemTimeShaderToToggle, itemTimeStateValue, itemTimeStartHour, itemTimeStopHour);
-			}
-		}
-	}
-
-
-	DEBUG_LOG(g_Logger, "\n", nullptr);
-#pragma endregion 
-
-#pragma region Interior
-	//Interior
-	ToggleStateInterior = ini.GetValue(sectionInteriorGeneral, "InteriorToggleOption");
-	ToggleAllStateInterior = ini.GetValue(sectionInteriorGeneral, "InteriorToggleAllState");
-	TimeUpdateIntervalInterior = ini.GetLongValue(sectionInteriorGeneral, "InteriorUpdateInterval");
-
-	DEBUG_LOG(g_Logger, "General InteriorToggleOption:  {} - InteriorToggleAllState: {} - InteriorUpdateInterval: {}", ToggleStateInterior, ToggleAllStateInterior, TimeUpdateIntervalInterior);
-
-	ini.GetAllKeys(sectionInteriorGeneral, InteriorGeneral_keys);
-	g_SpecificInterior.reserve(InteriorGeneral_keys.size()); // Reserve space for vector
-
-	const char* togglePrefix07 = "InteriorToggleSpecificFile";
-	const char* togglePrefix08 = "InteriorToggleSpecificState";
-
-	for (const auto& key : InteriorGeneral_keys)
-	{
-		if (strcmp(key.pItem, "InteriorToggleOption") != 0 && strcmp(key.pItem, "InteriorToggleAllState") != 0)
-		{
-			g_SpecificInterior.push_back(key.pItem);
-			//const char* interiorItemgeneral = g_SpecificInterior.back().c_str();
-
-			// Check if the key starts with InteriorToggleSpecificFile
-			if (strncmp(key.pItem, togglePrefix07, strlen(togglePrefix07)) == 0)
-			{
-				itemInteriorShaderToToggle = ini.GetValue(sectionInteriorGeneral, key.pItem, nullptr);
-				g_InteriorToggleFile.emplace(itemInteriorShaderToToggle);
-				//DEBUG_LOG(g_Logger, "InteriorToggleSpecificFile:  {} - Value: {}", interiorItemgeneral, itemInteriorShaderToToggle);
-
-				// Construct the corresponding key for the state
-				std::string stateKeyName = togglePrefix08 + std::to_string(g_SpecificInterior.size());
-
-				// Retrieve the state using the constructed key
-				itemInteriorStateValue = ini.GetValue(sectionInteriorGeneral, stateKeyName.c_str(), nullptr);
-				g_InteriorToggleState.emplace(itemInteriorStateValue);
-
-				// Populate the technique info
-				TechniqueInfo InteriorInfo;
-				InteriorInfo.filename = itemInteriorShaderToToggle;
-				InteriorInfo.state = itemInteriorStateValue;
-				techniqueInteriorInfoList.push_back(InteriorInfo);
-				DEBUG_LOG(g_Logger, "Populated TechniqueInteriorInfo: {} - {}", itemInteriorShaderToToggle, itemInteriorStateValue);
-			}
-		}
-	}
-
-	DEBUG_LOG(g_Logger, "\n", nullptr);
-#pragma endregion
-
-#pragma region Weather
-	//Weather
-	ToggleStateWeather = ini.GetValue(sectionWeatherGeneral, "WeatherToggleOption");
-	ToggleAllStateWeather = ini.GetValue(sectionWeatherGeneral, "WeatherToggleAllState");
-	TimeUpdateIntervalWeather = ini.GetLongValue(sectionWeatherGeneral, "WeatherUpdateInterval");
-
-	DEBUG_LOG(g_Logger, "General WeatherToggleOption:  {} - WeatherToggleAllState: {} - WeatherUpdateInterval: {}", ToggleStateWeather, ToggleAllStateWeather, TimeUpdateIntervalWeather);
-
-	ini.GetAllKeys(sectionWeatherGeneral, WeatherGeneral_keys);
-	g_SpecificWeather.reserve(WeatherGeneral_keys.size());
-
-	const char* togglePrefix09 = "WeatherToggleSpecificFile";
-	const char* togglePrefix10 = "WeatherToggleSpecificState";
-	const char* togglePrefixItemWeather = "WeatherToggleSpecificWeather";
-
-	for (const auto& key : WeatherGeneral_keys)
-	{
-		if (strcmp(key.pItem, "WeatherToggleOption") != 0 && strcmp(key.pItem, "WeatherToggleAllState") != 0)
-		{
-			g_SpecificWeather.push_back(key.pItem);
-			//const char* weatherItemgeneral = g_SpecificWeather.back().c_str();
-
-			if (strncmp(key.pItem, togglePrefix09, strlen(togglePrefix09)) == 0)
-			{
-				itemWeatherShaderToToggle = ini.GetValue(sectionWeatherGeneral, key.pItem, nullptr);
-				g_WeatherToggleFile.emplace(itemWeatherShaderToToggle);
-				//DEBUG_LOG(g_Logger, "WeatherToggleSpecificFile:  {} - Value: {}", weatherItemgeneral, itemWeatherShaderToToggle);
-
-				std::string stateKeyName = togglePrefix10 + std::to_string(g_SpecificWeather.size());
-
-				itemWeatherStateValue = ini.GetValue(sectionWeatherGeneral, stateKeyName.c_str(), nullptr);
-				g_WeatherToggleState.emplace(itemWeatherStateValue);
-
-				std::string weatherKeyName = togglePrefixItemWeather + std::to_string(g_SpecificWeather.size());
-				itemSpecificWeather = ini.GetValue(sectionWeatherGeneral, weatherKeyName.c_str(), nullptr);
-				g_WeatherSpecificWeather.emplace(itemSpecificWeather);
-
-				TechniqueInfo WeatherInfo;
-				WeatherInfo.filename = itemWeatherShaderToToggle;
-				WeatherInfo.state = itemWeatherStateValue;
-				WeatherInfo.Name = itemSpecificWeather;
-				techniqueWeatherInfoList.push_back(WeatherInfo);
-				DEBUG_LOG(g_Logger, "Populated TechniqueWeatherInfo: {} - {}", itemWeatherShaderToToggle, itemWeatherStateValue);
-			}
-		}
-	}
-
-	DEBUG_LOG(g_Logger, "\n", nullptr);
-
-	//WeatherProcess
-	ini.GetAllKeys(sectionWeatherProcess, WeatherProcess_keys);
-	g_INIweather.reserve(WeatherProcess_keys.size()); // Reserve space for vector
-
-	for (const auto& key : WeatherProcess_keys)
-	{
-		Info weather;
-		g_INIweather.push_back(key.pItem);
-		const char* weatherItem = g_INIweather.back().c_str();
-		const char* weatheritemValue = ini.GetValue(sectionWeatherProcess, key.pItem, nullptr);
-		g_WeatherValue.emplace(weatheritemValue);
-
-		weather.Index = weatherItem;
-		weather.Name = weatheritemValue;
-		weatherList.push_back(weather);
-
-		DEBUG_LOG(g_Logger, "Weather:  {} - Value: {}", weatherItem, weatheritemValue);
-	}
-
-	DEBUG_LOG(g_Logger, "\n", nullptr);
-#pragma endregion
-
-	if (TimeUpdateIntervalTime < 0) { TimeUpdateIntervalTime = 0; }
-	if (TimeUpdateIntervalInterior < 0) { TimeUpdateIntervalInterior = 0; }
-	if (TimeUpdateIntervalWeather < 0) { TimeUpdateIntervalWeather = 0; }
+	Config::LoadINI(presetPath);
 }
 
 void ReshadeToggler::LoadPreset(const std::string& Preset)
@@ -479,65 +203,9 @@ void ReshadeToggler::LoadPreset(const std::string& Preset)
 
 	g_Logger->info("Starting clear procedure...");
 
-	EnableMenus = false;
-	EnableTime = false;
-	EnableInterior = false;
-	EnableWeather = false;
-
-	// Empty every vector
-	g_MenuToggleFile.clear();
-	g_MenuToggleState.clear();
-	g_MenuSpecificMenu.clear();
-	g_SpecificMenu.clear();
-	g_INImenus.clear();
-	techniqueMenuInfoList.clear();
-	menuList.clear();
-	ToggleStateMenus.clear();
-	ToggleAllStateMenus.clear();
-	itemMenuShaderToToggle = nullptr; // itemMenuShaderToToggle is a pointer, set it to nullptr.
-	itemMenuStateValue = nullptr; // Similarly, set itemMenuStateValue to nullptr.
-	itemSpecificMenu = nullptr;
-
-	g_TimeToggleFile.clear();
-	g_TimeToggleState.clear();
-	techniqueTimeInfoList.clear();
-	techniqueTimeInfoListAll.clear();
-	g_SpecificTime.clear();
-	ToggleStateTime.clear();
-	ToggleAllStateTime.clear();
-	itemTimeShaderToToggle = nullptr; // Set to nullptr.
-	itemTimeStateValue = nullptr; // Set to nullptr.
-	itemTimeStartHour = 0.0;
-	itemTimeStopHour = 0.0;
-	itemTimeStartHourAll = 0.0;
-	itemTimeStopHourAll = 0.0;
-	TimeUpdateIntervalTime = 0;
-
-	g_InteriorToggleFile.clear();
-	g_InteriorToggleState.clear();
-	techniqueInteriorInfoList.clear();
-	g_SpecificInterior.clear();
-	ToggleStateInterior.clear();
-	ToggleAllStateInterior.clear();
-	itemInteriorShaderToToggle = nullptr;
-	itemInteriorStateValue = nullptr;
-	TimeUpdateIntervalInterior = 0;
-
-	g_WeatherValue.clear();
-	g_WeatherToggleFile.clear();
-	g_WeatherToggleState.clear();
-	g_WeatherSpecificWeather.clear();
-	g_SpecificWeather.clear();
-	g_INIweather.clear();
-	weatherList.clear();
-	techniqueWeatherInfoList.clear();
-	ToggleStateWeather.clear();
-	ToggleAllStateWeather.clear();
-	weatherflags.clear();
-	itemWeatherShaderToToggle = nullptr; // Set to nullptr.
-	itemWeatherStateValue = nullptr; // Set to nullptr.
-	itemSpecificWeather = nullptr;
-	TimeUpdateIntervalWeather = 0;
+	// The new preset's performance rules start from every effect on
+	Processor::GetSingleton().ResetGovernor();
+	Config::Clear();
 
 	g_Logger->info("Finished clearing procedure...");
 
@@ -554,6 +222,7 @@ void MessageListener(SKSE::MessagingInterface::Message* message)
 	case SKSE::MessagingInterface::kDataLoaded:
 		DEBUG_LOG(g_Logger, "kDataLoaded: sent after the data handler has loaded all its forms", nullptr);
 		isLoaded = true;
+		Processor::GetSingleton().OnDataLoaded();
 		if (isLoaded)
 		{
 			std::thread(RuntimeThread).detach();
@@ -595,7 +264,7 @@ void ReshadeToggler::Setup()
 	Load();
 	g_Logger->info("Loaded plugin");
 
-	if (EnableMenus)
+	if (Processor::NeedsMenuEvents())
 	{
 		auto& eventProcessorMenu = Processor::GetSingleton();
 		RE::UI::GetSingleton()->AddEventSink<RE::MenuOpenCloseEvent>(&eventProcessorMenu);
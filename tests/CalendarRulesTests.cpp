@@ -0,0 +1,116 @@
+#include "Catch.h"
+#include "Stubs.h"
+
+#include "Core/CalendarRules.h"
+#include "Core/Config.h"
+#include "Core/RuleEngine.h"
+
+namespace
+{
+	GameDate MakeDate(std::uint32_t month, std::uint32_t day, float daysPassed)
+	{
+		GameDate date;
+		date.month = month;
+		date.day = day;
+		date.daysPassed = daysPassed;
+		date.dayOfWeek = static_cast<std::uint32_t>(daysPassed) % 7;
+		return date;
+	}
+}
+
+TEST_CASE("Calendar rules are only evaluated at date boundaries", "[Calendar]")
+{
+	CHECK(CalendarRules::ParseMonths("Winter, Last Seed") == ((1 << 11) | (1 << 0) | (1 << 1) | (1 << 7)));
+	CHECK(CalendarRules::ParseMonths("Nope") == 0);
+	CHECK(CalendarRules::FormatMonths(CalendarRules::ParseMonths("Spring")) == "First Seed, Rain's Hand, Second Seed");
+	CHECK(CalendarRules::ParseWeekdays("Sundas,Loredas") == ((1 << 0) | (1 << 6)));
+	CHECK(CalendarRules::FormatWeekdays(CalendarRules::kAllWeekdays) == "Sundas, Morndas, Tirdas, Middas, Turdas, Fredas, Loredas");
+
+	CalendarInfo winter;
+	winter.filename = "Snow.fx";
+	winter.months = CalendarRules::ParseMonths("Winter");
+
+	CalendarInfo firstWeek;
+	firstWeek.filename = "Intro.fx";
+	firstWeek.lastDay = 6;
+
+	CalendarRules rules;
+	rules.Compile({ winter, firstWeek });
+
+	// Evening Star 30th, day 3 of the playthrough
+	CHECK(rules.Update(MakeDate(11, 30, 3.5f), 12.0f) == std::vector<std::size_t>{ 0, 1 });
+	CHECK(rules.IsActive(0));
+	CHECK(rules.IsActive(1));
+	CHECK(rules.GetNextBoundary() == Approx(5.0)); // Morning Star starts after the 31st
+	CHECK(rules.GetEvaluationCount() == 1);
+
+	// Nothing to look at until then
+	CHECK(rules.Update(MakeDate(11, 30, 3.9f), 21.6f).empty());
+	CHECK(rules.Update(MakeDate(11, 31, 4.2f), 4.8f).empty());
+	CHECK(rules.GetEvaluationCount() == 1);
+
+	// Still winter in Morning Star, the first week ends after day 6
+	CHECK(rules.Update(MakeDate(0, 1, 5.0f), 0.0f).empty());
+	CHECK(rules.GetEvaluationCount() == 2);
+	CHECK(rules.GetNextBoundary() == Approx(7.0));
+	CHECK(rules.Update(MakeDate(0, 3, 7.0f), 0.0f) == std::vector<std::size_t>{ 1 });
+	CHECK_FALSE(rules.IsActive(1));
+
+	// Winter ends with Sun's Dawn, 28 days
+	CHECK(rules.Update(MakeDate(1, 10, 40.0f), 0.0f).empty());
+	CHECK(rules.GetNextBoundary() == Approx(59.0));
+	CHECK(rules.Update(MakeDate(2, 1, 59.0f), 0.0f) == std::vector<std::size_t>{ 0 });
+	CHECK_FALSE(rules.IsActive(0));
+
+	// Loading an earlier save evaluates again
+	const std::size_t evaluations = rules.GetEvaluationCount();
+	CHECK(rules.Update(MakeDate(11, 30, 3.5f), 12.0f) == std::vector<std::size_t>{ 0, 1 });
+	CHECK(rules.GetEvaluationCount() == evaluations + 1);
+}
+
+TEST_CASE("Calendar rules follow the game date", "[Calendar][RuleEngine]")
+{
+	Config::Clear();
+	EnableCalendar = true;
+
+	CalendarInfo weekend;
+	weekend.filename = "Bloom.fx";
+	weekend.state = "on";
+	weekend.weekdays = CalendarRules::ParseWeekdays("Sundas, Loredas");
+	calendarInfoList.push_back(weekend);
+
+	StubGameState gameState;
+	gameState.hour = 12.0f;
+	gameState.date.daysPassed = 1.5f;
+	gameState.date.dayOfWeek = 1;
+	StubEffectRuntime runtime;
+	runtime.AddEffect("Bloom.fx");
+	RuleEngine engine(gameState, &runtime);
+
+	engine.ProcessTimeBasedToggling();
+	CHECK_FALSE(runtime.IsEffectEnabled("Bloom.fx"));
+
+	gameState.date.daysPassed = 6.5f;
+	gameState.date.dayOfWeek = 6;
+	engine.ProcessTimeBasedToggling();
+	CHECK(runtime.IsEffectEnabled("Bloom.fx"));
+
+	// Later the same day nothing is applied
+	runtime.ResetCounters();
+	gameState.hour = 20.0f;
+	gameState.date.daysPassed = 6.83f;
+	engine.ProcessTimeBasedToggling();
+	CHECK(runtime.techniqueStateCalls == 0);
+
+	// After a reload every rule is applied again
+	engine.InvalidateRules();
+	engine.ProcessTimeBasedToggling();
+	CHECK(runtime.techniqueStateCalls == 1);
+
+	gameState.hour = 1.0f;
+	gameState.date.daysPassed = 7.04f;
+	gameState.date.dayOfWeek = 0;
+	engine.ProcessTimeBasedToggling();
+	CHECK(runtime.IsEffectEnabled("Bloom.fx"));
+	CHECK(runtime.techniqueStateCalls == 1);
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+// Catch2 v3 split its single header, v2 still has catch.hpp
+#if __has_include(<catch2/catch_all.hpp>)
+#include <catch2/catch_all.hpp>
+#else
+#include <catch2/catch.hpp>
+#endif
@@ -0,0 +1,206 @@
+#include "Catch.h"
+#include "Stubs.h"
+
+#include "Core/ConditionExpressions.h"
+#include "Core/Config.h"
+#include "Core/RuleEngine.h"
+
+#include <algorithm>
+
+TEST_CASE("Expressions parse and report errors", "[Expressions]")
+{
+	std::unordered_set<std::string> menus = { "Map Menu" };
+	ConditionSnapshot snapshot;
+	snapshot.hour = 23.0f;
+	snapshot.interior = true;
+	snapshot.menus = &menus;
+	snapshot.weather = "kRainy";
+
+	ConditionExpressions expressions;
+	const auto night = expressions.Add("interior && hour(22, 5) && !menu(Map Menu)");
+	const auto words = expressions.Add("not exterior and (weather(\"kRainy\") or false)");
+	const auto precedence = expressions.Add("true || false && false");
+	const auto map = expressions.Add("menu( Map Menu )");
+	REQUIRE(night);
+	REQUIRE(words);
+	REQUIRE(precedence);
+	REQUIRE(map);
+
+	// Same terms share one input: interior, hour, menu and weather
+	CHECK(expressions.GetInputCount() == 4);
+
+	expressions.Update(snapshot);
+	CHECK_FALSE(expressions.GetResult(*night));
+	CHECK(expressions.GetResult(*words));
+	CHECK(expressions.GetResult(*precedence));
+	CHECK(expressions.GetResult(*map));
+
+	std::string error;
+	CHECK_FALSE(expressions.Add("interior &&", &error));
+	CHECK_FALSE(error.empty());
+	CHECK_FALSE(expressions.Add("indoors", &error));
+	CHECK(error == "unknown condition 'indoors'");
+	CHECK_FALSE(expressions.Add("hour(25, 3)", &error));
+	CHECK_FALSE(expressions.Add("(interior", &error));
+	CHECK_FALSE(expressions.Add("menu()", &error));
+	CHECK_FALSE(expressions.Add("interior exterior", &error));
+	CHECK_FALSE(expressions.Add("order", &error));
+	CHECK_FALSE(expressions.Add("player(Flying)", &error));
+	CHECK(error == "unknown player state 'Flying'");
+	CHECK_FALSE(expressions.Add("camera(Orbit)", &error));
+	CHECK(error == "unknown camera state 'Orbit'");
+	CHECK_FALSE(expressions.Add("light(Pitch)", &error));
+	CHECK(error == "unknown light band 'Pitch'");
+	CHECK(expressions.GetCount() == 4);
+
+	const auto sneaking = expressions.Add("player(Sneaking) && !player(Combat)");
+	REQUIRE(sneaking);
+	snapshot.player = static_cast<std::uint32_t>(PlayerState::kSneaking) | static_cast<std::uint32_t>(PlayerState::kMounted);
+	expressions.Update(snapshot);
+	CHECK(expressions.GetResult(*sneaking));
+	snapshot.player |= static_cast<std::uint32_t>(PlayerState::kCombat);
+	CHECK(expressions.Update(snapshot) == std::vector<ConditionExpressions::Index>{ *sneaking });
+	CHECK_FALSE(expressions.GetResult(*sneaking));
+
+	const auto firstPerson = expressions.Add("camera(FirstPerson) || camera(Killcam)");
+	REQUIRE(firstPerson);
+	snapshot.camera = static_cast<std::uint32_t>(CameraState::kKillcam);
+	expressions.Update(snapshot);
+	CHECK(expressions.GetResult(*firstPerson));
+	snapshot.camera = static_cast<std::uint32_t>(CameraState::kFree);
+	expressions.Update(snapshot);
+	CHECK_FALSE(expressions.GetResult(*firstPerson));
+
+	const auto dark = expressions.Add("interior && light(Dark)");
+	REQUIRE(dark);
+	snapshot.interior = true;
+	snapshot.light = static_cast<std::uint32_t>(GetLightBand(0.05f, 0.12f, 0.35f));
+	expressions.Update(snapshot);
+	CHECK(expressions.GetResult(*dark));
+	snapshot.light = static_cast<std::uint32_t>(GetLightBand(0.2f, 0.12f, 0.35f));
+	expressions.Update(snapshot);
+	CHECK_FALSE(expressions.GetResult(*dark));
+	CHECK(GetLightBand(std::nullopt, 0.12f, 0.35f) == LightBand::kNone);
+	CHECK(GetLightBand(0.35f, 0.12f, 0.35f) == LightBand::kBright);
+
+	// Right-leaning chains need a deep stack, left-leaning ones don't
+	std::string deep;
+	std::string flat = "true";
+	for (int i = 0; i < 70; i++)
+	{
+		deep += "(true && ";
+		flat += " && true";
+	}
+	deep += "true" + std::string(70, ')');
+	CHECK_FALSE(expressions.Add(deep, &error));
+	CHECK(error == "expression too deep");
+	CHECK(expressions.Add(flat));
+
+	// Rejected while parsing, before the recursion gets anywhere near the end of the stack
+	CHECK_FALSE(expressions.Add(std::string(100000, '(') + "true", &error));
+	CHECK(error == "expression too deep");
+	CHECK_FALSE(expressions.Add(std::string(100000, '!') + "true", &error));
+	CHECK(error == "expression too deep");
+
+	CHECK(ConditionExpressions::IsHourInRange(23.0f, 22.0, 5.0));
+	CHECK(ConditionExpressions::IsHourInRange(4.0f, 22.0, 5.0));
+	CHECK_FALSE(ConditionExpressions::IsHourInRange(12.0f, 22.0, 5.0));
+}
+
+TEST_CASE("Only expressions reading a changed input are evaluated", "[Expressions]")
+{
+	std::unordered_set<std::string> menus;
+	ConditionSnapshot snapshot;
+	snapshot.hour = 12.0f;
+	snapshot.menus = &menus;
+	snapshot.weather = "kPleasant";
+
+	ConditionExpressions expressions;
+	const auto inside = *expressions.Add("interior");
+	const auto map = *expressions.Add("menu(MapMenu) || weather(kRainy)");
+	const auto night = *expressions.Add("hour(20, 6) && exterior");
+
+	// The first update evaluates and reports everything
+	CHECK(expressions.Update(snapshot).size() == 3);
+	CHECK(expressions.GetEvaluatedCount() == 3);
+
+	CHECK(expressions.Update(snapshot).empty());
+	CHECK(expressions.GetEvaluatedCount() == 0);
+
+	menus.insert("MapMenu");
+	CHECK(expressions.Update(snapshot) == std::vector<ConditionExpressions::Index>{ map });
+	CHECK(expressions.GetEvaluatedCount() == 1);
+	CHECK(expressions.GetResult(map));
+
+	// Evaluated again but unchanged, so not reported
+	snapshot.weather = "kRainy";
+	CHECK(expressions.Update(snapshot).empty());
+	CHECK(expressions.GetEvaluatedCount() == 1);
+
+	snapshot.interior = true;
+	auto changed = expressions.Update(snapshot);
+	std::sort(changed.begin(), changed.end());
+	CHECK(changed == std::vector<ConditionExpressions::Index>{ inside });
+	CHECK(expressions.GetEvaluatedCount() == 2);
+
+	// Moving within the range doesn't flip the input
+	snapshot.hour = 13.0f;
+	CHECK(expressions.Update(snapshot).empty());
+	CHECK(expressions.GetEvaluatedCount() == 0);
+
+	snapshot.interior = false;
+	snapshot.hour = 21.0f;
+	changed = expressions.Update(snapshot);
+	std::sort(changed.begin(), changed.end());
+	CHECK(changed == std::vector<ConditionExpressions::Index>{ inside, night });
+
+	// Added later, evaluated on the next update on its own
+	const auto later = *expressions.Add("exterior");
+	CHECK(expressions.Update(snapshot) == std::vector<ConditionExpressions::Index>{ later });
+	CHECK(expressions.GetEvaluatedCount() == 1);
+}
+
+TEST_CASE("Expression rules toggle effects", "[Expressions]")
+{
+	Config::Clear();
+	EnableExpressions = true;
+
+	ExpressionInfo night;
+	night.filename = "Bloom.fx";
+	night.state = "off";
+	night.expression = "interior || menu(MapMenu)";
+	expressionInfoList.push_back(night);
+
+	ExpressionInfo broken;
+	broken.filename = "SSAO.fx";
+	broken.state = "on";
+	broken.expression = "interior &&";
+	expressionInfoList.push_back(broken);
+
+	StubGameState gameState;
+	StubEffectRuntime runtime;
+	runtime.AddEffect("Bloom.fx");
+	runtime.AddEffect("SSAO.fx");
+	RuleEngine engine(gameState, &runtime);
+
+	engine.ProcessInteriorBasedToggling();
+	CHECK(runtime.IsEffectEnabled("Bloom.fx"));
+	CHECK(runtime.IsEffectEnabled("SSAO.fx")); // Skipped, "on" would have turned it off outside
+
+	engine.ProcessMenuEvent("MapMenu", true);
+	CHECK_FALSE(runtime.IsEffectEnabled("Bloom.fx"));
+
+	// Nothing changed, nothing applied
+	runtime.ResetCounters();
+	engine.ProcessExpressions();
+	CHECK(runtime.enumerateCalls == 0);
+
+	engine.ProcessMenuEvent("MapMenu", false);
+	CHECK(runtime.IsEffectEnabled("Bloom.fx"));
+
+	// Edits compile again and apply right away
+	expressionInfoList[0].expression = "exterior";
+	expressionRevision++;
+	engine.ProcessExpressions();
+	CHECK_FALSE(runtime.IsEffectEnabled("Bloom.fx"));
+}
@@ -0,0 +1,303 @@
+#include "Catch.h"
+
+#include "Core/CalendarRules.h"
+#include "Core/Config.h"
+#include "Core/StateRules.h"
+
+#include <filesystem>
+
+TEST_CASE("Saved presets load back unchanged", "[Config]")
+{
+	Config::Clear();
+	EnableMenus = true;
+	EnableTime = true;
+	ToggleStateMenus = "Specific";
+	ToggleAllStateMenus = "off";
+	ToggleStateTime = "Specific";
+	ToggleAllStateTime = "off";
+	ToggleStateInterior = "All";
+	ToggleAllStateInterior = "on";
+	ToggleStateWeather = "All";
+	ToggleAllStateWeather = "off";
+	TimeUpdateIntervalTime = 5;
+
+	TechniqueInfo menuInfo;
+	menuInfo.filename = "DOF.fx";
+	menuInfo.state = "off";
+	menuInfo.Name = "MapMenu";
+	techniqueMenuInfoList.push_back(menuInfo);
+
+	TechniqueInfo timeInfo;
+	timeInfo.filename = "Bloom.fx";
+	timeInfo.state = "on";
+	timeInfo.startTime = 6.5;
+	timeInfo.stopTime = 18.0;
+	techniqueTimeInfoList.push_back(timeInfo);
+	techniqueTimeInfoListAll.push_back(TechniqueInfo{});
+
+	weatherList.push_back(Info{ "Weather1", "kRainy" });
+
+	EnablePerformance = true;
+	PerformanceTargetFrameTime = 8.3;
+	TechniqueInfo performanceInfo;
+	performanceInfo.filename = "SSAO.fx";
+	performanceInfo.state = "off";
+	performanceInfo.priority = 3;
+	techniquePerformanceInfoList.push_back(performanceInfo);
+
+	EnableDeferral = true;
+	DeferralTimeout = 45;
+	deferredEffectList.push_back("SSR.fx");
+
+	EnableDefinitions = true;
+	DefinitionBatchDelay = 0;
+	DefinitionInfo definitionInfo;
+	definitionInfo.filename = "SSAO.fx";
+	definitionInfo.name = "SSAO_SAMPLES";
+	definitionInfo.value = "8";
+	definitionInfo.defaultValue = "32";
+	definitionInfo.category = "Time";
+	definitionInfo.startTime = 20.0;
+	definitionInfo.stopTime = 23.5;
+	definitionInfoList.push_back(definitionInfo);
+
+	EnableUniforms = true;
+	UniformInfo uniformInfo;
+	uniformInfo.filename = "Bloom.fx";
+	uniformInfo.name = "fBloomStrength";
+	uniformInfo.value = 0.25;
+	uniformInfo.defaultValue = 0.75;
+	uniformInfo.category = "Weather";
+	uniformInfo.condition = "kRainy";
+	uniformInfoList.push_back(uniformInfo);
+
+	EnableCurves = true;
+	CurveInfo curveInfo;
+	curveInfo.filename = "Tonemap.fx";
+	curveInfo.name = "fExposure";
+	curveInfo.keys = { { 6.0, 0.25 }, { 12.5, 1.0 } };
+	curveInfoList.push_back(curveInfo);
+
+	EnableFades = true;
+	EnableGameUniforms = true;
+	FadeInfo fadeInfo;
+	fadeInfo.filename = "Bloom.fx";
+	fadeInfo.uniform = "fFade";
+	fadeInfo.duration = 750.0;
+	fadeInfo.maxValue = 0.5;
+	fadeInfoList.push_back(fadeInfo);
+
+	GroupInfo groupInfo;
+	groupInfo.name = "DOF";
+	groupInfo.members = { "DOF.fx", "CinematicDOF.fx:CinematicDOF" };
+	groupInfoList.push_back(groupInfo);
+
+	EnableExpressions = true;
+	ExpressionInfo expressionInfo;
+	expressionInfo.filename = "@DOF";
+	expressionInfo.state = "on";
+	expressionInfo.expression = "exterior && hour(22, 5) && !menu(Map Menu)";
+	expressionInfoList.push_back(expressionInfo);
+
+	EnableCalendar = true;
+	CalendarInfo calendarInfo;
+	calendarInfo.filename = "Snow.fx";
+	calendarInfo.state = "on";
+	calendarInfo.months = CalendarRules::ParseMonths("Winter");
+	calendarInfo.weekdays = CalendarRules::ParseWeekdays("Sundas, Loredas");
+	calendarInfo.firstDay = 3;
+	calendarInfo.lastDay = 100;
+	calendarInfoList.push_back(calendarInfo);
+
+	EnableLocation = true;
+	LocationInfo locationInfo;
+	locationInfo.filename = "RTGI.fx";
+	locationInfo.type = "Keyword";
+	locationInfo.name = "LocTypeDungeon";
+	locationInfoList.push_back(locationInfo);
+
+	EnableLight = true;
+	LightDarkThreshold = 0.1f;
+	LightBrightThreshold = 0.4f;
+
+	EnableHotkeys = true;
+	HotkeyInfo hotkeyInfo;
+	hotkeyInfo.key = "Ctrl+F10";
+	hotkeyInfo.action = "CyclePreset";
+	hotkeyInfo.target = "Day.ini, Night.ini";
+	hotkeyInfoList.push_back(hotkeyInfo);
+
+	EnableScene = true;
+	TimeUpdateIntervalScene = 3;
+	SceneInfo sceneInfo;
+	sceneInfo.filename = "@DOF";
+	sceneInfo.metric = "References";
+	sceneInfo.threshold = 4000.0;
+	sceneInfo.hysteresis = 500.0;
+	sceneInfoList.push_back(sceneInfo);
+
+	EnableReshadePresets = true;
+	DefaultReshadePreset = "Day.ini";
+	PresetSwitchInterval = 90;
+	PresetSwitchTimeout = 0;
+	ReshadePresetInfo presetInfo;
+	presetInfo.path = "Night.ini";
+	presetInfo.category = "Time";
+	presetInfo.startTime = 21.0;
+	presetInfo.stopTime = 23.5;
+	reshadePresetInfoList.push_back(presetInfo);
+
+	const auto path = (std::filesystem::temp_directory_path() / "ReShadeEffectTogglerConfigTest.ini").string();
+	Config::Save(path);
+
+	Config::Clear();
+	Config::LoadINI(path);
+	std::filesystem::remove(path);
+
+	CHECK(EnableMenus);
+	CHECK(EnableTime);
+	CHECK_FALSE(EnableWeather);
+	CHECK(ToggleStateInterior == "All");
+	CHECK(ToggleAllStateInterior == "on");
+	CHECK(TimeUpdateIntervalTime == 5);
+
+	REQUIRE(techniqueMenuInfoList.size() == 1);
+	CHECK(techniqueMenuInfoList[0].filename == "DOF.fx");
+	CHECK(techniqueMenuInfoList[0].Name == "MapMenu");
+
+	REQUIRE(techniqueTimeInfoList.size() == 1);
+	CHECK(techniqueTimeInfoList[0].state == "on");
+	CHECK(techniqueTimeInfoList[0].startTime == 6.5);
+	CHECK(techniqueTimeInfoList[0].stopTime == 18.0);
+
+	REQUIRE(weatherList.size() == 1);
+	CHECK(weatherList[0].Name == "kRainy");
+
+	CHECK(EnablePerformance);
+	CHECK(PerformanceTargetFrameTime == 8.3);
+	REQUIRE(techniquePerformanceInfoList.size() == 1);
+	CHECK(techniquePerformanceInfoList[0].filename == "SSAO.fx");
+	CHECK(techniquePerformanceInfoList[0].priority == 3);
+
+	CHECK(EnableDeferral);
+	CHECK(DeferralTimeout == 45);
+	CHECK(deferredEffectList == std::vector<std::string>{ "SSR.fx" });
+
+	CHECK(EnableDefinitions);
+	CHECK(DefinitionBatchDelay == 0);
+	REQUIRE(definitionInfoList.size() == 1);
+	CHECK(definitionInfoList[0].filename == "SSAO.fx");
+	CHECK(definitionInfoList[0].name == "SSAO_SAMPLES");
+	CHECK(definitionInfoList[0].value == "8");
+	CHECK(definitionInfoList[0].defaultValue == "32");
+	CHECK(definitionInfoList[0].category == "Time");
+	CHECK(definitionInfoList[0].startTime == 20.0);
+	CHECK(definitionInfoList[0].stopTime == 23.5);
+
+	CHECK(EnableUniforms);
+	REQUIRE(uniformInfoList.size() == 1);
+	CHECK(uniformInfoList[0].filename == "Bloom.fx");
+	CHECK(uniformInfoList[0].name == "fBloomStrength");
+	CHECK(uniformInfoList[0].type == "float");
+	CHECK(uniformInfoList[0].value == 0.25);
+	CHECK(uniformInfoList[0].defaultValue == 0.75);
+	CHECK(uniformInfoList[0].category == "Weather");
+	CHECK(uniformInfoList[0].condition == "kRainy");
+
+	CHECK(EnableCurves);
+	REQUIRE(curveInfoList.size() == 1);
+	CHECK(curveInfoList[0].filename == "Tonemap.fx");
+	CHECK(curveInfoList[0].name == "fExposure");
+	CHECK(curveInfoList[0].keys == curveInfo.keys);
+
+	CHECK(EnableFades);
+	CHECK(EnableGameUniforms);
+	REQUIRE(fadeInfoList.size() == 1);
+	CHECK(fadeInfoList[0].filename == "Bloom.fx");
+	CHECK(fadeInfoList[0].uniform == "fFade");
+	CHECK(fadeInfoList[0].duration == 750.0);
+	CHECK(fadeInfoList[0].maxValue == 0.5);
+
+	REQUIRE(groupInfoList.size() == 1);
+	CHECK(groupInfoList[0].name == "DOF");
+	CHECK(groupInfoList[0].members == groupInfo.members);
+
+	CHECK(EnableExpressions);
+	REQUIRE(expressionInfoList.size() == 1);
+	CHECK(expressionInfoList[0].filename == "@DOF");
+	CHECK(expressionInfoList[0].state == "on");
+	CHECK(expressionInfoList[0].expression == expressionInfo.expression);
+
+	CHECK(EnableCalendar);
+	REQUIRE(calendarInfoList.size() == 1);
+	CHECK(calendarInfoList[0].filename == "Snow.fx");
+	CHECK(calendarInfoList[0].state == "on");
+	CHECK(calendarInfoList[0].months == calendarInfo.months);
+	CHECK(calendarInfoList[0].weekdays == calendarInfo.weekdays);
+	CHECK(calendarInfoList[0].firstDay == 3);
+	CHECK(calendarInfoList[0].lastDay == 100);
+
+	CHECK(EnableLocation);
+	REQUIRE(locationInfoList.size() == 1);
+	CHECK(locationInfoList[0].filename == "RTGI.fx");
+	CHECK(locationInfoList[0].state == "off");
+	CHECK(locationInfoList[0].type == "Keyword");
+	CHECK(locationInfoList[0].name == "LocTypeDungeon");
+
+	CHECK(EnableLight);
+	CHECK(LightDarkThreshold == Approx(0.1));
+	CHECK(LightBrightThreshold == Approx(0.4));
+
+	CHECK(EnableHotkeys);
+	REQUIRE(hotkeyInfoList.size() == 1);
+	CHECK(hotkeyInfoList[0].key == "Ctrl+F10");
+	CHECK(hotkeyInfoList[0].action == "CyclePreset");
+	CHECK(hotkeyInfoList[0].target == "Day.ini, Night.ini");
+
+	CHECK(EnableScene);
+	CHECK(TimeUpdateIntervalScene == 3);
+	REQUIRE(sceneInfoList.size() == 1);
+	CHECK(sceneInfoList[0].filename == "@DOF");
+	CHECK(sceneInfoList[0].metric == "References");
+	CHECK(sceneInfoList[0].threshold == 4000.0);
+	CHECK(sceneInfoList[0].hysteresis == 500.0);
+
+	CHECK(EnableReshadePresets);
+	CHECK(DefaultReshadePreset == "Day.ini");
+	CHECK(PresetSwitchInterval == 90);
+	CHECK(PresetSwitchTimeout == 0);
+	REQUIRE(reshadePresetInfoList.size() == 1);
+	CHECK(reshadePresetInfoList[0].path == "Night.ini");
+	CHECK(reshadePresetInfoList[0].category == "Time");
+	CHECK(reshadePresetInfoList[0].startTime == 21.0);
+	CHECK(reshadePresetInfoList[0].stopTime == 23.5);
+}
+
+TEST_CASE("State rules load back unchanged", "[Config]")
+{
+	for (const StateRuleKind* kind : { &kPlayerRules, &kCameraRules, &kLightRules })
+	{
+		INFO(kind->name);
+
+		Config::Clear();
+		kind->enabled = true;
+		kind->rules.push_back(StateRuleInfo{ "@DOF", "on", kind->states.back() });
+		kind->rules.push_back(kind->newRule);
+
+		const auto path = (std::filesystem::temp_directory_path() / "ReShadeEffectTogglerStateRulesTest.ini").string();
+		Config::Save(path);
+
+		Config::Clear();
+		Config::LoadINI(path);
+		std::filesystem::remove(path);
+
+		CHECK(kind->enabled);
+		REQUIRE(kind->rules.size() == 2);
+		CHECK(kind->rules[0].filename == "@DOF");
+		CHECK(kind->rules[0].state == "on");
+		CHECK(kind->rules[0].condition == kind->states.back());
+		CHECK(kind->rules[1].filename == kind->newRule.filename);
+		CHECK(kind->rules[1].state == kind->newRule.state);
+		CHECK(kind->rules[1].condition == kind->newRule.condition);
+	}
+}
@@ -0,0 +1,44 @@
+#include "Catch.h"
+#include "Stubs.h"
+
+#include "Core/CostProfiler.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+TEST_CASE("Effect costs export ranked to CSV", "[Profiler]")
+{
+	StubEffectRuntime runtime;
+	runtime.AddEffect("Light.fx");
+	runtime.AddEffect("Heavy.fx");
+
+	CostProfiler profiler;
+	profiler.SetSettings(CostProfiler::Settings{ 1, 0, 1 });
+	profiler.Start(runtime, { "Light.fx", "Heavy.fx" });
+
+	// Baseline, Light off, baseline, Heavy off, baseline
+	for (const float frameTime : { 10.0f, 9.0f, 10.0f, 6.0f, 10.0f })
+	{
+		profiler.AddFrame(runtime, frameTime);
+	}
+	REQUIRE_FALSE(profiler.IsRunning());
+
+	const auto path = (std::filesystem::temp_directory_path() / "ReShadeEffectTogglerEffectCosts.csv").string();
+	REQUIRE(profiler.SaveCSV(path));
+
+	std::ifstream file(path);
+	std::stringstream contents;
+	contents << file.rdbuf();
+	file.close();
+	std::filesystem::remove(path);
+
+	// rapidcsv writes CRLF on Windows
+	std::string csv = contents.str();
+	std::erase(csv, '\r');
+
+	CHECK(csv ==
+		"Rank,Effect,Cost,Low95,High95,Samples\n"
+		"1,Heavy.fx,4,4,4,1\n"
+		"2,Light.fx,1,1,1,1\n");
+}
@@ -0,0 +1,188 @@
+#include "Catch.h"
+#include "Stubs.h"
+
+#include "Core/CostProfiler.h"
+
+#include <cmath>
+#include <random>
+
+namespace
+{
+	// Base load plus a fixed cost per enabled effect, with optional noise and drift per frame
+	struct Scene
+	{
+		StubEffectRuntime runtime;
+		std::vector<std::pair<std::string, float>> costs;
+		float base = 10.0f;
+		float drift = 0.0f;
+		float noise = 0.0f;
+		std::mt19937 random{ 1234 };
+
+		explicit Scene(std::vector<std::pair<std::string, float>> effectCosts) : costs(std::move(effectCosts))
+		{
+			for (const auto& [effect, cost] : costs)
+			{
+				runtime.AddEffect(effect, 2);
+			}
+		}
+
+		float NextFrame()
+		{
+			float frameTime = base;
+			for (const auto& [effect, cost] : costs)
+			{
+				if (runtime.IsEffectEnabled(effect))
+				{
+					frameTime += cost;
+				}
+			}
+			base += drift;
+			if (noise > 0.0f)
+			{
+				frameTime += std::normal_distribution<float>(0.0f, noise)(random);
+			}
+			return frameTime;
+		}
+
+		std::vector<std::string> Effects() const
+		{
+			std::vector<std::string> effects;
+			for (const auto& [effect, cost] : costs)
+			{
+				effects.push_back(effect);
+			}
+			return effects;
+		}
+	};
+
+	std::size_t RunToEnd(CostProfiler& profiler, Scene& scene)
+	{
+		std::size_t frames = 0;
+		while (profiler.IsRunning() && frames < 1000000)
+		{
+			profiler.AddFrame(scene.runtime, scene.NextFrame());
+			frames++;
+		}
+		return frames;
+	}
+}
+
+TEST_CASE("Cost stats give the t based confidence interval", "[Profiler]")
+{
+	CostStats stats;
+	CHECK(stats.GetConfidenceHalfWidth() == 0.0);
+
+	for (int i = 1; i <= 5; i++)
+	{
+		stats.Add(i);
+	}
+
+	CHECK(stats.GetCount() == 5);
+	CHECK(stats.GetMean() == 3.0);
+	CHECK(std::abs(stats.GetStandardDeviation() - std::sqrt(2.5)) < 1e-9);
+	CHECK(std::abs(stats.GetConfidenceHalfWidth() - 2.776 * std::sqrt(2.5) / std::sqrt(5.0)) < 1e-9);
+}
+
+TEST_CASE("Profiler ranks effects by measured cost", "[Profiler]")
+{
+	Scene scene({ { "Cheap.fx", 0.5f }, { "Heavy.fx", 3.0f }, { "Medium.fx", 1.0f } });
+	scene.noise = 0.3f;
+
+	CostProfiler profiler;
+	profiler.SetSettings(CostProfiler::Settings{ 30, 2, 8 });
+	profiler.Start(scene.runtime, scene.Effects());
+	REQUIRE(profiler.IsRunning());
+
+	RunToEnd(profiler, scene);
+	CHECK_FALSE(profiler.IsRunning());
+	CHECK(profiler.GetProgress() == 1.0f);
+
+	const auto results = profiler.GetResults();
+	REQUIRE(results.size() == 3);
+	CHECK(results[0].effect == "Heavy.fx");
+	CHECK(results[1].effect == "Medium.fx");
+	CHECK(results[2].effect == "Cheap.fx");
+
+	for (const auto& result : results)
+	{
+		const float expected = result.effect == "Heavy.fx" ? 3.0f : result.effect == "Medium.fx" ? 1.0f : 0.5f;
+		CHECK(result.samples == 8);
+		CHECK(result.confidence > 0.0);
+		CHECK(std::abs(result.cost - expected) < 0.15);
+	}
+
+	// Everything is back on
+	for (const auto& effect : scene.Effects())
+	{
+		CHECK(scene.runtime.IsEffectEnabled(effect));
+	}
+}
+
+TEST_CASE("Profiler cancels linear drift", "[Profiler]")
+{
+	Scene scene({ { "A.fx", 2.0f }, { "B.fx", 0.0f } });
+	// The scene gets 1 ms heavier every 100 frames
+	scene.drift = 0.01f;
+
+	CostProfiler profiler;
+	profiler.SetSettings(CostProfiler::Settings{ 20, 0, 4 });
+	profiler.Start(scene.runtime, scene.Effects());
+	RunToEnd(profiler, scene);
+
+	const auto results = profiler.GetResults();
+	REQUIRE(results.size() == 2);
+	CHECK(std::abs(results[0].cost - 2.0) < 1e-3);
+	CHECK(std::abs(results[1].cost) < 1e-3);
+	CHECK(results[0].confidence < 1e-3);
+}
+
+TEST_CASE("Profiler skips disabled effects and restores on stop", "[Profiler]")
+{
+	Scene scene({ { "On.fx", 1.0f }, { "Off.fx", 1.0f } });
+	scene.runtime.EnumerateTechniques("Off.fx", [&scene](EffectTechnique technique) { scene.runtime.SetTechniqueState(technique, false); });
+
+	CostProfiler profiler;
+	profiler.SetSettings(CostProfiler::Settings{ 10, 0, 3 });
+	profiler.Start(scene.runtime, scene.Effects());
+
+	// Baseline window, then On.fx goes off
+	for (int i = 0; i < 15; i++)
+	{
+		profiler.AddFrame(scene.runtime, scene.NextFrame());
+	}
+	CHECK_FALSE(scene.runtime.IsEffectEnabled("On.fx"));
+
+	profiler.Stop(scene.runtime);
+	CHECK_FALSE(profiler.IsRunning());
+	CHECK(scene.runtime.IsEffectEnabled("On.fx"));
+	CHECK_FALSE(scene.runtime.IsEffectEnabled("Off.fx"));
+
+	const auto results = profiler.GetResults();
+	REQUIRE(results.size() == 1);
+	CHECK(results[0].effect == "On.fx");
+	CHECK(results[0].samples == 0);
+}
+
+TEST_CASE("Profiler aborts without touching the runtime", "[Profiler]")
+{
+	Scene scene({ { "On.fx", 1.0f } });
+
+	CostProfiler profiler;
+	profiler.SetSettings(CostProfiler::Settings{ 10, 0, 3 });
+	profiler.Start(scene.runtime, scene.Effects());
+	for (int i = 0; i < 15; i++)
+	{
+		profiler.AddFrame(scene.runtime, scene.NextFrame());
+	}
+	REQUIRE_FALSE(scene.runtime.IsEffectEnabled("On.fx"));
+
+	// As if the effects were reloaded, the old handles mean nothing anymore
+	scene.runtime.ResetCounters();
+	profiler.Abort();
+	CHECK_FALSE(profiler.IsRunning());
+	CHECK(scene.runtime.techniqueStateCalls == 0);
+
+	profiler.AddFrame(scene.runtime, scene.NextFrame());
+	CHECK(scene.runtime.techniqueStateCalls == 0);
+	CHECK(profiler.GetResults().size() == 1);
+}
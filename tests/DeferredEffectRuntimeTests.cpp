@@ -0,0 +1,98 @@
+#include "Catch.h"
+#include "Stubs.h"
+
+#include "Core/Config.h"
+#include "Core/DeferredEffectRuntime.h"
+#include "Core/EffectApplier.h"
+
+TEST_CASE("Expensive enables wait for a loading screen", "[Deferral]")
+{
+	Config::Clear();
+	EnableDeferral = true;
+	deferredEffectList.push_back("SSR.fx");
+
+	StubEffectRuntime runtime;
+	runtime.AddEffect("SSR.fx", 2);
+	runtime.AddEffect("Bloom.fx");
+	DeferredEffectRuntime deferred(runtime);
+
+	// Disables are immediate
+	EffectApplier::ApplyTechniqueState(deferred, false, MakeTechnique("SSR.fx"));
+	EffectApplier::ApplyTechniqueState(deferred, false, MakeTechnique("Bloom.fx"));
+	CHECK_FALSE(runtime.IsEffectEnabled("SSR.fx"));
+
+	// Only flagged effects are held back
+	EffectApplier::ApplyTechniqueState(deferred, true, MakeTechnique("SSR.fx"));
+	EffectApplier::ApplyTechniqueState(deferred, true, MakeTechnique("Bloom.fx"));
+	CHECK_FALSE(runtime.IsEffectEnabled("SSR.fx"));
+	CHECK(runtime.IsEffectEnabled("Bloom.fx"));
+	CHECK(deferred.GetPendingCount() == 1);
+
+	CHECK(DeferredEffectRuntime::IsLoadingMenu("Loading Menu"));
+	CHECK_FALSE(DeferredEffectRuntime::IsLoadingMenu("MapMenu"));
+	deferred.Flush();
+	CHECK(runtime.IsEffectEnabled("SSR.fx"));
+	CHECK(deferred.GetPendingCount() == 0);
+}
+
+TEST_CASE("A disable cancels a queued enable", "[Deferral]")
+{
+	Config::Clear();
+	EnableDeferral = true;
+	deferredEffectList.push_back("SSR.fx");
+
+	StubEffectRuntime runtime;
+	runtime.AddEffect("SSR.fx");
+	DeferredEffectRuntime deferred(runtime);
+
+	EffectApplier::ApplyTechniqueState(deferred, false, MakeTechnique("SSR.fx"));
+	EffectApplier::ApplyTechniqueState(deferred, true, MakeTechnique("SSR.fx"));
+	EffectApplier::ApplyTechniqueState(deferred, false, MakeTechnique("SSR.fx"));
+	CHECK(deferred.GetPendingCount() == 0);
+
+	deferred.Flush();
+	CHECK_FALSE(runtime.IsEffectEnabled("SSR.fx"));
+
+	// Repeated enables queue once
+	EffectApplier::ApplyTechniqueState(deferred, true, MakeTechnique("SSR.fx"));
+	EffectApplier::ApplyTechniqueState(deferred, true, MakeTechnique("SSR.fx"));
+	CHECK(deferred.GetPendingCount() == 1);
+	deferred.Flush();
+
+	// Already running effects need no compile, nothing to wait for
+	EffectApplier::ApplyTechniqueState(deferred, true, MakeTechnique("SSR.fx"));
+	CHECK(deferred.GetPendingCount() == 0);
+}
+
+TEST_CASE("Deferred enables time out", "[Deferral]")
+{
+	Config::Clear();
+	EnableDeferral = true;
+	DeferralTimeout = 60;
+	deferredEffectList.push_back("SSR.fx");
+
+	StubEffectRuntime runtime;
+	runtime.AddEffect("SSR.fx");
+	DeferredEffectRuntime deferred(runtime);
+
+	EffectApplier::ApplyTechniqueState(deferred, false, MakeTechnique("SSR.fx"));
+	EffectApplier::ApplyTechniqueState(deferred, true, MakeTechnique("SSR.fx"));
+
+	const auto now = DeferredEffectRuntime::Clock::now();
+	deferred.Update(now + std::chrono::seconds(30));
+	CHECK_FALSE(runtime.IsEffectEnabled("SSR.fx"));
+
+	deferred.Update(now + std::chrono::seconds(61));
+	CHECK(runtime.IsEffectEnabled("SSR.fx"));
+
+	// Turning deferral off releases everything on the next update
+	EffectApplier::ApplyTechniqueState(deferred, false, MakeTechnique("SSR.fx"));
+	DeferralTimeout = 0;
+	EffectApplier::ApplyTechniqueState(deferred, true, MakeTechnique("SSR.fx"));
+	deferred.Update(now + std::chrono::hours(24));
+	CHECK(deferred.GetPendingCount() == 1);
+
+	EnableDeferral = false;
+	deferred.Update(now);
+	CHECK(runtime.IsEffectEnabled("SSR.fx"));
+}
@@ -0,0 +1,165 @@
+#include "Catch.h"
+#include "Stubs.h"
+
+#include "Core/Config.h"
+#include "Core/DefinitionBatchRuntime.h"
+#include "Core/RuleEngine.h"
+
+namespace
+{
+	DefinitionInfo MakeDefinition(const std::string& category, const std::string& value, const std::string& defaultValue)
+	{
+		DefinitionInfo info;
+		info.filename = "SSAO.fx";
+		info.name = "SSAO_SAMPLES";
+		info.value = value;
+		info.defaultValue = defaultValue;
+		info.category = category;
+		return info;
+	}
+}
+
+TEST_CASE("Definition changes are applied as one batch", "[Definitions]")
+{
+	Config::Clear();
+	EnableDefinitions = true;
+
+	StubEffectRuntime runtime;
+	runtime.definitions["SSAO.fx"]["SSAO_SAMPLES"] = "32";
+	DefinitionBatchRuntime batch(runtime);
+
+	batch.SetPreprocessorDefinition("SSAO.fx", "SSAO_SAMPLES", "16");
+	batch.SetPreprocessorDefinition("SSAO.fx", "SSAO_SAMPLES", "8");
+	batch.SetPreprocessorDefinition("SSAO.fx", "SSAO_RADIUS", "2");
+	batch.SetPreprocessorDefinition("Bloom.fx", "BLOOM_QUALITY", "0");
+
+	// Nothing reaches the runtime before the batch goes out, but reads see the queued value
+	CHECK(runtime.definitionCalls == 0);
+	CHECK(batch.GetPendingCount() == 3);
+	CHECK(batch.GetPreprocessorDefinition("SSAO.fx", "SSAO_SAMPLES") == "8");
+
+	CHECK(batch.Flush() == 2);
+	CHECK(runtime.definitionCalls == 3);
+	CHECK(runtime.definitions["SSAO.fx"]["SSAO_SAMPLES"] == "8");
+	CHECK(batch.GetPendingCount() == 0);
+	CHECK(batch.GetBatchCount() == 1);
+
+	// An empty flush isn't a batch
+	CHECK(batch.Flush() == 0);
+	CHECK(batch.GetBatchCount() == 1);
+}
+
+TEST_CASE("Unchanged definitions don't trigger a recompile", "[Definitions]")
+{
+	Config::Clear();
+	EnableDefinitions = true;
+
+	StubEffectRuntime runtime;
+	runtime.definitions["SSAO.fx"]["SSAO_SAMPLES"] = "32";
+	DefinitionBatchRuntime batch(runtime);
+
+	batch.SetPreprocessorDefinition("SSAO.fx", "SSAO_SAMPLES", "32");
+	CHECK(batch.GetPendingCount() == 0);
+
+	// Changed and changed back before the batch went out
+	batch.SetPreprocessorDefinition("SSAO.fx", "SSAO_SAMPLES", "8");
+	batch.SetPreprocessorDefinition("SSAO.fx", "SSAO_SAMPLES", "32");
+	CHECK(batch.GetPendingCount() == 0);
+	CHECK(batch.Flush() == 0);
+	CHECK(runtime.definitionCalls == 0);
+}
+
+TEST_CASE("Batches wait for the delay or a loading screen", "[Definitions]")
+{
+	Config::Clear();
+	EnableDefinitions = true;
+	DefinitionBatchDelay = 10;
+
+	StubEffectRuntime runtime;
+	DefinitionBatchRuntime batch(runtime);
+
+	const auto start = DefinitionBatchRuntime::Clock::now();
+	batch.SetPreprocessorDefinition("SSAO.fx", "SSAO_SAMPLES", "8");
+
+	batch.Update(start + std::chrono::seconds(5));
+	CHECK(batch.GetPendingCount() == 1);
+	batch.Update(start + std::chrono::seconds(11));
+	CHECK(batch.GetPendingCount() == 0);
+
+	// No delay, only a loading screen flushes
+	DefinitionBatchDelay = 0;
+	batch.SetPreprocessorDefinition("SSAO.fx", "SSAO_SAMPLES", "16");
+	batch.Update(start + std::chrono::hours(1));
+	CHECK(batch.GetPendingCount() == 1);
+
+	// Turning definitions off doesn't strand what's queued
+	EnableDefinitions = false;
+	batch.Update(start);
+	CHECK(batch.GetPendingCount() == 0);
+	CHECK(runtime.definitions["SSAO.fx"]["SSAO_SAMPLES"] == "16");
+}
+
+TEST_CASE("Definition rules follow their conditions", "[Definitions]")
+{
+	Config::Clear();
+	EnableDefinitions = true;
+	EnableInterior = true;
+	ToggleStateInterior = "Specific";
+	definitionInfoList.push_back(MakeDefinition("Interior", "8", "32"));
+
+	StubGameState gameState;
+	StubEffectRuntime runtime;
+	DefinitionBatchRuntime batch(runtime);
+	RuleEngine engine(gameState, &batch);
+
+	gameState.cellType = CellType::kInterior;
+	engine.ProcessInteriorBasedToggling();
+	batch.Flush();
+	CHECK(runtime.definitions["SSAO.fx"]["SSAO_SAMPLES"] == "8");
+
+	gameState.cellType = CellType::kExterior;
+	engine.ProcessInteriorBasedToggling();
+	batch.Flush();
+	CHECK(runtime.definitions["SSAO.fx"]["SSAO_SAMPLES"] == "32");
+
+	// Same state again, nothing to recompile
+	runtime.ResetCounters();
+	engine.ProcessInteriorBasedToggling();
+	CHECK(batch.GetPendingCount() == 0);
+	CHECK(batch.Flush() == 0);
+	CHECK(runtime.definitionCalls == 0);
+}
+
+TEST_CASE("Later definition rules win while they hold", "[Definitions]")
+{
+	Config::Clear();
+	EnableDefinitions = true;
+
+	DefinitionInfo night = MakeDefinition("Time", "16", "32");
+	night.startTime = 20.0;
+	night.stopTime = 23.0;
+	definitionInfoList.push_back(night);
+	DefinitionInfo map = MakeDefinition("Menu", "4", "32");
+	map.condition = "MapMenu";
+	definitionInfoList.push_back(map);
+
+	StubGameState gameState;
+	gameState.hour = 21.0f;
+	StubEffectRuntime runtime;
+	DefinitionBatchRuntime batch(runtime);
+	RuleEngine engine(gameState, &batch);
+
+	engine.ProcessTimeBasedToggling();
+	CHECK(batch.GetPreprocessorDefinition("SSAO.fx", "SSAO_SAMPLES") == "16");
+
+	engine.ProcessMenuEvent("MapMenu", true);
+	CHECK(batch.GetPreprocessorDefinition("SSAO.fx", "SSAO_SAMPLES") == "4");
+
+	// The inactive menu rule doesn't reset what the time rule wants
+	engine.ProcessMenuEvent("MapMenu", false);
+	CHECK(batch.GetPreprocessorDefinition("SSAO.fx", "SSAO_SAMPLES") == "16");
+
+	gameState.hour = 12.0f;
+	engine.ProcessTimeBasedToggling();
+	CHECK(batch.GetPreprocessorDefinition("SSAO.fx", "SSAO_SAMPLES") == "32");
+}
@@ -0,0 +1,90 @@
+#include "Catch.h"
+#include "Stubs.h"
+
+#include "Core/Config.h"
+#include "Core/EffectApplier.h"
+#include "Core/EffectGroups.h"
+#include "Core/RuleEngine.h"
+
+TEST_CASE("Groups resolve effects, techniques and annotations", "[Groups]")
+{
+	StubEffectRuntime runtime;
+	runtime.AddEffect("Bloom.fx");
+	runtime.AddEffect("DOF.fx", 2);
+	runtime.AddEffect("CinematicDOF.fx", 3);
+	runtime.AddEffect("SSAO.fx");
+	runtime.techniqueNames[runtime.GetTechniques("CinematicDOF.fx")[1].handle] = "CinematicDOF";
+	runtime.techniqueGroups[runtime.GetTechniques("SSAO.fx")[0].handle] = "Ambient, DOF";
+
+	GroupInfo dof;
+	dof.name = "DOF";
+	dof.members = EffectGroups::ParseMembers("DOF.fx, CinematicDOF.fx:CinematicDOF, Missing.fx");
+	REQUIRE(dof.members.size() == 3);
+
+	EffectGroups groups;
+	groups.Build(runtime, { "Bloom.fx", "DOF.fx", "CinematicDOF.fx", "SSAO.fx" }, { dof });
+	CHECK(groups.GetTechniqueCount() == 7);
+	CHECK(groups.GetGroupNames() == std::vector<std::string>{ "Ambient", "DOF" });
+
+	// IDs run effect by effect: Bloom 0, DOF 1-2, CinematicDOF 3-5, SSAO 6
+	CHECK(groups.GetTechniques("@DOF") == EffectGroups::Bits{ 0b1010110 });
+	CHECK(groups.GetTechniques("Ambient") == EffectGroups::Bits{ 0b1000000 });
+	CHECK(groups.GetTechniques("Unknown").empty());
+
+	CHECK(groups.Apply(runtime, "@DOF", false) == 4);
+	CHECK(runtime.IsEffectEnabled("Bloom.fx"));
+	CHECK_FALSE(runtime.IsEffectEnabled("DOF.fx"));
+	CHECK_FALSE(runtime.GetTechniqueState(runtime.GetTechniques("CinematicDOF.fx")[1]));
+	CHECK(runtime.GetTechniqueState(runtime.GetTechniques("CinematicDOF.fx")[0]));
+	CHECK_FALSE(runtime.IsEffectEnabled("SSAO.fx"));
+
+	// Effects without members aren't enumerated at all
+	runtime.ResetCounters();
+	CHECK(groups.Apply(runtime, "Ambient", true) == 1);
+	CHECK(runtime.enumerateCalls == 1);
+}
+
+TEST_CASE("Rules can target a group", "[Groups]")
+{
+	Config::Clear();
+	ToggleStateTime = "Specific";
+
+	GroupInfo dof;
+	dof.name = "DOF";
+	dof.members = { "DOF.fx", "CinematicDOF.fx" };
+	groupInfoList.push_back(dof);
+
+	TechniqueInfo night;
+	night.filename = "@DOF";
+	night.state = "off";
+	night.startTime = 20.0;
+	night.stopTime = 23.0;
+	techniqueTimeInfoList.push_back(night);
+
+	StubGameState gameState;
+	gameState.hour = 21.0f;
+	StubEffectRuntime runtime;
+	runtime.AddEffect("DOF.fx");
+	runtime.AddEffect("CinematicDOF.fx", 2);
+	runtime.AddEffect("Bloom.fx");
+
+	EffectGroups groups;
+	groups.Build(runtime, { "Bloom.fx", "CinematicDOF.fx", "DOF.fx" }, groupInfoList);
+	RuleEngine engine(gameState, &runtime);
+	engine.SetGroups(&groups);
+
+	engine.ProcessTimeBasedToggling();
+	CHECK_FALSE(runtime.IsEffectEnabled("DOF.fx"));
+	CHECK_FALSE(runtime.IsEffectEnabled("CinematicDOF.fx"));
+	CHECK(runtime.IsEffectEnabled("Bloom.fx"));
+
+	gameState.hour = 12.0f;
+	engine.ProcessTimeBasedToggling();
+	CHECK(runtime.IsEffectEnabled("DOF.fx"));
+	CHECK(runtime.IsEffectEnabled("CinematicDOF.fx"));
+
+	// Without groups a group rule does nothing
+	runtime.ResetCounters();
+	EffectApplier::ApplyTechniqueState(runtime, false, night);
+	CHECK(runtime.techniqueStateCalls == 0);
+}
@@ -0,0 +1,149 @@
+#include "Catch.h"
+#include "Stubs.h"
+
+#include "Core/Config.h"
+#include "Core/EffectApplier.h"
+#include "Core/FadeEffectRuntime.h"
+#include "Core/FrameStats.h"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+	void AddFade(const std::string& filename, const std::string& uniform)
+	{
+		FadeInfo info;
+		info.filename = filename;
+		info.uniform = uniform;
+		info.duration = 1000.0;
+		fadeInfoList.push_back(info);
+	}
+}
+
+TEST_CASE("Disables ramp the uniform down before switching off", "[Fades]")
+{
+	Config::Clear();
+	EnableFades = true;
+	AddFade("Bloom.fx", "fFade");
+
+	StubEffectRuntime runtime;
+	runtime.AddEffect("Bloom.fx");
+	runtime.AddEffect("SSAO.fx");
+	const EffectUniform fade = runtime.AddUniform("Bloom.fx", "fFade");
+	FadeEffectRuntime fades(runtime);
+
+	const auto start = FadeEffectRuntime::Clock::now();
+	EffectApplier::ApplyTechniqueState(fades, false, MakeTechnique("Bloom.fx"));
+	EffectApplier::ApplyTechniqueState(fades, false, MakeTechnique("SSAO.fx"));
+
+	// Effects without a fade switch at once
+	CHECK_FALSE(runtime.IsEffectEnabled("SSAO.fx"));
+	CHECK(runtime.IsEffectEnabled("Bloom.fx"));
+	CHECK(fades.GetActiveCount() == 1);
+
+	fades.Update(start + 500ms);
+	REQUIRE(runtime.uniformValues[fade.handle].size() == 1);
+	CHECK(runtime.uniformValues[fade.handle][0] == Approx(0.5f).margin(0.05f));
+	CHECK(runtime.IsEffectEnabled("Bloom.fx"));
+
+	fades.Update(start + 2s);
+	CHECK(runtime.uniformValues[fade.handle][0] == 0.0f);
+	CHECK_FALSE(runtime.IsEffectEnabled("Bloom.fx"));
+	CHECK(fades.GetActiveCount() == 0);
+}
+
+TEST_CASE("The switch at the end of a fade is recorded under its effect", "[Fades][FrameStats]")
+{
+	Config::Clear();
+	EnableFades = true;
+	AddFade("Bloom.fx", "fFade");
+
+	StubEffectRuntime runtime;
+	runtime.AddEffect("Bloom.fx");
+	runtime.AddUniform("Bloom.fx", "fFade");
+	FrameStats stats;
+	FrameStatsEffectRuntime statsRuntime(runtime, stats);
+	FadeEffectRuntime fades(statsRuntime);
+
+	const auto start = FadeEffectRuntime::Clock::now();
+	EffectApplier::ApplyTechniqueState(fades, false, MakeTechnique("Bloom.fx"));
+	fades.Update(start + 2s);
+	stats.RecordFrameTime(16.0f);
+
+	const FrameStats::Window window = stats.GetWindow(1);
+	REQUIRE(window.changes.size() == 1);
+	CHECK(window.changes[0].effect == "Bloom.fx");
+	CHECK_FALSE(window.changes[0].enabled);
+}
+
+TEST_CASE("Enables start at zero and a toggle mid fade reverses", "[Fades]")
+{
+	Config::Clear();
+	EnableFades = true;
+	AddFade("Bloom.fx", "fFade");
+
+	StubEffectRuntime runtime;
+	runtime.AddEffect("Bloom.fx");
+	const EffectUniform fade = runtime.AddUniform("Bloom.fx", "fFade");
+	FadeEffectRuntime fades(runtime);
+
+	EffectApplier::ApplyTechniqueState(fades, false, MakeTechnique("Bloom.fx"));
+	fades.Update(FadeEffectRuntime::Clock::now() + 2s);
+	CHECK_FALSE(runtime.IsEffectEnabled("Bloom.fx"));
+
+	const auto start = FadeEffectRuntime::Clock::now();
+	EffectApplier::ApplyTechniqueState(fades, true, MakeTechnique("Bloom.fx"));
+	CHECK(runtime.IsEffectEnabled("Bloom.fx"));
+	CHECK(runtime.uniformValues[fade.handle] == std::vector<float>{ 0.0f });
+
+	// Asking for the same state again doesn't restart the ramp
+	runtime.ResetCounters();
+	EffectApplier::ApplyTechniqueState(fades, true, MakeTechnique("Bloom.fx"));
+	CHECK(runtime.uniformCalls == 0);
+	CHECK(fades.GetActiveCount() == 1);
+
+	// Turning around only has to undo what was faded in so far
+	fades.Update(start + 250ms);
+	const float level = runtime.uniformValues[fade.handle][0];
+	CHECK(level > 0.0f);
+	EffectApplier::ApplyTechniqueState(fades, false, MakeTechnique("Bloom.fx"));
+	fades.Update(FadeEffectRuntime::Clock::now() + 400ms);
+	CHECK_FALSE(runtime.IsEffectEnabled("Bloom.fx"));
+	CHECK(runtime.uniformValues[fade.handle][0] == 0.0f);
+}
+
+TEST_CASE("Fades fall back to hard toggles", "[Fades]")
+{
+	Config::Clear();
+	EnableFades = true;
+	AddFade("Bloom.fx", "fMissing");
+
+	StubEffectRuntime runtime;
+	runtime.AddEffect("Bloom.fx");
+	FadeEffectRuntime fades(runtime);
+
+	// The effect has no such uniform
+	EffectApplier::ApplyTechniqueState(fades, false, MakeTechnique("Bloom.fx"));
+	CHECK_FALSE(runtime.IsEffectEnabled("Bloom.fx"));
+	CHECK(fades.GetActiveCount() == 0);
+
+	// Handles are looked up once per reload
+	runtime.ResetCounters();
+	EffectApplier::ApplyTechniqueState(fades, true, MakeTechnique("Bloom.fx"));
+	CHECK(runtime.findUniformCalls == 0);
+	fades.Reset();
+	EffectApplier::ApplyTechniqueState(fades, false, MakeTechnique("Bloom.fx"));
+	CHECK(runtime.findUniformCalls == 1);
+
+	// Fades switched off mid ramp
+	fadeInfoList.clear();
+	AddFade("Bloom.fx", "fFade");
+	runtime.AddUniform("Bloom.fx", "fFade");
+	fades.Reset();
+	EffectApplier::ApplyTechniqueState(fades, true, MakeTechnique("Bloom.fx"));
+	CHECK(fades.GetActiveCount() == 1);
+	EnableFades = false;
+	EffectApplier::ApplyTechniqueState(fades, false, MakeTechnique("Bloom.fx"));
+	CHECK_FALSE(runtime.IsEffectEnabled("Bloom.fx"));
+	CHECK(fades.GetActiveCount() == 0);
+}
@@ -0,0 +1,39 @@
+#include "Catch.h"
+
+#include "Core/FrameStats.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+TEST_CASE("Frame stats export one CSV row per window", "[FrameStats]")
+{
+	FrameStats stats;
+	for (int i = 0; i < 10; i++)
+	{
+		if (i == 7)
+		{
+			stats.RecordChange("Bloom.fx", false);
+			stats.RecordChange("", true);
+		}
+		stats.RecordFrameTime(static_cast<float>(10 + i));
+	}
+
+	const auto path = (std::filesystem::temp_directory_path() / "ReShadeEffectTogglerFrameStats.csv").string();
+	REQUIRE(stats.SaveCSV(path, 5));
+
+	std::ifstream file(path);
+	std::stringstream contents;
+	contents << file.rdbuf();
+	file.close();
+	std::filesystem::remove(path);
+
+	// rapidcsv writes CRLF on Windows
+	std::string csv = contents.str();
+	std::erase(csv, '\r');
+
+	CHECK(csv ==
+		"FirstFrame,Frames,P50,P95,P99,Changes\n"
+		"0,5,12,14,14,\n"
+		"5,5,17,19,19,Bloom.fx=off;All=on\n");
+}
@@ -0,0 +1,119 @@
+#include "Catch.h"
+#include "Stubs.h"
+
+#include "Core/FrameStats.h"
+
+TEST_CASE("Percentiles use the nearest rank", "[FrameStats]")
+{
+	std::vector<float> samples;
+	for (int i = 100; i >= 1; i--)
+	{
+		samples.push_back(static_cast<float>(i));
+	}
+
+	CHECK(FrameStats::Percentile(samples, 50.0f) == 50.0f);
+	CHECK(FrameStats::Percentile(samples, 95.0f) == 95.0f);
+	CHECK(FrameStats::Percentile(samples, 99.0f) == 99.0f);
+	CHECK(FrameStats::Percentile(samples, 100.0f) == 100.0f);
+
+	std::vector<float> empty;
+	CHECK(FrameStats::Percentile(empty, 50.0f) == 0.0f);
+}
+
+TEST_CASE("Frame ring keeps the newest frames once it wraps", "[FrameStats]")
+{
+	FrameTimeRing ring;
+	for (std::size_t i = 0; i < FrameTimeRing::kCapacity + 10; i++)
+	{
+		ring.Push(static_cast<float>(i));
+	}
+
+	std::vector<float> samples;
+	CHECK(ring.CopyLatest(3, samples) == FrameTimeRing::kCapacity + 7);
+	CHECK(samples == std::vector<float>{ FrameTimeRing::kCapacity + 7.0f, FrameTimeRing::kCapacity + 8.0f, FrameTimeRing::kCapacity + 9.0f });
+
+	CHECK(ring.CopyLatest(FrameTimeRing::kCapacity * 2, samples) == 10);
+	CHECK(samples.size() == FrameTimeRing::kCapacity);
+	CHECK(samples.front() == 10.0f);
+}
+
+TEST_CASE("Windows report stats and the changes made during them", "[FrameStats]")
+{
+	FrameStats stats;
+
+	// Present to present intervals, the first present only starts the clock
+	const auto start = std::chrono::steady_clock::now();
+	stats.OnPresent(start);
+	stats.OnPresent(start + std::chrono::milliseconds(16));
+	CHECK(stats.GetFrameCount() == 1);
+
+	for (int i = 1; i < 100; i++)
+	{
+		if (i == 50)
+		{
+			stats.RecordChange("Bloom.fx", false);
+		}
+		// One in ten frames hitches
+		stats.RecordFrameTime(i % 10 == 0 ? 33.0f : 16.0f);
+	}
+
+	const FrameStats::Window window = stats.GetWindow(100);
+	CHECK(window.frames == 100);
+	CHECK(window.p50 == 16.0f);
+	CHECK(window.p95 == 33.0f);
+	REQUIRE(window.changes.size() == 1);
+	CHECK(window.changes[0].frame == 50);
+	CHECK(window.changes[0].effect == "Bloom.fx");
+
+	const auto windows = stats.GetWindows(40);
+	REQUIRE(windows.size() == 3);
+	CHECK(windows[0].changes.empty());
+	CHECK(windows[1].changes.size() == 1);
+	CHECK(windows[2].frames == 20);
+}
+
+TEST_CASE("Stats runtime only reports states that changed", "[FrameStats]")
+{
+	FrameStats stats;
+	StubEffectRuntime runtime;
+	runtime.AddEffect("DOF.fx", 2);
+	FrameStatsEffectRuntime statsRuntime(runtime, stats);
+
+	const auto setEffect = [&statsRuntime](bool enabled)
+		{
+			statsRuntime.EnumerateTechniques("DOF.fx", [&statsRuntime, enabled](EffectTechnique technique)
+				{
+					statsRuntime.SetTechniqueState(technique, enabled);
+				});
+		};
+
+	// Techniques start enabled, the first call is only a change if it differs
+	setEffect(true);
+	setEffect(false);
+	setEffect(false);
+	statsRuntime.SetEffectsState(true);
+	statsRuntime.SetEffectsState(true);
+	setEffect(true);
+	stats.RecordFrameTime(16.0f);
+
+	CHECK_FALSE(runtime.techniqueStateCalls == 0);
+	CHECK(runtime.IsEffectEnabled("DOF.fx"));
+
+	const FrameStats::Window window = stats.GetWindow(1);
+	// Two techniques off, all effects on, two techniques back on
+	REQUIRE(window.changes.size() == 5);
+	CHECK(window.changes[0].effect == "DOF.fx");
+	CHECK(window.changes[2].effect.empty());
+	CHECK(window.changes[4].enabled);
+
+	// After a reload the same handle may be another technique, its state is read from the runtime again
+	statsRuntime.Reset();
+	runtime.EnumerateTechniques("DOF.fx", [&runtime](EffectTechnique technique) { runtime.SetTechniqueState(technique, false); });
+	setEffect(false);
+	stats.RecordFrameTime(16.0f);
+	CHECK(stats.GetWindow(1).changes.empty());
+
+	setEffect(true);
+	stats.RecordFrameTime(16.0f);
+	CHECK(stats.GetWindow(1).changes.size() == 2);
+}
@@ -0,0 +1,64 @@
+#include "Catch.h"
+#include "Stubs.h"
+
+#include "Core/GameUniformFeed.h"
+
+TEST_CASE("Game state reaches annotated uniforms", "[GameUniforms]")
+{
+	StubGameState gameState;
+	gameState.hour = 21.5f;
+	gameState.cellType = CellType::kInterior;
+	gameState.weatherTransition = 0.25f;
+
+	StubEffectRuntime runtime;
+	const EffectUniform hour = runtime.AddUniform("Bloom.fx", "Hour", "toggler_hour");
+	const EffectUniform hourCopy = runtime.AddUniform("SSAO.fx", "GameHour", "toggler_hour");
+	const EffectUniform interior = runtime.AddUniform("SSAO.fx", "Interior", "toggler_interior");
+	const EffectUniform weather = runtime.AddUniform("Bloom.fx", "Weather", "toggler_weather");
+	const EffectUniform transition = runtime.AddUniform("Bloom.fx", "Transition", "toggler_weather_transition");
+	const EffectUniform timer = runtime.AddUniform("Bloom.fx", "Timer", "timer");
+	runtime.AddUniform("Bloom.fx", "fBloomStrength");
+	GameUniformFeed feed;
+
+	CHECK(feed.Update(runtime, gameState) == 5);
+	CHECK(feed.GetUniformCount() == 5);
+	CHECK(runtime.uniformValues[hour.handle] == std::vector<float>{ 21.5f });
+	CHECK(runtime.uniformValues[hourCopy.handle] == std::vector<float>{ 21.5f });
+	CHECK(runtime.uniformValues[interior.handle] == std::vector<float>{ 1.0f });
+	CHECK(runtime.uniformValues[weather.handle] == std::vector<float>{ static_cast<float>(WeatherFlag::kPleasant) });
+	CHECK(runtime.uniformValues[transition.handle] == std::vector<float>{ 0.25f });
+	// ReShade's own sources are left alone
+	CHECK(runtime.uniformValues.count(timer.handle) == 0);
+
+	// Only what changed is written, and the uniforms aren't searched again
+	runtime.ResetCounters();
+	gameState.hour = 21.6f;
+	CHECK(feed.Update(runtime, gameState) == 2);
+	CHECK(runtime.uniformCalls == 2);
+	CHECK(runtime.enumerateUniformCalls == 0);
+	CHECK(feed.Update(runtime, gameState) == 0);
+}
+
+TEST_CASE("Game uniforms are found again after a reload", "[GameUniforms]")
+{
+	StubGameState gameState;
+	StubEffectRuntime runtime;
+	GameUniformFeed feed;
+
+	// No annotated uniforms yet, nothing written
+	CHECK(feed.Update(runtime, gameState) == 0);
+
+	const EffectUniform menu = runtime.AddUniform("Blur.fx", "MenuOpen", "toggler_menu_open");
+	CHECK(feed.Update(runtime, gameState) == 0);
+
+	feed.Reset();
+	CHECK(feed.Update(runtime, gameState) == 1);
+	CHECK(runtime.uniformValues[menu.handle] == std::vector<float>{ 0.0f });
+
+	gameState.menuOpen = true;
+	CHECK(feed.Update(runtime, gameState) == 1);
+	CHECK(runtime.uniformValues[menu.handle] == std::vector<float>{ 1.0f });
+
+	CHECK(GameUniformFeed::ParseSource("toggler_weather") == GameUniformSource::kWeatherFlags);
+	CHECK_FALSE(GameUniformFeed::ParseSource("timer"));
+}
@@ -0,0 +1,148 @@
+#include "Catch.h"
+#include "Stubs.h"
+
+#include "Core/Config.h"
+#include "Core/EffectGroups.h"
+#include "Core/Hotkeys.h"
+#include "Core/PresetSwitcher.h"
+
+namespace
+{
+	HotkeyInfo MakeHotkey(const std::string& key, const std::string& action, const std::string& target = {})
+	{
+		HotkeyInfo info;
+		info.key = key;
+		info.action = action;
+		info.target = target;
+		return info;
+	}
+}
+
+TEST_CASE("Hotkey names parse to virtual key codes", "[Hotkeys]")
+{
+	const auto key = Hotkeys::ParseKey("Ctrl+Shift+F10");
+	REQUIRE(key);
+	CHECK(key->keycode == 0x79);
+	CHECK(key->modifiers == (Hotkeys::kCtrl | Hotkeys::kShift));
+	CHECK(Hotkeys::FormatKey(*key) == "Ctrl+Shift+F10");
+
+	CHECK(Hotkeys::ParseKey("alt + home") == Hotkeys::Key{ 0x24, Hotkeys::kAlt });
+	CHECK(Hotkeys::ParseKey("numpad5") == Hotkeys::Key{ 0x65, 0 });
+	CHECK(Hotkeys::ParseKey("k") == Hotkeys::Key{ 'K', 0 });
+	CHECK(Hotkeys::FormatKey(Hotkeys::Key{ 0x65, 0 }) == "Numpad5");
+
+	CHECK_FALSE(Hotkeys::ParseKey(""));
+	CHECK_FALSE(Hotkeys::ParseKey("F25"));
+	CHECK_FALSE(Hotkeys::ParseKey("Win+F1"));
+	CHECK_FALSE(Hotkeys::ParseKey("Ctrl+"));
+}
+
+TEST_CASE("Hotkeys toggle effects and groups once per press", "[Hotkeys]")
+{
+	StubEffectRuntime runtime;
+	runtime.AddEffect("Bloom.fx");
+	runtime.AddEffect("DOF.fx", 2);
+
+	GroupInfo dof;
+	dof.name = "DOF";
+	dof.members = { "DOF.fx" };
+	EffectGroups groups;
+	groups.Build(runtime, { "Bloom.fx", "DOF.fx" }, { dof });
+	PresetSwitcher presets;
+
+	Hotkeys hotkeys;
+	hotkeys.Compile({ MakeHotkey("F10", "Toggle", "Bloom.fx"), MakeHotkey("Ctrl+F10", "Toggle", "@DOF"), MakeHotkey("F11", "Jump"), MakeHotkey("F12", "Toggle") });
+	CHECK(hotkeys.GetBindingCount() == 2);
+	CHECK(hotkeys.GetInvalid() == std::vector<std::size_t>{ 2, 3 });
+
+	// Nothing pressed is one poll per binding
+	CHECK_FALSE(hotkeys.Poll(runtime, &groups, presets));
+	CHECK(runtime.keyPolls == 2);
+	CHECK(runtime.techniqueStateCalls == 0);
+
+	runtime.keysPressed = { 0x79 };
+	hotkeys.Poll(runtime, &groups, presets);
+	CHECK_FALSE(runtime.IsEffectEnabled("Bloom.fx"));
+	CHECK(runtime.IsEffectEnabled("DOF.fx"));
+
+	// Same key with Ctrl held is the other binding
+	runtime.keysDown = { 0x11, 0x79 };
+	hotkeys.Poll(runtime, &groups, presets);
+	CHECK_FALSE(runtime.IsEffectEnabled("Bloom.fx"));
+	CHECK_FALSE(runtime.IsEffectEnabled("DOF.fx"));
+
+	runtime.keysDown.clear();
+	hotkeys.Poll(runtime, &groups, presets);
+	CHECK(runtime.IsEffectEnabled("Bloom.fx"));
+
+	// Held down isn't pressed again
+	runtime.ResetCounters();
+	runtime.keysPressed.clear();
+	runtime.keysDown = { 0x79 };
+	hotkeys.Poll(runtime, &groups, presets);
+	CHECK(runtime.techniqueStateCalls == 0);
+}
+
+TEST_CASE("Hotkey toggles invert the current state of their target", "[Hotkeys]")
+{
+	StubEffectRuntime runtime;
+	runtime.AddEffect("Bloom.fx");
+	runtime.AddEffect("DOF.fx", 2);
+
+	GroupInfo dof;
+	dof.name = "DOF";
+	dof.members = { "DOF.fx" };
+	EffectGroups groups;
+	groups.Build(runtime, { "Bloom.fx", "DOF.fx" }, { dof });
+	PresetSwitcher presets;
+
+	Hotkeys hotkeys;
+	hotkeys.Compile({ MakeHotkey("F10", "Toggle", "Bloom.fx"), MakeHotkey("F11", "Toggle", "@DOF") });
+
+	// Turned off by something else, eg. a rule, the first press turns it on
+	runtime.SetTechniqueState(runtime.GetTechniques("Bloom.fx")[0], false);
+	runtime.keysPressed = { 0x79 };
+	hotkeys.Poll(runtime, &groups, presets);
+	CHECK(runtime.IsEffectEnabled("Bloom.fx"));
+
+	// One technique still on counts as on
+	runtime.SetTechniqueState(runtime.GetTechniques("DOF.fx")[0], false);
+	CHECK(groups.IsEnabled(runtime, "@DOF"));
+	runtime.keysPressed = { 0x7A };
+	hotkeys.Poll(runtime, &groups, presets);
+	CHECK_FALSE(groups.IsEnabled(runtime, "DOF"));
+	hotkeys.Poll(runtime, &groups, presets);
+	CHECK(runtime.IsEffectEnabled("DOF.fx"));
+	CHECK_FALSE(groups.IsEnabled(runtime, "@Unknown"));
+}
+
+TEST_CASE("Hotkeys cycle presets and report suspends", "[Hotkeys]")
+{
+	Config::Clear();
+	StubEffectRuntime runtime;
+	PresetSwitcher presets;
+	const auto now = PresetSwitcher::Clock::now();
+
+	Hotkeys hotkeys;
+	hotkeys.Compile({ MakeHotkey("Numpad1", "CyclePreset", "Day.ini, Night.ini,"), MakeHotkey("Pause", "Suspend") });
+	REQUIRE(hotkeys.GetBindingCount() == 2);
+
+	// Switched on the next present without waiting for a loading screen
+	runtime.keysPressed = { 0x61 };
+	hotkeys.Poll(runtime, nullptr, presets);
+	presets.Update(runtime, now);
+	CHECK(runtime.currentPreset == "Day.ini");
+
+	hotkeys.Poll(runtime, nullptr, presets);
+	presets.Update(runtime, now);
+	CHECK(runtime.currentPreset == "Night.ini");
+
+	hotkeys.Poll(runtime, nullptr, presets);
+	presets.Update(runtime, now);
+	CHECK(runtime.currentPreset == "Day.ini");
+
+	runtime.keysPressed = { 0x13 };
+	CHECK(hotkeys.Poll(runtime, nullptr, presets));
+	runtime.keysDown = { 0x12 };
+	CHECK_FALSE(hotkeys.Poll(runtime, nullptr, presets));
+}
@@ -0,0 +1,131 @@
+#include "Catch.h"
+#include "Stubs.h"
+
+#include "Core/Config.h"
+#include "Core/LocationRules.h"
+#include "Core/RuleEngine.h"
+
+namespace
+{
+	constexpr std::uint32_t kTamriel = 0x3C;
+	constexpr std::uint32_t kSolstheim = 0x02000800;
+	constexpr std::uint32_t kWhiterunLocation = 0x18A56;
+	constexpr std::uint32_t kDragonsreachLocation = 0x18A57;
+	constexpr std::uint32_t kLocTypeCity = 0x13168;
+	constexpr std::uint32_t kLocTypeDungeon = 0x130DB;
+
+	LocationInfo MakeRule(const std::string& filename, const std::string& type, const std::string& name)
+	{
+		LocationInfo info;
+		info.filename = filename;
+		info.type = type;
+		info.name = name;
+		return info;
+	}
+}
+
+TEST_CASE("Location rules are matched by FormID", "[Location]")
+{
+	const std::vector<LocationInfo> rules = {
+		MakeRule("Snow.fx", "Worldspace", "DLC2SolstheimWorld"),
+		MakeRule("RTGI.fx", "Keyword", "LocTypeCity"),
+		MakeRule("Bloom.fx", "Location", "Skyrim.esm|0x18A56"), // Whiterun, also holds in Dragonsreach
+		MakeRule("SSAO.fx", "Keyword", "0x130DB"),
+		MakeRule("DOF.fx", "Location", "NotLoaded"),
+		MakeRule("DOF.fx", "Region", "LocTypeCity"),
+	};
+
+	std::size_t lookups = 0;
+	const LocationRules::Resolver resolve = [&](std::string_view name) -> std::uint32_t {
+		lookups++;
+		if (name == "DLC2SolstheimWorld")
+		{
+			return kSolstheim;
+		}
+		if (name == "LocTypeCity")
+		{
+			return kLocTypeCity;
+		}
+		if (name == "Skyrim.esm|0x18A56")
+		{
+			return kWhiterunLocation;
+		}
+		return 0;
+	};
+
+	LocationRules locations;
+	locations.Compile(rules, resolve);
+	CHECK(lookups == 5); // The plain FormID isn't looked up
+	CHECK(locations.GetUnresolved() == std::vector<std::size_t>{ 4, 5 });
+
+	LocationSnapshot whiterun;
+	whiterun.worldspace = kTamriel;
+	whiterun.locations = { kWhiterunLocation };
+	whiterun.keywords = { kLocTypeCity };
+	CHECK(locations.Update(whiterun) == std::vector<std::size_t>{ 0, 1, 2, 3, 4, 5 });
+	CHECK_FALSE(locations.IsActive(0));
+	CHECK(locations.IsActive(1));
+	CHECK(locations.IsActive(2));
+	CHECK_FALSE(locations.IsActive(3));
+
+	// Another cell of the same location changes nothing
+	CHECK(locations.Update(whiterun).empty());
+
+	// Dragonsreach is an interior below Whiterun
+	LocationSnapshot dragonsreach;
+	dragonsreach.locations = { kDragonsreachLocation, kWhiterunLocation };
+	CHECK(locations.Update(dragonsreach) == std::vector<std::size_t>{ 1 });
+	CHECK(locations.IsActive(2));
+
+	LocationSnapshot solstheim;
+	solstheim.worldspace = kSolstheim;
+	solstheim.keywords = { kLocTypeDungeon };
+	CHECK(locations.Update(solstheim) == std::vector<std::size_t>{ 0, 2, 3 });
+	CHECK(locations.IsActive(0));
+	CHECK(locations.IsActive(3));
+
+	locations.Invalidate();
+	CHECK(locations.Update(solstheim).size() == rules.size());
+	CHECK(lookups == 5);
+}
+
+TEST_CASE("Location rules follow the player", "[Location][RuleEngine]")
+{
+	Config::Clear();
+	EnableLocation = true;
+
+	LocationInfo city = MakeRule("RTGI.fx", "Keyword", "LocTypeCity");
+	city.state = "off";
+	locationInfoList.push_back(city);
+
+	StubGameState gameState;
+	gameState.formIDs["LocTypeCity"] = kLocTypeCity;
+	StubEffectRuntime runtime;
+	runtime.AddEffect("RTGI.fx");
+	RuleEngine engine(gameState, &runtime);
+
+	engine.ProcessLocationBasedToggling();
+	CHECK(runtime.IsEffectEnabled("RTGI.fx"));
+
+	gameState.location.worldspace = kTamriel;
+	gameState.location.locations = { kWhiterunLocation };
+	gameState.location.keywords = { kLocTypeCity };
+	engine.ProcessLocationBasedToggling();
+	CHECK_FALSE(runtime.IsEffectEnabled("RTGI.fx"));
+
+	// Events for cells within the city apply nothing
+	runtime.ResetCounters();
+	engine.ProcessLocationBasedToggling();
+	CHECK(runtime.techniqueStateCalls == 0);
+
+	// A reload applies again without resolving the names again
+	gameState.formIDs.clear();
+	engine.InvalidateRules();
+	engine.ProcessLocationBasedToggling();
+	CHECK(runtime.techniqueStateCalls == 1);
+	CHECK_FALSE(runtime.IsEffectEnabled("RTGI.fx"));
+
+	gameState.location = LocationSnapshot{};
+	engine.ProcessLocationBasedToggling();
+	CHECK(runtime.IsEffectEnabled("RTGI.fx"));
+}
@@ -0,0 +1,3 @@
+// Only built against Catch2 v2, v3 provides its own main through Catch2WithMain
+#define CATCH_CONFIG_MAIN
+#include "Catch.h"
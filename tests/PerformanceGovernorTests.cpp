@@ -0,0 +1,282 @@
+#include "Catch.h"
+#include "Stubs.h"
+
+#include "Core/Config.h"
+#include "Core/PerformanceGovernor.h"
+#include "Core/RuleEngine.h"
+
+#include <numeric>
+
+namespace
+{
+	// Frame time model: base load plus whatever the still enabled levels cost
+	struct Scene
+	{
+		std::vector<float> costs;
+		std::size_t shed = 0;
+
+		float FrameTime(float base) const
+		{
+			return std::accumulate(costs.begin(), costs.end() - shed, base);
+		}
+	};
+
+	// Runs frameCount frames at the given base load, returns the number of shed/restore actions
+	int Run(PerformanceGovernor& governor, Scene& scene, float base, std::size_t frameCount)
+	{
+		int actions = 0;
+		for (std::size_t i = 0; i < frameCount; i++)
+		{
+			switch (governor.AddFrame(scene.FrameTime(base)))
+			{
+			case PerformanceGovernor::Action::kShed:
+				scene.shed++;
+				actions++;
+				break;
+			case PerformanceGovernor::Action::kRestore:
+				scene.shed--;
+				actions++;
+				break;
+			default:
+				break;
+			}
+		}
+		return actions;
+	}
+
+	PerformanceGovernor MakeGovernor(std::size_t levels)
+	{
+		PerformanceGovernor governor;
+		governor.SetSettings(PerformanceGovernor::Settings{ 16.6f, 0.1f, 10 });
+		governor.SetLevelCount(levels);
+		return governor;
+	}
+}
+
+TEST_CASE("Governor leaves a frame budget that fits alone", "[Governor]")
+{
+	PerformanceGovernor governor = MakeGovernor(3);
+	Scene scene{ { 1.0f, 1.0f, 1.0f } };
+
+	CHECK(Run(governor, scene, 10.0f, 500) == 0);
+	CHECK(governor.GetShedCount() == 0);
+}
+
+TEST_CASE("Governor sheds one level per window until the budget is met", "[Governor]")
+{
+	PerformanceGovernor governor = MakeGovernor(3);
+	// Lowest priority (last) costs the most
+	Scene scene{ { 1.0f, 2.0f, 4.0f } };
+
+	// 12 + 7 = 19 ms, shedding the 4 ms level gets to 15 ms
+	Run(governor, scene, 12.0f, 10);
+	CHECK(scene.shed == 1);
+	Run(governor, scene, 12.0f, 200);
+	CHECK(scene.shed == 1);
+
+	// Heavier scene, all levels go and the governor stops there
+	Run(governor, scene, 20.0f, 200);
+	CHECK(scene.shed == 3);
+	CHECK(governor.GetShedCount() == 3);
+}
+
+TEST_CASE("Governor restores with hysteresis and doesn't flap", "[Governor]")
+{
+	PerformanceGovernor governor = MakeGovernor(2);
+	Scene scene{ { 1.0f, 4.0f } };
+
+	Run(governor, scene, 12.0f, 100);
+	REQUIRE(scene.shed == 1);
+
+	// 14 ms without the 4 ms level: restoring would give 18 ms, so it stays off
+	CHECK(Run(governor, scene, 13.0f, 1000) == 0);
+
+	// 12 ms + 4 ms = 16 ms is under target but not under target minus headroom
+	CHECK(Run(governor, scene, 11.0f, 1000) == 0);
+
+	// Enough headroom now
+	Run(governor, scene, 9.0f, 10);
+	CHECK(scene.shed == 0);
+	CHECK(Run(governor, scene, 9.0f, 1000) == 0);
+}
+
+TEST_CASE("Governor ignores single hitches inside a window", "[Governor]")
+{
+	PerformanceGovernor governor = MakeGovernor(1);
+
+	// One 50 ms frame in every window of 30 is below the p95
+	governor.SetSettings(PerformanceGovernor::Settings{ 16.6f, 0.1f, 30 });
+	for (int i = 0; i < 300; i++)
+	{
+		CHECK(governor.AddFrame(i % 30 == 0 ? 50.0f : 12.0f) == PerformanceGovernor::Action::kNone);
+	}
+}
+
+TEST_CASE("Governor restores levels that were removed from the list", "[Governor]")
+{
+	PerformanceGovernor governor = MakeGovernor(2);
+	Scene scene{ { 2.0f, 2.0f } };
+
+	Run(governor, scene, 16.0f, 20);
+	REQUIRE(scene.shed == 2);
+
+	governor.SetLevelCount(1);
+	Run(governor, scene, 16.0f, 10);
+	CHECK(scene.shed == 1);
+}
+
+TEST_CASE("Performance rules disable effects by priority", "[RuleEngine][Governor]")
+{
+	Config::Clear();
+	PerformanceWindowFrames = 5;
+	PerformanceTargetFrameTime = 16.6;
+	techniquePerformanceInfoList.push_back(TechniqueInfo{ "SSAO.fx", "off", "", 0.0, 0.0, true, 5 });
+	techniquePerformanceInfoList.push_back(TechniqueInfo{ "Bloom.fx", "off", "", 0.0, 0.0, true, 1 });
+	techniquePerformanceInfoList.push_back(TechniqueInfo{ "DOF.fx", "off", "", 0.0, 0.0, true, 1 });
+
+	StubGameState gameState;
+	StubEffectRuntime runtime;
+	runtime.AddEffect("SSAO.fx");
+	runtime.AddEffect("Bloom.fx", 2);
+	runtime.AddEffect("DOF.fx");
+	RuleEngine engine(gameState, &runtime);
+
+	// Same model as above: base load plus 4 ms SSAO, 3 ms Bloom and 2 ms DOF while enabled
+	const auto feed = [&engine, &runtime](float base, int frames)
+		{
+			for (int i = 0; i < frames; i++)
+			{
+				const float frameTime = base +
+					(runtime.IsEffectEnabled("SSAO.fx") ? 4.0f : 0.0f) +
+					(runtime.IsEffectEnabled("Bloom.fx") ? 3.0f : 0.0f) +
+					(runtime.IsEffectEnabled("DOF.fx") ? 2.0f : 0.0f);
+				engine.ProcessPerformanceBasedToggling(frameTime);
+			}
+		};
+
+	// 21 ms, equal priorities go in preset order
+	feed(12.0f, 5);
+	CHECK_FALSE(runtime.IsEffectEnabled("Bloom.fx"));
+	CHECK(runtime.IsEffectEnabled("DOF.fx"));
+
+	// 18 ms, still over
+	feed(12.0f, 5);
+	CHECK_FALSE(runtime.IsEffectEnabled("DOF.fx"));
+	CHECK(runtime.IsEffectEnabled("SSAO.fx"));
+	REQUIRE(engine.GetShedEffects().size() == 2);
+	CHECK(engine.GetShedEffects()[0].filename == "Bloom.fx");
+	CHECK(engine.GetShedEffects()[1].filename == "DOF.fx");
+
+	// 16 ms fits, SSAO stays
+	feed(12.0f, 50);
+	CHECK(runtime.IsEffectEnabled("SSAO.fx"));
+
+	// Nothing happens while a menu is open
+	engine.ProcessMenuEvent("MapMenu", true);
+	feed(30.0f, 50);
+	CHECK(runtime.IsEffectEnabled("SSAO.fx"));
+	engine.ProcessMenuEvent("MapMenu", false);
+
+	// Restored in reverse order, Bloom only once it fits with headroom
+	feed(8.0f, 5);
+	CHECK(runtime.IsEffectEnabled("DOF.fx"));
+	feed(8.0f, 50);
+	CHECK_FALSE(runtime.IsEffectEnabled("Bloom.fx"));
+	feed(5.0f, 5);
+	CHECK(runtime.IsEffectEnabled("Bloom.fx"));
+	CHECK(engine.GetShedEffects().empty());
+}
+
+TEST_CASE("Performance rules only restore what they shed", "[RuleEngine][Governor]")
+{
+	Config::Clear();
+	PerformanceWindowFrames = 5;
+	PerformanceTargetFrameTime = 16.6;
+	techniquePerformanceInfoList.push_back(TechniqueInfo{ "@Heavy", "off", "", 0.0, 0.0, true, 1 });
+
+	StubGameState gameState;
+	StubEffectRuntime runtime;
+	runtime.AddEffect("Bloom.fx", 2);
+	runtime.AddEffect("DOF.fx");
+
+	GroupInfo heavy;
+	heavy.name = "Heavy";
+	heavy.members = { "Bloom.fx" };
+	EffectGroups groups;
+	groups.Build(runtime, { "Bloom.fx", "DOF.fx" }, { heavy });
+
+	RuleEngine engine(gameState, &runtime);
+	engine.SetGroups(&groups);
+
+	// Turned off by something else before the governor got to it
+	const EffectTechnique second = runtime.GetTechniques("Bloom.fx")[1];
+	runtime.SetTechniqueState(second, false);
+
+	const auto feed = [&engine](float frameTime, int frames)
+		{
+			for (int i = 0; i < frames; i++)
+			{
+				engine.ProcessPerformanceBasedToggling(frameTime);
+			}
+		};
+
+	// Groups resolve, members outside the group stay on
+	feed(20.0f, 5);
+	CHECK_FALSE(runtime.GetTechniqueState(runtime.GetTechniques("Bloom.fx")[0]));
+	CHECK(runtime.IsEffectEnabled("DOF.fx"));
+	REQUIRE(engine.GetShedEffects().size() == 1);
+	CHECK(engine.GetShedEffects()[0].techniques == std::vector<std::uint32_t>{ 0 });
+
+	feed(20.0f, 5);
+	feed(1.0f, 10);
+	CHECK(engine.GetShedEffects().empty());
+	CHECK(runtime.GetTechniqueState(runtime.GetTechniques("Bloom.fx")[0]));
+	CHECK_FALSE(runtime.GetTechniqueState(second));
+}
+
+TEST_CASE("Resetting the governor restores or forgets what it shed", "[RuleEngine][Governor]")
+{
+	Config::Clear();
+	PerformanceWindowFrames = 5;
+	PerformanceTargetFrameTime = 16.6;
+	techniquePerformanceInfoList.push_back(TechniqueInfo{ "Bloom.fx", "off", "", 0.0, 0.0, true, 1 });
+	techniquePerformanceInfoList.push_back(TechniqueInfo{ "DOF.fx", "off", "", 0.0, 0.0, true, 2 });
+
+	StubGameState gameState;
+	StubEffectRuntime runtime;
+	runtime.AddEffect("Bloom.fx", 2);
+	runtime.AddEffect("DOF.fx");
+	RuleEngine engine(gameState, &runtime);
+
+	const auto feed = [&engine](float frameTime, int frames)
+		{
+			for (int i = 0; i < frames; i++)
+			{
+				engine.ProcessPerformanceBasedToggling(frameTime);
+			}
+		};
+
+	feed(20.0f, 10);
+	REQUIRE(engine.GetShedEffects().size() == 2);
+
+	// Switched off or another preset loaded
+	engine.ResetGovernor();
+	CHECK(runtime.IsEffectEnabled("Bloom.fx"));
+	CHECK(runtime.IsEffectEnabled("DOF.fx"));
+	CHECK(engine.GetShedEffects().empty());
+	CHECK(engine.GetGovernor().GetShedCount() == 0);
+
+	// After a reload the techniques are already back, nothing is turned on
+	feed(20.0f, 5);
+	REQUIRE(engine.GetShedEffects().size() == 1);
+	runtime.ResetCounters();
+	engine.ResetGovernor(false);
+	CHECK(runtime.techniqueStateCalls == 0);
+	CHECK_FALSE(runtime.IsEffectEnabled("Bloom.fx"));
+	CHECK(engine.GetShedEffects().empty());
+
+	// Starts over from the first level
+	feed(20.0f, 5);
+	REQUIRE(engine.GetShedEffects().size() == 1);
+	CHECK(engine.GetShedEffects()[0].filename == "Bloom.fx");
+}
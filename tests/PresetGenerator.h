@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Stubs.h"
+
+#include "Core/Config.h"
+
+#include <array>
+#include <spdlog/fmt/fmt.h>
+#include <string>
+
+// Builds synthetic presets of any size for tests and benchmarks.
+// Rule i targets Effect<i>.fx and cycles through the menu / weather names below.
+namespace PresetGenerator
+{
+	inline constexpr std::array s_MenuNames = {
+		"MapMenu", "InventoryMenu", "Journal Menu", "MagicMenu", "Dialogue Menu",
+		"Loading Menu", "Fader Menu", "Console", "Sleep/Wait Menu", "TweenMenu"
+	};
+
+	inline constexpr std::array s_WeatherNames = {
+		"kNone", "kPleasant", "kCloudy", "kRainy", "kSnow", "kPermAurora", "kAuroraFollowsSun"
+	};
+
+	inline std::string EffectName(std::size_t rule)
+	{
+		return fmt::format("Effect{}.fx", rule);
+	}
+
+	// Rules are spread evenly over the day so some are always active
+	inline double StartTime(std::size_t rule) { return static_cast<double>(rule % 24); }
+	inline double StopTime(std::size_t rule) { return static_cast<double>(rule % 24) + 4.0; }
+
+	// Preset text with ruleCount specific rules in every category
+	inline std::string GenerateINI(std::size_t ruleCount)
+	{
+		std::string ini;
+		ini += "[General]\nEnableMenus=true\nEnableTime=true\nEnableInterior=true\nEnableWeather=true\n\n";
+
+		ini += "[MenusGeneral]\nMenuToggleOption=Specific\nMenuToggleAllState=off\n";
+		for (std::size_t i = 1; i <= ruleCount; i++)
+		{
+			ini += fmt::format("MenuToggleSpecificFile{0}={1}\nMenuToggleSpecificState{0}=off\nMenuToggleSpecificMenu{0}={2}\n",
+				i, EffectName(i), s_MenuNames[i % s_MenuNames.size()]);
+		}
+
+		ini += "\n[MenusProcess]\n";
+		for (std::size_t i = 1; i <= ruleCount; i++)
+		{
+			ini += fmt::format("Menu{}={}\n", i, s_MenuNames[i % s_MenuNames.size()]);
+		}
+
+		ini += "\n[Time]\nTimeUpdateInterval=5\nTimeToggleOption=Specific\nTimeToggleAllState=off\nTimeToggleAllTimeStart=0.00\nTimeToggleAllTimeStop=0.00\n";
+		for (std::size_t i = 1; i <= ruleCount; i++)
+		{
+			ini += fmt::format("TimeToggleSpecificFile{0}={1}\nTimeToggleSpecificState{0}=off\nTimeToggleSpecificTimeStart{0}={2:.2f}\nTimeToggleSpecificTimeStop{0}={3:.2f}\n",
+				i, EffectName(i), StartTime(i), StopTime(i));
+		}
+
+		ini += "\n[Interior]\nInteriorUpdateInterval=3\nInteriorToggleOption=Specific\nInteriorToggleAllState=off\n";
+		for (std::size_t i = 1; i <= ruleCount; i++)
+		{
+			ini += fmt::format("InteriorToggleSpecificFile{0}={1}\nInteriorToggleSpecificState{0}=off\n", i, EffectName(i));
+		}
+
+		ini += "\n[Weather]\nWeatherUpdateInterval=5\nWeatherToggleOption=Specific\nWeatherToggleAllState=off\n";
+		for (std::size_t i = 1; i <= ruleCount; i++)
+		{
+			ini += fmt::format("WeatherToggleSpecificFile{0}={1}\nWeatherToggleSpecificState{0}=off\nWeatherToggleSpecificWeather{0}={2}\n",
+				i, EffectName(i), s_WeatherNames[i % s_WeatherNames.size()]);
+		}
+
+		ini += "\n[WeatherProcess]\n";
+		for (std::size_t i = 1; i <= ruleCount; i++)
+		{
+			ini += fmt::format("Weather{}={}\n", i, s_WeatherNames[i % s_WeatherNames.size()]);
+		}
+
+		return ini;
+	}
+
+	// Fills the preset globals directly with what LoadINI would produce for GenerateINI(ruleCount)
+	inline void Populate(std::size_t ruleCount)
+	{
+		Config::Clear();
+		EnableMenus = EnableTime = EnableInterior = EnableWeather = true;
+		ToggleStateMenus = ToggleStateTime = ToggleStateInterior = ToggleStateWeather = "Specific";
+		ToggleAllStateMenus = ToggleAllStateTime = ToggleAllStateInterior = ToggleAllStateWeather = "off";
+		TimeUpdateIntervalTime = 5;
+		TimeUpdateIntervalInterior = 3;
+		TimeUpdateIntervalWeather = 5;
+
+		techniqueTimeInfoListAll.push_back(TechniqueInfo{ "", "off" });
+
+		for (std::size_t i = 1; i <= ruleCount; i++)
+		{
+			const std::string menuName = s_MenuNames[i % s_MenuNames.size()];
+			const std::string weatherName = s_WeatherNames[i % s_WeatherNames.size()];
+
+			techniqueMenuInfoList.push_back(TechniqueInfo{ EffectName(i), "off", menuName });
+			menuList.push_back(Info{ fmt::format("Menu{}", i), menuName });
+			techniqueTimeInfoList.push_back(TechniqueInfo{ EffectName(i), "off", "", StartTime(i), StopTime(i) });
+			techniqueInteriorInfoList.push_back(TechniqueInfo{ EffectName(i), "off" });
+			techniqueWeatherInfoList.push_back(TechniqueInfo{ EffectName(i), "off", weatherName });
+			weatherList.push_back(Info{ fmt::format("Weather{}", i), weatherName });
+		}
+	}
+
+	// Registers every effect the generated preset references
+	inline void AddEffects(StubEffectRuntime& runtime, std::size_t ruleCount, std::size_t techniquesPerEffect = 1)
+	{
+		for (std::size_t i = 1; i <= ruleCount; i++)
+		{
+			runtime.AddEffect(EffectName(i), techniquesPerEffect);
+		}
+	}
+}
@@ -0,0 +1,110 @@
+#include "Catch.h"
+#include "Stubs.h"
+
+#include "Core/Config.h"
+#include "Core/PresetSwitcher.h"
+#include "Core/RuleEngine.h"
+
+using namespace std::chrono_literals;
+
+TEST_CASE("Preset switches wait for a loading screen or the timeout", "[Presets]")
+{
+	Config::Clear();
+	EnableReshadePresets = true;
+	PresetSwitchTimeout = 60;
+	PresetSwitchInterval = 300;
+
+	StubEffectRuntime runtime;
+	PresetSwitcher presets;
+	const auto start = PresetSwitcher::Clock::now();
+
+	presets.Request("Night.ini");
+	presets.Update(runtime, start + 10s);
+	CHECK(runtime.presetCalls == 0);
+	CHECK(presets.GetPending() == "Night.ini");
+
+	presets.Flush();
+	presets.Update(runtime, start + 11s);
+	CHECK(runtime.currentPreset == "Night.ini");
+	CHECK(presets.GetPending().empty());
+
+	// Latency closes on the next present
+	presets.Update(runtime, start + 11s + 40ms);
+	CHECK(presets.GetSwitchCount() == 1);
+	CHECK(presets.GetLastLatency() == Approx(40.0));
+
+	// Past the timeout, but the interval since the last switch isn't
+	presets.Request("Day.ini");
+	presets.Update(runtime, PresetSwitcher::Clock::now() + 120s);
+	CHECK(runtime.currentPreset == "Night.ini");
+	presets.Update(runtime, start + 11s + 301s);
+	CHECK(runtime.currentPreset == "Day.ini");
+	CHECK(runtime.presetCalls == 2);
+}
+
+TEST_CASE("Presets that are already active aren't loaded again", "[Presets]")
+{
+	Config::Clear();
+	EnableReshadePresets = true;
+
+	StubEffectRuntime runtime;
+	runtime.currentPreset = "./presets/../Day.ini";
+	PresetSwitcher presets;
+
+	CHECK(PresetSwitcher::IsSamePreset("DAY.ini", "./Day.ini"));
+	CHECK_FALSE(PresetSwitcher::IsSamePreset("Day.ini", "Night.ini"));
+	CHECK(PresetSwitcher::Normalize("./presets/../DAY.ini") == PresetSwitcher::Normalize("day.ini"));
+	CHECK(PresetSwitcher::Normalize("").empty());
+
+	presets.Request("Day.ini");
+	presets.Flush();
+	presets.Update(runtime, PresetSwitcher::Clock::now());
+	CHECK(runtime.presetCalls == 0);
+	CHECK(presets.GetPending().empty());
+
+	// Switching off presets leaves the pending one alone
+	presets.Request("Night.ini");
+	EnableReshadePresets = false;
+	presets.Flush();
+	presets.Update(runtime, PresetSwitcher::Clock::now());
+	CHECK(runtime.presetCalls == 0);
+}
+
+TEST_CASE("Preset rules pick the last preset that holds", "[Presets]")
+{
+	Config::Clear();
+	EnableReshadePresets = true;
+	DefaultReshadePreset = "Day.ini";
+
+	ReshadePresetInfo night;
+	night.path = "Night.ini";
+	night.category = "Time";
+	night.startTime = 20.0;
+	night.stopTime = 23.59;
+	reshadePresetInfoList.push_back(night);
+
+	ReshadePresetInfo interior;
+	interior.path = "Interior.ini";
+	interior.category = "Interior";
+	reshadePresetInfoList.push_back(interior);
+
+	StubGameState gameState;
+	gameState.hour = 21.0f;
+	StubEffectRuntime runtime;
+	PresetSwitcher presets;
+	RuleEngine engine(gameState, &runtime);
+	engine.SetPresetSwitcher(&presets);
+
+	engine.ProcessTimeBasedToggling();
+	CHECK(presets.GetPending() == "Night.ini");
+
+	gameState.cellType = CellType::kInterior;
+	engine.ProcessInteriorBasedToggling();
+	CHECK(presets.GetPending() == "Interior.ini");
+
+	gameState.hour = 12.0f;
+	gameState.cellType = CellType::kExterior;
+	engine.ProcessTimeBasedToggling();
+	engine.ProcessInteriorBasedToggling();
+	CHECK(presets.GetPending() == "Day.ini");
+}
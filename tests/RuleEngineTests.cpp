@@ -0,0 +1,430 @@
+#include "Catch.h"
+#include "Stubs.h"
+
+#include "Core/Config.h"
+#include "Core/RuleEngine.h"
+
+TEST_CASE("Menu rules toggle everything while a listed menu is open", "[RuleEngine][Menu]")
+{
+	Config::Clear();
+	ToggleStateMenus = "All";
+	ToggleAllStateMenus = "off";
+	menuList.push_back(Info{ "Menu1", "MapMenu" });
+
+	StubGameState gameState;
+	StubEffectRuntime runtime;
+	RuleEngine engine(gameState, &runtime);
+
+	engine.ProcessMenuEvent("HUD Menu", true);
+	CHECK(runtime.effectsEnabled);
+
+	engine.ProcessMenuEvent("MapMenu", true);
+	CHECK_FALSE(runtime.effectsEnabled);
+	CHECK(engine.IsMenuOpen());
+
+	engine.ProcessMenuEvent("MapMenu", false);
+	CHECK(runtime.effectsEnabled);
+}
+
+TEST_CASE("Menu rules toggle specific effects per menu", "[RuleEngine][Menu]")
+{
+	Config::Clear();
+	ToggleStateMenus = "Specific";
+	techniqueMenuInfoList.push_back(MakeTechnique("DOF.fx", "off", "InventoryMenu"));
+	techniqueMenuInfoList.push_back(MakeTechnique("Vignette.fx", "on", "MapMenu"));
+
+	StubGameState gameState;
+	StubEffectRuntime runtime;
+	runtime.AddEffect("DOF.fx", 2);
+	runtime.AddEffect("Vignette.fx");
+	RuleEngine engine(gameState, &runtime);
+
+	engine.ProcessMenuEvent("InventoryMenu", true);
+	CHECK_FALSE(runtime.IsEffectEnabled("DOF.fx"));
+	// "on" rules are inverted, the effect only runs inside its menu
+	CHECK_FALSE(runtime.IsEffectEnabled("Vignette.fx"));
+
+	engine.ProcessMenuEvent("MapMenu", true);
+	CHECK(runtime.IsEffectEnabled("Vignette.fx"));
+}
+
+TEST_CASE("Specific rules are only applied when their condition flips", "[RuleEngine]")
+{
+	Config::Clear();
+	ToggleStateMenus = "Specific";
+	ToggleStateTime = "Specific";
+	techniqueMenuInfoList.push_back(MakeTechnique("DOF.fx", "off", "InventoryMenu"));
+	techniqueMenuInfoList.push_back(MakeTechnique("Vignette.fx", "off", "MapMenu"));
+	TechniqueInfo night = MakeTechnique("Bloom.fx", "off");
+	night.startTime = 20.0;
+	night.stopTime = 23.0;
+	techniqueTimeInfoList.push_back(night);
+
+	StubGameState gameState;
+	gameState.hour = 12.0f;
+	StubEffectRuntime runtime;
+	runtime.AddEffect("DOF.fx");
+	runtime.AddEffect("Vignette.fx");
+	runtime.AddEffect("Bloom.fx");
+	RuleEngine engine(gameState, &runtime);
+
+	// The first pass applies everything
+	engine.ProcessTimeBasedToggling();
+	engine.ProcessMenuEvent("Console", true);
+	CHECK(runtime.enumerateCalls == 3);
+
+	// Only the rule naming the menu
+	runtime.ResetCounters();
+	engine.ProcessMenuEvent("MapMenu", true);
+	CHECK(runtime.enumerateCalls == 1);
+	CHECK_FALSE(runtime.IsEffectEnabled("Vignette.fx"));
+	CHECK(runtime.IsEffectEnabled("DOF.fx"));
+
+	runtime.ResetCounters();
+	engine.ProcessMenuEvent("Console", false);
+	CHECK(runtime.enumerateCalls == 0);
+	engine.ProcessMenuEvent("MapMenu", false); // Nothing open, so not applied
+
+	// Time ticks that stay on one side of the range cost nothing
+	runtime.ResetCounters();
+	gameState.hour = 13.0f;
+	engine.ProcessTimeBasedToggling();
+	CHECK(runtime.enumerateCalls == 0);
+	gameState.hour = 21.0f;
+	engine.ProcessTimeBasedToggling();
+	CHECK(runtime.enumerateCalls == 1);
+	CHECK_FALSE(runtime.IsEffectEnabled("Bloom.fx"));
+
+	// Edits and reloads apply every rule again
+	runtime.ResetCounters();
+	techniqueTimeInfoList[0].stopTime = 20.5;
+	ruleRevision++;
+	engine.ProcessTimeBasedToggling();
+	CHECK(runtime.IsEffectEnabled("Bloom.fx"));
+
+	CHECK(runtime.enumerateCalls == 1);
+
+	runtime.ResetCounters();
+	engine.InvalidateRules();
+	engine.ProcessMenuEvent("Console", true);
+	CHECK(runtime.enumerateCalls == 2);
+}
+
+TEST_CASE("Time rules follow the game hour", "[RuleEngine][Time]")
+{
+	Config::Clear();
+	ToggleStateTime = "Specific";
+	TechniqueInfo info = MakeTechnique("Bloom.fx", "off");
+	info.startTime = 8.0;
+	info.stopTime = 16.0;
+	techniqueTimeInfoList.push_back(info);
+
+	StubGameState gameState;
+	StubEffectRuntime runtime;
+	runtime.AddEffect("Bloom.fx");
+	RuleEngine engine(gameState, &runtime);
+
+	gameState.hour = 12.0f;
+	engine.ProcessTimeBasedToggling();
+	CHECK_FALSE(runtime.IsEffectEnabled("Bloom.fx"));
+
+	gameState.hour = 20.0f;
+	engine.ProcessTimeBasedToggling();
+	CHECK(runtime.IsEffectEnabled("Bloom.fx"));
+
+	// One rule over midnight instead of two
+	TechniqueInfo night = MakeTechnique("RTGI.fx", "off");
+	night.startTime = 22.0;
+	night.stopTime = 5.0;
+	techniqueTimeInfoList.push_back(night);
+	ruleRevision++;
+	runtime.AddEffect("RTGI.fx");
+
+	gameState.hour = 23.0f;
+	engine.ProcessTimeBasedToggling();
+	CHECK_FALSE(runtime.IsEffectEnabled("RTGI.fx"));
+
+	gameState.hour = 3.0f;
+	engine.ProcessTimeBasedToggling();
+	CHECK_FALSE(runtime.IsEffectEnabled("RTGI.fx"));
+
+	gameState.hour = 6.0f;
+	engine.ProcessTimeBasedToggling();
+	CHECK(runtime.IsEffectEnabled("RTGI.fx"));
+}
+
+TEST_CASE("Polled categories are skipped while a menu is open", "[RuleEngine]")
+{
+	Config::Clear();
+	ToggleStateTime = "All";
+	ToggleAllStateTime = "off";
+	TechniqueInfo info;
+	info.startTime = 0.0;
+	info.stopTime = 23.59;
+	techniqueTimeInfoListAll.push_back(info);
+
+	StubGameState gameState;
+	StubEffectRuntime runtime;
+	RuleEngine engine(gameState, &runtime);
+
+	engine.ProcessMenuEvent("Console", true);
+	engine.ProcessTimeBasedToggling();
+	CHECK(runtime.effectsStateCalls == 0);
+
+	engine.ProcessMenuEvent("Console", false);
+	engine.ProcessTimeBasedToggling();
+	CHECK(runtime.effectsStateCalls == 1);
+	CHECK_FALSE(runtime.effectsEnabled);
+}
+
+TEST_CASE("Interior rules track the player cell", "[RuleEngine][Interior]")
+{
+	Config::Clear();
+	ToggleStateInterior = "Specific";
+	techniqueInteriorInfoList.push_back(MakeTechnique("Sky.fx", "off"));
+
+	StubGameState gameState;
+	StubEffectRuntime runtime;
+	runtime.AddEffect("Sky.fx");
+	RuleEngine engine(gameState, &runtime);
+
+	gameState.cellType = CellType::kInterior;
+	engine.ProcessInteriorBasedToggling();
+	CHECK(IsInInteriorCell);
+	CHECK_FALSE(runtime.IsEffectEnabled("Sky.fx"));
+
+	// No cell while loading, nothing changes
+	gameState.cellType = CellType::kNone;
+	engine.ProcessInteriorBasedToggling();
+	CHECK(IsInInteriorCell);
+	CHECK_FALSE(runtime.IsEffectEnabled("Sky.fx"));
+
+	gameState.cellType = CellType::kExterior;
+	engine.ProcessInteriorBasedToggling();
+	CHECK_FALSE(IsInInteriorCell);
+	CHECK(runtime.IsEffectEnabled("Sky.fx"));
+}
+
+TEST_CASE("Weather rules match the current weather flag", "[RuleEngine][Weather]")
+{
+	Config::Clear();
+	ToggleStateWeather = "Specific";
+	techniqueWeatherInfoList.push_back(MakeTechnique("Rain.fx", "on", "kRainy"));
+
+	StubGameState gameState;
+	StubEffectRuntime runtime;
+	runtime.AddEffect("Rain.fx");
+	RuleEngine engine(gameState, &runtime);
+
+	gameState.weatherFlags = static_cast<std::uint32_t>(WeatherFlag::kRainy);
+	engine.ProcessWeatherBasedToggling();
+	CHECK(weatherflags == "kRainy");
+	CHECK(runtime.IsEffectEnabled("Rain.fx"));
+
+	// Combined flags aren't a known weather, the last one sticks
+	gameState.weatherFlags = static_cast<std::uint32_t>(WeatherFlag::kSnow) | static_cast<std::uint32_t>(WeatherFlag::kCloudy);
+	engine.ProcessWeatherBasedToggling();
+	CHECK(weatherflags == "kRainy");
+
+	gameState.weatherFlags = static_cast<std::uint32_t>(WeatherFlag::kPleasant);
+	engine.ProcessWeatherBasedToggling();
+	CHECK_FALSE(runtime.IsEffectEnabled("Rain.fx"));
+}
+
+TEST_CASE("Player rules only run when the player state changes", "[RuleEngine][Player]")
+{
+	Config::Clear();
+	playerInfoList.push_back(StateRuleInfo{ "DOF.fx", "off", "Sneaking" });
+	playerInfoList.push_back(StateRuleInfo{ "Sharpen.fx", "on", "Combat" });
+
+	StubGameState gameState;
+	StubEffectRuntime runtime;
+	runtime.AddEffect("DOF.fx");
+	runtime.AddEffect("Sharpen.fx");
+	RuleEngine engine(gameState, &runtime);
+
+	engine.ProcessPlayerBasedToggling();
+	CHECK(runtime.IsEffectEnabled("DOF.fx"));
+	CHECK_FALSE(runtime.IsEffectEnabled("Sharpen.fx"));
+
+	// Every frame, nothing changed
+	runtime.ResetCounters();
+	engine.ProcessPlayerBasedToggling();
+	engine.ProcessPlayerBasedToggling();
+	CHECK(runtime.techniqueStateCalls == 0);
+	CHECK(gameState.playerStateReads == 3);
+
+	gameState.playerState = static_cast<std::uint32_t>(PlayerState::kSneaking);
+	engine.ProcessPlayerBasedToggling();
+	CHECK_FALSE(runtime.IsEffectEnabled("DOF.fx"));
+	CHECK(runtime.techniqueStateCalls == 1);
+
+	gameState.playerState |= static_cast<std::uint32_t>(PlayerState::kCombat);
+	engine.ProcessPlayerBasedToggling();
+	CHECK(runtime.IsEffectEnabled("Sharpen.fx"));
+	CHECK_FALSE(runtime.IsEffectEnabled("DOF.fx"));
+	CHECK(runtime.techniqueStateCalls == 2);
+
+	// Expressions see the same state
+	EnableExpressions = true;
+	ExpressionInfo expression;
+	expression.filename = "Sharpen.fx";
+	expression.state = "off";
+	expression.expression = "player(Combat) && player(Mounted)";
+	expressionInfoList.push_back(expression);
+	expressionRevision++;
+
+	gameState.playerState |= static_cast<std::uint32_t>(PlayerState::kMounted);
+	engine.ProcessPlayerBasedToggling();
+	CHECK_FALSE(runtime.IsEffectEnabled("Sharpen.fx"));
+}
+
+TEST_CASE("Camera rules apply once per frame", "[RuleEngine][Camera]")
+{
+	Config::Clear();
+	cameraInfoList.push_back(StateRuleInfo{ "DOF.fx", "off", "FirstPerson" });
+	cameraInfoList.push_back(StateRuleInfo{ "Vignette.fx", "on", "Killcam" });
+
+	StubGameState gameState;
+	StubEffectRuntime runtime;
+	runtime.AddEffect("DOF.fx");
+	runtime.AddEffect("Vignette.fx");
+	RuleEngine engine(gameState, &runtime);
+
+	engine.ProcessCameraBasedToggling();
+	CHECK(runtime.IsEffectEnabled("DOF.fx"));
+	CHECK_FALSE(runtime.IsEffectEnabled("Vignette.fx"));
+
+	runtime.ResetCounters();
+	engine.ProcessCameraBasedToggling();
+	CHECK(runtime.techniqueStateCalls == 0);
+
+	// In and out of a killcam between two frames costs nothing
+	gameState.cameraState = CameraState::kKillcam;
+	gameState.cameraState = CameraState::kThirdPerson;
+	engine.ProcessCameraBasedToggling();
+	CHECK(runtime.techniqueStateCalls == 0);
+
+	gameState.cameraState = CameraState::kKillcam;
+	engine.ProcessCameraBasedToggling();
+	CHECK(runtime.IsEffectEnabled("Vignette.fx"));
+	CHECK(runtime.techniqueStateCalls == 1);
+
+	gameState.cameraState = CameraState::kFirstPerson;
+	engine.ProcessCameraBasedToggling();
+	CHECK_FALSE(runtime.IsEffectEnabled("Vignette.fx"));
+	CHECK_FALSE(runtime.IsEffectEnabled("DOF.fx"));
+	CHECK(runtime.techniqueStateCalls == 3);
+
+	// Player and camera passes keep their own state
+	playerInfoList.push_back(StateRuleInfo{ "Sharpen.fx", "on", "Combat" });
+	runtime.AddEffect("Sharpen.fx");
+	runtime.ResetCounters();
+	engine.ProcessPlayerBasedToggling();
+	engine.ProcessCameraBasedToggling();
+	CHECK(runtime.techniqueStateCalls == 1);
+}
+
+TEST_CASE("Light rules follow the band sampled at cell change", "[RuleEngine][Light]")
+{
+	Config::Clear();
+	lightInfoList.push_back(StateRuleInfo{ "Brighten.fx", "on", "Dark" });
+	lightInfoList.push_back(StateRuleInfo{ "Bloom.fx", "on", "Bright" });
+
+	StubGameState gameState;
+	StubEffectRuntime runtime;
+	runtime.AddEffect("Brighten.fx");
+	runtime.AddEffect("Bloom.fx");
+	RuleEngine engine(gameState, &runtime);
+
+	engine.ProcessLightBasedToggling();
+	CHECK_FALSE(runtime.IsEffectEnabled("Brighten.fx"));
+	CHECK_FALSE(runtime.IsEffectEnabled("Bloom.fx"));
+
+	// Frames don't read the cell, only a cell change does
+	gameState.lightLevel = 0.05f;
+	runtime.ResetCounters();
+	engine.ProcessLightBasedToggling();
+	engine.ProcessLightBasedToggling();
+	CHECK(gameState.lightReads == 0);
+	CHECK(runtime.techniqueStateCalls == 0);
+
+	engine.SampleCellLight();
+	engine.ProcessLightBasedToggling();
+	CHECK(gameState.lightReads == 1);
+	CHECK(runtime.IsEffectEnabled("Brighten.fx"));
+	CHECK(runtime.techniqueStateCalls == 1);
+
+	// A dim inn next door changes the band, not the rules
+	gameState.lightLevel = 0.2f;
+	engine.SampleCellLight();
+	engine.ProcessLightBasedToggling();
+	CHECK_FALSE(runtime.IsEffectEnabled("Brighten.fx"));
+	CHECK_FALSE(runtime.IsEffectEnabled("Bloom.fx"));
+
+	// Moving the threshold rebuckets the same sample
+	LightBrightThreshold = 0.15f;
+	engine.ProcessLightBasedToggling();
+	CHECK(runtime.IsEffectEnabled("Bloom.fx"));
+	CHECK(engine.GetCellLightLevel() == 0.2f);
+
+	gameState.lightLevel.reset();
+	engine.SampleCellLight();
+	engine.ProcessLightBasedToggling();
+	CHECK_FALSE(runtime.IsEffectEnabled("Bloom.fx"));
+	CHECK_FALSE(engine.GetCellLightLevel());
+}
+
+TEST_CASE("Nothing is applied without a runtime", "[RuleEngine]")
+{
+	Config::Clear();
+	ToggleStateInterior = "All";
+	ToggleAllStateInterior = "off";
+
+	StubGameState gameState;
+	StubEffectRuntime runtime;
+	RuleEngine engine(gameState);
+
+	engine.ProcessInteriorBasedToggling();
+	CHECK(runtime.effectsStateCalls == 0);
+
+	engine.SetRuntime(&runtime);
+	engine.ProcessInteriorBasedToggling();
+	CHECK(runtime.effectsStateCalls == 1);
+}
+
+TEST_CASE("A suspended engine applies nothing until it resumes", "[RuleEngine]")
+{
+	Config::Clear();
+	ToggleStateInterior = "Specific";
+	techniqueInteriorInfoList.push_back(MakeTechnique("Sky.fx", "off"));
+
+	StubGameState gameState;
+	StubEffectRuntime runtime;
+	runtime.AddEffect("Sky.fx");
+	RuleEngine engine(gameState, &runtime);
+
+	engine.SetSuspended(true);
+	CHECK(engine.IsSuspended());
+	CHECK(engine.GetRuntime() == &runtime);
+
+	gameState.cellType = CellType::kInterior;
+	engine.ProcessInteriorBasedToggling();
+	CHECK(IsInInteriorCell);
+	CHECK(runtime.IsEffectEnabled("Sky.fx"));
+
+	// Resuming applies the rules again even though the cell didn't change
+	engine.SetSuspended(false);
+	engine.ProcessInteriorBasedToggling();
+	CHECK_FALSE(runtime.IsEffectEnabled("Sky.fx"));
+}
+
+TEST_CASE("IsTimeWithinRange is inclusive and wraps past midnight", "[RuleEngine][Time]")
+{
+	CHECK(RuleEngine::IsTimeWithinRange(8.0, 8.0, 16.0));
+	CHECK(RuleEngine::IsTimeWithinRange(16.0, 8.0, 16.0));
+	CHECK_FALSE(RuleEngine::IsTimeWithinRange(7.99, 8.0, 16.0));
+	CHECK(RuleEngine::IsTimeWithinRange(23.0, 22.0, 5.0));
+	CHECK(RuleEngine::IsTimeWithinRange(5.0, 22.0, 5.0));
+	CHECK_FALSE(RuleEngine::IsTimeWithinRange(12.0, 22.0, 5.0));
+}
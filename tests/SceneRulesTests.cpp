@@ -0,0 +1,93 @@
+#include "Catch.h"
+#include "Stubs.h"
+
+#include "Core/Config.h"
+#include "Core/RuleEngine.h"
+#include "Core/SceneRules.h"
+
+namespace
+{
+	SceneInfo MakeRule(const std::string& filename, const std::string& metric, double threshold, double hysteresis)
+	{
+		SceneInfo info;
+		info.filename = filename;
+		info.metric = metric;
+		info.threshold = threshold;
+		info.hysteresis = hysteresis;
+		return info;
+	}
+
+	SceneSample MakeSample(std::uint32_t actors, std::uint32_t references)
+	{
+		SceneSample sample;
+		sample.actors = actors;
+		sample.references = references;
+		return sample;
+	}
+}
+
+TEST_CASE("Scene rules switch with hysteresis", "[Scene]")
+{
+	SceneRules rules;
+	rules.Compile({
+		MakeRule("RTGI.fx", "Actors", 20.0, 5.0),
+		MakeRule("SSAO.fx", "References", 3000.0, 0.0),
+		MakeRule("DOF.fx", "Crowds", 1.0, 0.0),
+	});
+
+	CHECK(rules.Update(MakeSample(18, 1000)) == std::vector<std::size_t>{ 0, 1, 2 });
+	CHECK_FALSE(rules.IsActive(0));
+
+	CHECK(rules.Update(MakeSample(20, 3000)) == std::vector<std::size_t>{ 0, 1 });
+	CHECK(rules.IsActive(0));
+	CHECK(rules.IsActive(1));
+
+	// Hovering around the threshold keeps the rule holding
+	CHECK(rules.Update(MakeSample(19, 2999)) == std::vector<std::size_t>{ 1 });
+	CHECK(rules.Update(MakeSample(16, 2999)).empty());
+	CHECK(rules.Update(MakeSample(21, 2999)).empty());
+	CHECK(rules.IsActive(0));
+
+	CHECK(rules.Update(MakeSample(15, 2999)) == std::vector<std::size_t>{ 0 });
+	CHECK_FALSE(rules.IsActive(0));
+	CHECK(rules.Update(MakeSample(19, 2999)).empty());
+
+	// Unknown metrics never hold
+	CHECK(rules.Update(MakeSample(100, 100)) == std::vector<std::size_t>{ 0 });
+	CHECK_FALSE(rules.IsActive(2));
+
+	// Reported again after an invalidate, still holding within the band
+	rules.Invalidate();
+	CHECK(rules.Update(MakeSample(17, 100)).size() == 3);
+	CHECK(rules.IsActive(0));
+}
+
+TEST_CASE("Scene rules follow the sampled scene", "[Scene][RuleEngine]")
+{
+	Config::Clear();
+	EnableScene = true;
+	sceneInfoList.push_back(MakeRule("RTGI.fx", "Actors", 20.0, 5.0));
+
+	StubGameState gameState;
+	StubEffectRuntime runtime;
+	runtime.AddEffect("RTGI.fx");
+	RuleEngine engine(gameState, &runtime);
+
+	engine.ProcessSceneBasedToggling(MakeSample(30, 2000), 0.5);
+	CHECK_FALSE(runtime.IsEffectEnabled("RTGI.fx"));
+
+	runtime.ResetCounters();
+	engine.ProcessSceneBasedToggling(MakeSample(18, 2000), 0.25);
+	CHECK(runtime.techniqueStateCalls == 0);
+
+	engine.ProcessSceneBasedToggling(MakeSample(10, 2000), 0.75);
+	CHECK(runtime.IsEffectEnabled("RTGI.fx"));
+
+	// Every sample is counted with what it cost
+	const SceneStats stats = engine.GetSceneStats();
+	CHECK(stats.samples == 3);
+	CHECK(stats.sample.actors == 10);
+	CHECK(stats.lastCost == Approx(0.75));
+	CHECK(stats.maxCost == Approx(0.75));
+	CHECK(stats.averageCost == Approx(0.5));
+}
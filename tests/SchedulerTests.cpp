@@ -0,0 +1,31 @@
+#include "Catch.h"
+
+#include "Core/Scheduler.h"
+
+namespace
+{
+	int s_Runs = 0;
+	int s_OtherRuns = 0;
+}
+
+TEST_CASE("Scheduler runs each queued name once", "[Scheduler]")
+{
+	s_Runs = 0;
+	s_OtherRuns = 0;
+
+	Scheduler scheduler;
+	scheduler.Submit("Time", []() { s_Runs++; });
+	scheduler.Submit("Time", []() { s_Runs++; });
+	scheduler.Submit("Weather", []() { s_OtherRuns++; });
+
+	CHECK(scheduler.IsQueued("Time"));
+	CHECK_FALSE(scheduler.IsQueued("Interior"));
+
+	scheduler.Execute();
+	CHECK(s_Runs == 1);
+	CHECK(s_OtherRuns == 1);
+	CHECK_FALSE(scheduler.IsQueued("Time"));
+
+	scheduler.Execute();
+	CHECK(s_Runs == 1);
+}
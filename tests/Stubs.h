@@ -0,0 +1,284 @@
+#pragma once
+
+#include "Core/Config.h"
+#include "Core/EffectRuntime.h"
+#include "Core/GameState.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Game state with plain fields, set whatever the test needs
+class StubGameState : public IGameStateProvider
+{
+public:
+	float GetHour() const override { return hour; }
+	float GetTimeScale() const override { return timeScale; }
+	GameDate GetDate() const override { return date; }
+	CellType GetCellType() const override { return cellType; }
+	SceneSample GetSceneSample() const override { return scene; }
+	std::uint32_t GetPlayerState() const override
+	{
+		playerStateReads++;
+		return playerState;
+	}
+	CameraState GetCameraState() const override { return cameraState; }
+	std::optional<float> GetCellLightLevel() const override
+	{
+		lightReads++;
+		return lightLevel;
+	}
+	LocationSnapshot GetLocation() const override { return location; }
+	std::uint32_t LookupFormID(std::string_view name) const override
+	{
+		const auto it = formIDs.find(std::string(name));
+		return it != formIDs.end() ? it->second : 0;
+	}
+	std::optional<std::uint32_t> GetWeatherFlags() const override { return weatherFlags; }
+	float GetWeatherTransition() const override { return weatherTransition; }
+	bool IsMenuOpen() const override { return menuOpen; }
+
+	float hour = 12.0f;
+	float timeScale = 20.0f;
+	GameDate date;
+	CellType cellType = CellType::kExterior;
+	std::uint32_t playerState = 0; // PlayerState bits
+	mutable std::size_t playerStateReads = 0;
+	CameraState cameraState = CameraState::kThirdPerson;
+	std::optional<float> lightLevel; // Empty is an exterior
+	mutable std::size_t lightReads = 0;
+	LocationSnapshot location;
+	SceneSample scene;
+	std::unordered_map<std::string, std::uint32_t> formIDs; // By name, for LookupFormID
+	std::optional<std::uint32_t> weatherFlags = static_cast<std::uint32_t>(WeatherFlag::kPleasant);
+	float weatherTransition = 1.0f;
+	bool menuOpen = false;
+};
+
+// Effect runtime that keeps technique states in memory and counts every call
+class StubEffectRuntime : public IEffectRuntime
+{
+public:
+	// Adds an effect file with the given number of techniques, all enabled
+	void AddEffect(const std::string& effectName, std::size_t techniqueCount = 1)
+	{
+		auto& techniques = m_Effects[effectName];
+		for (std::size_t i = 0; i < techniqueCount; i++)
+		{
+			const EffectTechnique technique{ ++m_LastHandle };
+			techniques.push_back(technique);
+			m_TechniqueStates[technique.handle] = true;
+		}
+	}
+
+	void SetEffectsState(bool enabled) override
+	{
+		effectsStateCalls++;
+		effectsEnabled = enabled;
+	}
+
+	void EnumerateTechniques(const char* effectName, const TechniqueCallback& callback) override
+	{
+		enumerateCalls++;
+		if (const auto it = m_Effects.find(effectName); it != m_Effects.end())
+		{
+			for (const EffectTechnique technique : it->second)
+			{
+				callback(technique);
+			}
+		}
+	}
+
+	void SetTechniqueState(EffectTechnique technique, bool enabled) override
+	{
+		techniqueStateCalls++;
+		m_TechniqueStates[technique.handle] = enabled;
+	}
+
+	bool GetTechniqueState(EffectTechnique technique) const override
+	{
+		return m_TechniqueStates.at(technique.handle);
+	}
+
+	std::string GetTechniqueName(EffectTechnique technique) const override
+	{
+		const auto it = techniqueNames.find(technique.handle);
+		return it != techniqueNames.end() ? it->second : std::string();
+	}
+
+	std::optional<std::string> GetTechniqueAnnotation(EffectTechnique technique, const char* name) const override
+	{
+		if (const auto it = techniqueGroups.find(technique.handle); it != techniqueGroups.end() && std::string_view(name) == "toggler_group")
+		{
+			return it->second;
+		}
+		return std::nullopt;
+	}
+
+	// Techniques of an effect in enumeration order
+	const std::vector<EffectTechnique>& GetTechniques(const std::string& effectName) const
+	{
+		return m_Effects.at(effectName);
+	}
+
+	void SetPreprocessorDefinition(const char* effectName, const char* name, const char* value) override
+	{
+		definitionCalls++;
+		definitions[effectName][name] = value;
+	}
+
+	std::optional<std::string> GetPreprocessorDefinition(const char* effectName, const char* name) const override
+	{
+		if (const auto effect = definitions.find(effectName); effect != definitions.end())
+		{
+			if (const auto it = effect->second.find(name); it != effect->second.end())
+			{
+				return it->second;
+			}
+		}
+		return std::nullopt;
+	}
+
+	// True if every technique of the effect is enabled
+	bool IsEffectEnabled(const std::string& effectName) const
+	{
+		for (const EffectTechnique technique : m_Effects.at(effectName))
+		{
+			if (!m_TechniqueStates.at(technique.handle))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Adds a uniform variable and returns its handle, source is its "source" annotation if any
+	EffectUniform AddUniform(const std::string& effectName, const std::string& variableName, const std::string& source = {})
+	{
+		const EffectUniform variable{ ++m_LastHandle };
+		m_Uniforms[effectName + ':' + variableName] = variable;
+		if (!source.empty())
+		{
+			m_Sources[variable.handle] = source;
+		}
+		return variable;
+	}
+
+	EffectUniform FindUniformVariable(const char* effectName, const char* variableName) const override
+	{
+		findUniformCalls++;
+		const auto it = m_Uniforms.find(std::string(effectName) + ':' + variableName);
+		return it != m_Uniforms.end() ? it->second : EffectUniform{};
+	}
+
+	void SetUniformValueFloat(EffectUniform variable, const float* values, std::size_t count) override
+	{
+		uniformCalls++;
+		uniformValues[variable.handle].assign(values, values + count);
+	}
+
+	void SetUniformValueInt(EffectUniform variable, const std::int32_t* values, std::size_t count) override
+	{
+		uniformCalls++;
+		uniformValues[variable.handle].assign(values, values + count);
+	}
+
+	void SetUniformValueBool(EffectUniform variable, const bool* values, std::size_t count) override
+	{
+		uniformCalls++;
+		uniformValues[variable.handle].assign(values, values + count);
+	}
+
+	void EnumerateUniformVariables(const char* effectName, const UniformCallback& callback) override
+	{
+		enumerateUniformCalls++;
+		const std::string prefix = effectName != nullptr ? std::string(effectName) + ':' : std::string();
+		for (const auto& [name, variable] : m_Uniforms)
+		{
+			if (name.starts_with(prefix))
+			{
+				callback(variable);
+			}
+		}
+	}
+
+	std::optional<std::string> GetUniformAnnotation(EffectUniform variable, const char* name) const override
+	{
+		if (const auto it = m_Sources.find(variable.handle); it != m_Sources.end() && std::string_view(name) == "source")
+		{
+			return it->second;
+		}
+		return std::nullopt;
+	}
+
+	std::string GetCurrentPresetPath() const override { return currentPreset; }
+
+	void SetCurrentPresetPath(const char* path) override
+	{
+		presetCalls++;
+		currentPreset = path;
+	}
+
+	bool IsKeyDown(std::uint32_t keycode) const override { return keysDown.contains(keycode); }
+
+	bool IsKeyPressed(std::uint32_t keycode) const override
+	{
+		keyPolls++;
+		return keysPressed.contains(keycode);
+	}
+
+	void ResetCounters()
+	{
+		effectsStateCalls = 0;
+		enumerateCalls = 0;
+		techniqueStateCalls = 0;
+		definitionCalls = 0;
+		findUniformCalls = 0;
+		uniformCalls = 0;
+		enumerateUniformCalls = 0;
+		presetCalls = 0;
+	}
+
+	bool effectsEnabled = true;
+	std::size_t effectsStateCalls = 0;
+	std::size_t enumerateCalls = 0;
+	std::size_t techniqueStateCalls = 0;
+	std::size_t definitionCalls = 0;
+	// Preprocessor definitions by effect, then name
+	std::unordered_map<std::string, std::unordered_map<std::string, std::string>> definitions;
+	mutable std::size_t findUniformCalls = 0;
+	std::size_t uniformCalls = 0;
+	std::size_t enumerateUniformCalls = 0;
+	std::string currentPreset = "ReShadePreset.ini";
+	// Technique names and toggler_group annotations by handle
+	std::unordered_map<std::uint64_t, std::string> techniqueNames;
+	std::unordered_map<std::uint64_t, std::string> techniqueGroups;
+	std::size_t presetCalls = 0;
+	// Keys held and keys that went down this frame
+	std::unordered_set<std::uint32_t> keysDown;
+	std::unordered_set<std::uint32_t> keysPressed;
+	mutable std::size_t keyPolls = 0;
+	// Last written uniform values by handle, converted to float
+	std::unordered_map<std::uint64_t, std::vector<float>> uniformValues;
+
+private:
+	std::unordered_map<std::string, std::vector<EffectTechnique>> m_Effects;
+	std::unordered_map<std::uint64_t, bool> m_TechniqueStates;
+	std::unordered_map<std::string, EffectUniform> m_Uniforms;
+	std::unordered_map<std::uint64_t, std::string> m_Sources;
+	std::uint64_t m_LastHandle = 0;
+};
+
+// Rule for one effect or "@Group", Name is the menu or weather of the rule
+inline TechniqueInfo MakeTechnique(const std::string& filename, const std::string& state = "off", const std::string& name = "")
+{
+	TechniqueInfo info;
+	info.filename = filename;
+	info.state = state;
+	info.Name = name;
+	return info;
+}
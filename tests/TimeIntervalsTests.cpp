@@ -0,0 +1,109 @@
+#include "Catch.h"
+
+#include "Core/RuleEngine.h"
+#include "Core/TimeIntervals.h"
+
+#include <algorithm>
+
+namespace
+{
+	TechniqueInfo MakeRule(const std::string& filename, const std::string& state, double start, double stop)
+	{
+		TechniqueInfo info;
+		info.filename = filename;
+		info.state = state;
+		info.startTime = start;
+		info.stopTime = stop;
+		return info;
+	}
+}
+
+TEST_CASE("Time rules are merged into wrapping intervals", "[TimeIntervals]")
+{
+	const std::vector<TechniqueInfo> rules = {
+		MakeRule("RTGI.fx", "off", 22.0, 5.0),   // Over midnight
+		MakeRule("Bloom.fx", "off", 8.0, 12.0),
+		MakeRule("Bloom.fx", "off", 11.0, 14.0), // Overlaps the one before
+		MakeRule("Bloom.fx", "on", 13.0, 15.0),  // Other state, other target
+		MakeRule("Stars.fx", "on", 20.0, 23.0),
+		MakeRule("Stars.fx", "on", 23.0, 24.0),  // Touches the one before and the next
+		MakeRule("Stars.fx", "on", 0.0, 4.0),
+		MakeRule("Sun.fx", "off", 0.0, 24.0),    // All day
+	};
+
+	TimeIntervals intervals;
+	intervals.Build(rules);
+	CHECK(intervals.GetRuleCount() == 8);
+	CHECK(intervals.GetTargetCount() == 5);
+	CHECK(intervals.GetIntervalCount() == 5);
+	CHECK(intervals.GetRules(1) == std::vector<std::size_t>{ 1, 2 });
+
+	intervals.Update(23.5f);
+	CHECK(intervals.IsActive(0));
+	CHECK_FALSE(intervals.IsActive(1));
+	CHECK(intervals.IsActive(3));
+	CHECK(intervals.IsActive(4));
+
+	intervals.Update(5.0f); // Stop hours are inclusive
+	CHECK(intervals.IsActive(0));
+	CHECK_FALSE(intervals.IsActive(3));
+	intervals.Update(5.01f);
+	CHECK_FALSE(intervals.IsActive(0));
+
+	intervals.Update(12.5f);
+	CHECK(intervals.IsActive(1));
+	CHECK(intervals.IsActive(4));
+
+	// Boundaries: 0 isn't one, Stars runs through midnight and Sun never switches
+	CHECK(intervals.GetBoundaryCount() == 8);
+	CHECK(*intervals.GetNextBoundary(12.5f) == Approx(13.0));
+	CHECK(*intervals.GetNextBoundary(23.5f) > 4.0);
+	CHECK(*intervals.GetNextBoundary(23.5f) < 4.001);
+	CHECK(intervals.FindSegment(1.0f) == intervals.FindSegment(23.9f));
+
+	TimeIntervals empty;
+	empty.Build({});
+	CHECK_FALSE(empty.GetNextBoundary(12.0f));
+	CHECK(empty.Update(12.0f).empty());
+}
+
+TEST_CASE("Time interval updates only report switched targets", "[TimeIntervals]")
+{
+	const std::vector<TechniqueInfo> rules = {
+		MakeRule("RTGI.fx", "off", 22.0, 5.0),
+		MakeRule("Bloom.fx", "off", 8.0, 12.0),
+		MakeRule("Fog.fx", "off", 6.0, 9.0),
+	};
+
+	TimeIntervals intervals;
+	intervals.Build(rules);
+
+	// Everything the first time
+	CHECK(intervals.Update(12.0f).size() == 3);
+	CHECK(intervals.Update(12.0f).empty());
+	CHECK(intervals.Update(13.0f) == std::vector<TimeIntervals::Target>{ 1 });
+	CHECK(intervals.Update(14.0f).empty());
+
+	CHECK(intervals.Update(23.0f) == std::vector<TimeIntervals::Target>{ 0 });
+
+	// Through midnight and several boundaries at once
+	CHECK(intervals.Update(8.5f) == std::vector<TimeIntervals::Target>{ 0, 1, 2 });
+
+	// Going back walks forward round the day, switches in between cancel out
+	CHECK(intervals.Update(8.6f).empty());
+	CHECK(intervals.Update(7.0f) == std::vector<TimeIntervals::Target>{ 1 });
+
+	intervals.Invalidate();
+	CHECK(intervals.Update(7.0f).size() == 3);
+
+	// Matches a plain scan of the rules all day
+	for (int minute = 0; minute < 24 * 60; minute += 7)
+	{
+		const float hour = minute / 60.0f;
+		intervals.Update(hour);
+		for (TimeIntervals::Target target = 0; target < rules.size(); target++)
+		{
+			CHECK(intervals.IsActive(target) == RuleEngine::IsTimeWithinRange(hour, rules[target].startTime, rules[target].stopTime));
+		}
+	}
+}
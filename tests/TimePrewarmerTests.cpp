@@ -0,0 +1,155 @@
+#include "Catch.h"
+#include "Stubs.h"
+
+#include "Core/Config.h"
+#include "Core/EffectGroups.h"
+#include "Core/TimePrewarmer.h"
+
+#include <cmath>
+
+namespace
+{
+	void SetupRules()
+	{
+		Config::Clear();
+		EnableTimePrewarm = true;
+		TimePrewarmLookahead = 60.0;
+		ToggleStateTime = "Specific";
+		// Off from 20 to 23, turns on after 23
+		techniqueTimeInfoList.push_back(TechniqueInfo{ "Day.fx", "off", "", 20.0, 23.0 });
+		// On from 6 to 18
+		techniqueTimeInfoList.push_back(TechniqueInfo{ "Sun.fx", "on", "", 6.0, 18.0 });
+	}
+}
+
+TEST_CASE("Activations are predicted from hour and time scale", "[Prewarm]")
+{
+	SetupRules();
+
+	// 0.1 game hours at time scale 20 is 18 real seconds
+	auto activations = TimePrewarmer::PredictActivations(22.9f, 20.0f, 60.0);
+	REQUIRE(activations.size() == 1);
+	CHECK(activations[0].effect == "Day.fx");
+	CHECK(std::abs(activations[0].seconds - 18.0) < 0.1);
+
+	activations = TimePrewarmer::PredictActivations(5.9f, 20.0f, 60.0);
+	REQUIRE(activations.size() == 1);
+	CHECK(activations[0].effect == "Sun.fx");
+
+	// Too far out, or already on
+	CHECK(TimePrewarmer::PredictActivations(5.0f, 20.0f, 60.0).empty());
+	CHECK(TimePrewarmer::PredictActivations(12.0f, 20.0f, 60.0).empty());
+	// Faster time brings it into the window
+	CHECK(TimePrewarmer::PredictActivations(5.0f, 200.0f, 60.0).size() == 1);
+
+	ToggleStateTime = "All";
+	CHECK(TimePrewarmer::PredictActivations(22.9f, 20.0f, 60.0).empty());
+}
+
+TEST_CASE("Predictions are checked against actual activations", "[Prewarm]")
+{
+	SetupRules();
+
+	TimePrewarmer prewarmer;
+	const auto start = TimePrewarmer::Clock::now();
+	const float timeScale = 20.0f;
+
+	// Poll once per real second from 22:50 until past 23:00
+	for (int second = 0; second < 60; second++)
+	{
+		const float hour = 22.0f + 50.0f / 60.0f + second * timeScale / 3600.0f;
+		prewarmer.Observe(hour, timeScale, start + std::chrono::seconds(second));
+	}
+
+	const PredictionHistogram histogram = prewarmer.GetHistogram();
+	CHECK(histogram.GetCount() == 1);
+	CHECK(histogram.GetMissed() == 0);
+	// Polling once a second can be up to a second late
+	const auto& bins = histogram.GetBins();
+	CHECK(bins[4] == 1);
+}
+
+TEST_CASE("Predictions that never happen are counted as missed", "[Prewarm]")
+{
+	SetupRules();
+
+	TimePrewarmer prewarmer;
+	const auto start = TimePrewarmer::Clock::now();
+
+	prewarmer.Observe(22.95f, 20.0f, start);
+	// The player waited backwards... or a script set the clock, either way it never fires
+	prewarmer.Observe(21.0f, 20.0f, start + std::chrono::seconds(30));
+	prewarmer.Observe(21.0f, 20.0f, start + std::chrono::seconds(120));
+
+	CHECK(prewarmer.GetHistogram().GetMissed() == 1);
+}
+
+TEST_CASE("Loading screens warm upcoming effects once", "[Prewarm]")
+{
+	SetupRules();
+
+	StubEffectRuntime runtime;
+	runtime.AddEffect("Day.fx", 2);
+	runtime.AddEffect("Sun.fx");
+	runtime.EnumerateTechniques("Day.fx", [&runtime](EffectTechnique technique) { runtime.SetTechniqueState(technique, false); });
+
+	TimePrewarmer prewarmer;
+	prewarmer.SetWarmFrames(2);
+	prewarmer.Prewarm(runtime, 22.9f, 20.0f);
+	CHECK(runtime.IsEffectEnabled("Day.fx"));
+	CHECK(prewarmer.GetWarmingCount() == 1);
+
+	prewarmer.OnPresent(runtime, 22.9f);
+	CHECK(runtime.IsEffectEnabled("Day.fx"));
+	prewarmer.OnPresent(runtime, 22.9f);
+	CHECK_FALSE(runtime.IsEffectEnabled("Day.fx"));
+	CHECK(prewarmer.GetWarmingCount() == 0);
+
+	// Already compiled
+	prewarmer.Prewarm(runtime, 22.9f, 20.0f);
+	CHECK_FALSE(runtime.IsEffectEnabled("Day.fx"));
+
+	// After a runtime reload it warms again, and stays on if the rule fired meanwhile
+	prewarmer.Reset();
+	prewarmer.Prewarm(runtime, 22.9f, 20.0f);
+	prewarmer.OnPresent(runtime, 23.1f);
+	prewarmer.OnPresent(runtime, 23.1f);
+	CHECK(runtime.IsEffectEnabled("Day.fx"));
+
+	EnableTimePrewarm = false;
+	prewarmer.Reset();
+	runtime.EnumerateTechniques("Day.fx", [&runtime](EffectTechnique technique) { runtime.SetTechniqueState(technique, false); });
+	prewarmer.Prewarm(runtime, 22.9f, 20.0f);
+	CHECK_FALSE(runtime.IsEffectEnabled("Day.fx"));
+}
+
+TEST_CASE("Loading screens warm upcoming groups", "[Prewarm]")
+{
+	SetupRules();
+	techniqueTimeInfoList[0].filename = "@Night";
+
+	StubEffectRuntime runtime;
+	runtime.AddEffect("Day.fx");
+	runtime.AddEffect("Stars.fx", 2);
+	runtime.EnumerateTechniques("Stars.fx", [&runtime](EffectTechnique technique) { runtime.SetTechniqueState(technique, false); });
+
+	GroupInfo night;
+	night.name = "Night";
+	night.members = EffectGroups::ParseMembers("Stars.fx");
+	EffectGroups groups;
+	groups.Build(runtime, { "Day.fx", "Stars.fx" }, { night });
+
+	// Without the groups there is nothing to enumerate
+	TimePrewarmer prewarmer;
+	prewarmer.SetWarmFrames(1);
+	prewarmer.Prewarm(runtime, 22.9f, 20.0f);
+	CHECK(prewarmer.GetWarmingCount() == 0);
+
+	prewarmer.Reset();
+	prewarmer.Prewarm(runtime, 22.9f, 20.0f, &groups);
+	CHECK(runtime.IsEffectEnabled("Stars.fx"));
+	CHECK(prewarmer.GetWarmingCount() == 1);
+
+	prewarmer.OnPresent(runtime, 22.9f);
+	CHECK_FALSE(runtime.IsEffectEnabled("Stars.fx"));
+}
@@ -0,0 +1,167 @@
+#include "Catch.h"
+#include "Stubs.h"
+
+#include "Core/Config.h"
+#include "Core/Replay.h"
+#include "Core/RuleEngine.h"
+#include "Core/Timeline.h"
+
+#include <utility>
+
+namespace
+{
+	TimelineEvent MakeEvent(std::uint32_t time, TimelineEventType type)
+	{
+		TimelineEvent event;
+		event.time = time;
+		event.type = type;
+		return event;
+	}
+
+	// Replay timestamps come from the timeline, only effect and state are comparable with a live run
+	std::vector<std::pair<std::string, bool>> Strip(const std::vector<ReplayEffectRuntime::Call>& calls)
+	{
+		std::vector<std::pair<std::string, bool>> result;
+		for (const auto& call : calls)
+		{
+			result.emplace_back(call.effect, call.enabled);
+		}
+		return result;
+	}
+}
+
+TEST_CASE("Timelines survive a serialize round trip", "[Timeline]")
+{
+	Timeline timeline;
+	TimelineEvent open = MakeEvent(0, TimelineEventType::kMenuOpen);
+	open.menu = timeline.InternMenu("MapMenu");
+	TimelineEvent hour = MakeEvent(16, TimelineEventType::kHour);
+	hour.hour = 21.75f;
+	TimelineEvent cell = MakeEvent(300000, TimelineEventType::kCell);
+	cell.cellType = CellType::kInterior;
+	TimelineEvent weather = MakeEvent(300001, TimelineEventType::kWeather);
+	weather.weatherFlags = static_cast<std::uint32_t>(WeatherFlag::kSnow);
+	TimelineEvent noWeather = MakeEvent(300001, TimelineEventType::kWeather);
+	TimelineEvent close = MakeEvent(400000, TimelineEventType::kMenuClose);
+	close.menu = timeline.InternMenu("MapMenu");
+	timeline.events = { open, hour, cell, weather, noWeather, close };
+
+	Timeline loaded;
+	REQUIRE(loaded.Deserialize(timeline.Serialize()));
+
+	CHECK(loaded.menuNames == timeline.menuNames);
+	REQUIRE(loaded.events.size() == timeline.events.size());
+	for (std::size_t i = 0; i < loaded.events.size(); i++)
+	{
+		CHECK(loaded.events[i] == timeline.events[i]);
+	}
+}
+
+TEST_CASE("Malformed timelines are rejected", "[Timeline]")
+{
+	Timeline timeline;
+	TimelineEvent open = MakeEvent(5, TimelineEventType::kMenuOpen);
+	open.menu = timeline.InternMenu("Journal Menu");
+	timeline.events = { open };
+	const auto data = timeline.Serialize();
+
+	Timeline loaded;
+	CHECK_FALSE(loaded.Deserialize({}));
+	CHECK_FALSE(loaded.Deserialize({ 'R', 'E', 'T', 'X', 1, 0 }));
+
+	// Cut inside the menu name
+	CHECK_FALSE(loaded.Deserialize({ data.begin(), data.end() - 3 }));
+	CHECK(loaded.events.empty());
+
+	auto badType = data;
+	badType[7] = 0x7F;
+	CHECK_FALSE(loaded.Deserialize(badType));
+}
+
+TEST_CASE("Recorder captures the inputs the rule engine reads", "[Timeline]")
+{
+	Config::Clear();
+
+	StubGameState gameState;
+	StubEffectRuntime runtime;
+	TimelineRecorder recorder;
+	RuleEngine engine(gameState, &runtime);
+	engine.SetRecorder(&recorder);
+
+	// Nothing is kept before Start
+	engine.ProcessTimeBasedToggling();
+	CHECK(recorder.GetEventCount() == 0);
+
+	recorder.Start();
+	gameState.hour = 7.5f;
+	engine.ProcessTimeBasedToggling();
+	gameState.cellType = CellType::kInterior;
+	engine.ProcessInteriorBasedToggling();
+	engine.ProcessWeatherBasedToggling();
+	engine.ProcessMenuEvent("MapMenu", true);
+	// Skipped by the engine while a menu is open, so not an input either
+	engine.ProcessTimeBasedToggling();
+	engine.ProcessMenuEvent("MapMenu", false);
+	recorder.Stop();
+	engine.ProcessMenuEvent("MapMenu", true);
+
+	const Timeline timeline = recorder.GetTimeline();
+	REQUIRE(timeline.events.size() == 5);
+	CHECK(timeline.events[0].type == TimelineEventType::kHour);
+	CHECK(timeline.events[0].hour == 7.5f);
+	CHECK(timeline.events[1].cellType == CellType::kInterior);
+	CHECK(timeline.events[2].weatherFlags == gameState.weatherFlags);
+	CHECK(timeline.events[3].type == TimelineEventType::kMenuOpen);
+	CHECK(timeline.events[4].type == TimelineEventType::kMenuClose);
+	CHECK(timeline.menuNames == std::vector<std::string>{ "MapMenu" });
+}
+
+TEST_CASE("Replaying a recording reproduces the live toggle sequence", "[Timeline][Replay]")
+{
+	Config::Clear();
+	ToggleStateMenus = "Specific";
+	techniqueMenuInfoList.push_back(TechniqueInfo{ "DOF.fx", "off", "InventoryMenu" });
+	ToggleStateTime = "Specific";
+	techniqueTimeInfoList.push_back(TechniqueInfo{ "Night.fx", "off", "", 20.0, 4.0 });
+	techniqueTimeInfoList.push_back(TechniqueInfo{ "Day.fx", "off", "", 6.0, 18.0 });
+	ToggleStateInterior = "All";
+	ToggleAllStateInterior = "off";
+	ToggleStateWeather = "Specific";
+	techniqueWeatherInfoList.push_back(TechniqueInfo{ "Rain.fx", "off", "kRainy" });
+
+	StubGameState gameState;
+	ReplayEffectRuntime live;
+	TimelineRecorder recorder;
+	RuleEngine engine(gameState, &live);
+	engine.SetRecorder(&recorder);
+	recorder.Start();
+
+	for (int step = 0; step < 48; step++)
+	{
+		gameState.hour = static_cast<float>(step % 24);
+		engine.ProcessTimeBasedToggling();
+		gameState.cellType = step % 5 == 0 ? CellType::kInterior : CellType::kExterior;
+		engine.ProcessInteriorBasedToggling();
+		gameState.weatherFlags = static_cast<std::uint32_t>(step % 3 == 0 ? WeatherFlag::kRainy : WeatherFlag::kCloudy);
+		engine.ProcessWeatherBasedToggling();
+		if (step % 7 == 0)
+		{
+			engine.ProcessMenuEvent("InventoryMenu", true);
+			engine.ProcessTimeBasedToggling();
+			engine.ProcessMenuEvent("InventoryMenu", false);
+		}
+	}
+	recorder.Stop();
+	REQUIRE_FALSE(live.GetCalls().empty());
+
+	// Go through the binary format so the test also covers what gets written to disk
+	Timeline timeline;
+	REQUIRE(timeline.Deserialize(recorder.GetTimeline().Serialize()));
+
+	ReplayEffectRuntime replayed;
+	TimelineReplayer replayer;
+	CHECK(replayer.Replay(timeline, replayed) == timeline.events.size());
+
+	CHECK(Strip(replayed.GetCalls()) == Strip(live.GetCalls()));
+	CHECK(replayed.GetCallCount() == live.GetCallCount());
+}
@@ -0,0 +1,95 @@
+#include "Catch.h"
+
+#include "Core/Config.h"
+#include "Core/UniformCurves.h"
+
+#include <cmath>
+#include <random>
+
+TEST_CASE("Curves interpolate linearly and wrap at midnight", "[Curves]")
+{
+	const std::vector<CurveKey> keys = { { 6.0, 0.0 }, { 12.0, 1.0 }, { 20.0, 0.5 } };
+
+	CHECK(UniformCurves::EvaluateKeys(keys, 6.0) == Approx(0.0));
+	CHECK(UniformCurves::EvaluateKeys(keys, 9.0) == Approx(0.5));
+	CHECK(UniformCurves::EvaluateKeys(keys, 16.0) == Approx(0.75));
+	// 20:00 to 6:00 is ten hours from 0.5 down to 0
+	CHECK(UniformCurves::EvaluateKeys(keys, 23.0) == Approx(0.35));
+	CHECK(UniformCurves::EvaluateKeys(keys, 1.0) == Approx(0.25));
+
+	CHECK(UniformCurves::EvaluateKeys({ { 3.0, 0.7 } }, 15.0) == Approx(0.7));
+	CHECK(UniformCurves::EvaluateKeys({}, 15.0) == 0.0);
+}
+
+TEST_CASE("Compiled curves match the reference evaluation", "[Curves]")
+{
+	std::mt19937 random(7);
+	std::uniform_real_distribution<double> hours(0.0, 24.0);
+	std::uniform_real_distribution<double> values(-2.0, 2.0);
+
+	// 13 curves so the last SIMD lane group is partly padding, plus one without keys
+	std::vector<CurveInfo> curves(14);
+	for (std::size_t i = 0; i < 13; i++)
+	{
+		for (std::size_t key = 0; key <= i % 6; key++)
+		{
+			curves[i].keys.push_back(CurveKey{ hours(random), values(random) });
+		}
+		std::sort(curves[i].keys.begin(), curves[i].keys.end(), [](const CurveKey& a, const CurveKey& b) { return a.hour < b.hour; });
+	}
+
+	UniformCurves compiled;
+	compiled.Compile(curves);
+	REQUIRE(compiled.GetCurveCount() == 13);
+
+	for (float hour = 0.0f; hour < 24.0f; hour += 0.37f)
+	{
+		const float* result = compiled.Evaluate(hour);
+		for (std::size_t i = 0; i < compiled.GetCurveCount(); i++)
+		{
+			const auto& keys = curves[compiled.GetSources()[i]].keys;
+			CHECK(result[i] == Approx(UniformCurves::EvaluateKeys(keys, hour)).margin(1e-3));
+		}
+	}
+
+	// Out of range hours wrap
+	const float before = compiled.Evaluate(1.5f)[0];
+	CHECK(compiled.Evaluate(25.5f)[0] == Approx(before));
+}
+
+TEST_CASE("Compiled curves follow the hour jumping in both directions", "[Curves]")
+{
+	// Shared and repeated key hours, a single key and one over midnight
+	std::vector<CurveInfo> curves(5);
+	curves[0].keys = { { 6.0, 0.0 }, { 12.0, 1.0 }, { 20.0, 0.5 } };
+	curves[1].keys = { { 6.0, 2.0 }, { 6.0, 3.0 }, { 18.0, 1.0 } };
+	curves[2].keys = { { 9.5, 0.7 } };
+	curves[3].keys = { { 22.0, 1.0 }, { 23.5, 0.0 } };
+	curves[4].keys = { { 0.0, 0.0 }, { 12.0, 4.0 } };
+
+	UniformCurves compiled;
+	compiled.Compile(curves);
+
+	// Waits and sleeping skip hours, loading an older save goes back
+	for (const float hour : { 0.0f, 5.99f, 6.0f, 6.01f, 23.9f, 1.0f, 12.0f, 11.99f, 22.5f, 3.0f, 23.75f, 0.25f })
+	{
+		const float* result = compiled.Evaluate(hour);
+		for (std::size_t i = 0; i < curves.size(); i++)
+		{
+			CHECK(result[i] == Approx(UniformCurves::EvaluateKeys(curves[i].keys, hour)).margin(1e-3));
+		}
+	}
+}
+
+TEST_CASE("Curve keys parse and format", "[Curves]")
+{
+	const auto keys = UniformCurves::ParseKeys("20:0.3, 6:0.2,12:1,bad,25:4,7:");
+	REQUIRE(keys.size() == 3);
+	CHECK(keys[0] == CurveKey{ 6.0, 0.2 });
+	CHECK(keys[1] == CurveKey{ 12.0, 1.0 });
+	CHECK(keys[2] == CurveKey{ 20.0, 0.3 });
+
+	CHECK(UniformCurves::FormatKeys(keys) == "6:0.2,12:1,20:0.3");
+	CHECK(UniformCurves::ParseKeys(UniformCurves::FormatKeys(keys)) == keys);
+	CHECK(UniformCurves::ParseKeys("").empty());
+}
@@ -0,0 +1,114 @@
+#include "Catch.h"
+#include "Stubs.h"
+
+#include "Core/Config.h"
+#include "Core/RuleEngine.h"
+#include "Core/UniformWriter.h"
+
+TEST_CASE("Uniform writes are batched per frame", "[Uniforms]")
+{
+	StubEffectRuntime runtime;
+	const EffectUniform strength = runtime.AddUniform("Bloom.fx", "fBloomStrength");
+	const EffectUniform samples = runtime.AddUniform("SSAO.fx", "iSamples");
+	UniformWriter uniforms;
+
+	uniforms.Set("Bloom.fx", "fBloomStrength", 0.5f);
+	uniforms.Set("Bloom.fx", "fBloomStrength", 0.25f);
+	uniforms.Set("SSAO.fx", "iSamples", std::int32_t{ 8 });
+	CHECK(runtime.uniformCalls == 0);
+
+	// Last value of the frame wins
+	CHECK(uniforms.Flush(runtime) == 2);
+	CHECK(runtime.uniformCalls == 2);
+	CHECK(runtime.uniformValues[strength.handle] == std::vector<float>{ 0.25f });
+	CHECK(runtime.uniformValues[samples.handle] == std::vector<float>{ 8.0f });
+
+	// Same value again is dropped, handles are cached
+	runtime.ResetCounters();
+	uniforms.Set("Bloom.fx", "fBloomStrength", 0.25f);
+	uniforms.Set("SSAO.fx", "iSamples", std::int32_t{ 16 });
+	uniforms.Set("SSAO.fx", "iSamples", std::int32_t{ 8 });
+	CHECK(uniforms.Flush(runtime) == 0);
+	CHECK(runtime.uniformCalls == 0);
+	CHECK(runtime.findUniformCalls == 0);
+	CHECK(uniforms.GetSkippedCount() == 1);
+
+	CHECK(uniforms.Flush(runtime) == 0);
+}
+
+TEST_CASE("Uniforms are written again after a reload", "[Uniforms]")
+{
+	StubEffectRuntime runtime;
+	const EffectUniform enabled = runtime.AddUniform("Bloom.fx", "bEnabled");
+	UniformWriter uniforms;
+
+	uniforms.Set("Bloom.fx", "bEnabled", false);
+	uniforms.Set("Bloom.fx", "Missing", 1.0f);
+	CHECK(uniforms.Flush(runtime) == 1);
+	CHECK(runtime.uniformValues[enabled.handle] == std::vector<float>{ 0.0f });
+
+	// Missing variables are only looked up once
+	runtime.ResetCounters();
+	uniforms.Set("Bloom.fx", "Missing", 2.0f);
+	CHECK(uniforms.Flush(runtime) == 0);
+	CHECK(runtime.findUniformCalls == 0);
+
+	uniforms.Reset();
+	CHECK(uniforms.Flush(runtime) == 1);
+	CHECK(runtime.findUniformCalls == 2);
+	CHECK(runtime.uniformCalls == 1);
+}
+
+TEST_CASE("Uniform rules follow their conditions", "[Uniforms]")
+{
+	Config::Clear();
+	EnableUniforms = true;
+
+	UniformInfo night;
+	night.filename = "Bloom.fx";
+	night.name = "fBloomStrength";
+	night.value = 0.3;
+	night.defaultValue = 0.8;
+	night.category = "Time";
+	night.startTime = 20.0;
+	night.stopTime = 23.0;
+	uniformInfoList.push_back(night);
+
+	UniformInfo indoors;
+	indoors.filename = "SSAO.fx";
+	indoors.name = "iSamples";
+	indoors.type = "int";
+	indoors.value = 16.0;
+	indoors.defaultValue = 32.0;
+	indoors.category = "Interior";
+	uniformInfoList.push_back(indoors);
+
+	StubGameState gameState;
+	gameState.hour = 21.0f;
+	StubEffectRuntime runtime;
+	const EffectUniform strength = runtime.AddUniform("Bloom.fx", "fBloomStrength");
+	const EffectUniform samples = runtime.AddUniform("SSAO.fx", "iSamples");
+	UniformWriter uniforms;
+	RuleEngine engine(gameState, &runtime);
+	engine.SetUniformWriter(&uniforms);
+
+	engine.ProcessTimeBasedToggling();
+	uniforms.Flush(runtime);
+	CHECK(runtime.uniformValues[strength.handle] == std::vector<float>{ 0.3f });
+	CHECK(runtime.uniformValues[samples.handle] == std::vector<float>{ 32.0f });
+
+	gameState.hour = 12.0f;
+	gameState.cellType = CellType::kInterior;
+	engine.ProcessTimeBasedToggling();
+	engine.ProcessInteriorBasedToggling();
+	uniforms.Flush(runtime);
+	CHECK(runtime.uniformValues[strength.handle] == std::vector<float>{ 0.8f });
+	CHECK(runtime.uniformValues[samples.handle] == std::vector<float>{ 16.0f });
+
+	// Passes that change nothing don't cost a write
+	runtime.ResetCounters();
+	engine.ProcessTimeBasedToggling();
+	engine.ProcessInteriorBasedToggling();
+	CHECK(uniforms.Flush(runtime) == 0);
+	CHECK(runtime.uniformCalls == 0);
+}
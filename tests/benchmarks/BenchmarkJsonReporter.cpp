@@ -0,0 +1,119 @@
+#include "Catch.h"
+
+#if CATCH_VERSION_MAJOR >= 3
+#include <catch2/reporters/catch_reporter_registrars.hpp>
+#include <catch2/reporters/catch_reporter_streaming_base.hpp>
+#endif
+
+#include <string>
+#include <vector>
+
+#ifndef TOGGLER_VERSION
+#define TOGGLER_VERSION "unknown"
+#endif
+
+namespace
+{
+	std::string EscapeJson(const std::string& text)
+	{
+		std::string escaped;
+		escaped.reserve(text.size());
+		for (const char c : text)
+		{
+			switch (c)
+			{
+			case '"':
+				escaped += "\\\"";
+				break;
+			case '\\':
+				escaped += "\\\\";
+				break;
+			case '\n':
+				escaped += "\\n";
+				break;
+			default:
+				escaped += c;
+			}
+		}
+		return escaped;
+	}
+
+	struct BenchmarkResult
+	{
+		std::string testCase;
+		std::string name;
+		double mean = 0.0;
+		double meanLow = 0.0;
+		double meanHigh = 0.0;
+		double standardDeviation = 0.0;
+		std::size_t samples = 0;
+	};
+}
+
+// Writes one flat JSON document per run: {"version": ..., "benchmarks": [...]}, all times in nanoseconds.
+// Kept stable on purpose so results from different releases can be diffed by a script.
+#if CATCH_VERSION_MAJOR >= 3
+class BenchmarkJsonReporter : public Catch::StreamingReporterBase
+{
+public:
+	using StreamingReporterBase::StreamingReporterBase;
+#else
+class BenchmarkJsonReporter : public Catch::StreamingReporterBase<BenchmarkJsonReporter>
+{
+public:
+	using StreamingReporterBase::StreamingReporterBase;
+
+	void assertionStarting(const Catch::AssertionInfo&) override {}
+	bool assertionEnded(const Catch::AssertionStats&) override { return true; }
+#endif
+
+	static std::string getDescription()
+	{
+		return "Reports benchmark results as JSON for comparing releases";
+	}
+
+	void benchmarkEnded(const Catch::BenchmarkStats<>& stats) override
+	{
+		BenchmarkResult result;
+		result.testCase = currentTestCaseInfo->name;
+		result.name = stats.info.name;
+		result.mean = stats.mean.point.count();
+		result.meanLow = stats.mean.lower_bound.count();
+		result.meanHigh = stats.mean.upper_bound.count();
+		result.standardDeviation = stats.standardDeviation.point.count();
+		result.samples = stats.samples.size();
+		m_Results.push_back(std::move(result));
+	}
+
+	void testRunEnded(const Catch::TestRunStats& stats) override
+	{
+		std::ostream& out = Stream();
+		out << "{\n  \"version\": \"" << TOGGLER_VERSION << "\",\n  \"benchmarks\": [";
+		for (std::size_t i = 0; i < m_Results.size(); i++)
+		{
+			const auto& result = m_Results[i];
+			out << (i == 0 ? "\n" : ",\n")
+				<< "    {\"test_case\": \"" << EscapeJson(result.testCase)
+				<< "\", \"name\": \"" << EscapeJson(result.name)
+				<< "\", \"mean_ns\": " << result.mean
+				<< ", \"mean_low_ns\": " << result.meanLow
+				<< ", \"mean_high_ns\": " << result.meanHigh
+				<< ", \"stddev_ns\": " << result.standardDeviation
+				<< ", \"samples\": " << result.samples << "}";
+		}
+		out << "\n  ]\n}\n";
+
+		StreamingReporterBase::testRunEnded(stats);
+	}
+
+private:
+#if CATCH_VERSION_MAJOR >= 3
+	std::ostream& Stream() { return m_stream; }
+#else
+	std::ostream& Stream() { return stream; }
+#endif
+
+	std::vector<BenchmarkResult> m_Results;
+};
+
+CATCH_REGISTER_REPORTER("benchjson", BenchmarkJsonReporter)
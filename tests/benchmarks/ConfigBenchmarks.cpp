@@ -0,0 +1,46 @@
+#include "Catch.h"
+#include "PresetGenerator.h"
+
+#include "Core/Config.h"
+
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+	constexpr std::size_t s_RuleCounts[] = { 10, 100, 10000 };
+}
+
+TEST_CASE("LoadINI", "[benchmark][Config]")
+{
+	for (const std::size_t ruleCount : s_RuleCounts)
+	{
+		const auto path = (std::filesystem::temp_directory_path() / fmt::format("TogglerBenchmark{}.ini", ruleCount)).string();
+		std::ofstream(path) << PresetGenerator::GenerateINI(ruleCount);
+
+		BENCHMARK(fmt::format("{} rules", ruleCount))
+		{
+			Config::Clear();
+			Config::LoadINI(path);
+		};
+
+		std::filesystem::remove(path);
+		CHECK(techniqueTimeInfoList.size() == ruleCount);
+	}
+}
+
+TEST_CASE("Save serialization", "[benchmark][Config]")
+{
+	for (const std::size_t ruleCount : s_RuleCounts)
+	{
+		PresetGenerator::Populate(ruleCount);
+
+		std::size_t size = 0;
+		BENCHMARK(fmt::format("{} rules", ruleCount))
+		{
+			size = Config::Serialize().size();
+		};
+
+		CHECK(size > 0);
+	}
+}
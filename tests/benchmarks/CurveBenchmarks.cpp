@@ -0,0 +1,68 @@
+#include "Catch.h"
+
+#include "Core/UniformCurves.h"
+
+#include <fmt/format.h>
+#include <random>
+
+namespace
+{
+	// Keys on quarter hours like hand made presets, or anywhere for the worst case grid
+	std::vector<CurveInfo> MakeCurves(std::size_t count, std::size_t keysPerCurve, bool quarterHours)
+	{
+		std::mt19937 random(42);
+		std::uniform_int_distribution<int> quarters(0, 95);
+		std::uniform_real_distribution<double> hours(0.0, 24.0);
+		std::uniform_real_distribution<double> values(0.0, 1.0);
+
+		std::vector<CurveInfo> curves(count);
+		for (CurveInfo& curve : curves)
+		{
+			for (std::size_t key = 0; key < keysPerCurve; key++)
+			{
+				const double hour = quarterHours ? quarters(random) * 0.25 : hours(random);
+				curve.keys.push_back(CurveKey{ hour, values(random) });
+			}
+			std::sort(curve.keys.begin(), curve.keys.end(), [](const CurveKey& a, const CurveKey& b) { return a.hour < b.hour; });
+		}
+		return curves;
+	}
+}
+
+TEST_CASE("Curve evaluation", "[benchmark][Curves]")
+{
+	for (const std::size_t curveCount : { 64, 256, 1024 })
+	{
+		UniformCurves curves;
+		curves.Compile(MakeCurves(curveCount, 8, true));
+
+		// A frame at 60 fps and time scale 20 advances the clock by about 0.0001 hours
+		float hour = 0.0f;
+		BENCHMARK(fmt::format("{} curves, 8 keys on quarter hours", curveCount))
+		{
+			hour = hour >= 24.0f ? 0.0f : hour + 0.0001f;
+			return curves.Evaluate(hour)[curveCount - 1];
+		};
+	}
+
+	UniformCurves curves;
+	curves.Compile(MakeCurves(1024, 8, false));
+	float hour = 0.0f;
+	BENCHMARK("1024 curves, 8 keys anywhere")
+	{
+		hour = hour >= 24.0f ? 0.0f : hour + 0.0001f;
+		return curves.Evaluate(hour)[1023];
+	};
+
+	const auto reference = MakeCurves(1024, 8, true);
+	BENCHMARK("1024 curves, 8 keys, one at a time")
+	{
+		hour = hour >= 24.0f ? 0.0f : hour + 0.0001f;
+		double sum = 0.0;
+		for (const CurveInfo& curve : reference)
+		{
+			sum += UniformCurves::EvaluateKeys(curve.keys, hour);
+		}
+		return sum;
+	};
+}
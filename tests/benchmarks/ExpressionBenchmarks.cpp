@@ -0,0 +1,113 @@
+#include "Catch.h"
+
+#include "Core/ConditionExpressions.h"
+
+#include <fmt/format.h>
+#include <random>
+
+namespace
+{
+	const char* const kMenus[] = { "MapMenu", "InventoryMenu", "Journal Menu", "Dialogue Menu", "Crafting Menu", "Sleep/Wait Menu", "MagicMenu", "FavoritesMenu" };
+	const char* const kWeathers[] = { "kPleasant", "kCloudy", "kRainy", "kSnow" };
+
+	std::string MakeTerm(std::mt19937& random)
+	{
+		std::uniform_int_distribution<int> kind(0, 3);
+		std::uniform_int_distribution<int> menu(0, std::size(kMenus) - 1);
+		std::uniform_int_distribution<int> weather(0, std::size(kWeathers) - 1);
+		std::uniform_int_distribution<int> hour(0, 23);
+
+		switch (kind(random))
+		{
+		case 0:
+			return random() % 2 ? "interior" : "exterior";
+		case 1:
+			return fmt::format("menu({})", kMenus[menu(random)]);
+		case 2:
+			return fmt::format("weather({})", kWeathers[weather(random)]);
+		default:
+			return fmt::format("hour({}, {})", hour(random), hour(random));
+		}
+	}
+
+	// Presets write short expressions, 2 to 6 terms with the odd negation and group
+	std::string MakeExpression(std::mt19937& random)
+	{
+		std::uniform_int_distribution<int> terms(2, 6);
+		std::string text = MakeTerm(random);
+		for (int i = terms(random); i > 1; i--)
+		{
+			const char* negate = random() % 4 ? "" : "!";
+			text = random() % 3 ? fmt::format("{} && {}{}", text, negate, MakeTerm(random)) : fmt::format("({} || {}{})", text, negate, MakeTerm(random));
+		}
+		return text;
+	}
+}
+
+TEST_CASE("Expression evaluation", "[benchmark][Expressions]")
+{
+	std::mt19937 random(42);
+	std::vector<std::string> texts;
+	for (int i = 0; i < 10000; i++)
+	{
+		texts.push_back(MakeExpression(random));
+	}
+
+	BENCHMARK("10000 expressions, compile")
+	{
+		ConditionExpressions compiled;
+		for (const std::string& text : texts)
+		{
+			compiled.Add(text);
+		}
+		return compiled.GetInputCount();
+	};
+
+	ConditionExpressions expressions;
+	for (const std::string& text : texts)
+	{
+		expressions.Add(text);
+	}
+
+	std::unordered_set<std::string> menus;
+	ConditionSnapshot snapshot;
+	snapshot.hour = 12.0f;
+	snapshot.menus = &menus;
+	snapshot.weather = "kPleasant";
+	expressions.Update(snapshot);
+
+	BENCHMARK("10000 expressions, nothing changed")
+	{
+		return expressions.Update(snapshot).size();
+	};
+
+	// Opening and closing a menu re-runs only what reads it
+	bool open = false;
+	BENCHMARK("10000 expressions, one menu toggled")
+	{
+		open = !open;
+		if (open)
+		{
+			menus.insert("MapMenu");
+		}
+		else
+		{
+			menus.erase("MapMenu");
+		}
+		return expressions.Update(snapshot).size();
+	};
+
+	// Interior is read by about a quarter of the terms, the worst single input
+	BENCHMARK("10000 expressions, interior toggled")
+	{
+		snapshot.interior = !snapshot.interior;
+		return expressions.Update(snapshot).size();
+	};
+
+	// Reference: what every update would cost without the dependency tracking
+	BENCHMARK("10000 expressions, all evaluated")
+	{
+		expressions.Invalidate();
+		return expressions.Update(snapshot).size();
+	};
+}
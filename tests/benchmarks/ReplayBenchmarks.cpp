@@ -0,0 +1,76 @@
+#include "Catch.h"
+#include "PresetGenerator.h"
+
+#include "Core/Replay.h"
+#include "Core/Timeline.h"
+
+namespace
+{
+	// Roughly what a session produces: a time tick per second with the occasional cell, weather and menu change
+	Timeline MakeSession(std::size_t seconds)
+	{
+		Timeline timeline;
+		const std::uint32_t map = timeline.InternMenu("MapMenu");
+
+		for (std::uint32_t second = 0; second < seconds; second++)
+		{
+			TimelineEvent event;
+			event.time = second * 1000;
+			event.type = TimelineEventType::kHour;
+			event.hour = static_cast<float>(second % 1440) / 60.0f;
+			timeline.events.push_back(event);
+
+			if (second % 30 == 0)
+			{
+				event.type = TimelineEventType::kCell;
+				event.cellType = second % 60 == 0 ? CellType::kInterior : CellType::kExterior;
+				timeline.events.push_back(event);
+
+				event.type = TimelineEventType::kWeather;
+				event.weatherFlags = 1u << (second / 30 % 6);
+				timeline.events.push_back(event);
+			}
+
+			if (second % 120 == 0)
+			{
+				event.menu = map;
+				event.type = TimelineEventType::kMenuOpen;
+				timeline.events.push_back(event);
+				event.type = TimelineEventType::kMenuClose;
+				timeline.events.push_back(event);
+			}
+		}
+
+		return timeline;
+	}
+}
+
+TEST_CASE("Timeline replay", "[benchmark][Replay]")
+{
+	const Timeline timeline = MakeSession(3600);
+	const auto data = timeline.Serialize();
+
+	BENCHMARK(fmt::format("Deserialize, {} events", timeline.events.size()))
+	{
+		Timeline loaded;
+		return loaded.Deserialize(data);
+	};
+
+	for (const std::size_t ruleCount : { 10, 100 })
+	{
+		PresetGenerator::Populate(ruleCount);
+
+		std::size_t callCount = 0;
+		BENCHMARK(fmt::format("Replay {} events, {} rules", timeline.events.size(), ruleCount))
+		{
+			ReplayEffectRuntime runtime;
+			runtime.SetLogging(false);
+			TimelineReplayer replayer;
+			replayer.Replay(timeline, runtime);
+			callCount = runtime.GetCallCount();
+			return callCount;
+		};
+
+		CHECK(callCount > 0);
+	}
+}
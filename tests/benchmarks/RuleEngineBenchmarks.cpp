@@ -0,0 +1,203 @@
+#include "Catch.h"
+#include "PresetGenerator.h"
+#include "Stubs.h"
+
+#include "Core/EffectApplier.h"
+#include "Core/RuleEngine.h"
+#include "Core/TimeIntervals.h"
+
+namespace
+{
+	constexpr std::size_t s_RuleCounts[] = { 10, 100, 10000 };
+}
+
+TEST_CASE("Menu events", "[benchmark][Menu]")
+{
+	for (const std::size_t ruleCount : s_RuleCounts)
+	{
+		PresetGenerator::Populate(ruleCount);
+
+		StubGameState gameState;
+		StubEffectRuntime runtime;
+		PresetGenerator::AddEffects(runtime, ruleCount);
+		RuleEngine engine(gameState, &runtime);
+		engine.ProcessMenuEvent("HUD Menu", true);
+
+		BENCHMARK(fmt::format("Specific open+close, {} rules", ruleCount))
+		{
+			engine.ProcessMenuEvent("MapMenu", true);
+			engine.ProcessMenuEvent("MapMenu", false);
+		};
+
+		ToggleStateMenus = "All";
+		BENCHMARK(fmt::format("All open+close, {} menus", ruleCount))
+		{
+			engine.ProcessMenuEvent("MapMenu", true);
+			engine.ProcessMenuEvent("MapMenu", false);
+		};
+
+		CHECK(runtime.techniqueStateCalls > 0);
+		CHECK(runtime.effectsStateCalls > 0);
+	}
+}
+
+TEST_CASE("Time evaluation", "[benchmark][Time]")
+{
+	for (const std::size_t ruleCount : s_RuleCounts)
+	{
+		PresetGenerator::Populate(ruleCount);
+
+		StubGameState gameState;
+		StubEffectRuntime runtime;
+		PresetGenerator::AddEffects(runtime, ruleCount);
+
+		// Without a runtime only the rules are evaluated
+		RuleEngine evaluateOnly(gameState);
+		BENCHMARK(fmt::format("Evaluate, {} rules", ruleCount))
+		{
+			gameState.hour = gameState.hour >= 23.0f ? 0.0f : gameState.hour + 0.5f;
+			evaluateOnly.ProcessTimeBasedToggling();
+		};
+
+		RuleEngine engine(gameState, &runtime);
+		BENCHMARK(fmt::format("Evaluate+apply, {} rules", ruleCount))
+		{
+			gameState.hour = gameState.hour >= 23.0f ? 0.0f : gameState.hour + 0.5f;
+			engine.ProcessTimeBasedToggling();
+		};
+
+		// Most ticks move the clock without crossing a rule boundary
+		BENCHMARK(fmt::format("Evaluate+apply, nothing crossed, {} rules", ruleCount))
+		{
+			gameState.hour = gameState.hour >= 12.9f ? 12.1f : gameState.hour + 0.0001f;
+			engine.ProcessTimeBasedToggling();
+		};
+
+		CHECK(runtime.techniqueStateCalls > 0);
+	}
+}
+
+TEST_CASE("Time interval lookup", "[benchmark][Time]")
+{
+	for (const std::size_t ruleCount : s_RuleCounts)
+	{
+		PresetGenerator::Populate(ruleCount);
+
+		TimeIntervals intervals;
+		BENCHMARK(fmt::format("Build, {} rules", ruleCount))
+		{
+			intervals.Build(techniqueTimeInfoList);
+			return intervals.GetBoundaryCount();
+		};
+
+		float hour = 0.0f;
+		BENCHMARK(fmt::format("Find segment, {} rules", ruleCount))
+		{
+			hour = hour >= 23.0f ? 0.0f : hour + 0.5f;
+			return intervals.FindSegment(hour);
+		};
+
+		BENCHMARK(fmt::format("Linear scan, {} rules", ruleCount))
+		{
+			hour = hour >= 23.0f ? 0.0f : hour + 0.5f;
+			std::size_t active = 0;
+			for (const TechniqueInfo& info : techniqueTimeInfoList)
+			{
+				active += RuleEngine::IsTimeWithinRange(hour, info.startTime, info.stopTime);
+			}
+			return active;
+		};
+	}
+}
+
+TEST_CASE("Weather matching", "[benchmark][Weather]")
+{
+	for (const std::size_t ruleCount : s_RuleCounts)
+	{
+		PresetGenerator::Populate(ruleCount);
+
+		StubGameState gameState;
+		StubEffectRuntime runtime;
+		PresetGenerator::AddEffects(runtime, ruleCount);
+		RuleEngine engine(gameState, &runtime);
+
+		// kNone and then every single flag
+		std::uint32_t weather = 0;
+		BENCHMARK(fmt::format("Specific, {} rules", ruleCount))
+		{
+			weather = (weather + 1) % 7;
+			gameState.weatherFlags = weather == 0 ? 0u : 1u << (weather - 1);
+			engine.ProcessWeatherBasedToggling();
+		};
+
+		ToggleStateWeather = "All";
+		BENCHMARK(fmt::format("All, {} weathers", ruleCount))
+		{
+			engine.ProcessWeatherBasedToggling();
+		};
+
+		CHECK(runtime.techniqueStateCalls > 0);
+	}
+}
+
+TEST_CASE("ApplyTechniqueState", "[benchmark][Apply]")
+{
+	StubEffectRuntime runtime;
+	runtime.AddEffect("Single.fx", 1);
+	runtime.AddEffect("Many.fx", 16);
+
+	const TechniqueInfo single{ "Single.fx", "off" };
+	const TechniqueInfo many{ "Many.fx", "on" };
+	const TechniqueInfo missing{ "Missing.fx", "off" };
+
+	bool enable = false;
+	BENCHMARK("1 technique")
+	{
+		enable = !enable;
+		EffectApplier::ApplyTechniqueState(runtime, enable, single);
+	};
+
+	BENCHMARK("16 techniques")
+	{
+		enable = !enable;
+		EffectApplier::ApplyTechniqueState(runtime, enable, many);
+	};
+
+	BENCHMARK("Effect not loaded")
+	{
+		EffectApplier::ApplyTechniqueState(runtime, enable, missing);
+	};
+
+	CHECK(runtime.enumerateCalls > 0);
+	CHECK(runtime.techniqueStateCalls > 0);
+}
+
+TEST_CASE("Interior changes", "[benchmark][Interior]")
+{
+	for (const std::size_t ruleCount : s_RuleCounts)
+	{
+		PresetGenerator::Populate(ruleCount);
+
+		StubGameState gameState;
+		StubEffectRuntime runtime;
+		PresetGenerator::AddEffects(runtime, ruleCount);
+		RuleEngine engine(gameState, &runtime);
+
+		// Every pass flips the condition, so every rule is applied
+		BENCHMARK(fmt::format("Enter+leave, {} rules", ruleCount))
+		{
+			gameState.cellType = CellType::kInterior;
+			engine.ProcessInteriorBasedToggling();
+			gameState.cellType = CellType::kExterior;
+			engine.ProcessInteriorBasedToggling();
+		};
+
+		// The usual poll, nothing flipped
+		BENCHMARK(fmt::format("Same cell, {} rules", ruleCount))
+		{
+			engine.ProcessInteriorBasedToggling();
+		};
+
+		CHECK(runtime.techniqueStateCalls > 0);
+	}
+}